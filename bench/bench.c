@@ -0,0 +1,430 @@
+/**
+ * @file bench.c
+ * @brief Benchmark runner.
+ *
+ * Runs every suite case across element counts and key lengths, reporting
+ * ns/op, ops/sec, allocations per op and peak RSS as a table and optionally
+ * as JSON. A JSON file from an earlier run can be given as a baseline, in
+ * which case cases slower than the baseline by more than the threshold are
+ * flagged and the exit status is non-zero. The "scaling" subcommand runs the
+ * multi-threaded benchmarks in bench_scaling.c instead, and "replay" replays a
+ * recorded operation trace with bench_replay.c.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "bench.h"
+#include "collection/i_platform.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_LIST 16
+#define MAX_ITERATIONS 1000000000u
+#define NAME_LENGTH 64
+
+struct Options {
+    size_t sizes[MAX_LIST];
+    size_t size_count;
+    size_t key_lengths[MAX_LIST];
+    size_t key_length_count;
+    const char *filter;
+    uint64_t min_time_ns;
+    const char *json_path;
+    const char *baseline_path;
+    double threshold;
+};
+
+struct Result {
+    char suite[NAME_LENGTH];
+    char name[NAME_LENGTH];
+    size_t size;
+    size_t key_length;
+    size_t iterations;
+    double ns_per_op;
+    double allocs_per_op;
+    double peak_rss_mb;
+};
+
+struct Results {
+    struct Result *items;
+    size_t count;
+    size_t capacity;
+};
+
+#ifdef BENCH_COUNT_ALLOCATIONS
+static atomic_uint_fast64_t allocation_count;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+
+// Counts a malloc call; installed with -Wl,--wrap=malloc.
+void *__wrap_malloc(const size_t size) {
+    atomic_fetch_add_explicit(&allocation_count, 1, memory_order_relaxed);
+    return __real_malloc(size);
+}
+
+// Counts a calloc call; installed with -Wl,--wrap=calloc.
+void *__wrap_calloc(const size_t count, const size_t size) {
+    atomic_fetch_add_explicit(&allocation_count, 1, memory_order_relaxed);
+    return __real_calloc(count, size);
+}
+
+// Counts a realloc call; installed with -Wl,--wrap=realloc.
+void *__wrap_realloc(void *pointer, const size_t size) {
+    atomic_fetch_add_explicit(&allocation_count, 1, memory_order_relaxed);
+    return __real_realloc(pointer, size);
+}
+#endif
+
+// Returns the number of allocations counted so far.
+uint64_t bench_allocations(void) {
+#ifdef BENCH_COUNT_ALLOCATIONS
+    return atomic_load_explicit(&allocation_count, memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+// Returns whether allocations are counted in this build.
+bool bench_counts_allocations(void) {
+#ifdef BENCH_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Stops attributing time and allocations to the case.
+void bench_pause(struct Bench *bench) {
+    if (!bench->running) return;
+    bench->elapsed_ns += clock_monotonic_ns() - bench->resumed_ns;
+    bench->allocations += bench_allocations() - bench->resumed_allocations;
+    bench->running = false;
+}
+
+// Resumes attributing time and allocations to the case.
+void bench_resume(struct Bench *bench) {
+    if (bench->running) return;
+    bench->resumed_allocations = bench_allocations();
+    bench->running = true;
+    bench->resumed_ns = clock_monotonic_ns();
+}
+
+// Returns a Fisher-Yates shuffle of [0, count) driven by xorshift64.
+size_t *bench_permutation(const size_t count, uint64_t seed) {
+    size_t *permutation = malloc((count ? count : 1) * sizeof(size_t));
+    if (permutation == NULL) return NULL;
+
+    for (size_t i = 0; i < count; i++) permutation[i] = i;
+    for (size_t i = count; i > 1; i--) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        const size_t j = (size_t) (seed % i);
+        const size_t swap = permutation[i - 1];
+        permutation[i - 1] = permutation[j];
+        permutation[j] = swap;
+    }
+    return permutation;
+}
+
+// Parses a comma-separated list of positive sizes; false on malformed input.
+static bool parse_list(const char *text, size_t *values, size_t *count) {
+    *count = 0;
+    while (*text) {
+        char *end;
+        const unsigned long long value = strtoull(text, &end, 10);
+        if (end == text || value == 0 || *count == MAX_LIST || (*end != ',' && *end != '\0')) return false;
+        values[(*count)++] = (size_t) value;
+        text = *end == ',' ? end + 1 : end;
+    }
+    return *count > 0;
+}
+
+// Prints command-line usage.
+static void usage(const char *program) {
+    printf("Usage: %s [options]\n"
+           "  --sizes N,...        Element counts (default 10,1000,100000)\n"
+           "  --full               Element counts 10,100,...,10000000\n"
+           "  --key-lengths N,...  Dictionary key lengths in bytes (default 8,32,128)\n"
+           "  --filter TEXT        Only run cases whose \"suite/case\" name contains TEXT\n"
+           "  --min-time MS        Minimum measured time per case (default 100)\n"
+           "  --json FILE          Also write results as JSON\n"
+           "  --baseline FILE      Compare against JSON from an earlier run\n"
+           "  --threshold PCT      Slowdown flagged as a regression (default 10)\n"
+           "Run \"%s scaling --help\" for the multi-threaded scalability benchmarks\n"
+           "and \"%s replay TRACE\" to replay a recorded operation trace.\n",
+           program, program, program);
+}
+
+// Parses command-line options; returns false and prints usage on error.
+static bool parse_options(const int argc, char **argv, struct Options *options) {
+    *options = (struct Options) {
+        .sizes = {10, 1000, 100000}, .size_count = 3,
+        .key_lengths = {8, 32, 128}, .key_length_count = 3,
+        .min_time_ns = 100000000u, .threshold = 10.0
+    };
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--full") == 0) {
+            options->size_count = 0;
+            for (size_t size = 10; size <= 10000000; size *= 10) options->sizes[options->size_count++] = size;
+            continue;
+        }
+        if (strcmp(arg, "--help") == 0 || value == NULL) goto invalid;
+
+        if (strcmp(arg, "--sizes") == 0) {
+            if (!parse_list(value, options->sizes, &options->size_count)) goto invalid;
+        } else if (strcmp(arg, "--key-lengths") == 0) {
+            if (!parse_list(value, options->key_lengths, &options->key_length_count)) goto invalid;
+        } else if (strcmp(arg, "--filter") == 0) {
+            options->filter = value;
+        } else if (strcmp(arg, "--min-time") == 0) {
+            options->min_time_ns = strtoull(value, NULL, 10) * 1000000u;
+        } else if (strcmp(arg, "--json") == 0) {
+            options->json_path = value;
+        } else if (strcmp(arg, "--baseline") == 0) {
+            options->baseline_path = value;
+        } else if (strcmp(arg, "--threshold") == 0) {
+            options->threshold = strtod(value, NULL);
+        } else {
+            goto invalid;
+        }
+        i++;
+    }
+    return true;
+
+invalid:
+    usage(argv[0]);
+    return false;
+}
+
+// Appends a result, growing the list as needed.
+static bool results_add(struct Results *results, const struct Result *result) {
+    if (results->count == results->capacity) {
+        const size_t capacity = results->capacity ? results->capacity * 2 : 256;
+        struct Result *items = realloc(results->items, capacity * sizeof(struct Result));
+        if (items == NULL) {
+            fprintf(stderr, "\033[0;31m[Collection::Bench::results_add] Error: Result allocation failed.\033[0m\n");
+            return false;
+        }
+        results->items = items;
+        results->capacity = capacity;
+    }
+    results->items[results->count++] = *result;
+    return true;
+}
+
+// Reads results from a JSON file written by --json.
+static bool results_load(struct Results *results, const char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Bench::results_load] Error: Cannot open %s.\033[0m\n", path);
+        return false;
+    }
+
+    char line[512];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        struct Result result = {0};
+        if (sscanf(line, " {\"suite\": \"%63[^\"]\", \"case\": \"%63[^\"]\", \"size\": %zu, \"key_length\": %zu, "
+                         "\"iterations\": %zu, \"ns_per_op\": %lf",
+                   result.suite, result.name, &result.size, &result.key_length, &result.iterations,
+                   &result.ns_per_op) == 6 && !results_add(results, &result)) {
+            fclose(file);
+            return false;
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+// Returns the baseline result for the same case, size and key length, or NULL.
+static const struct Result *results_find(const struct Results *results, const struct Result *result) {
+    for (size_t i = 0; i < results->count; i++) {
+        const struct Result *candidate = &results->items[i];
+        if (candidate->size == result->size && candidate->key_length == result->key_length &&
+            strcmp(candidate->suite, result->suite) == 0 && strcmp(candidate->name, result->name) == 0) return candidate;
+    }
+    return NULL;
+}
+
+// Writes results as JSON, one benchmark object per line.
+static bool results_write(const struct Results *results, const struct Options *options, const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Bench::results_write] Error: Cannot open %s.\033[0m\n", path);
+        return false;
+    }
+
+    fprintf(file, "{\n  \"context\": {\"min_time_ms\": %llu, \"allocations_counted\": %s},\n  \"benchmarks\": [\n",
+            (unsigned long long) (options->min_time_ns / 1000000u), bench_counts_allocations() ? "true" : "false");
+    for (size_t i = 0; i < results->count; i++) {
+        const struct Result *result = &results->items[i];
+        fprintf(file, "    {\"suite\": \"%s\", \"case\": \"%s\", \"size\": %zu, \"key_length\": %zu, \"iterations\": %zu, "
+                      "\"ns_per_op\": %.3f, \"ops_per_sec\": %.1f, ",
+                result->suite, result->name, result->size, result->key_length, result->iterations,
+                result->ns_per_op, result->ns_per_op > 0 ? 1e9 / result->ns_per_op : 0.0);
+        if (bench_counts_allocations()) fprintf(file, "\"allocs_per_op\": %.4f, ", result->allocs_per_op);
+        else fprintf(file, "\"allocs_per_op\": null, ");
+        fprintf(file, "\"peak_rss_mb\": %.2f}%s\n", result->peak_rss_mb, i + 1 < results->count ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+
+    const bool written = ferror(file) == 0;
+    return fclose(file) == 0 && written;
+}
+
+// Runs a case with a growing iteration count until it takes at least the minimum time.
+static void measure(const struct BenchCase *bench_case, void *fixture, const size_t size, const size_t key_length,
+                    const uint64_t min_time_ns, struct Result *result) {
+    size_t iterations = 1;
+    struct Bench bench;
+
+    for (;;) {
+        bench = (struct Bench) {.iterations = iterations, .size = size, .key_length = key_length, .fixture = fixture};
+        bench_resume(&bench);
+        bench_case->run(&bench);
+        bench_pause(&bench);
+
+        if (bench.elapsed_ns >= min_time_ns || iterations >= MAX_ITERATIONS) break;
+
+        // Aim 20% past the minimum, growing at least by one and at most 100-fold per attempt.
+        double next = bench.elapsed_ns > 0 ? (double) iterations * (double) min_time_ns * 1.2 / (double) bench.elapsed_ns
+                                           : (double) iterations * 100.0;
+        if (next > (double) iterations * 100.0) next = (double) iterations * 100.0;
+        if (next > MAX_ITERATIONS) next = MAX_ITERATIONS;
+        iterations = next > (double) iterations ? (size_t) next : iterations + 1;
+    }
+
+    result->iterations = bench.iterations;
+    result->ns_per_op = (double) bench.elapsed_ns / (double) bench.iterations;
+    result->allocs_per_op = (double) bench.allocations / (double) bench.iterations;
+
+    struct process_stats stats;
+    result->peak_rss_mb = process_stats_collect(&stats) == 0 ? stats.max_rss_mb : 0;
+}
+
+// Returns whether the case name passes the filter.
+static bool selected(const struct Options *options, const struct BenchSuite *suite, const struct BenchCase *bench_case) {
+    if (options->filter == NULL) return true;
+
+    char name[2 * NAME_LENGTH];
+    snprintf(name, sizeof(name), "%s/%s", suite->name, bench_case->name);
+    return strstr(name, options->filter) != NULL;
+}
+
+// Runs every selected case of a suite for one fixture shape; false if a result could not be recorded.
+static bool run_fixture(const struct Options *options, const struct BenchSuite *suite, const size_t size,
+                        const size_t key_length, const struct Results *baseline, struct Results *results,
+                        size_t *regressions) {
+    bool any = false;
+    for (size_t c = 0; c < suite->case_count && !any; c++) any = selected(options, suite, &suite->cases[c]);
+    if (!any) return true;
+
+    void *fixture = suite->setup(size, key_length);
+    if (fixture == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Bench::run] Error: Cannot build %s with %zu elements.\033[0m\n",
+                suite->name, size);
+        return true; // Too large for this machine; the remaining shapes may still fit.
+    }
+
+    for (size_t c = 0; c < suite->case_count; c++) {
+        const struct BenchCase *bench_case = &suite->cases[c];
+        if (!selected(options, suite, bench_case)) continue;
+
+        struct Result result = {0};
+        snprintf(result.suite, sizeof(result.suite), "%s", suite->name);
+        snprintf(result.name, sizeof(result.name), "%s", bench_case->name);
+        result.size = size;
+        result.key_length = key_length;
+        measure(bench_case, fixture, size, key_length, options->min_time_ns, &result);
+
+        printf("%-20s %-20s %9zu %5zu %12zu %12.2f %14.0f ", result.suite, result.name, result.size,
+               result.key_length, result.iterations, result.ns_per_op, 1e9 / result.ns_per_op);
+        if (bench_counts_allocations()) printf("%10.3f ", result.allocs_per_op);
+        else printf("%10s ", "-");
+        printf("%9.1f", result.peak_rss_mb);
+
+        const struct Result *base = baseline ? results_find(baseline, &result) : NULL;
+        if (base != NULL && base->ns_per_op > 0) {
+            const double change = (result.ns_per_op - base->ns_per_op) / base->ns_per_op * 100.0;
+            if (change > options->threshold) {
+                printf("  \033[0;31m%+.1f%% REGRESSION\033[0m", change);
+                (*regressions)++;
+            } else {
+                printf("  %+.1f%%", change);
+            }
+        }
+        printf("\n");
+        fflush(stdout);
+
+        if (!results_add(results, &result)) {
+            suite->teardown(fixture);
+            return false;
+        }
+    }
+
+    suite->teardown(fixture);
+    return true;
+}
+
+// Runs every suite over every size and key length.
+static bool run_suites(const struct Options *options, const struct BenchSuite *suites, const size_t count,
+                       const struct Results *baseline, struct Results *results, size_t *regressions) {
+    static const size_t unkeyed[] = {0};
+
+    for (size_t s = 0; s < count; s++) {
+        const struct BenchSuite *suite = &suites[s];
+        const size_t *lengths = suite->keyed ? options->key_lengths : unkeyed;
+        const size_t length_count = suite->keyed ? options->key_length_count : 1;
+
+        for (size_t i = 0; i < options->size_count; i++) {
+            for (size_t k = 0; k < length_count; k++) {
+                if (!run_fixture(options, suite, options->sizes[i], lengths[k], baseline, results, regressions)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "scaling") == 0) return bench_scaling_main(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "replay") == 0) return bench_replay_main(argc, argv);
+
+    struct Options options;
+    if (!parse_options(argc, argv, &options)) return EXIT_FAILURE;
+
+#if defined(__GNUC__) && !defined(__OPTIMIZE__)
+    fprintf(stderr, "Warning: collection_bench was built without optimization; use a Release build.\n");
+#endif
+
+    struct Results baseline = {0};
+    if (options.baseline_path && !results_load(&baseline, options.baseline_path)) return EXIT_FAILURE;
+
+    printf("%-20s %-20s %9s %5s %12s %12s %14s %10s %9s%s\n", "suite", "case", "size", "key", "iterations", "ns/op",
+           "ops/sec", "allocs/op", "peak MB", options.baseline_path ? "  vs baseline" : "");
+
+    struct Results results = {0};
+    size_t regressions = 0;
+    bool ok = run_suites(&options, bench_array_suites, bench_array_suite_count, options.baseline_path ? &baseline : NULL,
+                         &results, &regressions)
+              && run_suites(&options, bench_dictionary_suites, bench_dictionary_suite_count,
+                            options.baseline_path ? &baseline : NULL, &results, &regressions);
+
+    if (ok && options.json_path) ok = results_write(&results, &options, options.json_path);
+    if (options.baseline_path) {
+        printf("\n%zu of %zu cases regressed by more than %.1f%% against %s\n", regressions, results.count,
+               options.threshold, options.baseline_path);
+    }
+
+    free(results.items);
+    free(baseline.items);
+    return ok && regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file bench.h
+ * @brief Benchmark Harness
+ *
+ * A suite builds a fixture of a given size (and key length), then each of its
+ * cases performs bench->iterations operations on it and leaves it holding the
+ * same elements. The harness grows the iteration count until a case runs for
+ * the minimum time, and attributes only the time and allocations between
+ * bench_resume() and bench_pause() to the case.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include "collection/i_array.h"
+#include "collection/i_dictionary.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/** Largest number of elements a case adds or removes before restoring its fixture. */
+#define BENCH_ROUND 4096
+
+/**
+ * @brief State of one timed run of a case.
+ */
+struct Bench {
+    size_t iterations;          /**< Operations the case must perform. */
+    size_t size;                /**< Number of elements in the fixture. */
+    size_t key_length;          /**< Key length in bytes, or 0 for unkeyed suites. */
+    void *fixture;              /**< Fixture built by the suite's setup. */
+    uint64_t elapsed_ns;        /**< Time measured so far. */
+    uint64_t allocations;       /**< Allocations measured so far. */
+    uint64_t resumed_ns;        /**< Clock reading when measurement last resumed. */
+    uint64_t resumed_allocations; /**< Allocation count when measurement last resumed. */
+    bool running;               /**< Whether measurement is active. */
+};
+
+/**
+ * @brief Stops attributing time and allocations to the case, e.g. while restoring the fixture.
+ *
+ * @param bench Current run.
+ */
+void bench_pause(struct Bench *bench);
+
+/**
+ * @brief Resumes attributing time and allocations to the case.
+ *
+ * @param bench Current run.
+ */
+void bench_resume(struct Bench *bench);
+
+/**
+ * @brief Returns the number of heap allocations made so far by the process, or 0 if not counted.
+ */
+uint64_t bench_allocations(void);
+
+/**
+ * @brief Returns whether allocations are counted in this build.
+ */
+bool bench_counts_allocations(void);
+
+/**
+ * @brief Returns a pseudo-random permutation of [0, count), or NULL on failure. Release with free().
+ *
+ * @param count Number of elements.
+ * @param seed Any non-zero value.
+ */
+size_t *bench_permutation(size_t count, uint64_t seed);
+
+/**
+ * @brief A benchmarked operation.
+ */
+struct BenchCase {
+    const char *name;                       /**< Operation name, usually the vtable entry. */
+    void (*run)(struct Bench *bench);       /**< Performs bench->iterations operations and restores the fixture. */
+};
+
+/**
+ * @brief A collection flavor with its fixture and cases.
+ */
+struct BenchSuite {
+    const char *name;                       /**< Flavor name, e.g. "array.vector". */
+    bool keyed;                             /**< Whether the suite runs once per key length. */
+    void *(*setup)(size_t size, size_t key_length); /**< Builds a fixture, or returns NULL on failure. */
+    void (*teardown)(void *fixture);        /**< Releases a fixture. */
+    const struct BenchCase *cases;          /**< Cases run against each fixture. */
+    size_t case_count;                      /**< Number of cases. */
+};
+
+extern const struct BenchSuite bench_array_suites[];
+extern const size_t bench_array_suite_count;
+
+extern const struct BenchSuite bench_dictionary_suites[];
+extern const size_t bench_dictionary_suite_count;
+
+/**
+ * @brief A backend the multi-threaded benchmarks and the trace replayer can build.
+ */
+struct BenchTarget {
+    const char *name;                               /**< Flavor name, e.g. "dictionary.swiss". */
+    struct IDictionary *(*dictionary)(void);        /**< Set for dictionary targets. */
+    struct IArray *(*array)(size_t capacity);       /**< Set for array targets; bounded flavors use the capacity. */
+};
+
+extern const struct BenchTarget bench_targets[];
+extern const size_t bench_target_count;
+
+/**
+ * @brief Runs the multi-threaded scalability benchmarks (`collection_bench scaling ...`).
+ *
+ * @param argc Argument count, including the program name and the subcommand.
+ * @param argv Arguments; options start at argv[2].
+ * @return Process exit status.
+ */
+int bench_scaling_main(int argc, char **argv);
+
+/**
+ * @brief Replays a recorded operation trace against each backend (`collection_bench replay ...`).
+ *
+ * @param argc Argument count, including the program name and the subcommand.
+ * @param argv Arguments; the trace file is argv[2] and options follow it.
+ * @return Process exit status.
+ */
+int bench_replay_main(int argc, char **argv);
@@ -0,0 +1,336 @@
+/**
+ * @file bench_array.c
+ * @brief IArray benchmarks.
+ *
+ * Elements are the tokens 1..size cast to pointers, so no element memory is
+ * measured. Cases that remove elements put them back while paused, and cases
+ * that add elements remove them again, in rounds of at most BENCH_ROUND.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "bench.h"
+#include "collection/i_array.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+struct ArrayFixture {
+    struct IArray *(*factory)(void);
+    struct IArray *array;
+    size_t size;
+    size_t *order;              /* Random permutation of positions, used to pick targets. */
+};
+
+static volatile uintptr_t sink; // Keeps results observable so loops are not optimized away.
+
+// Returns the element token stored for position i.
+static const void *token(const size_t i) {
+    return (const void *) (uintptr_t) (i + 1);
+}
+
+// Fills an array with size tokens.
+static bool fill(struct IArray *array, const size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if (!array->push(array, token(i))) return false;
+    }
+    return true;
+}
+
+// Builds an array fixture with the given factory.
+static void *setup(struct IArray *(*factory)(void), const size_t size) {
+    struct ArrayFixture *fixture = calloc(1, sizeof(struct ArrayFixture));
+    if (fixture == NULL) return NULL;
+
+    fixture->factory = factory;
+    fixture->size = size;
+    fixture->array = factory();
+    fixture->order = bench_permutation(size, 0x9E3779B97F4A7C15u);
+    if (fixture->array == NULL || fixture->order == NULL || !fill(fixture->array, size)) {
+        if (fixture->array) fixture->array->dealloc(fixture->array, NULL);
+        free(fixture->order);
+        free(fixture);
+        return NULL;
+    }
+    return fixture;
+}
+
+// Builds a linked-list Array fixture.
+static void *setup_array(const size_t size, const size_t key_length) {
+    (void) key_length;
+    return setup(collection_array_new, size);
+}
+
+// Builds a Vector fixture.
+static void *setup_vector(const size_t size, const size_t key_length) {
+    (void) key_length;
+    return setup(collection_array_new_vector, size);
+}
+
+// Builds a Deque fixture.
+static void *setup_deque(const size_t size, const size_t key_length) {
+    (void) key_length;
+    return setup(collection_array_new_deque, size);
+}
+
+// Releases an array fixture.
+static void teardown(void *fixture) {
+    struct ArrayFixture *this = fixture;
+    this->array->dealloc(this->array, NULL);
+    free(this->order);
+    free(this);
+}
+
+// Returns the i-th target token in random order.
+static const void *target(const struct ArrayFixture *fixture, const size_t i) {
+    return token(fixture->order[i % fixture->size]);
+}
+
+// Matches the element passed as data.
+static bool equals(const void *element, const void *data) {
+    return element == data;
+}
+
+// Counts visited elements.
+static void visit(const void *element, const void *data) {
+    (void) data;
+    sink += (uintptr_t) element;
+}
+
+// Reads elements at random indexes.
+static void bench_get(struct Bench *bench) {
+    struct ArrayFixture *fixture = bench->fixture;
+    struct IArray *array = fixture->array;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        sink += (uintptr_t) array->get(array, fixture->order[i % fixture->size]);
+    }
+}
+
+// Writes elements at random indexes, carrying each displaced element to the next write.
+static void bench_put(struct Bench *bench) {
+    struct ArrayFixture *fixture = bench->fixture;
+    struct IArray *array = fixture->array;
+
+    bench_pause(bench);
+    const void *carried = array->get(array, fixture->order[0]);
+    bench_resume(bench);
+
+    for (size_t i = 0; i < bench->iterations; i++) { // Skips the first slot, which still holds the carried token.
+        const size_t slot = fixture->size > 1 ? fixture->order[1 + i % (fixture->size - 1)] : fixture->order[0];
+        carried = array->put(array, carried, slot);
+    }
+
+    bench_pause(bench);
+    array->put(array, carried, fixture->order[0]); // Closes the cycle so every token is stored once.
+    bench_resume(bench);
+}
+
+// Visits every element.
+static void bench_for_each(struct Bench *bench) {
+    struct IArray *array = ((struct ArrayFixture *) bench->fixture)->array;
+
+    for (size_t i = 0; i < bench->iterations; i++) array->for_each(array, visit, NULL);
+}
+
+// Searches for random elements with find.
+static void bench_find(struct Bench *bench) {
+    struct ArrayFixture *fixture = bench->fixture;
+    struct IArray *array = fixture->array;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        sink += (uintptr_t) array->find(array, equals, target(fixture, i));
+    }
+}
+
+// Searches for random elements with first_index.
+static void bench_first_index(struct Bench *bench) {
+    struct ArrayFixture *fixture = bench->fixture;
+    struct IArray *array = fixture->array;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        sink += array->first_index(array, equals, target(fixture, i));
+    }
+}
+
+// Searches for random elements with last_index.
+static void bench_last_index(struct Bench *bench) {
+    struct ArrayFixture *fixture = bench->fixture;
+    struct IArray *array = fixture->array;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        sink += array->last_index(array, equals, target(fixture, i));
+    }
+}
+
+// Prepends elements, then shifts them off while paused.
+static void bench_unshift(struct Bench *bench) {
+    struct IArray *array = ((struct ArrayFixture *) bench->fixture)->array;
+
+    for (size_t done = 0; done < bench->iterations;) {
+        const size_t round = bench->iterations - done < BENCH_ROUND ? bench->iterations - done : BENCH_ROUND;
+        for (size_t i = 0; i < round; i++) array->unshift(array, token(SIZE_MAX - 1));
+
+        bench_pause(bench);
+        for (size_t i = 0; i < round; i++) array->shift(array);
+        bench_resume(bench);
+        done += round;
+    }
+}
+
+// Appends elements, then pops them off while paused.
+static void bench_push(struct Bench *bench) {
+    struct IArray *array = ((struct ArrayFixture *) bench->fixture)->array;
+
+    for (size_t done = 0; done < bench->iterations;) {
+        const size_t round = bench->iterations - done < BENCH_ROUND ? bench->iterations - done : BENCH_ROUND;
+        for (size_t i = 0; i < round; i++) array->push(array, token(SIZE_MAX - 1));
+
+        bench_pause(bench);
+        for (size_t i = 0; i < round; i++) array->pop(array);
+        bench_resume(bench);
+        done += round;
+    }
+}
+
+// Tests membership of random elements.
+static void bench_contains_value(struct Bench *bench) {
+    struct ArrayFixture *fixture = bench->fixture;
+    struct IArray *array = fixture->array;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        sink += array->contains_value(array, target(fixture, i));
+    }
+}
+
+// Shifts elements off the head, then pushes them back while paused, rotating the array.
+static void bench_shift(struct Bench *bench) {
+    struct ArrayFixture *fixture = bench->fixture;
+    struct IArray *array = fixture->array;
+    const void *removed[BENCH_ROUND];
+
+    for (size_t done = 0; done < bench->iterations;) {
+        size_t round = bench->iterations - done < BENCH_ROUND ? bench->iterations - done : BENCH_ROUND;
+        if (round > fixture->size) round = fixture->size;
+        for (size_t i = 0; i < round; i++) removed[i] = array->shift(array);
+
+        bench_pause(bench);
+        for (size_t i = 0; i < round; i++) array->push(array, removed[i]);
+        bench_resume(bench);
+        done += round;
+    }
+}
+
+// Pops elements off the tail, then pushes them back while paused.
+static void bench_pop(struct Bench *bench) {
+    struct ArrayFixture *fixture = bench->fixture;
+    struct IArray *array = fixture->array;
+    const void *removed[BENCH_ROUND];
+
+    for (size_t done = 0; done < bench->iterations;) {
+        size_t round = bench->iterations - done < BENCH_ROUND ? bench->iterations - done : BENCH_ROUND;
+        if (round > fixture->size) round = fixture->size;
+        for (size_t i = 0; i < round; i++) removed[i] = array->pop(array);
+
+        bench_pause(bench);
+        for (size_t i = round; i > 0; i--) array->push(array, removed[i - 1]);
+        bench_resume(bench);
+        done += round;
+    }
+}
+
+// Removes random elements by value, then pushes them back while paused.
+static void bench_remove_item(struct Bench *bench) {
+    struct ArrayFixture *fixture = bench->fixture;
+    struct IArray *array = fixture->array;
+
+    for (size_t done = 0; done < bench->iterations;) {
+        size_t round = bench->iterations - done < BENCH_ROUND ? bench->iterations - done : BENCH_ROUND;
+        if (round > fixture->size) round = fixture->size;
+        for (size_t i = 0; i < round; i++) sink += (uintptr_t) array->remove_item(array, target(fixture, i));
+
+        bench_pause(bench);
+        for (size_t i = 0; i < round; i++) array->push(array, target(fixture, i));
+        bench_resume(bench);
+        done += round;
+    }
+}
+
+// Clones the array, releasing each clone while paused.
+static void bench_clone(struct Bench *bench) {
+    struct IArray *array = ((struct ArrayFixture *) bench->fixture)->array;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        struct IArray *clone = array->clone(array);
+
+        bench_pause(bench);
+        if (clone) clone->dealloc(clone, NULL);
+        bench_resume(bench);
+    }
+}
+
+// Reads the element count.
+static void bench_count(struct Bench *bench) {
+    struct IArray *array = ((struct ArrayFixture *) bench->fixture)->array;
+
+    for (size_t i = 0; i < bench->iterations; i++) sink += array->count(array);
+}
+
+// Clears the array, refilling it while paused.
+static void bench_clear(struct Bench *bench) {
+    struct ArrayFixture *fixture = bench->fixture;
+    struct IArray *array = fixture->array;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        array->clear(array, NULL);
+
+        bench_pause(bench);
+        fill(array, fixture->size);
+        bench_resume(bench);
+    }
+}
+
+// Releases arrays built while paused.
+static void bench_dealloc(struct Bench *bench) {
+    struct ArrayFixture *fixture = bench->fixture;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        bench_pause(bench);
+        struct IArray *array = fixture->factory();
+        if (array == NULL || !fill(array, fixture->size)) {
+            fprintf(stderr, "\033[0;31m[Collection::Bench::dealloc] Error: Array allocation failed.\033[0m\n");
+            exit(EXIT_FAILURE);
+        }
+        bench_resume(bench);
+
+        array->dealloc(array, NULL);
+    }
+}
+
+static const struct BenchCase cases[] = {
+    {"get", bench_get},
+    {"put", bench_put},
+    {"for_each", bench_for_each},
+    {"find", bench_find},
+    {"first_index", bench_first_index},
+    {"last_index", bench_last_index},
+    {"unshift", bench_unshift},
+    {"push", bench_push},
+    {"contains_value", bench_contains_value},
+    {"shift", bench_shift},
+    {"pop", bench_pop},
+    {"remove_item", bench_remove_item},
+    {"clone", bench_clone},
+    {"count", bench_count},
+    {"clear", bench_clear},
+    {"dealloc", bench_dealloc},
+};
+
+const struct BenchSuite bench_array_suites[] = {
+    {"array", false, setup_array, teardown, cases, sizeof(cases) / sizeof(cases[0])},
+    {"array.vector", false, setup_vector, teardown, cases, sizeof(cases) / sizeof(cases[0])},
+    {"array.deque", false, setup_deque, teardown, cases, sizeof(cases) / sizeof(cases[0])},
+};
+
+const size_t bench_array_suite_count = sizeof(bench_array_suites) / sizeof(bench_array_suites[0]);
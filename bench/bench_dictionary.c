@@ -0,0 +1,425 @@
+/**
+ * @file bench_dictionary.c
+ * @brief IDictionary benchmarks.
+ *
+ * Each fixture holds size keys of exactly key_length bytes, looked up in a
+ * random order, plus up to BENCH_ROUND absent ("fresh") keys that insert
+ * cases add and then remove while paused. Every value is its own key pointer.
+ * Batch cases count one operation per key and use batches of BATCH keys.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "bench.h"
+#include "collection/i_dictionary.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BATCH 64
+
+struct DictionaryFixture {
+    struct IDictionary *(*factory)(void);
+    struct IDictionary *dictionary;
+    size_t size;
+    char *storage;                  /* Bytes of every key, present and fresh. */
+    const char **ordered;           /* Present keys in random order. */
+    const char **fresh;             /* Keys never left in the dictionary. */
+    size_t fresh_count;
+    struct CollectionKey *handles;  /* Handles for the first ring ordered keys, then every fresh key. */
+    size_t ring;
+};
+
+static volatile uintptr_t sink; // Keeps results observable so loops are not optimized away.
+
+// Writes key i as base-36 digits, least significant first, padded to length; false if it does not fit.
+static bool format_key(char *key, size_t i, const size_t length) {
+    static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    size_t n = 0;
+    do {
+        if (n == length) return false;
+        key[n++] = digits[i % 36];
+        i /= 36;
+    } while (i > 0);
+    while (n < length) key[n++] = '_'; // Not a digit, so padding never makes two keys equal.
+    key[n] = '\0';
+    return true;
+}
+
+// Inserts every present key.
+static bool fill(struct IDictionary *dictionary, const struct DictionaryFixture *fixture) {
+    for (size_t i = 0; i < fixture->size; i++) {
+        if (!dictionary->put(dictionary, fixture->ordered[i], fixture->ordered[i])) return false;
+    }
+    return true;
+}
+
+// Releases a dictionary fixture.
+static void teardown(void *fixture) {
+    struct DictionaryFixture *this = fixture;
+    if (this->dictionary) this->dictionary->dealloc(this->dictionary, NULL);
+    free(this->handles);
+    free(this->ordered);
+    free(this->fresh);
+    free(this->storage);
+    free(this);
+}
+
+// Builds a dictionary fixture with the given factory.
+static void *setup(struct IDictionary *(*factory)(void), const size_t size, const size_t key_length) {
+    struct DictionaryFixture *fixture = calloc(1, sizeof(struct DictionaryFixture));
+    if (fixture == NULL) return NULL;
+
+    fixture->factory = factory;
+    fixture->size = size;
+    fixture->fresh_count = size < BENCH_ROUND ? size : BENCH_ROUND;
+    fixture->ring = fixture->fresh_count;
+
+    const size_t total = size + fixture->fresh_count;
+    size_t *order = bench_permutation(size, 0x2545F4914F6CDD1Du);
+    fixture->storage = malloc(total * (key_length + 1));
+    fixture->ordered = malloc(size * sizeof(char *));
+    fixture->fresh = malloc(fixture->fresh_count * sizeof(char *));
+    fixture->handles = malloc((fixture->ring + fixture->fresh_count) * sizeof(struct CollectionKey));
+    if (order == NULL || fixture->storage == NULL || fixture->ordered == NULL || fixture->fresh == NULL ||
+        fixture->handles == NULL) goto exception;
+
+    for (size_t i = 0; i < total; i++) {
+        if (!format_key(fixture->storage + i * (key_length + 1), i, key_length)) {
+            fprintf(stderr, "\033[0;31m[Collection::Bench::setup] Error: %zu keys do not fit in %zu bytes.\033[0m\n",
+                    total, key_length);
+            goto exception;
+        }
+    }
+    for (size_t i = 0; i < size; i++) fixture->ordered[i] = fixture->storage + order[i] * (key_length + 1);
+    for (size_t i = 0; i < fixture->fresh_count; i++) fixture->fresh[i] = fixture->storage + (size + i) * (key_length + 1);
+    for (size_t i = 0; i < fixture->ring; i++) fixture->handles[i] = collection_key(fixture->ordered[i]);
+    for (size_t i = 0; i < fixture->fresh_count; i++) fixture->handles[fixture->ring + i] = collection_key(fixture->fresh[i]);
+
+    fixture->dictionary = factory();
+    if (fixture->dictionary == NULL || !fill(fixture->dictionary, fixture)) goto exception;
+
+    free(order);
+    return fixture;
+
+exception:
+    free(order);
+    teardown(fixture);
+    return NULL;
+}
+
+// Creates a striped dictionary with the default stripe count.
+static struct IDictionary *new_striped(void) {
+    return collection_dictionary_new_striped(0);
+}
+
+// Builds a chained Dictionary fixture.
+static void *setup_dictionary(const size_t size, const size_t key_length) {
+    return setup(collection_dictionary_new, size, key_length);
+}
+
+// Builds a Swiss table fixture.
+static void *setup_swiss(const size_t size, const size_t key_length) {
+    return setup(collection_dictionary_new_swiss, size, key_length);
+}
+
+// Builds a lock-striped dictionary fixture.
+static void *setup_striped(const size_t size, const size_t key_length) {
+    return setup(new_striped, size, key_length);
+}
+
+// Builds a lock-free dictionary fixture.
+static void *setup_lockfree(const size_t size, const size_t key_length) {
+    return setup(collection_dictionary_new_lockfree, size, key_length);
+}
+
+// Returns the number of operations left, capped to limit.
+static size_t round_size(const struct Bench *bench, const size_t done, const size_t limit) {
+    const size_t remaining = bench->iterations - done;
+    return remaining < limit ? remaining : limit;
+}
+
+// Returns the i-th present key in random order.
+static const char *key_at(const struct DictionaryFixture *fixture, const size_t i) {
+    return fixture->ordered[i % fixture->size];
+}
+
+// Produces a value for get_or_insert_with misses.
+static void *produce(const char *key, void *context) {
+    (void) context;
+    return (void *) key;
+}
+
+// Keeps the current value.
+static bool keep(const char *key, void **value, void *context) {
+    (void) key;
+    (void) value;
+    (void) context;
+    return true;
+}
+
+// Looks up present keys.
+static void bench_get(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+
+    for (size_t i = 0; i < bench->iterations; i++) sink += (uintptr_t) dictionary->get(dictionary, key_at(fixture, i));
+}
+
+// Inserts fresh keys, removing them while paused.
+static void bench_put(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+
+    for (size_t done = 0; done < bench->iterations;) {
+        const size_t round = round_size(bench, done, fixture->fresh_count);
+        for (size_t i = 0; i < round; i++) dictionary->put(dictionary, fixture->fresh[i], fixture->fresh[i]);
+
+        bench_pause(bench);
+        for (size_t i = 0; i < round; i++) dictionary->remove_item(dictionary, fixture->fresh[i]);
+        bench_resume(bench);
+        done += round;
+    }
+}
+
+// Tests membership of present keys.
+static void bench_contains_key(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+
+    for (size_t i = 0; i < bench->iterations; i++) sink += dictionary->contains_key(dictionary, key_at(fixture, i));
+}
+
+// Removes present keys, putting them back while paused.
+static void bench_remove_item(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+
+    for (size_t done = 0; done < bench->iterations;) {
+        const size_t round = round_size(bench, done, fixture->ring);
+        for (size_t i = 0; i < round; i++) sink += (uintptr_t) dictionary->remove_item(dictionary, fixture->ordered[i]);
+
+        bench_pause(bench);
+        for (size_t i = 0; i < round; i++) dictionary->put(dictionary, fixture->ordered[i], fixture->ordered[i]);
+        bench_resume(bench);
+        done += round;
+    }
+}
+
+// Replaces values of present keys with themselves.
+static void bench_replace(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        const char *key = key_at(fixture, i);
+        sink += (uintptr_t) dictionary->replace(dictionary, key, key);
+    }
+}
+
+// Inserts fresh keys with put_if_absent, removing them while paused.
+static void bench_put_if_absent(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+
+    for (size_t done = 0; done < bench->iterations;) {
+        const size_t round = round_size(bench, done, fixture->fresh_count);
+        for (size_t i = 0; i < round; i++) sink += dictionary->put_if_absent(dictionary, fixture->fresh[i], fixture->fresh[i]);
+
+        bench_pause(bench);
+        for (size_t i = 0; i < round; i++) dictionary->remove_item(dictionary, fixture->fresh[i]);
+        bench_resume(bench);
+        done += round;
+    }
+}
+
+// Updates present keys with upsert.
+static void bench_upsert(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        const char *key = key_at(fixture, i);
+        sink += (uintptr_t) dictionary->upsert(dictionary, key, key);
+    }
+}
+
+// Finds present keys with get_or_insert_with.
+static void bench_get_or_insert_with(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        sink += (uintptr_t) dictionary->get_or_insert_with(dictionary, key_at(fixture, i), produce, NULL);
+    }
+}
+
+// Runs a value-preserving compute on present keys.
+static void bench_compute(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        sink += (uintptr_t) dictionary->compute(dictionary, key_at(fixture, i), keep, NULL);
+    }
+}
+
+// Looks up present keys in batches.
+static void bench_get_many(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+    void *values[BATCH];
+
+    for (size_t done = 0; done < bench->iterations;) {
+        const size_t start = done % fixture->size;
+        size_t batch = round_size(bench, done, BATCH);
+        if (batch > fixture->size - start) batch = fixture->size - start;
+
+        sink += dictionary->get_many(dictionary, fixture->ordered + start, batch, values);
+        done += batch;
+    }
+}
+
+// Inserts fresh keys in batches, removing them while paused.
+static void bench_put_many(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+    void *values[BATCH];
+
+    for (size_t done = 0; done < bench->iterations;) {
+        const size_t round = round_size(bench, done, fixture->fresh_count);
+        for (size_t start = 0; start < round; start += BATCH) {
+            const size_t batch = round - start < BATCH ? round - start : BATCH;
+            sink += dictionary->put_many(dictionary, fixture->fresh + start, (const void *const *) fixture->fresh + start, batch);
+        }
+
+        bench_pause(bench);
+        for (size_t start = 0; start < round; start += BATCH) {
+            const size_t batch = round - start < BATCH ? round - start : BATCH;
+            dictionary->remove_many(dictionary, fixture->fresh + start, batch, values);
+        }
+        bench_resume(bench);
+        done += round;
+    }
+}
+
+// Removes present keys in batches, putting them back while paused.
+static void bench_remove_many(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+    void *values[BATCH];
+
+    for (size_t done = 0; done < bench->iterations;) {
+        const size_t round = round_size(bench, done, fixture->ring);
+        for (size_t start = 0; start < round; start += BATCH) {
+            const size_t batch = round - start < BATCH ? round - start : BATCH;
+            sink += dictionary->remove_many(dictionary, fixture->ordered + start, batch, values);
+        }
+
+        bench_pause(bench);
+        for (size_t start = 0; start < round; start += BATCH) {
+            const size_t batch = round - start < BATCH ? round - start : BATCH;
+            dictionary->put_many(dictionary, fixture->ordered + start, (const void *const *) fixture->ordered + start, batch);
+        }
+        bench_resume(bench);
+        done += round;
+    }
+}
+
+// Looks up present keys through pre-hashed handles.
+static void bench_get_hashed(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        sink += (uintptr_t) dictionary->get_hashed(dictionary, &fixture->handles[i % fixture->ring]);
+    }
+}
+
+// Inserts fresh keys through pre-hashed handles, removing them while paused.
+static void bench_put_hashed(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+    const struct CollectionKey *handles = fixture->handles + fixture->ring;
+
+    for (size_t done = 0; done < bench->iterations;) {
+        const size_t round = round_size(bench, done, fixture->fresh_count);
+        for (size_t i = 0; i < round; i++) dictionary->put_hashed(dictionary, &handles[i], handles[i].key);
+
+        bench_pause(bench);
+        for (size_t i = 0; i < round; i++) dictionary->remove_item(dictionary, handles[i].key);
+        bench_resume(bench);
+        done += round;
+    }
+}
+
+// Tests membership of present keys through pre-hashed handles.
+static void bench_contains_key_hashed(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        sink += dictionary->contains_key_hashed(dictionary, &fixture->handles[i % fixture->ring]);
+    }
+}
+
+// Clears the dictionary, refilling it while paused.
+static void bench_clear(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+    struct IDictionary *dictionary = fixture->dictionary;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        dictionary->clear(dictionary, NULL);
+
+        bench_pause(bench);
+        fill(dictionary, fixture);
+        bench_resume(bench);
+    }
+}
+
+// Releases dictionaries built while paused.
+static void bench_dealloc(struct Bench *bench) {
+    struct DictionaryFixture *fixture = bench->fixture;
+
+    for (size_t i = 0; i < bench->iterations; i++) {
+        bench_pause(bench);
+        struct IDictionary *dictionary = fixture->factory();
+        if (dictionary == NULL || !fill(dictionary, fixture)) {
+            fprintf(stderr, "\033[0;31m[Collection::Bench::dealloc] Error: Dictionary allocation failed.\033[0m\n");
+            exit(EXIT_FAILURE);
+        }
+        bench_resume(bench);
+
+        dictionary->dealloc(dictionary, NULL);
+    }
+}
+
+static const struct BenchCase cases[] = {
+    {"get", bench_get},
+    {"put", bench_put},
+    {"contains_key", bench_contains_key},
+    {"remove_item", bench_remove_item},
+    {"replace", bench_replace},
+    {"put_if_absent", bench_put_if_absent},
+    {"upsert", bench_upsert},
+    {"get_or_insert_with", bench_get_or_insert_with},
+    {"compute", bench_compute},
+    {"get_many", bench_get_many},
+    {"put_many", bench_put_many},
+    {"remove_many", bench_remove_many},
+    {"get_hashed", bench_get_hashed},
+    {"put_hashed", bench_put_hashed},
+    {"contains_key_hashed", bench_contains_key_hashed},
+    {"clear", bench_clear},
+    {"dealloc", bench_dealloc},
+};
+
+const struct BenchSuite bench_dictionary_suites[] = {
+    {"dictionary", true, setup_dictionary, teardown, cases, sizeof(cases) / sizeof(cases[0])},
+    {"dictionary.swiss", true, setup_swiss, teardown, cases, sizeof(cases) / sizeof(cases[0])},
+    {"dictionary.striped", true, setup_striped, teardown, cases, sizeof(cases) / sizeof(cases[0])},
+    {"dictionary.lockfree", true, setup_lockfree, teardown, cases, sizeof(cases) / sizeof(cases[0])},
+};
+
+const size_t bench_dictionary_suite_count = sizeof(bench_dictionary_suites) / sizeof(bench_dictionary_suites[0]);
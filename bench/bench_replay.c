@@ -0,0 +1,663 @@
+/**
+ * @file bench_replay.c
+ * @brief Deterministic replay of recorded operation traces.
+ *
+ * Loads a trace written by a recording collection (see i_trace.h) and
+ * re-executes it against every backend of the matching kind: dictionary
+ * records against each dictionary, array records against each array. Keys are
+ * synthesized from the recorded hash and length, so distinct recorded keys
+ * stay distinct and keep their length; values are placeholders. Predicates
+ * match on the recorded call, and value searches target a stored value or an
+ * absent one depending on whether the recorded call succeeded.
+ *
+ * Serial mode runs every record on one thread in trace order. Interleaved
+ * mode starts one thread per recorded thread and hands execution from thread
+ * to thread so the trace order is reproduced exactly; its wall time includes
+ * the hand-offs, while the per-operation means do not. Each run reports its
+ * wall time, the mean time per operation type and how many results diverged
+ * from the recorded ones.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "bench.h"
+#include "collection/i_platform.h"
+#include "collection/i_trace.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef DWORD WINAPI ThreadResult;
+#define THREAD_RETURN 0
+#else
+typedef pthread_t Thread;
+typedef void *ThreadResult;
+#define THREAD_RETURN NULL
+#endif
+
+#define MAX_THREADS 1024
+#define MAX_KEY_LENGTH (1u << 20)
+#define SPIN_LIMIT 1024
+#define OP_CODES 256
+
+struct Options {
+    const char *path;
+    bool serial;
+    bool interleaved;
+    size_t capacity;
+    const char *filter;
+};
+
+/* One trace record, or the first record of a batch, prepared for execution. */
+struct ReplayOp {
+    uint8_t op;
+    bool expected;                  /* Whether the recorded call succeeded. */
+    uint16_t thread;                /* Dense thread slot. */
+    uint32_t key;                   /* Index into the synthesized keys. */
+    uint64_t argument;              /* Recorded index or predicate call count. */
+    uint32_t batch;                 /* Records executed by this one: the batch size, 1, or 0 inside a batch. */
+};
+
+/* The records of one collection kind with their synthesized keys and per-thread schedules. */
+struct Replay {
+    struct ReplayOp *ops;
+    size_t count;
+    const char **op_keys;           /* Key of each record, so a batch passes a contiguous slice. */
+    char *key_storage;
+    struct CollectionKey *handles;  /* Pre-hashed handle of each synthesized key. */
+    size_t key_count;
+    size_t thread_count;
+    size_t *schedule;               /* Batch-starting positions, grouped by thread in trace order. */
+    size_t *schedule_offsets;       /* thread_count + 1 offsets into schedule. */
+    size_t max_batch;
+};
+
+struct Counters {
+    uint64_t records[OP_CODES];
+    uint64_t ns[OP_CODES];
+    uint64_t diverged[OP_CODES];
+};
+
+struct Session {
+    const struct Replay *replay;
+    const struct BenchTarget *target;
+    size_t capacity;
+    struct IDictionary *dictionary;
+    struct IArray *array;
+    atomic_size_t next;             /* Position whose turn it is in interleaved mode. */
+    atomic_size_t waiters;
+    atomic_bool failed;
+    Monitor monitor;
+    Condition condition;
+};
+
+struct Worker {
+    struct Session *session;
+    size_t thread;
+    void **values;                  /* Scratch for batch results. */
+    struct Counters counters;
+};
+
+static int token;                   /* Stands in for every stored value. */
+static int absent;                  /* Never stored, so searches for it fail. */
+
+static const char *const dictionary_names[] = {
+    NULL, "get", "put", "contains_key", "remove_item", "replace", "put_if_absent", "upsert", "get_or_insert_with",
+    "compute", "get_many", "put_many", "remove_many", "get_hashed", "put_hashed", "contains_key_hashed", "clear",
+    "dealloc"
+};
+
+static const char *const array_names[] = {
+    "get", "put", "for_each", "find", "first_index", "last_index", "unshift", "push", "contains_value", "shift", "pop",
+    "remove_item", "clone", "count", "clear", "dealloc"
+};
+
+// Returns the name of an operation code, or NULL if it is unknown.
+static const char *op_name(const unsigned op) {
+    if (op < sizeof(dictionary_names) / sizeof(dictionary_names[0])) return dictionary_names[op];
+    if (op >= COLLECTION_TRACE_ARRAY_GET && op - COLLECTION_TRACE_ARRAY_GET < sizeof(array_names) / sizeof(array_names[0])) {
+        return array_names[op - COLLECTION_TRACE_ARRAY_GET];
+    }
+    return NULL;
+}
+
+// Returns whether an operation code is a dictionary batch operation.
+static bool is_batch(const unsigned op) {
+    return op == COLLECTION_TRACE_DICTIONARY_GET_MANY || op == COLLECTION_TRACE_DICTIONARY_PUT_MANY
+           || op == COLLECTION_TRACE_DICTIONARY_REMOVE_MANY;
+}
+
+// Writes the key for an id: its base-64 digits, padded to the recorded length with a character no digit uses.
+static size_t synthesize_key(char *key, size_t id, const size_t length) {
+    static const char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-_";
+    size_t n = 0;
+    do {
+        key[n++] = digits[id % 64];
+        id /= 64;
+    } while (id);
+    while (n < length) key[n++] = '.';
+    key[n] = '\0';
+    return n;
+}
+
+// Releases a prepared replay.
+static void replay_release(struct Replay *replay) {
+    free(replay->ops);
+    free((void *) replay->op_keys);
+    free(replay->key_storage);
+    free(replay->handles);
+    free(replay->schedule);
+    free(replay->schedule_offsets);
+    memset(replay, 0, sizeof(struct Replay));
+}
+
+struct KeySlot {
+    uint64_t hash;
+    uint32_t length;
+    uint32_t id;                    /* Key id plus one; 0 marks an empty slot. */
+};
+
+// Prepares the records of one kind: assigns key ids and thread slots, marks batches and builds the schedules.
+static bool replay_prepare(struct Replay *replay, const struct CollectionTraceRecord *records, const size_t count,
+                           const bool dictionary) {
+    memset(replay, 0, sizeof(struct Replay));
+    for (size_t i = 0; i < count; i++) {
+        if ((records[i].op < COLLECTION_TRACE_ARRAY_GET) == dictionary) replay->count++;
+    }
+    if (replay->count == 0) return true;
+
+    size_t slots = 16;
+    while (slots < 2 * replay->count) slots *= 2;
+    struct KeySlot *table = calloc(slots, sizeof(struct KeySlot));
+    uint32_t *thread_slots = calloc(65536, sizeof(uint32_t));
+    size_t *lengths = NULL;
+    replay->ops = calloc(replay->count, sizeof(struct ReplayOp));
+    replay->op_keys = calloc(replay->count, sizeof(char *));
+    if (table == NULL || thread_slots == NULL || replay->ops == NULL || replay->op_keys == NULL) goto exception;
+
+    size_t key_bytes = 0;
+    for (size_t i = 0, n = 0; i < count; i++) {
+        const struct CollectionTraceRecord *record = &records[i];
+        if ((record->op < COLLECTION_TRACE_ARRAY_GET) != dictionary) continue;
+
+        struct ReplayOp *op = &replay->ops[n++];
+        op->op = record->op;
+        op->expected = (record->flags & COLLECTION_TRACE_SUCCEEDED) != 0;
+        op->argument = record->index;
+        op->batch = 1;
+        if (thread_slots[record->thread] == 0) thread_slots[record->thread] = (uint32_t) ++replay->thread_count;
+        op->thread = (uint16_t) (thread_slots[record->thread] - 1);
+        if (!dictionary) continue;
+
+        size_t s = (size_t) (record->key_hash ^ record->key_length) & (slots - 1);
+        while (table[s].id && (table[s].hash != record->key_hash || table[s].length != record->key_length)) {
+            s = (s + 1) & (slots - 1);
+        }
+        if (table[s].id == 0) {
+            table[s] = (struct KeySlot) {record->key_hash, record->key_length, (uint32_t) ++replay->key_count};
+            key_bytes += record->key_length + 12; // Room for the id digits and the terminator.
+        }
+        op->key = table[s].id - 1;
+    }
+
+    if (dictionary) {
+        lengths = malloc(replay->key_count * sizeof(size_t));
+        replay->key_storage = malloc(key_bytes);
+        replay->handles = malloc(replay->key_count * sizeof(struct CollectionKey));
+        if (lengths == NULL || replay->key_storage == NULL || replay->handles == NULL) goto exception;
+
+        for (size_t s = 0; s < slots; s++) {
+            if (table[s].id) lengths[table[s].id - 1] = table[s].length;
+        }
+        char *cursor = replay->key_storage;
+        for (size_t k = 0; k < replay->key_count; k++) {
+            const size_t length = synthesize_key(cursor, k, lengths[k]);
+            replay->handles[k] = collection_key(cursor);
+            cursor += length + 1;
+        }
+        for (size_t i = 0; i < replay->count; i++) replay->op_keys[i] = replay->handles[replay->ops[i].key].key;
+    }
+
+    // A batch runs as one call when its records are intact; a damaged batch replays record by record.
+    replay->max_batch = 1;
+    for (size_t i = 0; i < replay->count; i++) {
+        struct ReplayOp *op = &replay->ops[i];
+        if (!is_batch(op->op) || op->argument <= 1 || op->argument > replay->count - i || op->argument > UINT32_MAX) continue;
+
+        size_t n = 1;
+        while (n < op->argument && replay->ops[i + n].op == op->op && replay->ops[i + n].thread == op->thread
+               && replay->ops[i + n].argument == op->argument - n) {
+            n++;
+        }
+        if (n != op->argument) continue;
+
+        op->batch = (uint32_t) n;
+        for (size_t j = 1; j < n; j++) replay->ops[i + j].batch = 0;
+        if (n > replay->max_batch) replay->max_batch = n;
+        i += n - 1;
+    }
+
+    replay->schedule_offsets = calloc(replay->thread_count + 1, sizeof(size_t));
+    replay->schedule = malloc(replay->count * sizeof(size_t));
+    if (replay->schedule_offsets == NULL || replay->schedule == NULL) goto exception;
+    for (size_t i = 0; i < replay->count; i++) {
+        if (replay->ops[i].batch) replay->schedule_offsets[replay->ops[i].thread + 1]++;
+    }
+    for (size_t t = 0; t < replay->thread_count; t++) replay->schedule_offsets[t + 1] += replay->schedule_offsets[t];
+    free(lengths);
+    lengths = calloc(replay->thread_count, sizeof(size_t));
+    if (lengths == NULL) goto exception;
+    for (size_t i = 0; i < replay->count; i++) {
+        const struct ReplayOp *op = &replay->ops[i];
+        if (op->batch) replay->schedule[replay->schedule_offsets[op->thread] + lengths[op->thread]++] = i;
+    }
+
+    free(lengths);
+    free(thread_slots);
+    free(table);
+    return true;
+
+exception:
+    fprintf(stderr, "\033[0;31m[Collection::Bench::replay] Error: Trace preparation failed.\033[0m\n");
+    free(lengths);
+    free(thread_slots);
+    free(table);
+    replay_release(replay);
+    return false;
+}
+
+// Builds the collection under test; false marks the session failed.
+static bool session_create(struct Session *session) {
+    if (session->target->dictionary) session->dictionary = session->target->dictionary();
+    else session->array = session->target->array(session->capacity);
+
+    if (session->dictionary == NULL && session->array == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Bench::replay] Error: Cannot build %s.\033[0m\n", session->target->name);
+        atomic_store(&session->failed, true);
+        return false;
+    }
+    return true;
+}
+
+// Releases the collection under test.
+static void session_release(struct Session *session) {
+    if (session->dictionary) collection_dictionary_dealloc(&session->dictionary, NULL);
+    if (session->array) collection_array_dealloc(&session->array, NULL);
+}
+
+// Ignores every element.
+static void consume(const void *element, const void *data) {
+    (void) element;
+    (void) data;
+}
+
+/* Predicate state: match on the given call, counting from 1; 0 never matches. */
+struct Match {
+    uint64_t call;
+    uint64_t calls;
+};
+
+// Matches exactly on the recorded call.
+static bool match_call(const void *element, const void *data) {
+    (void) element;
+    struct Match *match = (struct Match *) data;
+    return ++match->calls == match->call;
+}
+
+// Produces the recorded outcome: the context is the value to insert, or NULL to insert nothing.
+static void *produce(const char *key, void *context) {
+    (void) key;
+    return context;
+}
+
+// Stores the context as the value when it is non-NULL, and removes the key otherwise.
+static bool recompute(const char *key, void **value, void *context) {
+    (void) key;
+    *value = context;
+    return context != NULL;
+}
+
+// Executes one dictionary record or batch and returns whether it succeeded, counting per-key divergences of batches.
+static bool execute_dictionary(struct Worker *worker, const size_t position, uint64_t *diverged) {
+    const struct Replay *replay = worker->session->replay;
+    struct IDictionary *dictionary = worker->session->dictionary;
+    const struct ReplayOp *op = &replay->ops[position];
+    const char *key = replay->op_keys[position];
+    const struct CollectionKey *handle = &replay->handles[op->key];
+    const char *const *keys = &replay->op_keys[position];
+    void *value = op->expected ? &token : NULL;
+
+    switch (op->op) {
+        case COLLECTION_TRACE_DICTIONARY_GET: return dictionary->get(dictionary, key) != NULL;
+        case COLLECTION_TRACE_DICTIONARY_PUT: return dictionary->put(dictionary, key, &token);
+        case COLLECTION_TRACE_DICTIONARY_CONTAINS_KEY: return dictionary->contains_key(dictionary, key);
+        case COLLECTION_TRACE_DICTIONARY_REMOVE_ITEM: return dictionary->remove_item(dictionary, key) != NULL;
+        case COLLECTION_TRACE_DICTIONARY_REPLACE: return dictionary->replace(dictionary, key, &token) != NULL;
+        case COLLECTION_TRACE_DICTIONARY_PUT_IF_ABSENT: return dictionary->put_if_absent(dictionary, key, &token);
+        case COLLECTION_TRACE_DICTIONARY_UPSERT: return dictionary->upsert(dictionary, key, &token) != NULL;
+        case COLLECTION_TRACE_DICTIONARY_GET_OR_INSERT_WITH:
+            return dictionary->get_or_insert_with(dictionary, key, produce, value) != NULL;
+        case COLLECTION_TRACE_DICTIONARY_COMPUTE: return dictionary->compute(dictionary, key, recompute, value) != NULL;
+        case COLLECTION_TRACE_DICTIONARY_GET_MANY:
+        case COLLECTION_TRACE_DICTIONARY_REMOVE_MANY: {
+            if (op->op == COLLECTION_TRACE_DICTIONARY_GET_MANY) dictionary->get_many(dictionary, keys, op->batch, worker->values);
+            else dictionary->remove_many(dictionary, keys, op->batch, worker->values);
+            for (size_t i = 1; i < op->batch; i++) {
+                if ((worker->values[i] != NULL) != replay->ops[position + i].expected) (*diverged)++;
+            }
+            return worker->values[0] != NULL;
+        }
+        case COLLECTION_TRACE_DICTIONARY_PUT_MANY: {
+            for (size_t i = 0; i < op->batch; i++) worker->values[i] = &token;
+            const bool stored = dictionary->put_many(dictionary, keys, (const void *const *) worker->values, op->batch)
+                                == op->batch;
+            if (stored != op->expected) *diverged += op->batch - 1;
+            return stored;
+        }
+        case COLLECTION_TRACE_DICTIONARY_GET_HASHED: return dictionary->get_hashed(dictionary, handle) != NULL;
+        case COLLECTION_TRACE_DICTIONARY_PUT_HASHED: return dictionary->put_hashed(dictionary, handle, &token);
+        case COLLECTION_TRACE_DICTIONARY_CONTAINS_KEY_HASHED: return dictionary->contains_key_hashed(dictionary, handle);
+        case COLLECTION_TRACE_DICTIONARY_CLEAR: return dictionary->clear(dictionary, NULL);
+        case COLLECTION_TRACE_DICTIONARY_DEALLOC:
+            session_release(worker->session);
+            return session_create(worker->session);
+        default: return op->expected;
+    }
+}
+
+// Executes one array record and returns whether it succeeded.
+static bool execute_array(struct Worker *worker, const size_t position) {
+    struct IArray *array = worker->session->array;
+    const struct ReplayOp *op = &worker->session->replay->ops[position];
+    const size_t index = op->argument < SIZE_MAX ? (size_t) op->argument : SIZE_MAX - 1;
+    struct Match match = {.call = op->expected ? op->argument : 0};
+    const void *item = op->expected ? (const void *) &token : (const void *) &absent;
+
+    switch (op->op) {
+        case COLLECTION_TRACE_ARRAY_GET: return array->get(array, index) != NULL;
+        case COLLECTION_TRACE_ARRAY_PUT: return array->put(array, &token, index) != NULL;
+        case COLLECTION_TRACE_ARRAY_FOR_EACH:
+            array->for_each(array, consume, NULL);
+            return true;
+        case COLLECTION_TRACE_ARRAY_FIND: return array->find(array, match_call, &match) != NULL;
+        case COLLECTION_TRACE_ARRAY_FIRST_INDEX: return array->first_index(array, match_call, &match) != SIZE_MAX;
+        case COLLECTION_TRACE_ARRAY_LAST_INDEX: return array->last_index(array, match_call, &match) != SIZE_MAX;
+        case COLLECTION_TRACE_ARRAY_UNSHIFT: return array->unshift(array, &token) != NULL;
+        case COLLECTION_TRACE_ARRAY_PUSH: return array->push(array, &token);
+        case COLLECTION_TRACE_ARRAY_CONTAINS_VALUE: return array->contains_value(array, item);
+        case COLLECTION_TRACE_ARRAY_SHIFT: return array->shift(array) != NULL;
+        case COLLECTION_TRACE_ARRAY_POP: return array->pop(array) != NULL;
+        case COLLECTION_TRACE_ARRAY_REMOVE_ITEM: return array->remove_item(array, item) != NULL;
+        case COLLECTION_TRACE_ARRAY_CLONE: {
+            struct IArray *copy = array->clone(array);
+            if (copy == NULL) return false;
+            collection_array_dealloc(&copy, NULL);
+            return true;
+        }
+        case COLLECTION_TRACE_ARRAY_COUNT:
+            array->count(array);
+            return true;
+        case COLLECTION_TRACE_ARRAY_CLEAR:
+            array->clear(array, NULL);
+            return true;
+        case COLLECTION_TRACE_ARRAY_DEALLOC:
+            session_release(worker->session);
+            return session_create(worker->session);
+        default: return op->expected;
+    }
+}
+
+// Executes and times the record or batch at a position.
+static void execute(struct Worker *worker, const size_t position) {
+    const struct ReplayOp *op = &worker->session->replay->ops[position];
+    uint64_t diverged = 0;
+
+    const uint64_t begin = clock_monotonic_ns();
+    const bool succeeded = worker->session->dictionary ? execute_dictionary(worker, position, &diverged)
+                                                       : execute_array(worker, position);
+    const uint64_t elapsed = clock_monotonic_ns() - begin;
+
+    worker->counters.records[op->op] += op->batch;
+    worker->counters.ns[op->op] += elapsed;
+    worker->counters.diverged[op->op] += diverged + (succeeded != op->expected);
+}
+
+// Waits until the trace reaches a position; false if the session failed meanwhile.
+static bool wait_turn(struct Session *session, const size_t position) {
+    for (size_t spins = 0; spins < SPIN_LIMIT; spins++) {
+        if (atomic_load(&session->next) == position) return true;
+    }
+
+    monitor_lock(&session->monitor);
+    atomic_fetch_add(&session->waiters, 1);
+    while (atomic_load(&session->next) != position && !atomic_load(&session->failed)) {
+        condition_wait(&session->condition, &session->monitor, 10);
+    }
+    atomic_fetch_sub(&session->waiters, 1);
+    monitor_unlock(&session->monitor);
+    return !atomic_load(&session->failed);
+}
+
+// Hands the trace to whichever thread owns the next position.
+static void pass_turn(struct Session *session, const size_t next) {
+    atomic_store(&session->next, next);
+    if (atomic_load(&session->waiters) == 0) return;
+
+    monitor_lock(&session->monitor);
+    condition_broadcast(&session->condition);
+    monitor_unlock(&session->monitor);
+}
+
+// Replays one recorded thread's records, each in its turn.
+static ThreadResult worker_thread(void *arg) {
+    struct Worker *worker = arg;
+    struct Session *session = worker->session;
+    const struct Replay *replay = session->replay;
+
+    for (size_t s = replay->schedule_offsets[worker->thread]; s < replay->schedule_offsets[worker->thread + 1]; s++) {
+        const size_t position = replay->schedule[s];
+        if (!wait_turn(session, position)) break;
+        execute(worker, position);
+        if (atomic_load(&session->failed)) {
+            pass_turn(session, SIZE_MAX);
+            break;
+        }
+        pass_turn(session, position + replay->ops[position].batch);
+    }
+    return THREAD_RETURN;
+}
+
+// Creates a platform thread.
+static bool thread_create(Thread *thread, ThreadResult (*routine)(void *), void *arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+    return *thread != NULL;
+#else
+    return pthread_create(thread, NULL, routine, arg) == 0;
+#endif
+}
+
+// Waits for a platform thread to finish.
+static void thread_join(Thread thread) {
+#ifdef _WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+// Prints the results of one run, then the per-operation breakdown.
+static void report(const struct BenchTarget *target, const char *mode, const struct Replay *replay,
+                   const struct Counters *counters, const uint64_t elapsed) {
+    uint64_t diverged = 0;
+    for (size_t op = 0; op < OP_CODES; op++) diverged += counters->diverged[op];
+
+    printf("%-20s %-12s %8zu %12zu %10.2f %14.0f %10llu\n", target->name, mode, replay->thread_count, replay->count,
+           (double) elapsed / 1e6, (double) replay->count * 1e9 / (double) (elapsed ? elapsed : 1),
+           (unsigned long long) diverged);
+    for (size_t op = 0; op < OP_CODES; op++) {
+        if (counters->records[op] == 0) continue;
+        printf("  %-31s %21llu %10.1f ns/op %10llu\n", op_name((unsigned) op), (unsigned long long) counters->records[op],
+               (double) counters->ns[op] / (double) counters->records[op], (unsigned long long) counters->diverged[op]);
+    }
+    fflush(stdout);
+}
+
+// Replays a prepared trace against one target in one mode.
+static bool run(const struct Replay *replay, const struct BenchTarget *target, const struct Options *options,
+                const bool interleaved) {
+    const size_t thread_count = interleaved ? replay->thread_count : 1;
+    struct Session session = {.replay = replay, .target = target, .capacity = options->capacity};
+    struct Worker *workers = calloc(thread_count, sizeof(struct Worker));
+    Thread *threads = calloc(thread_count, sizeof(Thread));
+    bool ok = workers != NULL && threads != NULL;
+    for (size_t i = 0; ok && i < thread_count; i++) {
+        workers[i].session = &session;
+        workers[i].thread = i;
+        ok = (workers[i].values = malloc(replay->max_batch * sizeof(void *))) != NULL;
+    }
+    if (!ok) fprintf(stderr, "\033[0;31m[Collection::Bench::replay] Error: Setup failed.\033[0m\n");
+    ok = ok && session_create(&session);
+
+    uint64_t elapsed = 0;
+    if (ok && !interleaved) {
+        const uint64_t begin = clock_monotonic_ns();
+        for (size_t i = 0; i < replay->count && !atomic_load(&session.failed); i++) {
+            if (replay->ops[i].batch) execute(&workers[0], i);
+        }
+        elapsed = clock_monotonic_ns() - begin;
+    } else if (ok) {
+        monitor_init(&session.monitor);
+        condition_init(&session.condition);
+        atomic_store(&session.next, SIZE_MAX); // Hold every thread until all have started.
+
+        size_t started = 0;
+        while (started < thread_count && thread_create(&threads[started], worker_thread, &workers[started])) started++;
+        if (started != thread_count) {
+            fprintf(stderr, "\033[0;31m[Collection::Bench::replay] Error: Cannot start %zu threads.\033[0m\n", thread_count);
+            atomic_store(&session.failed, true);
+        }
+
+        const uint64_t begin = clock_monotonic_ns();
+        pass_turn(&session, 0);
+        for (size_t i = 0; i < started; i++) thread_join(threads[i]);
+        elapsed = clock_monotonic_ns() - begin;
+
+        condition_destroy(&session.condition);
+        monitor_destroy(&session.monitor);
+    }
+    ok = ok && !atomic_load(&session.failed);
+    session_release(&session);
+
+    if (ok) {
+        struct Counters *total = &workers[0].counters;
+        for (size_t i = 1; i < thread_count; i++) {
+            for (size_t op = 0; op < OP_CODES; op++) {
+                total->records[op] += workers[i].counters.records[op];
+                total->ns[op] += workers[i].counters.ns[op];
+                total->diverged[op] += workers[i].counters.diverged[op];
+            }
+        }
+        report(target, interleaved ? "interleaved" : "serial", replay, total, elapsed);
+    }
+
+    for (size_t i = 0; workers && i < thread_count; i++) free(workers[i].values);
+    free(threads);
+    free(workers);
+    return ok;
+}
+
+// Prints command-line usage.
+static void usage(const char *program) {
+    printf("Usage: %s replay TRACE [options]\n"
+           "  --mode NAME              serial, interleaved or both (default both)\n"
+           "  --filter TEXT            Only replay against targets whose name contains TEXT\n"
+           "  --capacity N             Capacity of bounded arrays (default 65536)\n"
+           "Dictionary records are replayed against every dictionary and array records against every array.\n"
+           "Record a trace with collection_dictionary_new_recording(), collection_array_new_recording()\n"
+           "or \"%s scaling --record TRACE\".\n",
+           program, program);
+}
+
+// Parses the trace path and replay options after the subcommand; returns false and prints usage on error.
+static bool parse_options(const int argc, char **argv, struct Options *options) {
+    *options = (struct Options) {.serial = true, .interleaved = true, .capacity = 65536};
+    if (argc < 3 || strncmp(argv[2], "--", 2) == 0) goto invalid;
+    options->path = argv[2];
+
+    for (int i = 3; i < argc; i += 2) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (value == NULL) goto invalid;
+
+        if (strcmp(arg, "--mode") == 0) {
+            options->serial = strcmp(value, "serial") == 0 || strcmp(value, "both") == 0;
+            options->interleaved = strcmp(value, "interleaved") == 0 || strcmp(value, "both") == 0;
+            if (!options->serial && !options->interleaved) goto invalid;
+        } else if (strcmp(arg, "--filter") == 0) {
+            options->filter = value;
+        } else if (strcmp(arg, "--capacity") == 0) {
+            options->capacity = strtoull(value, NULL, 10);
+            if (options->capacity < 1) goto invalid;
+        } else {
+            goto invalid;
+        }
+    }
+    return true;
+
+invalid:
+    usage(argv[0]);
+    return false;
+}
+
+// Loads a trace and replays it against every selected target in every selected mode.
+int bench_replay_main(const int argc, char **argv) {
+    struct Options options;
+    if (!parse_options(argc, argv, &options)) return EXIT_FAILURE;
+
+    size_t count;
+    struct CollectionTraceRecord *records = collection_trace_load(options.path, &count);
+    if (records == NULL) return EXIT_FAILURE;
+
+    bool ok = true;
+    for (size_t i = 0; ok && i < count; i++) {
+        if (op_name(records[i].op) == NULL || records[i].key_length > MAX_KEY_LENGTH) {
+            fprintf(stderr, "\033[0;31m[Collection::Bench::replay] Error: Record %zu is malformed.\033[0m\n", i);
+            ok = false;
+        }
+    }
+
+    struct Replay replays[2] = {0}; // Dictionary records, then array records.
+    ok = ok && replay_prepare(&replays[0], records, count, true) && replay_prepare(&replays[1], records, count, false);
+    free(records);
+    for (size_t r = 0; ok && r < 2; r++) {
+        if (replays[r].thread_count > MAX_THREADS && options.interleaved) {
+            fprintf(stderr, "\033[0;31m[Collection::Bench::replay] Error: More than %d recorded threads.\033[0m\n",
+                    MAX_THREADS);
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        printf("%s: %zu dictionary and %zu array records\n", options.path, replays[0].count, replays[1].count);
+        printf("%-20s %-12s %8s %12s %10s %14s %10s\n", "target", "mode", "threads", "records", "wall ms", "records/sec",
+               "diverged");
+    }
+    for (size_t t = 0; ok && t < bench_target_count; t++) {
+        const struct BenchTarget *target = &bench_targets[t];
+        const struct Replay *replay = &replays[target->dictionary ? 0 : 1];
+        if (replay->count == 0 || (options.filter && strstr(target->name, options.filter) == NULL)) continue;
+
+        if (options.serial) ok = run(replay, target, &options, false);
+        if (ok && options.interleaved) ok = run(replay, target, &options, true);
+    }
+
+    replay_release(&replays[0]);
+    replay_release(&replays[1]);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
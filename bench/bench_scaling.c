@@ -0,0 +1,606 @@
+/**
+ * @file bench_scaling.c
+ * @brief Multi-threaded scalability benchmarks.
+ *
+ * Runs identical timed workloads against each backend while sweeping thread
+ * counts, operation mixes and key distributions. Dictionary workloads mix
+ * get() with upsert() on a prefilled key space drawn uniformly or from a
+ * Zipfian distribution; array workloads mix push() with shift() on a
+ * prefilled queue. Each run reports throughput, speedup over the first thread
+ * count (ideal speedup equals the thread count when the first count is 1),
+ * per-thread fairness and sampled latency percentiles. With --record, every
+ * operation is also written to a trace for `collection_bench replay`.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "bench.h"
+#include "collection/i_array.h"
+#include "collection/i_dictionary.h"
+#include "collection/i_platform.h"
+#include "collection/i_trace.h"
+
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef DWORD WINAPI ThreadResult;
+#define THREAD_RETURN 0
+#else
+typedef pthread_t Thread;
+typedef void *ThreadResult;
+#define THREAD_RETURN NULL
+#endif
+
+#define MAX_LIST 16
+#define MAX_THREADS 256
+#define KEY_LENGTH 24
+#define SUB_BUCKETS 8
+#define HISTOGRAM_BUCKETS (2 * SUB_BUCKETS + 60 * SUB_BUCKETS)
+
+enum Distribution {
+    UNIFORM,
+    ZIPF
+};
+
+struct Options {
+    size_t threads[MAX_LIST];
+    size_t thread_count;
+    size_t read_percents[MAX_LIST];
+    size_t read_percent_count;
+    size_t push_percents[MAX_LIST];
+    size_t push_percent_count;
+    bool distributions[2];          /* Indexed by enum Distribution. */
+    double zipf_theta;
+    size_t keys;
+    size_t capacity;
+    uint64_t duration_ns;
+    unsigned sample_shift;          /* One operation in 2^sample_shift is timed. */
+    const char *filter;
+    const char *json_path;
+    const char *record_path;
+    struct ITrace *trace;           /* Opened from --record; NULL when not recording. */
+};
+
+/* Zipfian generator after Gray et al., "Quickly Generating Billion-Record Synthetic Databases". */
+struct Zipf {
+    size_t n;
+    double theta;
+    double zeta_n;
+    double alpha;
+    double eta;
+    double half_pow_theta;
+};
+
+struct Workload {
+    const struct BenchTarget *target;
+    const struct Options *options;
+    struct IDictionary *dictionary;
+    struct IArray *array;
+    const char **keys;
+    const struct Zipf *zipf;        /* NULL for uniform keys. */
+    size_t percent;                 /* Reads (dictionaries) or pushes (arrays) out of 100. */
+    atomic_bool start;
+    atomic_bool stop;
+};
+
+struct Worker {
+    struct Workload *workload;
+    uint64_t seed;                  /* Written on every operation; the histogram keeps neighbours' seeds apart. */
+    uint64_t operations;
+    uint64_t histogram[HISTOGRAM_BUCKETS];
+};
+
+struct Run {
+    double ops_per_sec;
+    double fairness;                /* Jain's index over per-thread operation counts; 1 is perfectly fair. */
+    uint64_t min_thread_ops;
+    uint64_t max_thread_ops;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+};
+
+// Creates a striped dictionary with the default stripe count.
+static struct IDictionary *new_striped(void) {
+    return collection_dictionary_new_striped(0);
+}
+
+// Creates an unbounded linked-list Array.
+static struct IArray *new_array(const size_t capacity) {
+    (void) capacity;
+    return collection_array_new();
+}
+
+// Creates an unbounded Vector.
+static struct IArray *new_vector(const size_t capacity) {
+    (void) capacity;
+    return collection_array_new_vector();
+}
+
+// Creates an unbounded Deque.
+static struct IArray *new_deque(const size_t capacity) {
+    (void) capacity;
+    return collection_array_new_deque();
+}
+
+const struct BenchTarget bench_targets[] = {
+    {"dictionary", collection_dictionary_new, NULL},
+    {"dictionary.swiss", collection_dictionary_new_swiss, NULL},
+    {"dictionary.striped", new_striped, NULL},
+    {"dictionary.lockfree", collection_dictionary_new_lockfree, NULL},
+    {"array", NULL, new_array},
+    {"array.vector", NULL, new_vector},
+    {"array.deque", NULL, new_deque},
+    {"array.mpmc", NULL, collection_array_new_mpmc},
+    {"array.blocking", NULL, collection_array_new_blocking},
+};
+const size_t bench_target_count = sizeof(bench_targets) / sizeof(bench_targets[0]);
+
+// Returns the next xorshift64* value.
+static uint64_t next_random(uint64_t *state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Du;
+}
+
+// Returns a uniform double in [0, 1).
+static double next_unit(uint64_t *state) {
+    return (double) (next_random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Precomputes the constants of a Zipfian distribution over n ranks; O(n).
+static void zipf_init(struct Zipf *zipf, const size_t n, const double theta) {
+    double zeta_n = 0;
+    for (size_t i = 1; i <= n; i++) zeta_n += 1.0 / pow((double) i, theta);
+    const double zeta_2 = 1.0 + 1.0 / pow(2.0, theta);
+
+    zipf->n = n;
+    zipf->theta = theta;
+    zipf->zeta_n = zeta_n;
+    zipf->alpha = 1.0 / (1.0 - theta);
+    zipf->eta = (1.0 - pow(2.0 / (double) n, 1.0 - theta)) / (1.0 - zeta_2 / zeta_n);
+    zipf->half_pow_theta = pow(0.5, theta);
+}
+
+// Draws a rank in [0, n), rank 0 being the most popular; O(1).
+static size_t zipf_next(const struct Zipf *zipf, uint64_t *state) {
+    const double u = next_unit(state);
+    const double uz = u * zipf->zeta_n;
+    if (uz < 1.0) return 0;
+    if (uz < 1.0 + zipf->half_pow_theta) return 1;
+
+    const size_t rank = (size_t) ((double) zipf->n * pow(zipf->eta * u - zipf->eta + 1.0, zipf->alpha));
+    return rank < zipf->n ? rank : zipf->n - 1;
+}
+
+// Maps a latency to a log-linear histogram bucket with SUB_BUCKETS steps per power of two.
+static size_t bucket_of(const uint64_t ns) {
+    if (ns < 2 * SUB_BUCKETS) return (size_t) ns;
+
+    unsigned msb = 63;
+#if defined(__GNUC__) || defined(__clang__)
+    msb = 63u - (unsigned) __builtin_clzll(ns);
+#else
+    while ((ns >> msb) == 0) msb--;
+#endif
+    const size_t sub = (size_t) (ns >> (msb - 3)) & (SUB_BUCKETS - 1);
+    return 2 * SUB_BUCKETS + (msb - 4) * SUB_BUCKETS + sub;
+}
+
+// Returns the smallest latency that falls into a bucket.
+static uint64_t bucket_floor(const size_t bucket) {
+    if (bucket < 2 * SUB_BUCKETS) return bucket;
+
+    const size_t msb = (bucket - 2 * SUB_BUCKETS) / SUB_BUCKETS + 4;
+    const size_t sub = (bucket - 2 * SUB_BUCKETS) % SUB_BUCKETS;
+    return ((uint64_t) (SUB_BUCKETS + sub)) << (msb - 3);
+}
+
+// Returns the latency below which the given fraction of samples fall.
+static uint64_t percentile(const uint64_t *histogram, const uint64_t samples, const double fraction) {
+    const uint64_t rank = (uint64_t) ceil(fraction * (double) samples);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += histogram[i];
+        if (seen >= rank && seen > 0) return bucket_floor(i);
+    }
+    return 0;
+}
+
+// Picks the key index for the next operation.
+static size_t next_key(const struct Workload *workload, uint64_t *seed) {
+    if (workload->zipf) return zipf_next(workload->zipf, seed);
+    return (size_t) (next_random(seed) % workload->options->keys);
+}
+
+// Performs one dictionary operation: a get, or an upsert that updates an existing key.
+static void dictionary_operation(const struct Workload *workload, uint64_t *seed) {
+    struct IDictionary *dictionary = workload->dictionary;
+    const char *key = workload->keys[next_key(workload, seed)];
+
+    if (next_random(seed) % 100 < workload->percent) dictionary->get(dictionary, key);
+    else dictionary->upsert(dictionary, key, key);
+}
+
+// Performs one array operation: a push or a shift.
+static void array_operation(const struct Workload *workload, uint64_t *seed) {
+    struct IArray *array = workload->array;
+
+    if (next_random(seed) % 100 < workload->percent) array->push(array, workload);
+    else array->shift(array);
+}
+
+// Runs operations until stopped, timing one in 2^sample_shift of them.
+static ThreadResult worker_thread(void *arg) {
+    struct Worker *worker = arg;
+    const struct Workload *workload = worker->workload;
+    void (*operation)(const struct Workload *, uint64_t *) = workload->dictionary ? dictionary_operation : array_operation;
+    const uint64_t mask = (1u << workload->options->sample_shift) - 1;
+
+    while (!atomic_load_explicit(&workload->start, memory_order_acquire)) {}
+
+    uint64_t operations = 0;
+    while (!atomic_load_explicit(&workload->stop, memory_order_relaxed)) {
+        if ((operations & mask) == 0) {
+            const uint64_t begin = clock_monotonic_ns();
+            operation(workload, &worker->seed);
+            worker->histogram[bucket_of(clock_monotonic_ns() - begin)]++;
+        } else {
+            operation(workload, &worker->seed);
+        }
+        operations++;
+    }
+    worker->operations = operations;
+    return THREAD_RETURN;
+}
+
+// Creates a platform thread.
+static bool thread_create(Thread *thread, ThreadResult (*routine)(void *), void *arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+    return *thread != NULL;
+#else
+    return pthread_create(thread, NULL, routine, arg) == 0;
+#endif
+}
+
+// Waits for a platform thread to finish.
+static void thread_join(Thread thread) {
+#ifdef _WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+// Sleeps for roughly the given number of nanoseconds.
+static void sleep_ns(const uint64_t ns) {
+    Monitor monitor;
+    Condition condition;
+    monitor_init(&monitor);
+    condition_init(&condition);
+
+    const uint64_t deadline = clock_monotonic_ns() + ns;
+    monitor_lock(&monitor);
+    for (uint64_t now = clock_monotonic_ns(); now < deadline; now = clock_monotonic_ns()) {
+        condition_wait(&condition, &monitor, (long) ((deadline - now + 999999u) / 1000000u));
+    }
+    monitor_unlock(&monitor);
+
+    condition_destroy(&condition);
+    monitor_destroy(&monitor);
+}
+
+// Builds the collection under test and prefills it.
+static bool workload_prepare(struct Workload *workload) {
+    const struct Options *options = workload->options;
+
+    if (workload->target->dictionary) {
+        workload->dictionary = workload->target->dictionary();
+        if (workload->dictionary == NULL) return false;
+        if (options->trace) {
+            struct IDictionary *recording = collection_dictionary_new_recording(workload->dictionary, options->trace);
+            if (recording == NULL) return false;
+            workload->dictionary = recording;
+        }
+        for (size_t i = 0; i < options->keys; i++) {
+            if (!workload->dictionary->put(workload->dictionary, workload->keys[i], workload->keys[i])) return false;
+        }
+    } else {
+        workload->array = workload->target->array(options->capacity);
+        if (workload->array == NULL) return false;
+        if (options->trace) {
+            struct IArray *recording = collection_array_new_recording(workload->array, options->trace);
+            if (recording == NULL) return false;
+            workload->array = recording;
+        }
+        for (size_t i = 0; i < options->capacity / 2; i++) workload->array->push(workload->array, workload);
+    }
+    return true;
+}
+
+// Releases the collection under test.
+static void workload_release(struct Workload *workload) {
+    if (workload->dictionary) collection_dictionary_dealloc(&workload->dictionary, NULL);
+    if (workload->array) collection_array_dealloc(&workload->array, NULL);
+}
+
+// Runs one workload with the given number of threads.
+static bool run_workload(struct Workload *workload, const size_t thread_count, struct Worker *workers, struct Run *run) {
+    Thread threads[MAX_THREADS];
+    if (!workload_prepare(workload)) {
+        fprintf(stderr, "\033[0;31m[Collection::Bench::scaling] Error: Cannot build %s.\033[0m\n", workload->target->name);
+        workload_release(workload);
+        return false;
+    }
+
+    atomic_store(&workload->start, false);
+    atomic_store(&workload->stop, false);
+    size_t started = 0;
+    for (; started < thread_count; started++) {
+        memset(&workers[started], 0, sizeof(struct Worker));
+        workers[started].workload = workload;
+        workers[started].seed = 0x9E3779B97F4A7C15u * (started + 1);
+        if (!thread_create(&threads[started], worker_thread, &workers[started])) break;
+    }
+
+    const uint64_t begin = clock_monotonic_ns();
+    atomic_store_explicit(&workload->start, true, memory_order_release);
+    if (started == thread_count) sleep_ns(workload->options->duration_ns);
+    atomic_store_explicit(&workload->stop, true, memory_order_relaxed);
+    for (size_t i = 0; i < started; i++) thread_join(threads[i]);
+    const uint64_t elapsed = clock_monotonic_ns() - begin;
+
+    workload_release(workload);
+    if (started != thread_count) {
+        fprintf(stderr, "\033[0;31m[Collection::Bench::scaling] Error: Cannot start %zu threads.\033[0m\n", thread_count);
+        return false;
+    }
+
+    uint64_t histogram[HISTOGRAM_BUCKETS] = {0};
+    uint64_t total = 0, samples = 0;
+    double squares = 0;
+    run->min_thread_ops = UINT64_MAX;
+    run->max_thread_ops = 0;
+    for (size_t i = 0; i < thread_count; i++) {
+        const uint64_t operations = workers[i].operations;
+        total += operations;
+        squares += (double) operations * (double) operations;
+        if (operations < run->min_thread_ops) run->min_thread_ops = operations;
+        if (operations > run->max_thread_ops) run->max_thread_ops = operations;
+        for (size_t b = 0; b < HISTOGRAM_BUCKETS; b++) {
+            histogram[b] += workers[i].histogram[b];
+            samples += workers[i].histogram[b];
+        }
+    }
+
+    run->ops_per_sec = (double) total * 1e9 / (double) elapsed;
+    run->fairness = squares > 0 ? (double) total * (double) total / ((double) thread_count * squares) : 0;
+    run->p50_ns = percentile(histogram, samples, 0.50);
+    run->p99_ns = percentile(histogram, samples, 0.99);
+    run->p999_ns = percentile(histogram, samples, 0.999);
+    run->max_ns = 0;
+    for (size_t b = HISTOGRAM_BUCKETS; b > 0; b--) {
+        if (histogram[b - 1]) {
+            run->max_ns = bucket_floor(b - 1);
+            break;
+        }
+    }
+    return true;
+}
+
+// Parses a comma-separated list of numbers within [minimum, maximum]; false on malformed input.
+static bool parse_list(const char *text, size_t *values, size_t *count, const size_t minimum, const size_t maximum) {
+    *count = 0;
+    while (*text) {
+        char *end;
+        const unsigned long long value = strtoull(text, &end, 10);
+        if (end == text || value < minimum || value > maximum || *count == MAX_LIST || (*end != ',' && *end != '\0')) {
+            return false;
+        }
+        values[(*count)++] = (size_t) value;
+        text = *end == ',' ? end + 1 : end;
+    }
+    return *count > 0;
+}
+
+// Prints command-line usage.
+static void usage(const char *program) {
+    printf("Usage: %s scaling [options]\n"
+           "  --threads N,...          Thread counts (default 1,2,4,8,16,32,64)\n"
+           "  --read-percents P,...    Dictionary get share; the rest are upserts (default 100,95,50)\n"
+           "  --push-percents P,...    Array push share; the rest are shifts (default 50)\n"
+           "  --distribution NAME      uniform, zipf or both (default both)\n"
+           "  --zipf-theta T           Zipfian skew in (0, 1) (default 0.99)\n"
+           "  --keys N                 Dictionary key space (default 100000)\n"
+           "  --capacity N             Array capacity, half prefilled (default 65536)\n"
+           "  --duration MS            Length of each run (default 250)\n"
+           "  --sample N               Time one in 2^N operations (default 4)\n"
+           "  --filter TEXT            Only run targets whose name contains TEXT\n"
+           "  --json FILE              Also write results as JSON\n"
+           "  --record FILE            Also record every operation as a trace for \"replay\"\n",
+           program);
+}
+
+// Parses scaling options after the subcommand; returns false and prints usage on error.
+static bool parse_options(const int argc, char **argv, struct Options *options) {
+    *options = (struct Options) {
+        .threads = {1, 2, 4, 8, 16, 32, 64}, .thread_count = 7,
+        .read_percents = {100, 95, 50}, .read_percent_count = 3,
+        .push_percents = {50}, .push_percent_count = 1,
+        .distributions = {true, true}, .zipf_theta = 0.99,
+        .keys = 100000, .capacity = 65536, .duration_ns = 250000000u, .sample_shift = 4
+    };
+
+    for (int i = 2; i < argc; i += 2) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (value == NULL) goto invalid;
+
+        if (strcmp(arg, "--threads") == 0) {
+            if (!parse_list(value, options->threads, &options->thread_count, 1, MAX_THREADS)) goto invalid;
+        } else if (strcmp(arg, "--read-percents") == 0) {
+            if (!parse_list(value, options->read_percents, &options->read_percent_count, 0, 100)) goto invalid;
+        } else if (strcmp(arg, "--push-percents") == 0) {
+            if (!parse_list(value, options->push_percents, &options->push_percent_count, 0, 100)) goto invalid;
+        } else if (strcmp(arg, "--distribution") == 0) {
+            options->distributions[UNIFORM] = strcmp(value, "uniform") == 0 || strcmp(value, "both") == 0;
+            options->distributions[ZIPF] = strcmp(value, "zipf") == 0 || strcmp(value, "both") == 0;
+            if (!options->distributions[UNIFORM] && !options->distributions[ZIPF]) goto invalid;
+        } else if (strcmp(arg, "--zipf-theta") == 0) {
+            options->zipf_theta = strtod(value, NULL);
+            if (!(options->zipf_theta > 0 && options->zipf_theta < 1)) goto invalid;
+        } else if (strcmp(arg, "--keys") == 0) {
+            options->keys = strtoull(value, NULL, 10);
+            if (options->keys < 2) goto invalid;
+        } else if (strcmp(arg, "--capacity") == 0) {
+            options->capacity = strtoull(value, NULL, 10);
+            if (options->capacity < 2) goto invalid;
+        } else if (strcmp(arg, "--duration") == 0) {
+            options->duration_ns = strtoull(value, NULL, 10) * 1000000u;
+        } else if (strcmp(arg, "--sample") == 0) {
+            options->sample_shift = (unsigned) strtoul(value, NULL, 10);
+            if (options->sample_shift > 20) goto invalid;
+        } else if (strcmp(arg, "--filter") == 0) {
+            options->filter = value;
+        } else if (strcmp(arg, "--json") == 0) {
+            options->json_path = value;
+        } else if (strcmp(arg, "--record") == 0) {
+            options->record_path = value;
+        } else {
+            goto invalid;
+        }
+    }
+    return true;
+
+invalid:
+    usage(argv[0]);
+    return false;
+}
+
+// Formats key i, zero-padded so every key has the same length.
+static char *keys_create(const size_t count, const char ***keys) {
+    char *storage = malloc(count * KEY_LENGTH);
+    *keys = malloc(count * sizeof(char *));
+    if (storage == NULL || *keys == NULL) {
+        free(storage);
+        free((void *) *keys);
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        snprintf(storage + i * KEY_LENGTH, KEY_LENGTH, "key:%019zu", i);
+        (*keys)[i] = storage + i * KEY_LENGTH;
+    }
+    return storage;
+}
+
+// Runs the thread sweep for one target, mix and distribution.
+static bool sweep(const struct BenchTarget *target, const struct Options *options, const char **keys, const struct Zipf *zipf,
+                  const size_t percent, struct Worker *workers, FILE *json, bool *first) {
+    struct Workload workload = {.target = target, .options = options, .keys = keys, .zipf = zipf, .percent = percent};
+    const char *distribution = target->dictionary ? (zipf ? "zipf" : "uniform") : "-";
+    char mix[32];
+    if (target->dictionary) snprintf(mix, sizeof(mix), "%zu/%zu get/upsert", percent, 100 - percent);
+    else snprintf(mix, sizeof(mix), "%zu/%zu push/shift", percent, 100 - percent);
+
+    double reference = 0;
+    for (size_t t = 0; t < options->thread_count; t++) {
+        struct Run run;
+        if (!run_workload(&workload, options->threads[t], workers, &run)) return false;
+        if (t == 0) reference = run.ops_per_sec / (double) options->threads[0];
+
+        const double speedup = reference > 0 ? run.ops_per_sec / reference : 0;
+        printf("%-20s %-22s %-8s %7zu %14.0f %8.2f %8.3f %10llu %10llu %8llu %8llu %8llu %10llu\n", target->name, mix,
+               distribution, options->threads[t], run.ops_per_sec, speedup, run.fairness,
+               (unsigned long long) run.min_thread_ops, (unsigned long long) run.max_thread_ops,
+               (unsigned long long) run.p50_ns, (unsigned long long) run.p99_ns, (unsigned long long) run.p999_ns,
+               (unsigned long long) run.max_ns);
+        fflush(stdout);
+
+        if (json) {
+            fprintf(json, "%s    {\"target\": \"%s\", \"mix\": \"%s\", \"distribution\": \"%s\", \"threads\": %zu, "
+                          "\"ops_per_sec\": %.1f, \"speedup\": %.3f, \"fairness\": %.4f, \"min_thread_ops\": %llu, "
+                          "\"max_thread_ops\": %llu, \"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu}",
+                    *first ? "" : ",\n", target->name, mix, distribution, options->threads[t], run.ops_per_sec, speedup,
+                    run.fairness, (unsigned long long) run.min_thread_ops, (unsigned long long) run.max_thread_ops,
+                    (unsigned long long) run.p50_ns, (unsigned long long) run.p99_ns, (unsigned long long) run.p999_ns,
+                    (unsigned long long) run.max_ns);
+            *first = false;
+        }
+    }
+    return true;
+}
+
+// Sweeps every selected target over thread counts, mixes and distributions.
+int bench_scaling_main(const int argc, char **argv) {
+    struct Options options;
+    if (!parse_options(argc, argv, &options)) return EXIT_FAILURE;
+
+    size_t max_threads = 0;
+    for (size_t i = 0; i < options.thread_count; i++) {
+        if (options.threads[i] > max_threads) max_threads = options.threads[i];
+    }
+
+    const char **keys = NULL;
+    char *storage = keys_create(options.keys, &keys);
+    struct Worker *workers = calloc(max_threads, sizeof(struct Worker));
+    FILE *json = options.json_path ? fopen(options.json_path, "w") : NULL;
+    options.trace = options.record_path ? collection_trace_new(options.record_path) : NULL;
+    bool ok = storage != NULL && workers != NULL && (options.json_path == NULL || json != NULL)
+              && (options.record_path == NULL || options.trace != NULL);
+    if (!ok) fprintf(stderr, "\033[0;31m[Collection::Bench::scaling] Error: Setup failed.\033[0m\n");
+
+    struct Zipf zipf;
+    if (ok && options.distributions[ZIPF]) zipf_init(&zipf, options.keys, options.zipf_theta);
+
+    if (json) {
+        fprintf(json, "{\n  \"context\": {\"duration_ms\": %llu, \"keys\": %zu, \"capacity\": %zu, \"zipf_theta\": %.3f, "
+                      "\"sample_shift\": %u},\n  \"runs\": [\n",
+                (unsigned long long) (options.duration_ns / 1000000u), options.keys, options.capacity,
+                options.zipf_theta, options.sample_shift);
+    }
+    if (ok) {
+        printf("%-20s %-22s %-8s %7s %14s %8s %8s %10s %10s %8s %8s %8s %10s\n", "target", "mix", "keys", "threads",
+               "ops/sec", "speedup", "fairness", "min ops", "max ops", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+    }
+
+    bool first = true;
+    for (size_t t = 0; ok && t < bench_target_count; t++) {
+        const struct BenchTarget *target = &bench_targets[t];
+        if (options.filter && strstr(target->name, options.filter) == NULL) continue;
+
+        if (target->dictionary) {
+            for (size_t m = 0; ok && m < options.read_percent_count; m++) {
+                for (int d = UNIFORM; ok && d <= ZIPF; d++) {
+                    if (!options.distributions[d]) continue;
+                    ok = sweep(target, &options, keys, d == ZIPF ? &zipf : NULL, options.read_percents[m], workers, json,
+                               &first);
+                }
+            }
+        } else {
+            for (size_t m = 0; ok && m < options.push_percent_count; m++) {
+                ok = sweep(target, &options, keys, NULL, options.push_percents[m], workers, json, &first);
+            }
+        }
+    }
+
+    if (json) {
+        fprintf(json, "\n  ]\n}\n");
+        if (fclose(json) != 0) ok = false;
+    }
+    if (ok && lock_profile_enabled()) lock_profile_print(10);
+    if (options.trace && !options.trace->flush(options.trace)) ok = false;
+    collection_trace_dealloc(&options.trace);
+    free(workers);
+    free((void *) keys);
+    free(storage);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
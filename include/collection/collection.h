@@ -20,5 +20,10 @@
 #pragma once
 
 #include "i_array.h"
+#include "i_cache.h"
 #include "i_dictionary.h"
+#include "i_int_dictionary.h"
+#include "i_key_dictionary.h"
+#include "i_intern_pool.h"
 #include "i_platform.h"
+#include "i_trace.h"
@@ -168,6 +168,17 @@ struct IArray {
      * @param destructor Optional destructor called on each item before removal. Can be NULL.
      */
     void (*clear)(struct IArray *self, void (*destructor)(void *item));
+
+    /**
+     * @brief Releases the array and all of its internal resources.
+     *
+     * Invoked by collection_array_dealloc(), which should be used instead of
+     * calling this entry directly.
+     *
+     * @param self Pointer to the array instance.
+     * @param destructor Optional destructor called on each item before removal. Can be NULL.
+     */
+    void (*dealloc)(struct IArray *self, void (*destructor)(void *item));
 };
 
 /**
@@ -177,11 +188,174 @@ struct IArray {
  */
 struct IArray *collection_array_new(void);
 
+/**
+ * @brief Creates a new array instance backed by a contiguous, geometrically growing buffer.
+ *
+ * Provides O(1) indexed get() and put(), amortized O(1) push() and pop(), and
+ * cache-friendly iteration. Inserting or removing at the front is O(n).
+ *
+ * @return A newly allocated array, or NULL if allocation fails.
+ */
+struct IArray *collection_array_new_vector(void);
+
+/**
+ * @brief Ensures a vector array can hold at least the given number of elements without reallocating.
+ *
+ * @param array Array created by collection_array_new_vector().
+ * @param capacity Minimum number of elements to reserve space for.
+ *
+ * @return true if the capacity is available; false if allocation fails or the array is not a vector.
+ */
+bool collection_array_vector_reserve(struct IArray *array, size_t capacity);
+
+/**
+ * @brief Releases unused capacity of a vector array.
+ *
+ * @param array Array created by collection_array_new_vector().
+ *
+ * @return true on success; false if reallocation fails, in which case the array is unchanged, or the array is not a vector.
+ */
+bool collection_array_vector_shrink_to_fit(struct IArray *array);
+
+/**
+ * @brief Creates a new array instance backed by a circular buffer.
+ *
+ * push(), pop(), shift(), unshift(), get(), put() and count() are O(1). The
+ * buffer doubles when full and is never shrunk, so a queue or stack in steady
+ * state performs no allocations.
+ *
+ * @return A newly allocated array, or NULL if allocation fails.
+ */
+struct IArray *collection_array_new_deque(void);
+
+/**
+ * @brief Creates a new lock-free, bounded multi-producer/multi-consumer queue.
+ *
+ * push() appends to the tail and fails when the queue is full; shift() removes
+ * from the head and returns NULL when it is empty. Neither blocks nor takes a
+ * lock, and count() is a snapshot. Operations that do not apply to a queue
+ * (get, put, for_each, find, first_index, last_index, unshift, contains_value,
+ * pop, remove_item, clone) fail by returning NULL, false or SIZE_MAX. clear()
+ * drains the elements present when it is called. Avoid storing NULL items,
+ * which shift() cannot distinguish from an empty queue.
+ *
+ * @param capacity Maximum number of elements, rounded up to a power of two.
+ *
+ * @return A newly allocated array, or NULL if allocation fails.
+ */
+struct IArray *collection_array_new_mpmc(size_t capacity);
+
+/**
+ * @brief Creates a new wait-free, bounded single-producer/single-consumer queue.
+ *
+ * Exactly one thread may call push() and collection_array_spsc_push_n(), and
+ * exactly one (possibly different) thread may call shift(), clear() and
+ * collection_array_spsc_shift_n(). Under that contract every operation
+ * completes in a bounded number of steps without locks or atomic
+ * read-modify-write instructions. Unsupported operations behave as for
+ * collection_array_new_mpmc().
+ *
+ * @param capacity Maximum number of elements, rounded up to a power of two.
+ *
+ * @return A newly allocated array, or NULL if allocation fails.
+ */
+struct IArray *collection_array_new_spsc(size_t capacity);
+
+/**
+ * @brief Appends as many of the given elements as fit to an SPSC queue.
+ *
+ * The elements become visible to the consumer together. Producer thread only.
+ *
+ * @param array Array created by collection_array_new_spsc().
+ * @param items Elements to append, in order.
+ * @param n Number of elements in items.
+ *
+ * @return The number of elements appended, from 0 (full, or not an SPSC queue) to n.
+ */
+size_t collection_array_spsc_push_n(struct IArray *array, const void *const *items, size_t n);
+
+/**
+ * @brief Removes up to n elements from the head of an SPSC queue.
+ *
+ * Consumer thread only.
+ *
+ * @param array Array created by collection_array_new_spsc().
+ * @param items Receives the removed elements, in order.
+ * @param n Capacity of items.
+ *
+ * @return The number of elements removed, from 0 (empty, or not an SPSC queue) to n.
+ */
+size_t collection_array_spsc_shift_n(struct IArray *array, const void **items, size_t n);
+
+/**
+ * @brief Creates a new Chase-Lev work-stealing deque for task schedulers.
+ *
+ * One owner thread calls push() and pop() on the bottom, both lock-free and
+ * LIFO; clear() is also owner-only. Any thread may call shift() to steal the
+ * oldest element from the top with a CAS, retrying lost races until it wins
+ * or the deque is empty. The ring doubles when full without stopping thieves.
+ * pop() and shift() return NULL when the deque is empty, or in pop()'s case
+ * when a thief took the last element. Unsupported operations behave as for
+ * collection_array_new_mpmc().
+ *
+ * @return A newly allocated array, or NULL if allocation fails.
+ */
+struct IArray *collection_array_new_work_stealing(void);
+
+/**
+ * @brief Creates a new bounded queue whose consumers and producers can block.
+ *
+ * Supports every IArray operation under a single lock. push() and unshift()
+ * fail instead of exceeding the capacity, and shift() and pop() return NULL
+ * when the queue is empty; use collection_array_blocking_push_wait() and
+ * collection_array_blocking_shift_wait() to wait instead. Every removal wakes
+ * a waiting producer, and clear() wakes them all.
+ *
+ * @param capacity Maximum number of elements (at least 1).
+ *
+ * @return A newly allocated array, or NULL if allocation fails.
+ */
+struct IArray *collection_array_new_blocking(size_t capacity);
+
+/**
+ * @brief Appends an element to a blocking queue, waiting for space if it is full.
+ *
+ * @param array Array created by collection_array_new_blocking().
+ * @param item Element to append.
+ * @param timeout_ms Maximum time to wait in milliseconds; 0 does not wait and a negative value waits indefinitely.
+ *
+ * @return true if the element was appended; false if the timeout elapsed first or the array is not a blocking queue.
+ */
+bool collection_array_blocking_push_wait(struct IArray *array, const void *item, long timeout_ms);
+
+/**
+ * @brief Removes the first element of a blocking queue, waiting for one if it is empty.
+ *
+ * @param array Array created by collection_array_new_blocking().
+ * @param timeout_ms Maximum time to wait in milliseconds; 0 does not wait and a negative value waits indefinitely.
+ *
+ * @return The removed element, or NULL if the timeout elapsed first or the array is not a blocking queue.
+ */
+const void *collection_array_blocking_shift_wait(struct IArray *array, long timeout_ms);
+
+/**
+ * @brief Returns a file descriptor that is readable exactly while a blocking queue is non-empty.
+ *
+ * Linux only. The eventfd is created on the first call and closed by
+ * collection_array_dealloc(). Register it for EPOLLIN in an event loop and
+ * call shift() until it returns NULL; do not read from the descriptor.
+ *
+ * @param array Array created by collection_array_new_blocking().
+ *
+ * @return The descriptor, or -1 if it could not be created, the array is not a blocking queue, or the platform has no eventfd.
+ */
+int collection_array_blocking_eventfd(struct IArray *array);
+
 /**
  * @brief Destroys an array instance.
  *
  * Releases all internal resources and optionally destroys each stored
- * element using the supplied destructor.
+ * element using the supplied destructor. Works for every array flavor.
  *
  * @param array Pointer to the array pointer. On successful return, *array is set to NULL.
  * @param destructor destructor Optional callback invoked for each stored element before removal. May be NULL.
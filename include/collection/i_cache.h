@@ -0,0 +1,186 @@
+/**
+ * @file i_cache.h
+ * @ingroup Collection
+ * @brief Cache Interface
+ *
+ * Defines the ICache interface for bounded key-value caches. A cache holds at
+ * most a configured number of entries or bytes, optionally expires entries
+ * after a time-to-live, and evicts entries it has not seen used recently
+ * when it runs out of room.
+ *
+ * Implementations of this interface are expected to provide thread-safe
+ * operations.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Limits and callbacks of a cache. Zeroed members keep the default.
+ */
+struct CollectionCacheOptions {
+    size_t capacity;            /**< Maximum number of entries; 0 for no entry limit. */
+    size_t max_bytes;           /**< Maximum total of size_of() over all values; 0 for no byte limit. */
+
+    /**
+     * @brief Returns the number of bytes a value is charged against max_bytes.
+     *
+     * Default: every value is charged 0 bytes.
+     *
+     * @param value Value being stored.
+     *
+     * @return The size of the value in bytes.
+     */
+    size_t (*size_of)(const void *value);
+
+    uint64_t ttl_ns;            /**< Lifetime of entries stored with put(), in nanoseconds; 0 to never expire. */
+
+    /**
+     * @brief Receives every value the cache drops on its own.
+     *
+     * Called for values evicted to make room, entries found expired, and
+     * values replaced by put() with a different value. It runs with the cache
+     * locked, so it must not access the cache. Values returned by
+     * remove_item() or passed to the destructor of clear() are not reported.
+     *
+     * @param key Key of the dropped entry.
+     * @param value Dropped value.
+     * @param context The context member of these options.
+     */
+    void (*on_evict)(const char *key, void *value, void *context);
+
+    void *context;              /**< Opaque pointer passed to on_evict. */
+};
+
+/**
+ * @brief Interface for a thread-safe, bounded cache.
+ */
+struct ICache {
+    /**
+     * @brief Returns the value associated with the specified key and marks the entry as recently used.
+     *
+     * @param self Pointer to the cache instance.
+     * @param key Null-terminated key string.
+     *
+     * @return Pointer to the associated value, or NULL if the key is absent or expired.
+     */
+    void *(*get)(struct ICache *self, const char *key);
+
+    /**
+     * @brief Inserts or updates a key-value pair with the default time-to-live, evicting entries if needed.
+     *
+     * @param self Pointer to the cache instance.
+     * @param key Null-terminated key string.
+     * @param value Pointer to the value to associate with the key.
+     *
+     * @return true if the pair was stored; false if the value alone exceeds max_bytes or allocation fails.
+     */
+    bool (*put)(struct ICache *self, const char *key, const void *value);
+
+    /**
+     * @brief Inserts or updates a key-value pair that expires after ttl_ns nanoseconds.
+     *
+     * @param self Pointer to the cache instance.
+     * @param key Null-terminated key string.
+     * @param value Pointer to the value to associate with the key.
+     * @param ttl_ns Lifetime of the entry in nanoseconds; 0 to never expire.
+     *
+     * @return true if the pair was stored; false if the value alone exceeds max_bytes or allocation fails.
+     */
+    bool (*put_with_ttl)(struct ICache *self, const char *key, const void *value, uint64_t ttl_ns);
+
+    /**
+     * @brief Determines whether an unexpired entry exists, without marking it as used.
+     *
+     * @param self Pointer to the cache instance.
+     * @param key Null-terminated key string.
+     *
+     * @return true if the key exists and has not expired; otherwise false.
+     */
+    bool (*contains_key)(const struct ICache *self, const char *key);
+
+    /**
+     * @brief Removes the specified entry.
+     *
+     * @param self Pointer to the cache instance.
+     * @param key Null-terminated key string.
+     *
+     * @return Pointer to the removed value, or NULL if the key was absent or expired.
+     */
+    void *(*remove_item)(struct ICache *self, const char *key);
+
+    /**
+     * @brief Evicts every expired entry.
+     *
+     * Expired entries are otherwise reclaimed lazily when eviction or a write reaches them.
+     *
+     * @param self Pointer to the cache instance.
+     *
+     * @return Number of entries evicted.
+     */
+    size_t (*purge_expired)(struct ICache *self);
+
+    /**
+     * @brief Returns the number of entries, including expired ones not yet reclaimed.
+     *
+     * @param self Pointer to the cache instance.
+     *
+     * @return The number of entries.
+     */
+    size_t (*count)(const struct ICache *self);
+
+    /**
+     * @brief Returns the total size charged against max_bytes.
+     *
+     * @param self Pointer to the cache instance.
+     *
+     * @return The number of bytes.
+     */
+    size_t (*bytes)(const struct ICache *self);
+
+    /**
+     * @brief Removes all entries.
+     *
+     * @param self Pointer to the cache instance.
+     * @param destructor Optional function to release each value; on_evict is not called.
+     */
+    void (*clear)(struct ICache *self, void (*destructor)(void *value));
+
+    /**
+     * @brief Releases the cache.
+     *
+     * Invoked by collection_cache_dealloc(), which should be used instead of
+     * calling this member directly.
+     *
+     * @param self Pointer to the cache instance.
+     * @param destructor Optional function to release each value.
+     */
+    void (*dealloc)(struct ICache *self, void (*destructor)(void *value));
+};
+
+/**
+ * @brief Creates a cache with CLOCK (second-chance) approximate LRU eviction.
+ *
+ * Hits take a shared lock and set the entry's reference bit, so concurrent
+ * readers do not serialize. Writers take an exclusive lock; when the cache is
+ * over a limit, a clock hand sweeps the entries in insertion order, clearing
+ * reference bits and evicting the first expired or unreferenced entry.
+ *
+ * @param options Limits and callbacks, copied by the cache; NULL for an unbounded cache without expiry.
+ *
+ * @return Pointer to the new cache, or NULL on failure.
+ */
+struct ICache *collection_cache_new(const struct CollectionCacheOptions *options);
+
+/**
+ * @brief Deallocates a cache and sets the caller's pointer to NULL.
+ *
+ * @param cache Pointer to the caller's cache pointer.
+ * @param destructor Optional function to release each value.
+ */
+void collection_cache_dealloc(struct ICache **cache, void (*destructor)(void *value));
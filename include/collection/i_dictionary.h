@@ -17,6 +17,44 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+
+struct IInternPool;
+
+/**
+ * @brief A key bundled with its length and collection_hash() value.
+ *
+ * Build one with collection_key() and reuse it for hot keys: the *_hashed
+ * operations of every IDictionary skip hashing the key bytes. The handle
+ * borrows the key string, which must outlive it.
+ */
+struct CollectionKey {
+    const char *key;    /**< Null-terminated key string. */
+    size_t length;      /**< Key length in bytes, excluding the terminator. */
+    uint64_t hash;      /**< collection_hash() of the key bytes. */
+};
+
+/**
+ * @brief Hashes a byte string with the process-wide seed shared by all dictionaries.
+ *
+ * The result is stable for the lifetime of the process and differs between
+ * processes, so it must not be persisted.
+ *
+ * @param key Bytes to hash. May be NULL when length is 0.
+ * @param length Number of bytes.
+ *
+ * @return The hash value.
+ */
+uint64_t collection_hash(const void *key, size_t length);
+
+/**
+ * @brief Creates a handle for a null-terminated key.
+ *
+ * @param key Null-terminated key string; borrowed by the handle.
+ *
+ * @return The handle.
+ */
+struct CollectionKey collection_key(const char *key);
 
 /**
  * @brief Interface for a generic, thread-safe dictionary.
@@ -74,6 +112,139 @@ struct IDictionary {
      */
     void *(*replace)(const struct IDictionary *self, const char *key, const void *value);
 
+    /**
+     * @brief Inserts a key-value pair only if the key is absent.
+     *
+     * The check and the insert happen atomically, with a single lookup.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Null-terminated key string.
+     * @param value Pointer to the value to associate with the key.
+     *
+     * @return true if the pair was inserted; false if the key exists or allocation fails.
+     */
+    bool (*put_if_absent)(struct IDictionary *self, const char *key, const void *value);
+
+    /**
+     * @brief Updates the value of an existing key, or inserts the pair if the key is absent.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Null-terminated key string.
+     * @param value Pointer to the value to associate with the key.
+     *
+     * @return Pointer to the previous value, or NULL if the key was absent.
+     */
+    void *(*upsert)(struct IDictionary *self, const char *key, const void *value);
+
+    /**
+     * @brief Returns the value of a key, inserting a value created by factory if the key is absent.
+     *
+     * Lock-based dictionaries call factory with the dictionary locked, so it runs
+     * at most once per inserted key and must not access the dictionary. The
+     * lock-free dictionary calls it without a lock; if another thread inserts
+     * the key first, that thread's value is returned and the created value is
+     * left to the factory's owner.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Null-terminated key string.
+     * @param factory Callback returning the value to insert; returning NULL inserts nothing.
+     * @param context Opaque pointer passed to factory.
+     *
+     * @return Pointer to the existing or inserted value, or NULL if nothing was inserted.
+     */
+    void *(*get_or_insert_with)(struct IDictionary *self, const char *key,
+                                void *(*factory)(const char *key, void *context), void *context);
+
+    /**
+     * @brief Atomically recomputes the value of a key.
+     *
+     * function receives the current value in *value (NULL if the key is absent)
+     * and may change it. Returning true stores *value, inserting the key if
+     * needed; returning false removes the key. Lock-based dictionaries call
+     * function with the dictionary locked, so it must not access the
+     * dictionary. The lock-free dictionary may call it more than once when
+     * racing with other writers, and only the last result takes effect.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Null-terminated key string.
+     * @param function Callback computing the new value.
+     * @param context Opaque pointer passed to function.
+     *
+     * @return Pointer to the stored value afterwards, or NULL if the key is absent.
+     */
+    void *(*compute)(struct IDictionary *self, const char *key,
+                     bool (*function)(const char *key, void **value, void *context), void *context);
+
+    /**
+     * @brief Looks up a batch of keys.
+     *
+     * All keys are hashed up front and resolved under one lock acquisition,
+     * with upcoming buckets prefetched so their cache misses overlap.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param keys Null-terminated key strings.
+     * @param count Number of keys.
+     * @param values Receives the value of keys[i] in values[i], or NULL if absent.
+     *
+     * @return Number of keys found; 0 with every value NULL if allocation fails.
+     */
+    size_t (*get_many)(const struct IDictionary *self, const char *const *keys, size_t count, void **values);
+
+    /**
+     * @brief Stores a batch of key-value pairs with the semantics of put.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param keys Null-terminated key strings.
+     * @param values Value to associate with each key.
+     * @param count Number of pairs.
+     *
+     * @return Number of pairs stored.
+     */
+    size_t (*put_many)(struct IDictionary *self, const char *const *keys, const void *const *values, size_t count);
+
+    /**
+     * @brief Removes a batch of keys.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param keys Null-terminated key strings.
+     * @param count Number of keys.
+     * @param values Optional; receives the removed value of keys[i] in values[i], or NULL if absent.
+     *
+     * @return Number of keys removed.
+     */
+    size_t (*remove_many)(struct IDictionary *self, const char *const *keys, size_t count, void **values);
+
+    /**
+     * @brief Returns the value associated with a pre-hashed key.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Handle created by collection_key().
+     *
+     * @return Pointer to the associated value, or NULL if the key is not found.
+     */
+    void *(*get_hashed)(const struct IDictionary *self, const struct CollectionKey *key);
+
+    /**
+     * @brief Stores a pre-hashed key with the semantics of put.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Handle created by collection_key().
+     * @param value Pointer to the value to associate with the key.
+     *
+     * @return true if the operation succeeds; otherwise false.
+     */
+    bool (*put_hashed)(struct IDictionary *self, const struct CollectionKey *key, const void *value);
+
+    /**
+     * @brief Determines whether a pre-hashed key exists.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Handle created by collection_key().
+     *
+     * @return true if the key exists; otherwise false.
+     */
+    bool (*contains_key_hashed)(const struct IDictionary *self, const struct CollectionKey *key);
+
     /**
      * @brief Removes all key-value pairs from the dictionary.
      *
@@ -83,6 +254,17 @@ struct IDictionary {
      * @return true if the dictionary was cleared successfully; otherwise false.
      */
     bool (*clear)(const struct IDictionary *self, void (*destructor)(void *value));
+
+    /**
+     * @brief Releases the dictionary and all of its internal resources.
+     *
+     * Invoked by collection_dictionary_dealloc(), which should be used instead of
+     * calling this entry directly.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param destructor Optional callback invoked for each stored value before destruction. May be NULL.
+     */
+    void (*dealloc)(struct IDictionary *self, void (*destructor)(void *value));
 };
 
 /**
@@ -92,11 +274,90 @@ struct IDictionary {
  */
 struct IDictionary *collection_dictionary_new(void);
 
+/**
+ * @brief Creates a new dictionary instance pre-sized for an expected number of entries.
+ *
+ * The dictionary still grows beyond the hint as needed, but never shrinks below it,
+ * which lets bulk loaders avoid intermediate resizes.
+ *
+ * @param capacity Expected number of entries.
+ *
+ * @return A newly allocated dictionary, or NULL if allocation fails.
+ */
+struct IDictionary *collection_dictionary_new_with_capacity(size_t capacity);
+
+/**
+ * @brief Creates a new dictionary instance that borrows its keys.
+ *
+ * put() stores the caller's key pointer instead of copying the string, which
+ * suits string literals and keys owned by a long-lived string table. The
+ * caller must keep each key alive and unchanged until it is removed or the
+ * dictionary is destroyed.
+ *
+ * @return A newly allocated dictionary, or NULL if allocation fails.
+ */
+struct IDictionary *collection_dictionary_new_borrowed(void);
+
+/**
+ * @brief Creates a new dictionary instance whose keys are interned in a shared pool.
+ *
+ * put() stores the pool's canonical copy of each key, so dictionaries sharing
+ * a pool hold one copy of every distinct key. Lookups with a pointer returned
+ * by the pool match by address before any bytes are compared. The pool must
+ * outlive the dictionary.
+ *
+ * @param pool Intern pool that owns the keys.
+ *
+ * @return A newly allocated dictionary, or NULL if pool is NULL or allocation fails.
+ */
+struct IDictionary *collection_dictionary_new_interned(struct IInternPool *pool);
+
+/**
+ * @brief Creates a new open-addressing ("Swiss table") dictionary instance.
+ *
+ * Entries live in a flat slot array indexed through a control array of one-byte
+ * hash tags, which is scanned 16 slots at a time (SSE2 where available), so most
+ * lookups are resolved within a single cache line. Unlike the chained dictionary,
+ * put() on an existing key updates its value instead of adding a duplicate.
+ *
+ * @return A newly allocated dictionary, or NULL if allocation fails.
+ */
+struct IDictionary *collection_dictionary_new_swiss(void);
+
+/**
+ * @brief Creates a new lock-striped dictionary instance for write-heavy concurrent use.
+ *
+ * Keys are spread over independently locked stripes by the high bits of their
+ * hash, so writers to different stripes proceed in parallel and readers only
+ * wait for writers in their own stripe. Each stripe behaves like the chained
+ * dictionary, including duplicate handling. clear() locks every stripe.
+ *
+ * @param stripes Number of stripes, rounded up to a power of two (at most 4096); 0 selects 16.
+ *
+ * @return A newly allocated dictionary, or NULL if allocation fails.
+ */
+struct IDictionary *collection_dictionary_new_striped(size_t stripes);
+
+/**
+ * @brief Creates a new lock-free dictionary instance for read-dominated concurrent use.
+ *
+ * Every operation is lock-free: get() and contains_key() take no locks,
+ * though readers may help unlink removed nodes and lazily create bucket
+ * sentinels; put(), remove_item() and replace() use CAS and never block. Like the Swiss table, put() on an existing key updates its
+ * value. Removed entries are freed only once no concurrent reader can still
+ * reach them, using epoch-based reclamation. clear() removes every entry it
+ * visits; entries inserted concurrently may survive it. collection_dictionary_dealloc()
+ * requires that no other thread is using the dictionary.
+ *
+ * @return A newly allocated dictionary, or NULL if allocation fails.
+ */
+struct IDictionary *collection_dictionary_new_lockfree(void);
+
 /**
  * @brief Destroys a dictionary instance.
  *
  * Releases all internal resources and optionally destroys each stored
- * value using the supplied destructor.
+ * value using the supplied destructor. Works for every dictionary flavor.
  *
  * @param dictionary Pointer to the dictionary pointer. On successful return, *dictionary is set to NULL.
  * @param destructor Optional callback invoked for each stored value before destruction. May be NULL.
@@ -0,0 +1,138 @@
+/**
+ * @file i_int_dictionary.h
+ * @ingroup Collection
+ * @brief Integer-Keyed Dictionary Interface
+ *
+ * Defines the IIntDictionary interface for key-value containers keyed by
+ * 64-bit integers or pointers. It mirrors IDictionary without the cost of
+ * formatting, copying, and comparing string keys.
+ *
+ * Implementations of this interface are expected to provide thread-safe
+ * operations.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Converts a pointer into an IIntDictionary key.
+ *
+ * @param pointer Pointer to use as a key; only its address is used.
+ *
+ * @return The key.
+ */
+static inline uint64_t collection_pointer_key(const void *pointer) {
+    return (uint64_t) (uintptr_t) pointer;
+}
+
+/**
+ * @brief Interface for a thread-safe dictionary with integer keys.
+ */
+struct IIntDictionary {
+    /**
+     * @brief Returns the value associated with the specified key.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Integer key.
+     *
+     * @return Pointer to the associated value, or NULL if the key is not found.
+     */
+    void *(*get)(const struct IIntDictionary *self, uint64_t key);
+
+    /**
+     * @brief Inserts a key-value pair, or updates the value if the key exists.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Integer key.
+     * @param value Pointer to the value to associate with the key.
+     *
+     * @return true if the operation succeeds; otherwise false.
+     */
+    bool (*put)(struct IIntDictionary *self, uint64_t key, const void *value);
+
+    /**
+     * @brief Determines whether the specified key exists.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Integer key.
+     *
+     * @return true if the key exists; otherwise false.
+     */
+    bool (*contains_key)(const struct IIntDictionary *self, uint64_t key);
+
+    /**
+     * @brief Removes the specified key-value pair.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Integer key.
+     *
+     * @return Pointer to the removed value, or NULL if the key is not found.
+     */
+    void *(*remove_item)(struct IIntDictionary *self, uint64_t key);
+
+    /**
+     * @brief Replaces the value associated with the specified key.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Integer key.
+     * @param value Replacement value.
+     *
+     * @return Pointer to the previous value, or NULL if the key is not found.
+     */
+    void *(*replace)(const struct IIntDictionary *self, uint64_t key, const void *value);
+
+    /**
+     * @brief Removes all key-value pairs from the dictionary.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param destructor Optional callback invoked for each value before removal. May be NULL.
+     *
+     * @return true if the dictionary was cleared successfully; otherwise false.
+     */
+    bool (*clear)(const struct IIntDictionary *self, void (*destructor)(void *value));
+
+    /**
+     * @brief Releases the dictionary and all of its internal resources.
+     *
+     * Invoked by collection_int_dictionary_dealloc(), which should be used instead of
+     * calling this entry directly.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param destructor Optional callback invoked for each stored value before destruction. May be NULL.
+     */
+    void (*dealloc)(struct IIntDictionary *self, void (*destructor)(void *value));
+};
+
+/**
+ * @brief Creates a new integer-keyed dictionary instance.
+ *
+ * Keys and values are stored inline in one flat, linearly probed slot array
+ * of 16-byte slots, so a lookup usually touches a single cache line and
+ * allocates nothing. Removal shifts later entries back instead of leaving
+ * tombstones.
+ *
+ * @return A newly allocated dictionary, or NULL if allocation fails.
+ */
+struct IIntDictionary *collection_int_dictionary_new(void);
+
+/**
+ * @brief Creates a new integer-keyed dictionary instance pre-sized for an expected number of entries.
+ *
+ * @param capacity Expected number of entries.
+ *
+ * @return A newly allocated dictionary, or NULL if allocation fails.
+ */
+struct IIntDictionary *collection_int_dictionary_new_with_capacity(size_t capacity);
+
+/**
+ * @brief Destroys an integer-keyed dictionary instance.
+ *
+ * @param dictionary Pointer to the dictionary pointer. On successful return, *dictionary is set to NULL.
+ * @param destructor Optional callback invoked for each stored value before destruction. May be NULL.
+ */
+void collection_int_dictionary_dealloc(struct IIntDictionary **dictionary, void (*destructor)(void *item));
@@ -0,0 +1,79 @@
+/**
+ * @file i_intern_pool.h
+ * @ingroup Collection
+ * @brief String Intern Pool Interface
+ *
+ * Defines the IInternPool interface for a thread-safe pool of canonical,
+ * immutable strings. Interning equal strings yields the same pointer, so
+ * interned strings can be compared by address, and dictionaries created with
+ * collection_dictionary_new_interned() share one copy of each key.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * @brief Interface for a thread-safe string intern pool.
+ */
+struct IInternPool {
+    /**
+     * @brief Returns the canonical copy of a string, adding it to the pool if needed.
+     *
+     * The returned string stays valid until the pool is destroyed.
+     *
+     * @param self Pointer to the pool instance.
+     * @param string Null-terminated string.
+     *
+     * @return The interned string, or NULL if allocation fails.
+     */
+    const char *(*intern)(struct IInternPool *self, const char *string);
+
+    /**
+     * @brief Returns the canonical copy of a string without adding it.
+     *
+     * @param self Pointer to the pool instance.
+     * @param string Null-terminated string.
+     *
+     * @return The interned string, or NULL if the string has not been interned.
+     */
+    const char *(*lookup)(const struct IInternPool *self, const char *string);
+
+    /**
+     * @brief Returns the number of distinct strings in the pool.
+     *
+     * @param self Pointer to the pool instance.
+     *
+     * @return Number of interned strings.
+     */
+    size_t (*count)(const struct IInternPool *self);
+
+    /**
+     * @brief Releases the pool and every interned string.
+     *
+     * Invoked by collection_intern_pool_dealloc(), which should be used instead of
+     * calling this entry directly.
+     *
+     * @param self Pointer to the pool instance.
+     */
+    void (*dealloc)(struct IInternPool *self);
+};
+
+/**
+ * @brief Creates a new intern pool instance.
+ *
+ * @return A newly allocated pool, or NULL if allocation fails.
+ */
+struct IInternPool *collection_intern_pool_new(void);
+
+/**
+ * @brief Destroys an intern pool instance.
+ *
+ * Every string returned by the pool becomes invalid. Dictionaries created
+ * with the pool must be destroyed first.
+ *
+ * @param pool Pointer to the pool pointer. On successful return, *pool is set to NULL.
+ */
+void collection_intern_pool_dealloc(struct IInternPool **pool);
@@ -0,0 +1,172 @@
+/**
+ * @file i_key_dictionary.h
+ * @ingroup Collection
+ * @brief Generic-Key Dictionary Interface
+ *
+ * Defines the IKeyDictionary interface for key-value containers whose keys
+ * are arbitrary byte strings given as a pointer and a length, such as UUIDs,
+ * packed tuples, fixed-size structs, or strings containing NUL bytes.
+ * Optional CollectionKeyOps callbacks replace the default bytewise hashing,
+ * comparison, and copying.
+ *
+ * Implementations of this interface are expected to provide thread-safe
+ * operations.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Caller-supplied key handling. Every member may be NULL to keep the default.
+ */
+struct CollectionKeyOps {
+    /**
+     * @brief Hashes a key. Keys that compare equal must hash equally.
+     *
+     * Default: a seeded hash of all length bytes.
+     *
+     * @param key Key bytes.
+     * @param length Key length in bytes.
+     * @param seed Per-dictionary seed to mix into the result.
+     *
+     * @return The hash value.
+     */
+    uint64_t (*hash)(const void *key, size_t length, uint64_t seed);
+
+    /**
+     * @brief Compares a stored key with a lookup key.
+     *
+     * Default: equal lengths and equal bytes.
+     *
+     * @return true if the keys are equal; otherwise false.
+     */
+    bool (*equals)(const void *stored, size_t stored_length, const void *key, size_t length);
+
+    /**
+     * @brief Returns an owned copy of a key to store, or NULL if allocation fails.
+     *
+     * Default: the key bytes are copied into the entry itself.
+     */
+    void *(*copy)(const void *key, size_t length);
+
+    /**
+     * @brief Releases a key returned by copy when its entry is removed. Ignored without copy.
+     */
+    void (*free)(void *key);
+};
+
+/**
+ * @brief Interface for a generic, thread-safe dictionary with byte-string keys.
+ */
+struct IKeyDictionary {
+    /**
+     * @brief Returns the value associated with the specified key.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Key bytes.
+     * @param length Key length in bytes.
+     *
+     * @return Pointer to the associated value, or NULL if the key is not found.
+     */
+    void *(*get)(const struct IKeyDictionary *self, const void *key, size_t length);
+
+    /**
+     * @brief Inserts a key-value pair.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Key bytes.
+     * @param length Key length in bytes.
+     * @param value Pointer to the value to associate with the key.
+     *
+     * @return true if the operation succeeds; otherwise false.
+     */
+    bool (*put)(struct IKeyDictionary *self, const void *key, size_t length, const void *value);
+
+    /**
+     * @brief Determines whether the specified key exists.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Key bytes.
+     * @param length Key length in bytes.
+     *
+     * @return true if the key exists; otherwise false.
+     */
+    bool (*contains_key)(const struct IKeyDictionary *self, const void *key, size_t length);
+
+    /**
+     * @brief Removes the specified key-value pair.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Key bytes.
+     * @param length Key length in bytes.
+     *
+     * @return Pointer to the removed value, or NULL if the key is not found.
+     */
+    void *(*remove_item)(struct IKeyDictionary *self, const void *key, size_t length);
+
+    /**
+     * @brief Replaces the value associated with the specified key.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param key Key bytes.
+     * @param length Key length in bytes.
+     * @param value Replacement value.
+     *
+     * @return Pointer to the previous value, or NULL if the key is not found.
+     */
+    void *(*replace)(const struct IKeyDictionary *self, const void *key, size_t length, const void *value);
+
+    /**
+     * @brief Removes all key-value pairs from the dictionary.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param destructor Optional callback invoked for each value before removal. May be NULL.
+     *
+     * @return true if the dictionary was cleared successfully; otherwise false.
+     */
+    bool (*clear)(const struct IKeyDictionary *self, void (*destructor)(void *value));
+
+    /**
+     * @brief Releases the dictionary and all of its internal resources.
+     *
+     * Invoked by collection_key_dictionary_dealloc(), which should be used instead of
+     * calling this entry directly.
+     *
+     * @param self Pointer to the dictionary instance.
+     * @param destructor Optional callback invoked for each stored value before destruction. May be NULL.
+     */
+    void (*dealloc)(struct IKeyDictionary *self, void (*destructor)(void *value));
+};
+
+/**
+ * @brief Creates a new dictionary instance keyed by byte strings.
+ *
+ * Keys are hashed and compared bytewise, so struct keys must not contain
+ * uninitialized padding; zero them first or supply callbacks. Like the
+ * chained dictionary, put() does not check for an existing key.
+ *
+ * @return A newly allocated dictionary, or NULL if allocation fails.
+ */
+struct IKeyDictionary *collection_key_dictionary_new(void);
+
+/**
+ * @brief Creates a new dictionary instance with caller-supplied key handling.
+ *
+ * @param ops Key callbacks; copied, so the structure need not outlive the call. NULL selects the defaults.
+ *
+ * @return A newly allocated dictionary, or NULL if allocation fails.
+ */
+struct IKeyDictionary *collection_key_dictionary_new_with_ops(const struct CollectionKeyOps *ops);
+
+/**
+ * @brief Destroys a generic-key dictionary instance.
+ *
+ * @param dictionary Pointer to the dictionary pointer. On successful return, *dictionary is set to NULL.
+ * @param destructor Optional callback invoked for each stored value before destruction. May be NULL.
+ */
+void collection_key_dictionary_dealloc(struct IKeyDictionary **dictionary, void (*destructor)(void *item));
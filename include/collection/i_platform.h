@@ -1,10 +1,23 @@
 /**
  * @file i_platform.h
  * @ingroup Collection
- * @brief Cross-platform mutex, once, alignment, and process statistics utilities.
+ * @brief Cross-platform mutex, once, condition variable, thread-local storage, clock, alignment, and process statistics utilities.
+ *
+ * Building with COLLECTION_ENABLE_LOCK_PROFILING instruments every Mutex:
+ * acquisitions, contended acquisitions, and wait and hold times are counted
+ * per lock name and can be printed with lock_profile_print(). Without it the
+ * profiling functions are no-ops and Mutex carries no extra state.
+ *
+ * Process statistics come from getrusage() and /proc/self on POSIX and from
+ * the process memory and time counters on Windows. A stats region measures the
+ * change across a span of code and, on Linux where perf_event_open() is
+ * permitted, the hardware and software counters of the measuring thread.
  */
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
     #define WIN32_LEAN_AND_MEAN
@@ -20,6 +33,11 @@
  */
 typedef struct Mutex {
     CRITICAL_SECTION cs; /**< Native Windows critical section. */
+#ifdef COLLECTION_LOCK_PROFILING
+    struct lock_profile_record *profile; /**< Statistics shared by every mutex with the same name. */
+    uint64_t held_since;                 /**< clock_monotonic_ns() when the exclusive holder acquired the lock. */
+    int held_exclusive;                  /**< Non-zero while the lock is held exclusively. */
+#endif
 } Mutex;
 
 /**
@@ -34,6 +52,31 @@ typedef INIT_ONCE MutexOnce;
  */
 #define MUTEX_ONCE_INIT INIT_ONCE_STATIC_INIT
 
+/**
+ * @brief Cross-platform thread-specific storage key.
+ *
+ * On Windows, this is backed by a fiber local storage index.
+ */
+typedef DWORD ThreadKey;
+
+/**
+ * @brief Cross-platform exclusive lock that condition variables can wait on.
+ *
+ * On Windows, this is backed by CRITICAL_SECTION.
+ */
+typedef struct Monitor {
+    CRITICAL_SECTION cs; /**< Native Windows critical section. */
+} Monitor;
+
+/**
+ * @brief Cross-platform condition variable.
+ *
+ * On Windows, this is backed by CONDITION_VARIABLE.
+ */
+typedef struct Condition {
+    CONDITION_VARIABLE cv; /**< Native Windows condition variable. */
+} Condition;
+
 /* Alignment compatibility shim. */
 #if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
     #include <stdalign.h>
@@ -62,6 +105,11 @@ typedef INIT_ONCE MutexOnce;
  */
 typedef struct Mutex {
     pthread_rwlock_t rwlock; /**< Native POSIX read/write lock. */
+#ifdef COLLECTION_LOCK_PROFILING
+    struct lock_profile_record *profile; /**< Statistics shared by every mutex with the same name. */
+    uint64_t held_since;                 /**< clock_monotonic_ns() when the exclusive holder acquired the lock. */
+    int held_exclusive;                  /**< Non-zero while the lock is held exclusively. */
+#endif
 } Mutex;
 
 /**
@@ -75,6 +123,31 @@ typedef pthread_once_t MutexOnce;
  * @brief Static initializer for MutexOnce.
  */
 #define MUTEX_ONCE_INIT PTHREAD_ONCE_INIT
+
+/**
+ * @brief Cross-platform thread-specific storage key.
+ *
+ * On POSIX platforms, this is backed by pthread_key_t.
+ */
+typedef pthread_key_t ThreadKey;
+
+/**
+ * @brief Cross-platform exclusive lock that condition variables can wait on.
+ *
+ * On POSIX platforms, this is backed by pthread_mutex_t.
+ */
+typedef struct Monitor {
+    pthread_mutex_t mutex; /**< Native POSIX mutex. */
+} Monitor;
+
+/**
+ * @brief Cross-platform condition variable.
+ *
+ * On POSIX platforms, this is backed by pthread_cond_t on the monotonic clock where available.
+ */
+typedef struct Condition {
+    pthread_cond_t cond; /**< Native POSIX condition variable. */
+} Condition;
 #endif
 
 /**
@@ -117,6 +190,20 @@ int mutex_unlock(Mutex *mutex);
  */
 int mutex_destroy(Mutex *mutex);
 
+/**
+ * @brief Names a mutex for lock profiling.
+ *
+ * Mutexes sharing a name share one profile, so a container names its lock
+ * after its type and all of its instances are reported together. Unnamed
+ * mutexes are reported as "(unnamed)". Call before the mutex is shared.
+ * Does nothing unless built with COLLECTION_ENABLE_LOCK_PROFILING.
+ *
+ * @param mutex Pointer to an initialized mutex.
+ * @param name Profile name, copied and truncated to LOCK_PROFILE_NAME_LENGTH - 1 bytes.
+ * @return 0 on success; non-zero on failure.
+ */
+int mutex_set_name(Mutex *mutex, const char *name);
+
 /**
  * @brief Executes a callback exactly once for a given once token.
  *
@@ -126,6 +213,123 @@ int mutex_destroy(Mutex *mutex);
  */
 int mutex_once(MutexOnce *once, void (*callback)(void));
 
+/**
+ * @brief Creates a thread-specific storage key.
+ *
+ * @param key Pointer to the key to create.
+ * @param destructor Optional callback invoked with a thread's non-NULL value when that thread exits. May be NULL.
+ * @return 0 on success; non-zero on failure.
+ */
+int thread_key_create(ThreadKey *key, void (*destructor)(void *value));
+
+/**
+ * @brief Associates a value with a thread-specific storage key for the calling thread.
+ *
+ * @param key Key created by thread_key_create().
+ * @param value Value to store.
+ * @return 0 on success; non-zero on failure.
+ */
+int thread_key_set(ThreadKey key, void *value);
+
+/**
+ * @brief Returns the calling thread's value for a thread-specific storage key.
+ *
+ * @param key Key created by thread_key_create().
+ * @return The stored value, or NULL if none was set.
+ */
+void *thread_key_get(ThreadKey key);
+
+/**
+ * @brief Deletes a thread-specific storage key. Destructors are not invoked.
+ *
+ * @param key Key created by thread_key_create().
+ * @return 0 on success; non-zero on failure.
+ */
+int thread_key_delete(ThreadKey key);
+
+/**
+ * @brief Initializes a monitor lock.
+ *
+ * @param monitor Pointer to the monitor to initialize.
+ * @return 0 on success; non-zero on failure.
+ */
+int monitor_init(Monitor *monitor);
+
+/**
+ * @brief Acquires a monitor lock.
+ *
+ * @param monitor Pointer to the monitor.
+ * @return 0 on success; non-zero on failure.
+ */
+int monitor_lock(Monitor *monitor);
+
+/**
+ * @brief Releases a monitor lock.
+ *
+ * @param monitor Pointer to the monitor.
+ * @return 0 on success; non-zero on failure.
+ */
+int monitor_unlock(Monitor *monitor);
+
+/**
+ * @brief Destroys a monitor lock.
+ *
+ * @param monitor Pointer to the monitor to destroy.
+ * @return 0 on success; non-zero on failure.
+ */
+int monitor_destroy(Monitor *monitor);
+
+/**
+ * @brief Initializes a condition variable.
+ *
+ * @param condition Pointer to the condition variable to initialize.
+ * @return 0 on success; non-zero on failure.
+ */
+int condition_init(Condition *condition);
+
+/**
+ * @brief Atomically releases a held monitor and waits for a signal, then reacquires the monitor.
+ *
+ * Wakeups may be spurious, so callers re-check their predicate in a loop.
+ *
+ * @param condition Pointer to the condition variable.
+ * @param monitor Monitor held by the caller.
+ * @param timeout_ms Maximum time to wait in milliseconds, or a negative value to wait indefinitely.
+ * @return 0 when woken; non-zero on timeout or failure.
+ */
+int condition_wait(Condition *condition, Monitor *monitor, long timeout_ms);
+
+/**
+ * @brief Wakes at least one thread waiting on a condition variable.
+ *
+ * @param condition Pointer to the condition variable.
+ * @return 0 on success; non-zero on failure.
+ */
+int condition_signal(Condition *condition);
+
+/**
+ * @brief Wakes every thread waiting on a condition variable.
+ *
+ * @param condition Pointer to the condition variable.
+ * @return 0 on success; non-zero on failure.
+ */
+int condition_broadcast(Condition *condition);
+
+/**
+ * @brief Destroys a condition variable.
+ *
+ * @param condition Pointer to the condition variable to destroy.
+ * @return 0 on success; non-zero on failure.
+ */
+int condition_destroy(Condition *condition);
+
+/**
+ * @brief Returns a monotonic timestamp for measuring intervals.
+ *
+ * @return Nanoseconds since an unspecified starting point.
+ */
+uint64_t clock_monotonic_ns(void);
+
 /**
  * @brief Process resource usage statistics.
  */
@@ -155,3 +359,145 @@ int process_stats_collect(struct process_stats *out);
  * @brief Prints current process resource usage statistics.
  */
 void process_stats_print(void);
+
+/**
+ * @brief Performance counters read by a stats region where the platform permits.
+ */
+enum stats_counter {
+    STATS_CYCLES,                  /**< CPU cycles (hardware). */
+    STATS_INSTRUCTIONS,            /**< Retired instructions (hardware). */
+    STATS_CACHE_REFERENCES,        /**< Last-level cache references (hardware). */
+    STATS_CACHE_MISSES,            /**< Last-level cache misses (hardware). */
+    STATS_BRANCH_MISSES,           /**< Mispredicted branches (hardware). */
+    STATS_TASK_CLOCK_NS,           /**< CPU time of the counted threads in nanoseconds (software). */
+    STATS_CPU_MIGRATIONS,          /**< Migrations between CPUs (software). */
+    STATS_COUNTER_COUNT            /**< Number of counters; not a counter. */
+};
+
+/**
+ * @brief State of an open stats region. Treat as opaque.
+ */
+struct stats_region {
+    struct process_stats start;    /**< Process statistics at stats_region_begin(). */
+    uint64_t start_ns;             /**< clock_monotonic_ns() at stats_region_begin(). */
+    int counters[STATS_COUNTER_COUNT]; /**< Counter descriptors, or -1 where unavailable. */
+};
+
+/**
+ * @brief Change in resource usage across a stats region.
+ */
+struct stats_delta {
+    double wall_sec;               /**< Elapsed monotonic time in seconds. */
+    double rss_mb;                 /**< Change in current resident memory in megabytes; negative if memory was returned. */
+    double max_rss_mb;             /**< Peak resident memory at the end of the region in megabytes. */
+
+    double user_cpu_sec;           /**< User CPU time in seconds. */
+    double system_cpu_sec;         /**< Kernel/system CPU time in seconds. */
+
+    long minor_page_faults;        /**< Number of minor page faults. */
+    long major_page_faults;        /**< Number of major page faults. */
+
+    long voluntary_ctx_switches;   /**< Number of voluntary context switches. */
+    long involuntary_ctx_switches; /**< Number of involuntary context switches. */
+
+    uint64_t counters[STATS_COUNTER_COUNT]; /**< Counter values, scaled when the kernel multiplexed them; 0 where unavailable. */
+    unsigned available;            /**< Bit (1u << counter) set for each counter that was read. */
+};
+
+/**
+ * @brief Starts measuring resource usage.
+ *
+ * Process statistics cover the whole process. Performance counters, where
+ * available, count user-space events of the calling thread and of threads it
+ * creates and joins before stats_region_end(). They are unavailable off Linux,
+ * when perf_event_paranoid forbids them, or when the hardware has no PMU
+ * (common in virtual machines); the region still measures everything else.
+ *
+ * @param region Region state, released by stats_region_end().
+ * @return 0 on success; non-zero if process statistics could not be collected.
+ */
+int stats_region_begin(struct stats_region *region);
+
+/**
+ * @brief Stops measuring and reports the change since stats_region_begin().
+ *
+ * Must be called on the thread that began the region.
+ *
+ * @param region Region started by stats_region_begin().
+ * @param out Pointer to the output delta.
+ * @return 0 on success; non-zero if process statistics could not be collected.
+ */
+int stats_region_end(struct stats_region *region, struct stats_delta *out);
+
+/**
+ * @brief Prints a stats region delta, omitting unavailable counters.
+ *
+ * @param name Label for the measured workload.
+ * @param delta Delta filled by stats_region_end().
+ */
+void stats_delta_print(const char *name, const struct stats_delta *delta);
+
+/**
+ * @brief Lock modes distinguished by lock profiles.
+ */
+enum lock_mode {
+    LOCK_EXCLUSIVE,                /**< Acquired with mutex_lock(). */
+    LOCK_SHARED,                   /**< Acquired with mutex_lock_shared(). */
+    LOCK_MODE_COUNT                /**< Number of modes; not a mode. */
+};
+
+/**
+ * @brief Length of the name buffer of a lock profile, including the terminator.
+ */
+#define LOCK_PROFILE_NAME_LENGTH 64
+
+/**
+ * @brief Number of histogram buckets. Bucket b counts durations of [2^b, 2^(b+1)) ns; the first and last are open-ended.
+ */
+#define LOCK_PROFILE_BUCKETS 32
+
+/**
+ * @brief Snapshot of the statistics of every mutex with one name, indexed by enum lock_mode.
+ */
+struct lock_profile_stats {
+    char name[LOCK_PROFILE_NAME_LENGTH];                    /**< Name given with mutex_set_name(). */
+    size_t locks;                                           /**< Mutexes currently initialized under the name. */
+    uint64_t acquisitions[LOCK_MODE_COUNT];                 /**< Successful acquisitions. */
+    uint64_t contended[LOCK_MODE_COUNT];                    /**< Acquisitions that had to wait because the lock was held. */
+    uint64_t wait_ns[LOCK_MODE_COUNT];                      /**< Total time spent waiting by contended acquisitions. */
+    uint64_t hold_ns[LOCK_MODE_COUNT];                      /**< Total time the lock was held. */
+    uint64_t wait_histogram[LOCK_MODE_COUNT][LOCK_PROFILE_BUCKETS]; /**< Wait times of contended acquisitions. */
+    uint64_t hold_histogram[LOCK_MODE_COUNT][LOCK_PROFILE_BUCKETS]; /**< Hold times. */
+};
+
+/**
+ * @brief Returns whether the library was built with COLLECTION_ENABLE_LOCK_PROFILING.
+ *
+ * @return Non-zero if mutexes are profiled; otherwise 0.
+ */
+int lock_profile_enabled(void);
+
+/**
+ * @brief Copies the profiles of every lock name, most contended first.
+ *
+ * Profiles are ordered by contended acquisitions, then by total wait time.
+ * Counters are read without stopping other threads, so a snapshot taken
+ * under load is approximate.
+ *
+ * @param out Array receiving up to capacity profiles; may be NULL when capacity is 0.
+ * @param capacity Number of elements in out.
+ * @return Number of lock names profiled, which may exceed capacity; 0 when profiling is disabled or unavailable.
+ */
+size_t lock_profile_snapshot(struct lock_profile_stats *out, size_t capacity);
+
+/**
+ * @brief Prints the most contended lock names with their reader/writer split and wait and hold percentiles.
+ *
+ * @param limit Maximum number of lock names to print; 0 prints all.
+ */
+void lock_profile_print(size_t limit);
+
+/**
+ * @brief Clears every profile counter, keeping names and lock counts.
+ */
+void lock_profile_reset(void);
@@ -0,0 +1,189 @@
+/**
+ * @file i_trace.h
+ * @ingroup Collection
+ * @brief Operation Trace Interface
+ *
+ * Defines the ITrace interface for recording the operations applied to a
+ * collection into a compact binary file, so that a captured workload can be
+ * replayed against other implementations. Recording is opt-in: wrap an
+ * existing IArray or IDictionary with collection_array_new_recording() or
+ * collection_dictionary_new_recording() and use the wrapper in its place.
+ *
+ * Each operation is stored as one fixed-size record holding the operation,
+ * whether it succeeded, the recording thread, its position among the
+ * records of every thread, and either the key's length and collection_hash()
+ * or an array index. Keys and values themselves are never written.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include "i_array.h"
+#include "i_dictionary.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Operation codes stored in trace records.
+ */
+enum CollectionTraceOp {
+    COLLECTION_TRACE_DICTIONARY_GET = 1,
+    COLLECTION_TRACE_DICTIONARY_PUT,
+    COLLECTION_TRACE_DICTIONARY_CONTAINS_KEY,
+    COLLECTION_TRACE_DICTIONARY_REMOVE_ITEM,
+    COLLECTION_TRACE_DICTIONARY_REPLACE,
+    COLLECTION_TRACE_DICTIONARY_PUT_IF_ABSENT,
+    COLLECTION_TRACE_DICTIONARY_UPSERT,
+    COLLECTION_TRACE_DICTIONARY_GET_OR_INSERT_WITH,
+    COLLECTION_TRACE_DICTIONARY_COMPUTE,
+    COLLECTION_TRACE_DICTIONARY_GET_MANY,
+    COLLECTION_TRACE_DICTIONARY_PUT_MANY,
+    COLLECTION_TRACE_DICTIONARY_REMOVE_MANY,
+    COLLECTION_TRACE_DICTIONARY_GET_HASHED,
+    COLLECTION_TRACE_DICTIONARY_PUT_HASHED,
+    COLLECTION_TRACE_DICTIONARY_CONTAINS_KEY_HASHED,
+    COLLECTION_TRACE_DICTIONARY_CLEAR,
+    COLLECTION_TRACE_DICTIONARY_DEALLOC,
+
+    COLLECTION_TRACE_ARRAY_GET = 64,
+    COLLECTION_TRACE_ARRAY_PUT,
+    COLLECTION_TRACE_ARRAY_FOR_EACH,
+    COLLECTION_TRACE_ARRAY_FIND,
+    COLLECTION_TRACE_ARRAY_FIRST_INDEX,
+    COLLECTION_TRACE_ARRAY_LAST_INDEX,
+    COLLECTION_TRACE_ARRAY_UNSHIFT,
+    COLLECTION_TRACE_ARRAY_PUSH,
+    COLLECTION_TRACE_ARRAY_CONTAINS_VALUE,
+    COLLECTION_TRACE_ARRAY_SHIFT,
+    COLLECTION_TRACE_ARRAY_POP,
+    COLLECTION_TRACE_ARRAY_REMOVE_ITEM,
+    COLLECTION_TRACE_ARRAY_CLONE,
+    COLLECTION_TRACE_ARRAY_COUNT,
+    COLLECTION_TRACE_ARRAY_CLEAR,
+    COLLECTION_TRACE_ARRAY_DEALLOC
+};
+
+/** Record flag: the operation found, stored, or removed what it was asked to. */
+#define COLLECTION_TRACE_SUCCEEDED 0x01u
+
+/**
+ * @brief One recorded operation, as returned by collection_trace_load().
+ */
+struct CollectionTraceRecord {
+    uint8_t op;                 /**< An enum CollectionTraceOp value. */
+    uint8_t flags;              /**< COLLECTION_TRACE_SUCCEEDED or 0. */
+    uint16_t thread;            /**< Recording thread, numbered from 0 in order of first use. */
+    uint32_t key_length;        /**< Key length in bytes; 0 for array and whole-collection operations. */
+    uint64_t key_hash;          /**< collection_hash() of the key; 0 without a key. */
+
+    /**
+     * @brief Operation argument.
+     *
+     * The index for array get and put; the number of predicate calls for
+     * find, first_index and last_index; and, for the records of one batch
+     * operation, the number of records left in the batch including this one.
+     * Batches are always stored contiguously. 0 otherwise.
+     */
+    uint64_t index;
+
+    uint64_t sequence;          /**< Position among the records of every thread, from 0; collection_trace_load() returns records in this order. */
+};
+
+/**
+ * @brief Interface for a trace file that recording collections append to.
+ */
+struct ITrace {
+    /**
+     * @brief Writes buffered records to the file.
+     *
+     * @param self Pointer to the trace instance.
+     *
+     * @return true on success; false if the file could not be written.
+     */
+    bool (*flush)(struct ITrace *self);
+
+    /**
+     * @brief Returns the number of records appended so far.
+     *
+     * @param self Pointer to the trace instance.
+     *
+     * @return The number of records.
+     */
+    size_t (*count)(const struct ITrace *self);
+
+    /**
+     * @brief Flushes and closes the trace.
+     *
+     * Invoked by collection_trace_dealloc(), which should be used instead of
+     * calling this entry directly.
+     *
+     * @param self Pointer to the trace instance.
+     */
+    void (*dealloc)(struct ITrace *self);
+};
+
+/**
+ * @brief Creates a trace that writes to a new file, replacing any existing one.
+ *
+ * Records from any number of threads and recording collections take the next
+ * sequence number atomically and go to a buffer owned by the recording
+ * thread, so threads do not wait for each other. A thread's buffer is written
+ * when it fills, when flush() is called, or when the trace is destroyed.
+ *
+ * @param path File to create.
+ *
+ * @return A newly allocated trace, or NULL if the file cannot be created.
+ */
+struct ITrace *collection_trace_new(const char *path);
+
+/**
+ * @brief Flushes, closes and deallocates a trace, and sets the caller's pointer to NULL.
+ *
+ * Recording collections using the trace must be destroyed first.
+ *
+ * @param trace Pointer to the caller's trace pointer.
+ */
+void collection_trace_dealloc(struct ITrace **trace);
+
+/**
+ * @brief Reads every record of a trace file.
+ *
+ * @param path File written by a trace.
+ * @param count Receives the number of records.
+ *
+ * @return Records in sequence order, released with free(), or NULL if the file is
+ *         missing, malformed or empty.
+ */
+struct CollectionTraceRecord *collection_trace_load(const char *path, size_t *count);
+
+/**
+ * @brief Creates a dictionary that records every operation before returning its result.
+ *
+ * All operations are forwarded to the wrapped dictionary, which the wrapper
+ * owns and destroys with it. Each operation's records (a whole batch for the
+ * *_many operations) take consecutive sequence numbers.
+ *
+ * @param dictionary Dictionary to wrap.
+ * @param trace Trace to append to; must outlive the wrapper.
+ *
+ * @return A newly allocated dictionary, or NULL if allocation fails, in which case the wrapped dictionary is not taken.
+ */
+struct IDictionary *collection_dictionary_new_recording(struct IDictionary *dictionary, struct ITrace *trace);
+
+/**
+ * @brief Creates an array that records every operation before returning its result.
+ *
+ * All operations are forwarded to the wrapped array, which the wrapper owns
+ * and destroys with it. Element values are not recorded, so the traces of
+ * contains_value() and remove_item() only say whether they succeeded. A clone
+ * is not recorded.
+ *
+ * @param array Array to wrap.
+ * @param trace Trace to append to; must outlive the wrapper.
+ *
+ * @return A newly allocated array, or NULL if allocation fails, in which case the wrapped array is not taken.
+ */
+struct IArray *collection_array_new_recording(struct IArray *array, struct ITrace *trace);
@@ -7,11 +7,14 @@
 * @copyright BSD 3-Clause License
 */
 #include "array.h"
+#include "node_pool.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
+static struct NodePool node_pool = NODE_POOL_INIT(NODE_POOL_ARRAY_NODE, sizeof(struct ArrayNode));
+
 // Returns the element at the specified index, or NULL if out of range.
 static const void *get(const struct IArray *self, const size_t index) {
     struct Array *this = (struct Array *) self;
@@ -112,7 +115,7 @@ static size_t last_index(const struct IArray *self, bool (*predicate)(const void
 static const void *unshift(struct IArray *self, const void *item) {
     struct Array *this = (struct Array *) self;
 
-    struct ArrayNode *node = malloc(sizeof(struct ArrayNode));
+    struct ArrayNode *node = node_pool_alloc(&node_pool);
     if (node == NULL) {
         fprintf(stderr, "\033[0;31m[Collection::Array::unshift] Error: Failed to allocate ArrayNode.\033[0m\n");
         return NULL;
@@ -133,7 +136,7 @@ static bool push(struct IArray *self, const void *item) {
     struct Array *this = (struct Array *) self;
     bool success = false;
 
-    struct ArrayNode *node = malloc(sizeof(struct ArrayNode));
+    struct ArrayNode *node = node_pool_alloc(&node_pool);
     if (node == NULL) {
         fprintf(stderr, "\033[0;31m[Collection::Array::push] Error: Failed to allocate ArrayNode.\033[0m\n");
         return success;
@@ -180,7 +183,7 @@ static const void *shift(struct IArray *self) {
     if (node) {
         this->list = node->next;    // Update head
         item = node->item;          // Capture item
-        free(node);                 // Free removed ArrayNode
+        node_pool_free(&node_pool, node); // Free removed ArrayNode
     }
 
     mutex_unlock(&this->mutex);
@@ -200,7 +203,7 @@ static const void *pop(struct IArray *self) {
         struct ArrayNode *node = *cursor;
         item = node->item;  // Capture item
         *cursor = NULL;     // Remove last ArrayNode
-        free(node);         // Free ArrayNode
+        node_pool_free(&node_pool, node); // Free ArrayNode
     }
 
     mutex_unlock(&this->mutex);
@@ -218,7 +221,7 @@ static void *remove_item(struct IArray *self, const void *item) {
             struct ArrayNode *node = *cursor;
             *cursor = (*cursor)->next;    // Remove ArrayNode from ArrayNode
             data = (void *) node->item;   // Return item
-            free(node);                   // Free ArrayNode
+            node_pool_free(&node_pool, node); // Free ArrayNode
             break;
         }
     }
@@ -234,13 +237,13 @@ static struct IArray *array_clone(const struct IArray *self) {
 
     struct ArrayNode *copy = NULL;
     for (struct ArrayNode *cursor = this->list, **copyPtr = &copy; cursor; cursor = cursor->next) {
-        struct ArrayNode *node = malloc(sizeof(struct ArrayNode));
+        struct ArrayNode *node = node_pool_alloc(&node_pool);
         if (node == NULL) {
             mutex_unlock(&this->mutex);
             while (copy) {
                 struct ArrayNode *temp = copy;
                 copy = copy->next;
-                free(temp);
+                node_pool_free(&node_pool, temp);
             }
             fprintf(stderr, "\033[0;31m[Collection::Array::clone] Error: Failed to allocate ArrayNode.\033[0m\n");
             return NULL;
@@ -259,7 +262,7 @@ static struct IArray *array_clone(const struct IArray *self) {
         for (struct ArrayNode **cursor = &copy; *cursor;) {
             struct ArrayNode *temp = *cursor;
             *cursor = (*cursor)->next;
-            free(temp);
+            node_pool_free(&node_pool, temp);
         }
         return NULL;
     }
@@ -290,12 +293,22 @@ static void clear(struct IArray *self, void (*destructor)(void *item)) {
         struct ArrayNode *node = *cursor;
         *cursor = (*cursor)->next;         // Remove ArrayNode from ArrayNode
         if (destructor) destructor((void *) node->item);
-        free(node);
+        node_pool_free(&node_pool, node);
     }
 
     mutex_unlock(&this->mutex);
 }
 
+// Releases an Array instance.
+static void dealloc(struct IArray *self, void (*destructor)(void *item)) {
+    struct Array *this = (struct Array *) self;
+
+    clear(self, destructor);
+    mutex_destroy(&this->mutex);
+
+    free(this);
+}
+
 // Returns the aligned allocation size for Array.
 static size_t size(void) {
     return (sizeof(struct Array) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u); // Align to pointer size.
@@ -321,6 +334,7 @@ static struct IArray *init(struct IArray *array) {
     memset(this, 0, sizeof(struct Array));
 
     if (mutex_init(&this->mutex) != 0) goto exception;
+    mutex_set_name(&this->mutex, "Collection::Array");
 
     this->list = NULL;
     this->super.get = get;
@@ -338,11 +352,12 @@ static struct IArray *init(struct IArray *array) {
     this->super.clone = array_clone;
     this->super.count = count;
     this->super.clear = clear;
+    this->super.dealloc = dealloc;
 
     return array;
 
 exception:
-    collection_array_dealloc(&array, NULL);
+    free(array);
     return NULL;
 }
 
@@ -353,12 +368,8 @@ struct IArray *collection_array_new(void) {
 
 // Destroys an array instance.
 void collection_array_dealloc(struct IArray **array, void (*destructor)(void *item)) {
-    if (array == NULL) return;
-    struct Array *this = (struct Array *) *array;
-
-    (*array)->clear(*array, destructor);
-    mutex_destroy(&this->mutex);
+    if (array == NULL || *array == NULL) return;
 
-    free(*array);
+    (*array)->dealloc(*array, destructor);
     *array = NULL;
 }
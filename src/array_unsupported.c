@@ -0,0 +1,83 @@
+/**
+ * @file array_unsupported.c
+ * @internal
+ * @brief Unsupported IArray Operations Implementation
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "array_unsupported.h"
+
+// Returns NULL; indexed access is not supported.
+const void *array_unsupported_get(const struct IArray *self, const size_t index) {
+    (void) self;
+    (void) index;
+    return NULL;
+}
+
+// Returns NULL; indexed replacement is not supported.
+void *array_unsupported_put(struct IArray *self, const void *item, const size_t index) {
+    (void) self;
+    (void) item;
+    (void) index;
+    return NULL;
+}
+
+// Does nothing; iteration is not supported.
+void array_unsupported_for_each(const struct IArray *self, void (*consumer)(const void *element, const void *data),
+                                const void *data) {
+    (void) self;
+    (void) consumer;
+    (void) data;
+}
+
+// Returns NULL; searching is not supported.
+const void *array_unsupported_find(const struct IArray *self, bool (*predicate)(const void *element, const void *data),
+                                   const void *data) {
+    (void) self;
+    (void) predicate;
+    (void) data;
+    return NULL;
+}
+
+// Returns (size_t) -1; searching is not supported.
+size_t array_unsupported_index(const struct IArray *self, bool (*predicate)(const void *element, const void *data),
+                               const void *data) {
+    (void) self;
+    (void) predicate;
+    (void) data;
+    return (size_t) -1;
+}
+
+// Returns NULL; inserting at the front is not supported.
+const void *array_unsupported_unshift(struct IArray *self, const void *item) {
+    (void) self;
+    (void) item;
+    return NULL;
+}
+
+// Returns false; membership tests are not supported.
+bool array_unsupported_contains_value(const struct IArray *self, const void *item) {
+    (void) self;
+    (void) item;
+    return false;
+}
+
+// Returns NULL; removing from the back is not supported.
+const void *array_unsupported_pop(struct IArray *self) {
+    (void) self;
+    return NULL;
+}
+
+// Returns NULL; removing arbitrary elements is not supported.
+void *array_unsupported_remove_item(struct IArray *self, const void *item) {
+    (void) self;
+    (void) item;
+    return NULL;
+}
+
+// Returns NULL; cloning is not supported.
+struct IArray *array_unsupported_clone(const struct IArray *self) {
+    (void) self;
+    return NULL;
+}
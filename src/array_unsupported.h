@@ -0,0 +1,89 @@
+/**
+ * @file array_unsupported.h
+ * @internal
+ * @brief Unsupported IArray Operations Header
+ *
+ * Shared vtable entries for the concurrent arrays (queues and the
+ * work-stealing deque) that only support adding and removing at their ends.
+ * Each entry does nothing and returns the interface's "not found" value.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include "collection/i_array.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Indexed access is not supported.
+ *
+ * @return NULL.
+ */
+const void *array_unsupported_get(const struct IArray *self, size_t index);
+
+/**
+ * @brief Indexed replacement is not supported.
+ *
+ * @return NULL.
+ */
+void *array_unsupported_put(struct IArray *self, const void *item, size_t index);
+
+/**
+ * @brief Iteration is not supported; the consumer is never invoked.
+ */
+void array_unsupported_for_each(const struct IArray *self, void (*consumer)(const void *element, const void *data),
+                                const void *data);
+
+/**
+ * @brief Searching is not supported.
+ *
+ * @return NULL.
+ */
+const void *array_unsupported_find(const struct IArray *self, bool (*predicate)(const void *element, const void *data),
+                                   const void *data);
+
+/**
+ * @brief Searching is not supported; serves both first_index and last_index.
+ *
+ * @return (size_t) -1.
+ */
+size_t array_unsupported_index(const struct IArray *self, bool (*predicate)(const void *element, const void *data),
+                               const void *data);
+
+/**
+ * @brief Inserting at the front is not supported.
+ *
+ * @return NULL.
+ */
+const void *array_unsupported_unshift(struct IArray *self, const void *item);
+
+/**
+ * @brief Membership tests are not supported.
+ *
+ * @return false.
+ */
+bool array_unsupported_contains_value(const struct IArray *self, const void *item);
+
+/**
+ * @brief Removing from the back is not supported.
+ *
+ * @return NULL.
+ */
+const void *array_unsupported_pop(struct IArray *self);
+
+/**
+ * @brief Removing arbitrary elements is not supported.
+ *
+ * @return NULL.
+ */
+void *array_unsupported_remove_item(struct IArray *self, const void *item);
+
+/**
+ * @brief Cloning is not supported.
+ *
+ * @return NULL.
+ */
+struct IArray *array_unsupported_clone(const struct IArray *self);
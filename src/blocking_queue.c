@@ -0,0 +1,481 @@
+/**
+ * @file blocking_queue.c
+ * @internal
+ * @brief Blocking Queue Implementation
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "blocking_queue.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+// Returns the ring slot of the element at the given logical index.
+static size_t slot(const struct BlockingQueue *this, const size_t index) {
+    const size_t i = this->head + index;
+    return i >= this->capacity ? i - this->capacity : i;
+}
+
+// Wakes one consumer and raises the eventfd if the queue just became non-empty. Caller holds the monitor.
+static void added(struct BlockingQueue *this) {
+#ifdef __linux__
+    if (this->size == 1 && this->event_fd >= 0) eventfd_write(this->event_fd, 1);
+#endif
+    condition_signal(&this->not_empty);
+}
+
+// Wakes one producer and lowers the eventfd if the queue just became empty. Caller holds the monitor.
+static void removed(struct BlockingQueue *this) {
+#ifdef __linux__
+    eventfd_t value;
+    if (this->size == 0 && this->event_fd >= 0) eventfd_read(this->event_fd, &value);
+#endif
+    condition_signal(&this->not_full);
+}
+
+// Waits on a condition until woken or the deadline passes. Returns false once the deadline has passed.
+static bool wait_until(struct BlockingQueue *this, Condition *condition, const long timeout_ms, const uint64_t deadline) {
+    if (timeout_ms < 0) {
+        condition_wait(condition, &this->monitor, -1); // Callers re-check their predicate, so spurious wakeups are harmless.
+        return true;
+    }
+
+    const uint64_t now = clock_monotonic_ns();
+    if (now >= deadline) return false;
+
+    const uint64_t remaining_ms = (deadline - now + 999999u) / 1000000u; // Round up so we never wake early and spin.
+    condition_wait(condition, &this->monitor, (long) remaining_ms);
+    return true;
+}
+
+// Removes the first element. Caller holds the monitor and has checked the queue is non-empty.
+static const void *take_first(struct BlockingQueue *this) {
+    const void *item = this->items[this->head];
+    this->head = slot(this, 1);
+    this->size--;
+    removed(this);
+    return item;
+}
+
+// Returns the element at the specified index, or NULL if out of range.
+static const void *get(const struct IArray *self, const size_t index) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    const void *item = index < this->size ? this->items[slot(this, index)] : NULL;
+
+    monitor_unlock(&this->monitor);
+    return item;
+}
+
+// Replaces the element at the specified index.
+static void *put(struct IArray *self, const void *item, const size_t index) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    void *temp = NULL;
+    if (index < this->size) {
+        const size_t i = slot(this, index);
+        temp = (void *) this->items[i];
+        this->items[i] = item;
+    }
+
+    monitor_unlock(&this->monitor);
+    return temp;
+}
+
+// Invokes a callback for each element.
+static void for_each(const struct IArray *self, void (*consumer)(const void *element, const void *data), const void *data) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    for (size_t i = 0; i < this->size; i++) {
+        consumer(this->items[slot(this, i)], data);
+    }
+
+    monitor_unlock(&this->monitor);
+}
+
+// Finds the first element matching a predicate.
+static const void *find(const struct IArray *self, bool (*predicate)(const void *element, const void *data), const void *data) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    const void *item = NULL;
+    for (size_t i = 0; i < this->size; i++) {
+        const void *element = this->items[slot(this, i)];
+        if (predicate(element, data)) {
+            item = element;
+            break;
+        }
+    }
+
+    monitor_unlock(&this->monitor);
+    return item;
+}
+
+// Returns the index of the first matching element.
+static size_t first_index(const struct IArray *self, bool (*predicate)(const void *element, const void *data), const void *data) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    size_t index = (size_t) -1; // No matching element found.
+    for (size_t i = 0; i < this->size; i++) {
+        if (predicate(this->items[slot(this, i)], data)) {
+            index = i;
+            break;
+        }
+    }
+
+    monitor_unlock(&this->monitor);
+    return index;
+}
+
+// Returns the index of the last matching element.
+static size_t last_index(const struct IArray *self, bool (*predicate)(const void *element, const void *data), const void *data) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    size_t index = (size_t) -1;
+    for (size_t i = this->size; i > 0; i--) { // Scan backwards and stop at the first match.
+        if (predicate(this->items[slot(this, i - 1)], data)) {
+            index = i - 1;
+            break;
+        }
+    }
+
+    monitor_unlock(&this->monitor);
+    return index;
+}
+
+// Inserts an element at the head of the queue, failing if it is full.
+static const void *unshift(struct IArray *self, const void *item) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    const void *result = NULL;
+    if (this->size < this->capacity) {
+        this->head = this->head == 0 ? this->capacity - 1 : this->head - 1;
+        this->items[this->head] = item;
+        this->size++;
+        added(this);
+        result = item;
+    }
+
+    monitor_unlock(&this->monitor);
+    return result;
+}
+
+// Appends an element to the tail of the queue, failing if it is full.
+static bool push(struct IArray *self, const void *item) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    const bool success = this->size < this->capacity;
+    if (success) {
+        this->items[slot(this, this->size)] = item;
+        this->size++;
+        added(this);
+    }
+
+    monitor_unlock(&this->monitor);
+    return success;
+}
+
+// Returns whether the queue contains the specified element.
+static bool contains_value(const struct IArray *self, const void *item) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    bool found = false;
+    for (size_t i = 0; i < this->size; i++) {
+        if (this->items[slot(this, i)] == item) {
+            found = true;
+            break;
+        }
+    }
+
+    monitor_unlock(&this->monitor);
+    return found;
+}
+
+// Removes and returns the first element, or NULL if the queue is empty.
+static const void *shift(struct IArray *self) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    const void *item = this->size > 0 ? take_first(this) : NULL;
+
+    monitor_unlock(&this->monitor);
+    return item;
+}
+
+// Removes and returns the last element, or NULL if the queue is empty.
+static const void *pop(struct IArray *self) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    const void *item = NULL;
+    if (this->size > 0) {
+        this->size--;
+        item = this->items[slot(this, this->size)];
+        removed(this);
+    }
+
+    monitor_unlock(&this->monitor);
+    return item;
+}
+
+// Removes the specified element, closing the gap from whichever end is nearer.
+static void *remove_item(struct IArray *self, const void *item) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    void *data = NULL;
+    for (size_t i = 0; i < this->size; i++) {
+        if (this->items[slot(this, i)] != item) continue;
+
+        data = (void *) item;
+        if (i < this->size / 2) {
+            for (size_t j = i; j > 0; j--) this->items[slot(this, j)] = this->items[slot(this, j - 1)];
+            this->head = slot(this, 1);
+        } else {
+            for (size_t j = i; j + 1 < this->size; j++) this->items[slot(this, j)] = this->items[slot(this, j + 1)];
+        }
+        this->size--;
+        removed(this);
+        break;
+    }
+
+    monitor_unlock(&this->monitor);
+    return data;
+}
+
+// Creates a shallow copy of the queue with the same capacity.
+static struct IArray *queue_clone(const struct IArray *self) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+
+    struct IArray *arr = collection_array_new_blocking(this->capacity); // Capacity is immutable
+    if (arr == NULL) return NULL;
+    struct BlockingQueue *copy = (struct BlockingQueue *) arr;
+
+    monitor_lock(&this->monitor);
+
+    for (size_t i = 0; i < this->size; i++) copy->items[i] = this->items[slot(this, i)]; // Shallow copy item pointers
+    copy->size = this->size;
+
+    monitor_unlock(&this->monitor);
+    return arr;
+}
+
+// Returns the number of elements.
+static size_t count(const struct IArray *self) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    const size_t count = this->size;
+
+    monitor_unlock(&this->monitor);
+    return count;
+}
+
+// Removes all elements and wakes every waiting producer.
+static void clear(struct IArray *self, void (*destructor)(void *item)) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+    monitor_lock(&this->monitor);
+
+    if (destructor) {
+        for (size_t i = 0; i < this->size; i++) destructor((void *) this->items[slot(this, i)]);
+    }
+    const bool was_empty = this->size == 0;
+    this->head = 0;
+    this->size = 0;
+    if (!was_empty) {
+        removed(this);
+        condition_broadcast(&this->not_full);
+    }
+
+    monitor_unlock(&this->monitor);
+}
+
+// Releases a BlockingQueue instance, its ring and its eventfd. No thread may be waiting on it.
+static void dealloc(struct IArray *self, void (*destructor)(void *item)) {
+    struct BlockingQueue *this = (struct BlockingQueue *) self;
+
+    clear(self, destructor);
+#ifdef __linux__
+    if (this->event_fd >= 0) close(this->event_fd);
+#endif
+    condition_destroy(&this->not_full);
+    condition_destroy(&this->not_empty);
+    monitor_destroy(&this->monitor);
+
+    free(this->items);
+    free(this);
+}
+
+// Returns the aligned allocation size for BlockingQueue.
+static size_t size(void) {
+    return (sizeof(struct BlockingQueue) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u); // Align to pointer size.
+}
+
+// Allocates a BlockingQueue instance.
+static struct IArray *alloc() {
+    struct IArray *array = malloc(size());
+
+    if (array == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::BlockingQueue::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return array;
+}
+
+// Initializes a BlockingQueue instance holding at most `capacity` elements.
+static struct IArray *init(struct IArray *array, const size_t capacity) {
+    if (array == NULL) return NULL;
+
+    struct BlockingQueue *this = (struct BlockingQueue *) array;
+    memset(this, 0, sizeof(struct BlockingQueue));
+
+    this->capacity = capacity ? capacity : 1;
+    this->items = this->capacity <= SIZE_MAX / sizeof(void *) ? malloc(this->capacity * sizeof(void *)) : NULL;
+    if (this->items == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::BlockingQueue::init] ERROR: Ring allocation failed.\033[0m\n");
+        goto exception;
+    }
+
+    if (monitor_init(&this->monitor) != 0) goto exception;
+    if (condition_init(&this->not_empty) != 0) {
+        monitor_destroy(&this->monitor);
+        goto exception;
+    }
+    if (condition_init(&this->not_full) != 0) {
+        condition_destroy(&this->not_empty);
+        monitor_destroy(&this->monitor);
+        goto exception;
+    }
+
+    this->event_fd = -1; // Created on first request.
+    this->super.get = get;
+    this->super.put = put;
+    this->super.for_each = for_each;
+    this->super.find = find;
+    this->super.first_index = first_index;
+    this->super.last_index = last_index;
+    this->super.unshift = unshift;
+    this->super.push = push;
+    this->super.contains_value = contains_value;
+    this->super.shift = shift;
+    this->super.pop = pop;
+    this->super.remove_item = remove_item;
+    this->super.clone = queue_clone;
+    this->super.count = count;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return array;
+
+exception:
+    free(this->items);
+    free(array);
+    return NULL;
+}
+
+// Creates a new bounded blocking queue.
+struct IArray *collection_array_new_blocking(const size_t capacity) {
+    return init(alloc(), capacity);
+}
+
+// Returns whether an array is a blocking queue.
+static bool is_blocking_queue(const struct IArray *array) {
+    return array->dealloc == dealloc;
+}
+
+// Appends an element, waiting up to timeout_ms for space.
+bool collection_array_blocking_push_wait(struct IArray *array, const void *item, const long timeout_ms) {
+    if (array == NULL) return false;
+    if (!is_blocking_queue(array)) {
+        fprintf(stderr, "\033[0;31m[Collection::BlockingQueue::push_wait] Error: Array is not a blocking queue.\033[0m\n");
+        return false;
+    }
+    struct BlockingQueue *this = (struct BlockingQueue *) array;
+
+    const uint64_t deadline = timeout_ms > 0 ? clock_monotonic_ns() + (uint64_t) timeout_ms * 1000000u : 0;
+    monitor_lock(&this->monitor);
+
+    bool success = true;
+    while (this->size == this->capacity) {
+        if (timeout_ms == 0 || !wait_until(this, &this->not_full, timeout_ms, deadline)) {
+            success = false;
+            break;
+        }
+    }
+    if (success) {
+        this->items[slot(this, this->size)] = item;
+        this->size++;
+        added(this);
+    }
+
+    monitor_unlock(&this->monitor);
+    return success;
+}
+
+// Removes the first element, waiting up to timeout_ms for one to arrive.
+const void *collection_array_blocking_shift_wait(struct IArray *array, const long timeout_ms) {
+    if (array == NULL) return NULL;
+    if (!is_blocking_queue(array)) {
+        fprintf(stderr, "\033[0;31m[Collection::BlockingQueue::shift_wait] Error: Array is not a blocking queue.\033[0m\n");
+        return NULL;
+    }
+    struct BlockingQueue *this = (struct BlockingQueue *) array;
+
+    const uint64_t deadline = timeout_ms > 0 ? clock_monotonic_ns() + (uint64_t) timeout_ms * 1000000u : 0;
+    monitor_lock(&this->monitor);
+
+    const void *item = NULL;
+    for (;;) {
+        if (this->size > 0) {
+            item = take_first(this);
+            break;
+        }
+        if (timeout_ms == 0 || !wait_until(this, &this->not_empty, timeout_ms, deadline)) break;
+    }
+
+    monitor_unlock(&this->monitor);
+    return item;
+}
+
+// Returns a descriptor that is readable while the queue is non-empty, creating it on first use.
+int collection_array_blocking_eventfd(struct IArray *array) {
+    if (array == NULL) return -1;
+    if (!is_blocking_queue(array)) {
+        fprintf(stderr, "\033[0;31m[Collection::BlockingQueue::eventfd] Error: Array is not a blocking queue.\033[0m\n");
+        return -1;
+    }
+#ifdef __linux__
+    struct BlockingQueue *this = (struct BlockingQueue *) array;
+    monitor_lock(&this->monitor);
+
+    if (this->event_fd < 0) {
+        this->event_fd = eventfd(this->size > 0 ? 1 : 0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (this->event_fd < 0) {
+            fprintf(stderr, "\033[0;31m[Collection::BlockingQueue::eventfd] Error: Failed to create eventfd.\033[0m\n");
+        }
+    }
+    const int fd = this->event_fd;
+
+    monitor_unlock(&this->monitor);
+    return fd;
+#else
+    return -1;
+#endif
+}
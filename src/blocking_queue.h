@@ -0,0 +1,33 @@
+/**
+ * @file blocking_queue.h
+ * @internal
+ * @brief Blocking Queue Header
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include "collection/i_array.h"
+#include "collection/i_platform.h"
+
+/**
+ * @struct BlockingQueue
+ * @brief Bounded circular buffer implementation of IArray with blocking waits.
+ *
+ * Every operation runs under one monitor. Threads waiting for space sleep on
+ * not_full and threads waiting for data sleep on not_empty; each insertion or
+ * removal signals the opposite condition. When requested, an eventfd mirrors
+ * whether the queue is non-empty so it can be polled alongside sockets.
+ */
+struct BlockingQueue {
+    struct IArray super;            /**< IArray interface implemented by this type. */
+    const void **items;             /**< Ring buffer of item pointers. */
+    size_t head;                    /**< Ring position of the first element. */
+    size_t size;                    /**< Number of stored items. */
+    size_t capacity;                /**< Maximum number of items. */
+    int event_fd;                   /**< Readiness eventfd, or -1 until requested (Linux only). */
+    Monitor monitor;                /**< Lock protecting queue state. */
+    Condition not_empty;            /**< Signaled when an item is added. */
+    Condition not_full;             /**< Signaled when an item is removed. */
+};
@@ -0,0 +1,380 @@
+/**
+* @file cache.c
+* @internal
+* @brief CLOCK Cache Implementation
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#include "cache.h"
+#include "hash.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 16
+
+// Returns whether an entry has expired at time now.
+static bool expired(const struct CacheEntry *entry, const uint64_t now) {
+    return entry->expires_at != 0 && entry->expires_at <= now;
+}
+
+// Returns the current time if the entry can expire, so lookups of entries without a TTL never read the clock.
+static uint64_t now_if_needed(const struct CacheEntry *entry) {
+    return entry && entry->expires_at != 0 ? clock_monotonic_ns() : 0;
+}
+
+// Returns the entry holding key, or NULL.
+static struct CacheEntry *find(const struct Cache *this, const char *key, const size_t length, const uint64_t h) {
+    for (struct CacheEntry *entry = this->buckets[h & (this->capacity - 1)]; entry; entry = entry->next) {
+        if (entry->hash == h && entry->length == length && memcmp(entry->key, key, length) == 0) return entry;
+    }
+    return NULL;
+}
+
+// Doubles the bucket array once the index holds as many entries as buckets. Caller holds the exclusive lock.
+static void grow_if_needed(struct Cache *this) {
+    if (this->size < this->capacity || this->capacity > SIZE_MAX / 2 / sizeof(struct CacheEntry *)) return;
+
+    const size_t capacity = this->capacity * 2;
+    struct CacheEntry **buckets = calloc(capacity, sizeof(struct CacheEntry *));
+    if (buckets == NULL) { // Longer chains are still correct; growth is retried on a later insert.
+        fprintf(stderr, "\033[0;31m[Collection::Cache::grow] Error: Failed to allocate buckets.\033[0m\n");
+        return;
+    }
+
+    for (size_t i = 0; i < this->capacity; i++) {
+        for (struct CacheEntry *entry = this->buckets[i]; entry;) {
+            struct CacheEntry *next = entry->next;
+            struct CacheEntry **bucket = &buckets[entry->hash & (capacity - 1)];
+            entry->next = *bucket;
+            *bucket = entry;
+            entry = next;
+        }
+    }
+
+    free(this->buckets);
+    this->buckets = buckets;
+    this->capacity = capacity;
+}
+
+// Links an entry just behind the clock hand, the last position a sweep reaches.
+static void ring_insert(struct Cache *this, struct CacheEntry *entry) {
+    if (this->hand == NULL) {
+        entry->ring_prev = entry->ring_next = entry;
+        this->hand = entry;
+        return;
+    }
+    entry->ring_next = this->hand;
+    entry->ring_prev = this->hand->ring_prev;
+    this->hand->ring_prev->ring_next = entry;
+    this->hand->ring_prev = entry;
+}
+
+// Unlinks an entry from the clock ring, moving the hand past it.
+static void ring_remove(struct Cache *this, struct CacheEntry *entry) {
+    if (entry->ring_next == entry) {
+        this->hand = NULL;
+        return;
+    }
+    entry->ring_prev->ring_next = entry->ring_next;
+    entry->ring_next->ring_prev = entry->ring_prev;
+    if (this->hand == entry) this->hand = entry->ring_next;
+}
+
+// Unlinks an entry from the index and the ring and frees it. Caller holds the exclusive lock.
+static void entry_delete(struct Cache *this, struct CacheEntry *entry) {
+    struct CacheEntry **cursor = &this->buckets[entry->hash & (this->capacity - 1)];
+    while (*cursor != entry) cursor = &(*cursor)->next;
+    *cursor = entry->next;
+
+    ring_remove(this, entry);
+    this->size--;
+    this->bytes -= entry->size;
+    free(entry);
+}
+
+// Reports an entry's value to on_evict and deletes the entry. Caller holds the exclusive lock.
+static void evict(struct Cache *this, struct CacheEntry *entry) {
+    if (this->options.on_evict) this->options.on_evict(entry->key, (void *) entry->value, this->options.context);
+    entry_delete(this, entry);
+}
+
+// Advances the clock hand to the first expired or unreferenced entry other than keep and evicts it.
+static bool evict_one(struct Cache *this, const struct CacheEntry *keep, const uint64_t now) {
+    // Two full turns suffice: the first clears every reference bit it passes.
+    for (size_t visits = 2 * this->size; visits > 0 && this->hand; visits--) {
+        struct CacheEntry *entry = this->hand;
+        this->hand = entry->ring_next;
+
+        if (entry == keep) continue;
+        if (!expired(entry, now) && atomic_load_explicit(&entry->referenced, memory_order_relaxed)) {
+            atomic_store_explicit(&entry->referenced, false, memory_order_relaxed); // Second chance.
+            continue;
+        }
+
+        evict(this, entry);
+        return true;
+    }
+    return false;
+}
+
+// Returns whether the cache exceeds its entry or byte limit.
+static bool over_limit(const struct Cache *this) {
+    return (this->options.capacity && this->size > this->options.capacity) ||
+           (this->options.max_bytes && this->bytes > this->options.max_bytes);
+}
+
+// Returns the value associated with the specified key and sets its reference bit.
+static void *get(struct ICache *self, const char *key) {
+    struct Cache *this = (struct Cache *) self;
+    const size_t length = strlen(key);
+    const uint64_t h = hash_table_key(key, length, this->seed);
+
+    mutex_lock_shared(&this->mutex);
+
+    struct CacheEntry *entry = find(this, key, length, h);
+    void *value = NULL;
+    if (entry && !expired(entry, now_if_needed(entry))) {
+        // Hits only read and set a flag, so they share the lock; skip the store when already set.
+        if (!atomic_load_explicit(&entry->referenced, memory_order_relaxed)) {
+            atomic_store_explicit(&entry->referenced, true, memory_order_relaxed);
+        }
+        value = (void *) entry->value;
+    }
+
+    mutex_unlock(&this->mutex);
+    return value;
+}
+
+// Inserts or updates a key-value pair that expires after ttl_ns, then evicts until the cache is within its limits.
+static bool put_with_ttl(struct ICache *self, const char *key, const void *value, const uint64_t ttl_ns) {
+    struct Cache *this = (struct Cache *) self;
+    const size_t length = strlen(key);
+    const uint64_t h = hash_table_key(key, length, this->seed);
+    const size_t size = this->options.size_of ? this->options.size_of(value) : 0;
+    if (this->options.max_bytes && size > this->options.max_bytes) return false;
+
+    const uint64_t now = clock_monotonic_ns();
+    const uint64_t expires_at = ttl_ns == 0 ? 0 : ttl_ns > UINT64_MAX - now ? UINT64_MAX : now + ttl_ns;
+
+    mutex_lock(&this->mutex);
+
+    struct CacheEntry *entry = find(this, key, length, h);
+    if (entry) {
+        if (this->options.on_evict && entry->value != value) {
+            this->options.on_evict(entry->key, (void *) entry->value, this->options.context);
+        }
+        this->bytes = this->bytes - entry->size + size;
+    } else {
+        entry = malloc(sizeof(struct CacheEntry) + length + 1); // Key is stored in the same allocation.
+        if (entry == NULL) {
+            mutex_unlock(&this->mutex);
+            fprintf(stderr, "\033[0;31m[Collection::Cache::put] Error: Failed to allocate entry.\033[0m\n");
+            return false;
+        }
+        entry->hash = h;
+        entry->length = length;
+        memcpy(entry->key, key, length + 1);
+        atomic_init(&entry->referenced, false);
+
+        grow_if_needed(this);
+        struct CacheEntry **bucket = &this->buckets[h & (this->capacity - 1)];
+        entry->next = *bucket;
+        *bucket = entry;
+        ring_insert(this, entry);
+        this->size++;
+        this->bytes += size;
+    }
+    entry->value = value;
+    entry->size = size;
+    entry->expires_at = expires_at;
+
+    while (over_limit(this) && evict_one(this, entry, now)) {}
+
+    mutex_unlock(&this->mutex);
+    return true;
+}
+
+// Inserts or updates a key-value pair with the default time-to-live.
+static bool put(struct ICache *self, const char *key, const void *value) {
+    return put_with_ttl(self, key, value, ((struct Cache *) self)->options.ttl_ns);
+}
+
+// Returns whether an unexpired entry exists.
+static bool contains_key(const struct ICache *self, const char *key) {
+    struct Cache *this = (struct Cache *) self;
+    const size_t length = strlen(key);
+    const uint64_t h = hash_table_key(key, length, this->seed);
+
+    mutex_lock_shared(&this->mutex);
+
+    const struct CacheEntry *entry = find(this, key, length, h);
+    const bool found = entry && !expired(entry, now_if_needed(entry));
+
+    mutex_unlock(&this->mutex);
+    return found;
+}
+
+// Removes the specified entry; an expired entry is reported to on_evict instead of returned.
+static void *remove_item(struct ICache *self, const char *key) {
+    struct Cache *this = (struct Cache *) self;
+    const size_t length = strlen(key);
+    const uint64_t h = hash_table_key(key, length, this->seed);
+    void *value = NULL;
+
+    mutex_lock(&this->mutex);
+
+    struct CacheEntry *entry = find(this, key, length, h);
+    if (entry && expired(entry, now_if_needed(entry))) {
+        evict(this, entry);
+    } else if (entry) {
+        value = (void *) entry->value;
+        entry_delete(this, entry);
+    }
+
+    mutex_unlock(&this->mutex);
+    return value;
+}
+
+// Evicts every expired entry.
+static size_t purge_expired(struct ICache *self) {
+    struct Cache *this = (struct Cache *) self;
+    const uint64_t now = clock_monotonic_ns();
+    size_t purged = 0;
+
+    mutex_lock(&this->mutex);
+
+    for (size_t remaining = this->size; remaining > 0 && this->hand; remaining--) {
+        struct CacheEntry *entry = this->hand;
+        this->hand = entry->ring_next;
+        if (expired(entry, now)) {
+            evict(this, entry);
+            purged++;
+        }
+    }
+
+    mutex_unlock(&this->mutex);
+    return purged;
+}
+
+// Returns the number of entries.
+static size_t count(const struct ICache *self) {
+    struct Cache *this = (struct Cache *) self;
+    mutex_lock_shared(&this->mutex);
+
+    const size_t count = this->size;
+
+    mutex_unlock(&this->mutex);
+    return count;
+}
+
+// Returns the total size charged against max_bytes.
+static size_t bytes(const struct ICache *self) {
+    struct Cache *this = (struct Cache *) self;
+    mutex_lock_shared(&this->mutex);
+
+    const size_t bytes = this->bytes;
+
+    mutex_unlock(&this->mutex);
+    return bytes;
+}
+
+// Removes all entries.
+static void clear(struct ICache *self, void (*destructor)(void *value)) {
+    struct Cache *this = (struct Cache *) self;
+    mutex_lock(&this->mutex);
+
+    while (this->hand) {
+        struct CacheEntry *entry = this->hand;
+        ring_remove(this, entry);
+        if (destructor) destructor((void *) entry->value);
+        free(entry);
+    }
+    memset(this->buckets, 0, this->capacity * sizeof(struct CacheEntry *));
+    this->size = 0;
+    this->bytes = 0;
+
+    mutex_unlock(&this->mutex);
+}
+
+// Releases a Cache instance and its entries.
+static void dealloc(struct ICache *self, void (*destructor)(void *value)) {
+    struct Cache *this = (struct Cache *) self;
+
+    clear(self, destructor);
+    mutex_destroy(&this->mutex);
+
+    free(this->buckets);
+    free(this);
+}
+
+// Returns the aligned allocation size for Cache.
+static size_t size(void) {
+    return (sizeof(struct Cache) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u);
+}
+
+// Allocates a Cache instance.
+static struct ICache *alloc() {
+    struct ICache *cache = malloc(size());
+
+    if (cache == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Cache::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return cache;
+}
+
+// Initializes a Cache instance, sizing the index for the entry limit when there is one.
+static struct ICache *init(struct ICache *cache, const struct CollectionCacheOptions *options) {
+    if (cache == NULL) return NULL;
+
+    struct Cache *this = (struct Cache *) cache;
+    memset(this, 0, sizeof(struct Cache));
+
+    if (options) this->options = *options;
+    this->capacity = INITIAL_CAPACITY;
+    while (this->capacity < this->options.capacity && this->capacity <= SIZE_MAX / 2 / sizeof(struct CacheEntry *)) {
+        this->capacity <<= 1;
+    }
+    this->seed = hash_seed();
+
+    this->buckets = calloc(this->capacity, sizeof(struct CacheEntry *));
+    if (this->buckets == NULL) goto exception;
+
+    if (mutex_init(&this->mutex) != 0) goto exception;
+    mutex_set_name(&this->mutex, "Collection::Cache");
+
+    this->super.get = get;
+    this->super.put = put;
+    this->super.put_with_ttl = put_with_ttl;
+    this->super.contains_key = contains_key;
+    this->super.remove_item = remove_item;
+    this->super.purge_expired = purge_expired;
+    this->super.count = count;
+    this->super.bytes = bytes;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return cache;
+
+exception:
+    free(this->buckets);
+    free(cache);
+    return NULL;
+}
+
+// Creates a new CLOCK cache instance.
+struct ICache *collection_cache_new(const struct CollectionCacheOptions *options) {
+    return init(alloc(), options);
+}
+
+// Deallocates a cache and clears the caller's pointer.
+void collection_cache_dealloc(struct ICache **cache, void (*destructor)(void *value)) {
+    if (cache == NULL || *cache == NULL) return;
+
+    (*cache)->dealloc(*cache, destructor);
+    *cache = NULL;
+}
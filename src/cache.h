@@ -0,0 +1,52 @@
+/**
+* @file cache.h
+* @internal
+* @brief CLOCK Cache Header
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#pragma once
+
+#include "collection/i_cache.h"
+#include "collection/i_platform.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+/**
+ * @struct CacheEntry
+ * @brief Cache entry, linked into a hash bucket chain and the clock ring, with its key stored inline.
+ */
+struct CacheEntry {
+    struct CacheEntry *next;            /**< Next entry in the same bucket. */
+    struct CacheEntry *ring_prev;       /**< Previous entry in the clock ring. */
+    struct CacheEntry *ring_next;       /**< Next entry in the clock ring. */
+    const void *value;                  /**< Stored value. */
+    uint64_t hash;                      /**< Cached hash of the key. */
+    uint64_t expires_at;                /**< clock_monotonic_ns() deadline, or 0 if the entry never expires. */
+    size_t size;                        /**< Bytes charged against max_bytes. */
+    size_t length;                      /**< Key length in bytes, excluding the terminator. */
+    atomic_bool referenced;             /**< Set by hits under the shared lock; cleared by the clock hand. */
+    char key[];                         /**< Null-terminated key bytes. */
+};
+
+/**
+ * @struct Cache
+ * @brief ICache implemented as a chained hash index over entries that also form a CLOCK ring.
+ *
+ * New entries join the ring just behind the hand, so a full sweep reaches
+ * them last. Eviction advances the hand, giving referenced entries a second
+ * chance and dropping the first expired or unreferenced one.
+ */
+struct Cache {
+    struct ICache super;                /**< ICache interface implemented by this type. */
+    struct CacheEntry **buckets;        /**< Bucket array, a power of two in length. */
+    size_t capacity;                    /**< Number of buckets. */
+    size_t size;                        /**< Number of entries. */
+    size_t bytes;                       /**< Sum of entry sizes. */
+    struct CacheEntry *hand;            /**< Next entry the clock hand examines, or NULL when empty. */
+    uint64_t seed;                      /**< Per-instance hash seed. */
+    struct CollectionCacheOptions options; /**< Copy of the caller's limits and callbacks. */
+    Mutex mutex;                        /**< Shared for lookups, exclusive for writes and eviction. */
+};
@@ -0,0 +1,40 @@
+/**
+ * @file compiler.h
+ * @internal
+ * @brief Compiler portability helpers shared by the implementations.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+/**
+ * @brief Declares a variable with thread storage duration.
+ */
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+/**
+ * @brief Assumed cache line size, used to keep independently written fields on separate lines.
+ */
+#define CACHE_LINE_SIZE 64
+
+/**
+ * @brief Hints the processor to start loading the cache line holding address. Never faults, even on NULL.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define PREFETCH(address) _mm_prefetch((const char *) (address), _MM_HINT_T0)
+#else
+#define PREFETCH(address) ((void) (address))
+#endif
+
+/**
+ * @brief How many keys ahead batch operations prefetch, enough to overlap several cache misses.
+ */
+#define PREFETCH_DISTANCE 8
@@ -0,0 +1,364 @@
+/**
+ * @file deque.c
+ * @internal
+ * @brief Deque Implementation
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "deque.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 16
+
+// Returns the ring slot of the element at the given logical index.
+static size_t slot(const struct Deque *this, const size_t index) {
+    return (this->head + index) & (this->capacity - 1);
+}
+
+// Copies the elements in logical order into dst.
+static void copy_ordered(const struct Deque *this, const void **dst) {
+    const size_t first = this->capacity - this->head < this->size ? this->capacity - this->head : this->size;
+    if (first > 0) memcpy(dst, this->items + this->head, first * sizeof(void *));
+    if (this->size > first) memcpy(dst + first, this->items, (this->size - first) * sizeof(void *));
+}
+
+// Makes room for one more item, doubling the ring when full. Caller holds the exclusive lock.
+static bool grow(struct Deque *this) {
+    if (this->size < this->capacity) return true;
+
+    const size_t capacity = this->capacity ? this->capacity * 2 : INITIAL_CAPACITY;
+    const void **items = capacity <= SIZE_MAX / sizeof(void *) ? malloc(capacity * sizeof(void *)) : NULL;
+    if (items == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Deque::grow] Error: Failed to allocate ring buffer.\033[0m\n");
+        return false;
+    }
+
+    copy_ordered(this, items); // Unwrap so the elements start at slot 0.
+    free(this->items);
+
+    this->items = items;
+    this->head = 0;
+    this->capacity = capacity;
+    return true;
+}
+
+// Returns the element at the specified index, or NULL if out of range.
+static const void *get(const struct IArray *self, const size_t index) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock_shared(&this->mutex);
+
+    const void *item = index < this->size ? this->items[slot(this, index)] : NULL;
+
+    mutex_unlock(&this->mutex);
+    return item;
+}
+
+// Replaces the element at the specified index.
+static void *put(struct IArray *self, const void *item, const size_t index) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock(&this->mutex);
+
+    void *temp = NULL;
+    if (index < this->size) {
+        const size_t i = slot(this, index);
+        temp = (void *) this->items[i];
+        this->items[i] = item;
+    }
+
+    mutex_unlock(&this->mutex);
+    return temp;
+}
+
+// Invokes a callback for each element.
+static void for_each(const struct IArray *self, void (*consumer)(const void *element, const void *data), const void *data) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock_shared(&this->mutex);
+
+    for (size_t i = 0; i < this->size; i++) {
+        consumer(this->items[slot(this, i)], data);
+    }
+
+    mutex_unlock(&this->mutex);
+}
+
+// Finds the first element matching a predicate.
+static const void *find(const struct IArray *self, bool (*predicate)(const void *element, const void *data), const void *data) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock_shared(&this->mutex);
+
+    const void *item = NULL;
+    for (size_t i = 0; i < this->size; i++) {
+        const void *element = this->items[slot(this, i)];
+        if (predicate(element, data)) {
+            item = element;
+            break;
+        }
+    }
+
+    mutex_unlock(&this->mutex);
+    return item;
+}
+
+// Returns the index of the first matching element.
+static size_t first_index(const struct IArray *self, bool (*predicate)(const void *element, const void *data), const void *data) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock_shared(&this->mutex);
+
+    size_t index = (size_t) -1; // No matching element found.
+    for (size_t i = 0; i < this->size; i++) {
+        if (predicate(this->items[slot(this, i)], data)) {
+            index = i;
+            break;
+        }
+    }
+
+    mutex_unlock(&this->mutex);
+    return index;
+}
+
+// Returns the index of the last matching element.
+static size_t last_index(const struct IArray *self, bool (*predicate)(const void *element, const void *data), const void *data) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock_shared(&this->mutex);
+
+    size_t index = (size_t) -1;
+    for (size_t i = this->size; i > 0; i--) { // Scan backwards and stop at the first match.
+        if (predicate(this->items[slot(this, i - 1)], data)) {
+            index = i - 1;
+            break;
+        }
+    }
+
+    mutex_unlock(&this->mutex);
+    return index;
+}
+
+// Inserts an element at the beginning of the array.
+static const void *unshift(struct IArray *self, const void *item) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock(&this->mutex);
+
+    if (!grow(this)) {
+        mutex_unlock(&this->mutex);
+        return NULL;
+    }
+
+    this->head = (this->head - 1) & (this->capacity - 1);
+    this->items[this->head] = item;
+    this->size++;
+
+    mutex_unlock(&this->mutex);
+    return item;
+}
+
+// Appends an element to the end of the array.
+static bool push(struct IArray *self, const void *item) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock(&this->mutex);
+
+    const bool success = grow(this);
+    if (success) {
+        this->items[slot(this, this->size)] = item;
+        this->size++;
+    }
+
+    mutex_unlock(&this->mutex);
+    return success;
+}
+
+// Returns whether the array contains the specified element.
+static bool contains_value(const struct IArray *self, const void *item) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock_shared(&this->mutex);
+
+    bool found = false;
+    for (size_t i = 0; i < this->size; i++) {
+        if (this->items[slot(this, i)] == item) {
+            found = true;
+            break;
+        }
+    }
+
+    mutex_unlock(&this->mutex);
+    return found;
+}
+
+// Removes and returns the first element.
+static const void *shift(struct IArray *self) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock(&this->mutex);
+
+    const void *item = NULL;
+    if (this->size > 0) {
+        item = this->items[this->head];
+        this->head = (this->head + 1) & (this->capacity - 1);
+        this->size--;
+    }
+
+    mutex_unlock(&this->mutex);
+    return item;
+}
+
+// Removes and returns the last element.
+static const void *pop(struct IArray *self) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock(&this->mutex);
+
+    const void *item = NULL;
+    if (this->size > 0) {
+        this->size--;
+        item = this->items[slot(this, this->size)];
+    }
+
+    mutex_unlock(&this->mutex);
+    return item;
+}
+
+// Removes the specified element, closing the gap from whichever end is nearer.
+static void *remove_item(struct IArray *self, const void *item) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock(&this->mutex);
+
+    void *data = NULL;
+    for (size_t i = 0; i < this->size; i++) {
+        if (this->items[slot(this, i)] != item) continue;
+
+        data = (void *) item;
+        if (i < this->size / 2) {
+            for (size_t j = i; j > 0; j--) this->items[slot(this, j)] = this->items[slot(this, j - 1)];
+            this->head = (this->head + 1) & (this->capacity - 1);
+        } else {
+            for (size_t j = i; j + 1 < this->size; j++) this->items[slot(this, j)] = this->items[slot(this, j + 1)];
+        }
+        this->size--;
+        break;
+    }
+
+    mutex_unlock(&this->mutex);
+    return data;
+}
+
+// Creates a shallow copy of the array.
+static struct IArray *deque_clone(const struct IArray *self) {
+    struct Deque *this = (struct Deque *) self;
+
+    struct IArray *arr = collection_array_new_deque(); // Create a new array container
+    if (arr == NULL) return NULL;
+    struct Deque *copy = (struct Deque *) arr;
+
+    mutex_lock_shared(&this->mutex); // Acquire read lock
+
+    if (this->capacity > 0) {
+        copy->items = malloc(this->capacity * sizeof(void *));
+        if (copy->items == NULL) {
+            mutex_unlock(&this->mutex);
+            fprintf(stderr, "\033[0;31m[Collection::Deque::clone] Error: Failed to allocate ring buffer.\033[0m\n");
+            collection_array_dealloc(&arr, NULL);
+            return NULL;
+        }
+        copy_ordered(this, copy->items); // Shallow copy item pointers
+        copy->capacity = this->capacity;
+        copy->size = this->size;
+    }
+
+    mutex_unlock(&this->mutex);
+    return arr;
+}
+
+// Returns the number of elements.
+static size_t count(const struct IArray *self) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock_shared(&this->mutex);
+
+    const size_t count = this->size;
+
+    mutex_unlock(&this->mutex);
+    return count;
+}
+
+// Removes all elements from the array, keeping the ring allocated.
+static void clear(struct IArray *self, void (*destructor)(void *item)) {
+    struct Deque *this = (struct Deque *) self;
+    mutex_lock(&this->mutex);
+
+    if (destructor) {
+        for (size_t i = 0; i < this->size; i++) destructor((void *) this->items[slot(this, i)]);
+    }
+    this->head = 0;
+    this->size = 0;
+
+    mutex_unlock(&this->mutex);
+}
+
+// Releases a Deque instance and its ring.
+static void dealloc(struct IArray *self, void (*destructor)(void *item)) {
+    struct Deque *this = (struct Deque *) self;
+
+    clear(self, destructor);
+    mutex_destroy(&this->mutex);
+
+    free(this->items);
+    free(this);
+}
+
+// Returns the aligned allocation size for Deque.
+static size_t size(void) {
+    return (sizeof(struct Deque) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u); // Align to pointer size.
+}
+
+// Allocates a Deque instance.
+static struct IArray *alloc() {
+    struct IArray *array = malloc(size());
+
+    if (array == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Deque::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return array;
+}
+
+// Initializes a Deque instance.
+static struct IArray *init(struct IArray *array) {
+    if (array == NULL) return NULL;
+
+    struct Deque *this = (struct Deque *) array;
+    memset(this, 0, sizeof(struct Deque));
+
+    if (mutex_init(&this->mutex) != 0) goto exception;
+    mutex_set_name(&this->mutex, "Collection::Deque");
+
+    this->items = NULL; // Allocated lazily on first insert.
+    this->super.get = get;
+    this->super.put = put;
+    this->super.for_each = for_each;
+    this->super.find = find;
+    this->super.first_index = first_index;
+    this->super.last_index = last_index;
+    this->super.unshift = unshift;
+    this->super.push = push;
+    this->super.contains_value = contains_value;
+    this->super.shift = shift;
+    this->super.pop = pop;
+    this->super.remove_item = remove_item;
+    this->super.clone = deque_clone;
+    this->super.count = count;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return array;
+
+exception:
+    free(array);
+    return NULL;
+}
+
+// Creates a new deque-backed array instance.
+struct IArray *collection_array_new_deque(void) {
+    return init(alloc());
+}
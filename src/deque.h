@@ -0,0 +1,30 @@
+/**
+ * @file deque.h
+ * @internal
+ * @brief Deque Header
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include "collection/i_array.h"
+#include "collection/i_platform.h"
+
+/**
+ * @struct Deque
+ * @brief Circular buffer implementation of IArray.
+ *
+ * Stores item pointers in a power-of-two ring so both ends can be updated in
+ * O(1) without moving other elements. The ring doubles when full and never
+ * shrinks, so a queue in steady state does not allocate. Access is
+ * synchronized with a mutex.
+ */
+struct Deque {
+    struct IArray super;            /**< IArray interface implemented by this type. */
+    const void **items;             /**< Ring buffer of item pointers. */
+    size_t head;                    /**< Ring position of the first element. */
+    size_t size;                    /**< Number of stored items. */
+    size_t capacity;                /**< Number of ring slots, a power of two (0 until first insert). */
+    Mutex mutex;                    /**< Mutex protecting deque operations. */
+};
@@ -7,118 +7,383 @@
 * @copyright BSD 3-Clause License
 */
 #include "dictionary.h"
+#include "compiler.h"
+#include "hash.h"
+#include "node_pool.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
-#ifdef _WIN32
-#define strdup _strdup
-#endif
-
 #define INITIAL_CAPACITY 16
+#define REHASH_STEP 4           // Buckets migrated per write operation while rehashing.
+#define REHASH_EMPTY_VISITS 10  // Empty buckets skipped per migrated bucket before a step gives up.
+#define SHRINK_RATIO 8          // Shrink once fewer than capacity / SHRINK_RATIO entries remain.
+
+static struct NodePool node_pool = NODE_POOL_INIT(NODE_POOL_DICTIONARY_NODE, sizeof(struct DictionaryNode) + DICTIONARY_INLINE_KEY + 1);
+static struct NodePool ref_node_pool = NODE_POOL_INIT(NODE_POOL_DICTIONARY_REF_NODE, sizeof(struct DictionaryNode));
+
+// Allocates a node for a key in one block: the key bytes go into the node unless they are borrowed, interned, or copied by a callback.
+static struct DictionaryNode *node_new(const struct Dictionary *this, const char *key, const size_t length,
+                                       const uint64_t hash, const void *value) {
+    const bool custom_copy = this->key_mode == DICTIONARY_KEY_CUSTOM && this->key_ops->copy;
+    const bool copy = this->key_mode == DICTIONARY_KEY_COPY || (this->key_mode == DICTIONARY_KEY_CUSTOM && !custom_copy);
+
+    const char *owned = NULL;
+    if (custom_copy && (owned = this->key_ops->copy(key, length)) == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Dictionary::put] Error: Key copy callback failed.\033[0m\n");
+        return NULL;
+    }
 
-// Computes the hash value for a string key.
-static unsigned long hash(const char *str) {
-    unsigned long hash = 5381;
-    while (*str) {
-        hash = (hash << 5) + hash + (unsigned char)*str++;
+    struct DictionaryNode *node;
+    if (!copy) {
+        node = node_pool_alloc(&ref_node_pool);
+    } else if (length <= DICTIONARY_INLINE_KEY) {
+        node = node_pool_alloc(&node_pool);
+    } else {
+        node = malloc(sizeof(struct DictionaryNode) + length + 1);
+    }
+    if (node == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Dictionary::put] Error: Failed to allocate DictionaryNode.\033[0m\n");
+        if (owned && this->key_ops->free) this->key_ops->free((void *) owned);
+        return NULL;
     }
-    return hash;
+
+    node->next = NULL;
+    node->value = value;
+    node->hash = hash;
+    node->length = length;
+    if (copy) {
+        memcpy(node->bytes, key, length); // Own a copy of the key because the caller may release or mutate its string.
+        node->bytes[length] = '\0';
+        node->key = node->bytes;
+    } else {
+        node->key = owned ? owned : key;
+    }
+    return node;
 }
 
-// Returns the value associated with the specified key.
-static void *get(const struct IDictionary *self, const char *key) {
-    struct Dictionary *this = (struct Dictionary *) self;
+// Releases a node to wherever node_new() took it from, and a key copied by a callback.
+static void node_free(const struct Dictionary *this, struct DictionaryNode *node) {
+    if (node->key != node->bytes) {
+        if (this->key_mode == DICTIONARY_KEY_CUSTOM && this->key_ops->copy && this->key_ops->free) {
+            this->key_ops->free((void *) node->key);
+        }
+        node_pool_free(&ref_node_pool, node);
+    } else if (node->length <= DICTIONARY_INLINE_KEY) {
+        node_pool_free(&node_pool, node);
+    } else {
+        free(node);
+    }
+}
 
-    mutex_lock_shared(&this->mutex);
+// Returns the smallest power of two greater than or equal to n.
+static size_t round_up_pow2(size_t n) {
+    size_t capacity = INITIAL_CAPACITY;
+    while (capacity < n && capacity <= SIZE_MAX / 2) capacity <<= 1;
+    return capacity;
+}
 
-    const unsigned long index = hash(key) % this->capacity;
-    void *value = NULL;
+// Returns whether an incremental rehash is in progress.
+static bool is_rehashing(const struct Dictionary *this) {
+    return this->rehash_index != SIZE_MAX;
+}
+
+// Returns whether a node holds the key: by address and length first, then by cached hash and length before the bytes.
+static bool matches(const struct Dictionary *this, const struct DictionaryNode *node,
+                    const char *key, const size_t length, const uint64_t h) {
+    if (node->key == key && node->length == length) return true; // A borrowed key's prefix shares its address.
+    if (node->hash != h) return false;
+    if (this->key_mode == DICTIONARY_KEY_CUSTOM && this->key_ops->equals) {
+        return this->key_ops->equals(node->key, node->length, key, length);
+    }
+    return node->length == length && memcmp(node->key, key, length) == 0;
+}
+
+// Returns the node holding key in the given table, or NULL.
+static struct DictionaryNode *table_find(const struct Dictionary *this, const struct DictionaryTable *table,
+                                         const char *key, const size_t length, const uint64_t h) {
+    if (table->capacity == 0) return NULL;
+    for (struct DictionaryNode *cursor = table->buckets[h & (table->capacity - 1)]; cursor; cursor = cursor->next) {
+        if (matches(this, cursor, key, length, h)) return cursor;
+    }
+    return NULL;
+}
+
+// Returns the node holding key in either table, or NULL.
+static struct DictionaryNode *find(const struct Dictionary *this, const char *key, const size_t length, const uint64_t h) {
+    struct DictionaryNode *node = table_find(this, &this->tables[0], key, length, h);
+    if (node == NULL && is_rehashing(this)) node = table_find(this, &this->tables[1], key, length, h);
+    return node;
+}
+
+// Moves every node of tables[0] bucket `index` into tables[1], preserving their relative order.
+static void migrate_bucket(struct Dictionary *this, const size_t index) {
+    struct DictionaryTable *target = &this->tables[1];
+
+    // Reverse the chain, then push each node onto the head of its target bucket. Nodes already in
+    // the target bucket were inserted during the rehash and are newer, so they stay behind.
+    struct DictionaryNode *reversed = NULL;
+    for (struct DictionaryNode *cursor = this->tables[0].buckets[index]; cursor;) {
+        struct DictionaryNode *next = cursor->next;
+        cursor->next = reversed;
+        reversed = cursor;
+        cursor = next;
+    }
+
+    while (reversed) {
+        struct DictionaryNode *node = reversed;
+        reversed = reversed->next;
+
+        const size_t slot = node->hash & (target->capacity - 1);
+        node->next = target->buckets[slot];
+        target->buckets[slot] = node;
+    }
+
+    this->tables[0].buckets[index] = NULL;
+}
+
+// Migrates up to `steps` non-empty buckets and promotes tables[1] once tables[0] is drained.
+static void rehash_step(struct Dictionary *this, size_t steps) {
+    if (!is_rehashing(this)) return;
+
+    size_t empty_visits = steps * REHASH_EMPTY_VISITS;
+    while (steps > 0 && this->rehash_index < this->tables[0].capacity) {
+        if (this->tables[0].buckets[this->rehash_index] == NULL) {
+            this->rehash_index++;
+            if (--empty_visits == 0) return; // Bound the work done on sparse tables.
+            continue;
+        }
+        migrate_bucket(this, this->rehash_index++);
+        steps--;
+    }
+
+    if (this->rehash_index >= this->tables[0].capacity) {
+        free(this->tables[0].buckets);
+        this->tables[0] = this->tables[1];
+        this->tables[1] = (struct DictionaryTable) {NULL, 0};
+        this->rehash_index = SIZE_MAX;
+    }
+}
 
-    for (const struct DictionaryNode *cursor = this->buckets[index]; cursor; cursor = cursor->next) {
-        if (strcmp(cursor->key, key) == 0) {
-            value = (void *) cursor->value; // Found value
-            break;
+// Starts an incremental rehash into a table with the given number of buckets.
+static void rehash_begin(struct Dictionary *this, const size_t capacity) {
+    if (is_rehashing(this) || capacity == this->tables[0].capacity) return;
+
+    struct DictionaryNode **buckets = calloc(capacity, sizeof(struct DictionaryNode *));
+    if (buckets == NULL) { // Keep operating on the current table; the resize is retried on a later write.
+        fprintf(stderr, "\033[0;31m[Collection::Dictionary::rehash] Error: Failed to allocate buckets.\033[0m\n");
+        return;
+    }
+
+    this->tables[1] = (struct DictionaryTable) {buckets, capacity};
+    this->rehash_index = 0;
+}
+
+// Grows or shrinks the table when the load factor leaves its bounds, then advances any running rehash.
+static void rehash_if_needed(struct Dictionary *this) {
+    if (!is_rehashing(this)) {
+        const size_t capacity = this->tables[0].capacity;
+        if (this->size >= capacity && capacity <= SIZE_MAX / 2) {
+            rehash_begin(this, capacity * 2);
+        } else if (capacity > this->min_capacity && this->size < capacity / SHRINK_RATIO) {
+            const size_t target = round_up_pow2(this->size * 2);
+            rehash_begin(this, target > this->min_capacity ? target : this->min_capacity);
         }
     }
+    rehash_step(this, REHASH_STEP);
+}
+
+// Returns the value associated with the specified key.
+void *dictionary_get_hashed(struct Dictionary *this, const char *key, const size_t length, const uint64_t hash) {
+    mutex_lock_shared(&this->mutex);
+
+    const struct DictionaryNode *node = find(this, key, length, hash);
+    void *value = node ? (void *) node->value : NULL;
 
     mutex_unlock(&this->mutex);
     return value;
 }
 
-// Inserts a new key-value pair.
-static bool put(struct IDictionary *self, const char *key, const void *value) {
-    struct Dictionary *this = (struct Dictionary *) self;
-    bool added = false;
+// Returns the key to store for an insert, interned in DICTIONARY_KEY_INTERN mode. NULL if interning fails.
+static const char *storable_key(const struct Dictionary *this, const char *key) {
+    if (this->key_mode != DICTIONARY_KEY_INTERN) return key;
+    return this->intern_pool->intern(this->intern_pool, key); // Called before locking; the pool has its own lock.
+}
 
-    mutex_lock(&this->mutex);
+// Points a node built from the caller's key at the pool's copy in DICTIONARY_KEY_INTERN mode. Conditional inserts
+// call this only once the node will be linked, so finding the key or declining the insert never grows the
+// append-only pool. Caller holds the exclusive lock; the pool's lock nests inside it and never the other way round.
+static bool intern_node_key(const struct Dictionary *this, struct DictionaryNode *node) {
+    if (this->key_mode != DICTIONARY_KEY_INTERN) return true;
+    const char *interned = this->intern_pool->intern(this->intern_pool, node->key);
+    if (interned) node->key = interned;
+    return interned != NULL;
+}
 
-    const unsigned long index = hash(key) % this->capacity;
-    struct DictionaryNode *node = malloc(sizeof(struct DictionaryNode));
-    if (node == NULL) {
-        fprintf(stderr, "\033[0;31m[Collection::Dictionary::put] Error: Failed to allocate DictionaryNode.\033[0m\n");
-        goto out_unlock;
-    }
+// Appends a node to the end of its bucket chain. Caller holds the exclusive lock.
+static void link_locked(struct Dictionary *this, struct DictionaryNode *node) {
+    rehash_if_needed(this);
 
-    node->key = strdup(key); // Own a copy of the key because the caller may release or mutate its string.
-    if (node->key == NULL) {
-        fprintf(stderr, "\033[0;31m[Collection::Dictionary::put] Error: Failed to allocate DictionaryNode key.\033[0m\n");
-        free(node);
-        goto out_unlock;
-    }
-    node->value = value;
-    node->next = NULL;
-    this->size++;
+    // New nodes go to the migration target while rehashing.
+    struct DictionaryTable *table = &this->tables[is_rehashing(this) ? 1 : 0];
+    const size_t index = node->hash & (table->capacity - 1);
 
     // Append new DictionaryNode to bucket's linked list
     struct DictionaryNode **cursor;
-    for(cursor = &this->buckets[index]; *cursor; cursor = &(*cursor)->next) {}
+    for(cursor = &table->buckets[index]; *cursor; cursor = &(*cursor)->next) {}
     *cursor = node;
-    added = true;
+    this->size++;
+}
+
+// Inserts a new key-value pair.
+bool dictionary_put_hashed(struct Dictionary *this, const char *key, const size_t length, const uint64_t hash, const void *value) {
+    if ((key = storable_key(this, key)) == NULL) return false;
+
+    mutex_lock(&this->mutex);
+
+    struct DictionaryNode *node = node_new(this, key, length, hash, value);
+    if (node) link_locked(this, node);
 
-out_unlock:
     mutex_unlock(&this->mutex);
-    return added;
+    return node != NULL;
 }
 
-// Returns whether the specified key exists.
-static bool contains_key(const struct IDictionary *self, const char *key) {
-    struct Dictionary *this = (struct Dictionary *) self;
-    bool found = false;
+// Inserts a key-value pair only if the key is absent.
+bool dictionary_put_if_absent_hashed(struct Dictionary *this, const char *key, const size_t length, const uint64_t hash,
+                                     const void *value) {
+    mutex_lock(&this->mutex);
 
-    mutex_lock_shared(&this->mutex);
+    struct DictionaryNode *node = NULL;
+    if (find(this, key, length, hash) == NULL && (node = node_new(this, key, length, hash, value)) != NULL) {
+        if (intern_node_key(this, node)) {
+            link_locked(this, node);
+        } else {
+            node_free(this, node);
+            node = NULL;
+        }
+    }
+
+    mutex_unlock(&this->mutex);
+    return node != NULL;
+}
+
+// Updates the value of an existing key or inserts the pair, returning the previous value.
+void *dictionary_upsert_hashed(struct Dictionary *this, const char *key, const size_t length, const uint64_t hash,
+                               const void *value) {
+    mutex_lock(&this->mutex);
+
+    void *previous = NULL;
+    struct DictionaryNode *node = find(this, key, length, hash);
+    if (node) {
+        previous = (void *) node->value;
+        node->value = value;
+        rehash_step(this, REHASH_STEP);
+    } else if ((node = node_new(this, key, length, hash, value)) != NULL) {
+        if (intern_node_key(this, node)) link_locked(this, node);
+        else node_free(this, node);
+    }
 
-    const unsigned long index = hash(key) % this->capacity;
-    for (const struct DictionaryNode *cursor = this->buckets[index]; cursor; cursor = cursor->next) {
-        if (strcmp(cursor->key, key) == 0) {
-            found = true;
-            break;
+    mutex_unlock(&this->mutex);
+    return previous;
+}
+
+// Returns the value of a key, inserting the value produced by factory if the key is absent.
+void *dictionary_get_or_insert_with_hashed(struct Dictionary *this, const char *key, const size_t length, const uint64_t hash,
+                                           void *(*factory)(const char *key, void *context), void *context) {
+    mutex_lock(&this->mutex);
+
+    const void *value = NULL;
+    struct DictionaryNode *node = find(this, key, length, hash);
+    if (node) {
+        value = node->value;
+    } else if ((node = node_new(this, key, length, hash, NULL)) != NULL) { // Allocate first so a created value is rarely dropped.
+        value = factory(node->key, context);
+        if (value && intern_node_key(this, node)) {
+            node->value = value;
+            link_locked(this, node);
+        } else {
+            node_free(this, node);
+            value = NULL;
         }
     }
 
     mutex_unlock(&this->mutex);
+    return (void *) value;
+}
+
+// Returns whether the specified key exists.
+bool dictionary_contains_key_hashed(struct Dictionary *this, const char *key, const size_t length, const uint64_t hash) {
+    mutex_lock_shared(&this->mutex);
+    const bool found = find(this, key, length, hash) != NULL;
+    mutex_unlock(&this->mutex);
+
     return found;
 }
 
+// Unlinks and frees the node holding key in the given table, returning its value.
+static bool table_remove(const struct Dictionary *this, struct DictionaryTable *table,
+                         const char *key, const size_t length, const uint64_t h, void **value) {
+    if (table->capacity == 0) return false;
+
+    for (struct DictionaryNode **cursor = &table->buckets[h & (table->capacity - 1)]; *cursor; cursor = &(*cursor)->next) {
+        struct DictionaryNode *node = *cursor;
+        if (matches(this, node, key, length, h)) {
+            *cursor = node->next;       // Remove DictionaryNode
+            *value = (void *) node->value;
+            node_free(this, node);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Removes a key and returns whether it was present. Caller holds the exclusive lock.
+static bool remove_locked(struct Dictionary *this, const char *key, const size_t length, const uint64_t hash, void **value) {
+    if (table_remove(this, &this->tables[0], key, length, hash, value) ||
+        (is_rehashing(this) && table_remove(this, &this->tables[1], key, length, hash, value))) {
+        this->size--;
+        rehash_if_needed(this);
+        return true;
+    }
+    return false;
+}
+
 // Removes the specified key-value pair.
-void *remove_item(struct IDictionary *self, const char *key) {
-    struct Dictionary *this = (struct Dictionary *) self;
+void *dictionary_remove_hashed(struct Dictionary *this, const char *key, const size_t length, const uint64_t hash) {
     void *value = NULL;
 
     mutex_lock(&this->mutex);
+    remove_locked(this, key, length, hash, &value);
+    mutex_unlock(&this->mutex);
 
-    const unsigned long index = hash(key) % this->capacity;
-    for (struct DictionaryNode **cursor = &this->buckets[index]; *cursor; cursor = &(*cursor)->next) {
-        struct DictionaryNode *node = *cursor;
-        if (strcmp(node->key, key) == 0) {
-            *cursor = node->next;       // Remove DictionaryNode
-            value = (void *) node->value;
+    return value;
+}
+
+// Recomputes the value of a key under the lock; the function decides whether the key is kept, inserted or removed.
+void *dictionary_compute_hashed(struct Dictionary *this, const char *key, const size_t length, const uint64_t hash,
+                                bool (*function)(const char *key, void **value, void *context), void *context) {
+    mutex_lock(&this->mutex);
 
-            free((void *) node->key);
-            free(node);
-            this->size--;
-            break;
+    void *value = NULL;
+    struct DictionaryNode *node = find(this, key, length, hash);
+    if (node) {
+        value = (void *) node->value;
+        if (function(key, &value, context)) {
+            node->value = value;
+        } else {
+            void *removed;
+            remove_locked(this, key, length, hash, &removed);
+            value = NULL;
+        }
+    } else if ((node = node_new(this, key, length, hash, NULL)) != NULL) { // Allocate first so a computed value is rarely dropped.
+        if (function(key, &value, context) && intern_node_key(this, node)) {
+            node->value = value;
+            link_locked(this, node);
+        } else {
+            node_free(this, node);
+            value = NULL;
         }
     }
 
@@ -127,47 +392,276 @@ void *remove_item(struct IDictionary *self, const char *key) {
 }
 
 // Replaces the value associated with the specified key.
-static void *replace(const struct IDictionary *self, const char *key, const void *value) {
-    struct Dictionary *this = (struct Dictionary *) self;
+void *dictionary_replace_hashed(struct Dictionary *this, const char *key, const size_t length, const uint64_t hash, const void *value) {
     void *temp = NULL;
 
     mutex_lock(&this->mutex);
 
-    const unsigned long index = hash(key) % this->capacity;
-    for (struct DictionaryNode *cursor = this->buckets[index]; cursor; cursor = cursor->next) {
-        if (strcmp(cursor->key, key) == 0) {
-            temp = (void *) cursor->value;
-            cursor->value = value;
-            break;
-        }
+    struct DictionaryNode *node = find(this, key, length, hash);
+    if (node) {
+        temp = (void *) node->value;
+        node->value = value;
     }
+    rehash_step(this, REHASH_STEP);
 
     mutex_unlock(&this->mutex);
     return temp;
 }
 
-// Removes all key-value pairs from the dictionary.
-static bool clear(const struct IDictionary *self, void (*destructor)(void *value)) {
-    struct Dictionary *this = (struct Dictionary *) self;
+// Prefetches the bucket slots a hash maps to. Caller holds the lock.
+static void prefetch_bucket(const struct Dictionary *this, const uint64_t h) {
+    const struct DictionaryTable *table = &this->tables[0];
+    if (table->capacity) PREFETCH(&table->buckets[h & (table->capacity - 1)]);
+    if (is_rehashing(this)) PREFETCH(&this->tables[1].buckets[h & (this->tables[1].capacity - 1)]);
+}
+
+// Prefetches the first node of the chain a hash maps to; its bucket slot was prefetched earlier. Caller holds the lock.
+static void prefetch_chain(const struct Dictionary *this, const uint64_t h) {
+    const struct DictionaryTable *table = &this->tables[0];
+    if (table->capacity) PREFETCH(table->buckets[h & (table->capacity - 1)]);
+}
+
+// Keeps the prefetch window ahead of batch position i: bucket slots two distances ahead, chain heads one ahead.
+static void prefetch_ahead(const struct Dictionary *this, const struct HashedKey *keys, const size_t count, const size_t i) {
+    if (i == 0) {
+        for (size_t j = 0; j < count && j < 2 * PREFETCH_DISTANCE; j++) prefetch_bucket(this, keys[j].hash);
+    } else if (i + 2 * PREFETCH_DISTANCE - 1 < count) {
+        prefetch_bucket(this, keys[i + 2 * PREFETCH_DISTANCE - 1].hash);
+    }
+    if (i + PREFETCH_DISTANCE < count) prefetch_chain(this, keys[i + PREFETCH_DISTANCE].hash);
+}
+
+// Looks up a batch of keys under one shared lock.
+size_t dictionary_get_many_hashed(struct Dictionary *this, const struct HashedKey *keys, const size_t count, void **values) {
+    size_t found = 0;
+
+    mutex_lock_shared(&this->mutex);
+
+    for (size_t i = 0; i < count; i++) {
+        prefetch_ahead(this, keys, count, i);
+        const struct DictionaryNode *node = find(this, keys[i].key, keys[i].length, keys[i].hash);
+        values[keys[i].index] = node ? (void *) node->value : NULL;
+        if (node) found++;
+    }
+
+    mutex_unlock(&this->mutex);
+    return found;
+}
+
+// Inserts a batch of key-value pairs under one exclusive lock.
+size_t dictionary_put_many_hashed(struct Dictionary *this, struct HashedKey *keys, const size_t count, const void *const *values) {
+    for (size_t i = 0; i < count; i++) keys[i].key = storable_key(this, keys[i].key); // NULL marks a failed intern.
+
+    size_t stored = 0;
+
+    mutex_lock(&this->mutex);
+
+    for (size_t i = 0; i < count; i++) {
+        prefetch_ahead(this, keys, count, i);
+        if (keys[i].key == NULL) continue;
+
+        struct DictionaryNode *node = node_new(this, keys[i].key, keys[i].length, keys[i].hash, values[keys[i].index]);
+        if (node == NULL) continue;
+        link_locked(this, node);
+        stored++;
+    }
+
+    mutex_unlock(&this->mutex);
+    return stored;
+}
+
+// Removes a batch of keys under one exclusive lock.
+size_t dictionary_remove_many_hashed(struct Dictionary *this, const struct HashedKey *keys, const size_t count, void **values) {
+    size_t removed = 0;
+
     mutex_lock(&this->mutex);
 
-    for (size_t i = 0; i < this->capacity; ++i) {
-        struct DictionaryNode *current = this->buckets[i];
+    for (size_t i = 0; i < count; i++) {
+        prefetch_ahead(this, keys, count, i);
+        void *value = NULL;
+        if (remove_locked(this, keys[i].key, keys[i].length, keys[i].hash, &value)) removed++;
+        if (values) values[keys[i].index] = value;
+    }
+
+    mutex_unlock(&this->mutex);
+    return removed;
+}
+
+// Frees every node of a table and resets its buckets.
+static void table_clear(const struct Dictionary *this, struct DictionaryTable *table, void (*destructor)(void *value)) {
+    for (size_t i = 0; i < table->capacity; ++i) {
+        struct DictionaryNode *current = table->buckets[i];
         while (current != NULL) {
             struct DictionaryNode *node = current;
             current = current->next;
-            free((void *) node->key);
             if (destructor) destructor((void *) node->value);
-            free(node);
+            node_free(this, node);
+        }
+        table->buckets[i] = NULL; // Reset bucket pointer
+    }
+}
+
+// Returns the value associated with a pre-hashed key.
+static void *get_hashed(const struct IDictionary *self, const struct CollectionKey *key) {
+    struct Dictionary *this = (struct Dictionary *) self;
+    return dictionary_get_hashed(this, key->key, key->length, hash_u64(key->hash, this->seed));
+}
+
+// Inserts a pre-hashed key-value pair.
+static bool put_hashed(struct IDictionary *self, const struct CollectionKey *key, const void *value) {
+    struct Dictionary *this = (struct Dictionary *) self;
+    return dictionary_put_hashed(this, key->key, key->length, hash_u64(key->hash, this->seed), value);
+}
+
+// Returns whether a pre-hashed key exists.
+static bool contains_key_hashed(const struct IDictionary *self, const struct CollectionKey *key) {
+    struct Dictionary *this = (struct Dictionary *) self;
+    return dictionary_contains_key_hashed(this, key->key, key->length, hash_u64(key->hash, this->seed));
+}
+
+// Removes all key-value pairs. Caller holds the exclusive lock.
+void dictionary_clear_locked(struct Dictionary *this, void (*destructor)(void *value)) {
+    table_clear(this, &this->tables[0], destructor);
+    if (is_rehashing(this)) { // Abandon the migration and keep the larger table.
+        table_clear(this, &this->tables[1], destructor);
+        if (this->tables[1].capacity > this->tables[0].capacity) {
+            struct DictionaryTable temp = this->tables[0];
+            this->tables[0] = this->tables[1];
+            this->tables[1] = temp;
         }
-        this->buckets[i] = NULL; // Reset bucket pointer
+        free(this->tables[1].buckets);
+        this->tables[1] = (struct DictionaryTable) {NULL, 0};
+        this->rehash_index = SIZE_MAX;
     }
     this->size = 0;
+}
+
+// Hashes a key with the instance seed.
+static uint64_t hash_key(const struct IDictionary *self, const char *key, const size_t length) {
+    return hash_table_key(key, length, ((const struct Dictionary *) self)->seed);
+}
+
+// Returns the value associated with the specified key.
+static void *get(const struct IDictionary *self, const char *key) {
+    const size_t length = strlen(key);
+    return dictionary_get_hashed((struct Dictionary *) self, key, length, hash_key(self, key, length));
+}
+
+// Inserts a new key-value pair.
+static bool put(struct IDictionary *self, const char *key, const void *value) {
+    const size_t length = strlen(key);
+    return dictionary_put_hashed((struct Dictionary *) self, key, length, hash_key(self, key, length), value);
+}
+
+// Returns whether the specified key exists.
+static bool contains_key(const struct IDictionary *self, const char *key) {
+    const size_t length = strlen(key);
+    return dictionary_contains_key_hashed((struct Dictionary *) self, key, length, hash_key(self, key, length));
+}
+
+// Removes the specified key-value pair.
+static void *remove_item(struct IDictionary *self, const char *key) {
+    const size_t length = strlen(key);
+    return dictionary_remove_hashed((struct Dictionary *) self, key, length, hash_key(self, key, length));
+}
+
+// Replaces the value associated with the specified key.
+static void *replace(const struct IDictionary *self, const char *key, const void *value) {
+    const size_t length = strlen(key);
+    return dictionary_replace_hashed((struct Dictionary *) self, key, length, hash_key(self, key, length), value);
+}
+
+// Inserts a key-value pair only if the key is absent.
+static bool put_if_absent(struct IDictionary *self, const char *key, const void *value) {
+    const size_t length = strlen(key);
+    return dictionary_put_if_absent_hashed((struct Dictionary *) self, key, length, hash_key(self, key, length), value);
+}
+
+// Updates or inserts a key-value pair, returning the previous value.
+static void *upsert(struct IDictionary *self, const char *key, const void *value) {
+    const size_t length = strlen(key);
+    return dictionary_upsert_hashed((struct Dictionary *) self, key, length, hash_key(self, key, length), value);
+}
+
+// Returns the value of a key, inserting one from factory if it is absent.
+static void *get_or_insert_with(struct IDictionary *self, const char *key,
+                                void *(*factory)(const char *key, void *context), void *context) {
+    const size_t length = strlen(key);
+    return dictionary_get_or_insert_with_hashed((struct Dictionary *) self, key, length, hash_key(self, key, length),
+                                                factory, context);
+}
+
+// Atomically recomputes the value of a key.
+static void *compute(struct IDictionary *self, const char *key,
+                     bool (*function)(const char *key, void **value, void *context), void *context) {
+    const size_t length = strlen(key);
+    return dictionary_compute_hashed((struct Dictionary *) self, key, length, hash_key(self, key, length), function, context);
+}
+
+// Looks up a batch of keys.
+static size_t get_many(const struct IDictionary *self, const char *const *keys, const size_t count, void **values) {
+    struct HashedKey buffer[HASH_KEYS_INLINE];
+    struct HashedKey *hashed = hash_keys(keys, count, ((const struct Dictionary *) self)->seed, buffer, HASH_KEYS_INLINE);
+    if (hashed == NULL) {
+        for (size_t i = 0; i < count; i++) values[i] = NULL;
+        return 0;
+    }
+
+    const size_t found = dictionary_get_many_hashed((struct Dictionary *) self, hashed, count, values);
+    hash_keys_free(hashed, buffer);
+    return found;
+}
+
+// Inserts a batch of key-value pairs.
+static size_t put_many(struct IDictionary *self, const char *const *keys, const void *const *values, const size_t count) {
+    struct HashedKey buffer[HASH_KEYS_INLINE];
+    struct HashedKey *hashed = hash_keys(keys, count, ((const struct Dictionary *) self)->seed, buffer, HASH_KEYS_INLINE);
+    if (hashed == NULL) return 0;
+
+    const size_t stored = dictionary_put_many_hashed((struct Dictionary *) self, hashed, count, values);
+    hash_keys_free(hashed, buffer);
+    return stored;
+}
+
+// Removes a batch of keys.
+static size_t remove_many(struct IDictionary *self, const char *const *keys, const size_t count, void **values) {
+    struct HashedKey buffer[HASH_KEYS_INLINE];
+    struct HashedKey *hashed = hash_keys(keys, count, ((const struct Dictionary *) self)->seed, buffer, HASH_KEYS_INLINE);
+    if (hashed == NULL) {
+        for (size_t i = 0; values && i < count; i++) values[i] = NULL;
+        return 0;
+    }
+
+    const size_t removed = dictionary_remove_many_hashed((struct Dictionary *) self, hashed, count, values);
+    hash_keys_free(hashed, buffer);
+    return removed;
+}
+
+// Removes all key-value pairs from the dictionary.
+static bool clear(const struct IDictionary *self, void (*destructor)(void *value)) {
+    struct Dictionary *this = (struct Dictionary *) self;
+    mutex_lock(&this->mutex);
+
+    dictionary_clear_locked(this, destructor);
 
     mutex_unlock(&this->mutex);
     return true;
 }
 
+// Releases a Dictionary instance and its buckets.
+static void dealloc(struct IDictionary *self, void (*destructor)(void *value)) {
+    struct Dictionary *this = (struct Dictionary *) self;
+
+    clear(self, destructor);
+
+    free(this->tables[0].buckets);
+    this->tables[0] = (struct DictionaryTable) {NULL, 0};
+
+    mutex_destroy(&this->mutex);
+
+    free(this);
+}
+
 // Returns the aligned allocation size for Dictionary.
 static size_t size(void) {
     return (sizeof(struct Dictionary) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u);
@@ -185,52 +679,84 @@ static struct IDictionary *alloc() {
     return dictionary;
 }
 
-// Initializes a Dictionary instance.
-static struct IDictionary *init(struct IDictionary *dictionary) {
+// Initializes a Dictionary instance with at least the given number of buckets.
+static struct IDictionary *init(struct IDictionary *dictionary, const size_t capacity, const enum DictionaryKeyMode key_mode,
+                                struct IInternPool *intern_pool, const struct CollectionKeyOps *key_ops) {
     if (dictionary == NULL) return NULL;
 
     struct Dictionary *this = (struct Dictionary *) dictionary;
     memset(this, 0, sizeof(struct Dictionary));
 
-    this->capacity = INITIAL_CAPACITY;
+    this->min_capacity = round_up_pow2(capacity);
+    this->rehash_index = SIZE_MAX;
     this->size = 0;
-    this->buckets = calloc(this->capacity, sizeof(struct DictionaryNode *));
-    if (this->buckets == NULL) goto exception;
+    this->seed = hash_seed();
+    this->key_mode = key_mode;
+    this->intern_pool = intern_pool;
+    this->key_ops = key_ops;
+    this->tables[0].buckets = calloc(this->min_capacity, sizeof(struct DictionaryNode *));
+    if (this->tables[0].buckets == NULL) goto exception;
+    this->tables[0].capacity = this->min_capacity;
 
     if (mutex_init(&this->mutex) != 0) goto exception;
+    mutex_set_name(&this->mutex, "Collection::Dictionary");
 
     this->super.get = get;
     this->super.put = put;
     this->super.contains_key = contains_key;
     this->super.remove_item = remove_item;
     this->super.replace = replace;
+    this->super.put_if_absent = put_if_absent;
+    this->super.upsert = upsert;
+    this->super.get_or_insert_with = get_or_insert_with;
+    this->super.compute = compute;
+    this->super.get_many = get_many;
+    this->super.put_many = put_many;
+    this->super.remove_many = remove_many;
+    this->super.get_hashed = get_hashed;
+    this->super.put_hashed = put_hashed;
+    this->super.contains_key_hashed = contains_key_hashed;
     this->super.clear = clear;
+    this->super.dealloc = dealloc;
 
     return dictionary;
 
 exception:
-    collection_dictionary_dealloc(&dictionary, NULL);
+    free(this->tables[0].buckets);
+    free(dictionary);
     return NULL;
 }
 
 // Creates a new dictionary instance.
 struct IDictionary *collection_dictionary_new(void) {
-    return init(alloc());
+    return init(alloc(), INITIAL_CAPACITY, DICTIONARY_KEY_COPY, NULL, NULL);
 }
 
-// Destroys a dictionary instance. (Optional destructor to free entries)
-void collection_dictionary_dealloc(struct IDictionary **dictionary, void (*destructor)(void *item)) {
-    if (dictionary == NULL) return;
-    struct Dictionary *this = (struct Dictionary *) *dictionary;
+// Creates a new dictionary instance pre-sized for the expected number of entries.
+struct IDictionary *collection_dictionary_new_with_capacity(const size_t capacity) {
+    return init(alloc(), capacity, DICTIONARY_KEY_COPY, NULL, NULL);
+}
 
-    (*dictionary)->clear(*dictionary, destructor);
+// Creates a new dictionary instance that stores the caller's key pointers without copying them.
+struct IDictionary *collection_dictionary_new_borrowed(void) {
+    return init(alloc(), INITIAL_CAPACITY, DICTIONARY_KEY_BORROW, NULL, NULL);
+}
 
-    free(this->buckets);
-    this->buckets = NULL;
-    this->capacity = 0;
+// Creates a new dictionary instance whose keys are interned in a shared pool.
+struct IDictionary *collection_dictionary_new_interned(struct IInternPool *pool) {
+    if (pool == NULL) return NULL;
+    return init(alloc(), INITIAL_CAPACITY, DICTIONARY_KEY_INTERN, pool, NULL);
+}
 
-    mutex_destroy(&this->mutex);
+// Creates a Dictionary whose keys are handled through callbacks.
+struct Dictionary *dictionary_new_with_key_ops(const struct CollectionKeyOps *ops) {
+    return (struct Dictionary *) init(alloc(), INITIAL_CAPACITY, DICTIONARY_KEY_CUSTOM, NULL, ops);
+}
+
+// Destroys a dictionary instance. (Optional destructor to free entries)
+void collection_dictionary_dealloc(struct IDictionary **dictionary, void (*destructor)(void *item)) {
+    if (dictionary == NULL || *dictionary == NULL) return;
 
-    free(*dictionary);
+    (*dictionary)->dealloc(*dictionary, destructor);
     *dictionary = NULL;
 }
@@ -9,19 +9,60 @@
 #pragma once
 
 #include "collection/i_dictionary.h"
+#include "collection/i_intern_pool.h"
+#include "collection/i_key_dictionary.h"
 #include "collection/i_platform.h"
+#include "hash.h"
+
+#include <stdint.h>
+
+/**
+ * @brief Longest key, in bytes, stored in a pooled fixed-size node.
+ */
+#define DICTIONARY_INLINE_KEY 23
+
+/**
+ * @enum DictionaryKeyMode
+ * @brief How a Dictionary stores the keys passed to put().
+ */
+enum DictionaryKeyMode {
+    DICTIONARY_KEY_COPY,                /**< Copies each key into its node. */
+    DICTIONARY_KEY_BORROW,              /**< Stores the caller's pointer; the caller keeps the key alive and unchanged. */
+    DICTIONARY_KEY_INTERN,              /**< Stores the pointer returned by an IInternPool. */
+    DICTIONARY_KEY_CUSTOM               /**< Compares, copies, and frees keys through CollectionKeyOps. */
+};
 
 /**
  * @struct DictionaryNode
  * @brief Node in a hash table bucket chain.
  *
  * Stores a key-value pair and a pointer to the next node used for
- * collision resolution via separate chaining.
+ * collision resolution via separate chaining. A copied key trails the node
+ * in the same allocation: keys of up to DICTIONARY_INLINE_KEY bytes fit in a
+ * fixed-size node from the node pool, longer keys get a node sized to fit.
+ * Borrowed, interned, and callback-copied keys are only referenced.
+ *
+ * The node caches the hash its table was searched with, so rehashing never
+ * re-reads keys. String-keyed dictionaries store hash_table_key(), which
+ * equals hash_u64() of a cached collection_hash(); an IKeyDictionary stores
+ * the result of its hash callback or hash_bytes().
  */
 struct DictionaryNode {
-    const char *key;                    /**< Heap-allocated key string. */
-    const void *value;                  /**< Associated value. */
     struct DictionaryNode *next;        /**< Next node in the bucket chain. */
+    const void *value;                  /**< Associated value. */
+    const char *key;                    /**< Key string: bytes for a copied key, otherwise the borrowed or interned string. */
+    uint64_t hash;                      /**< Cached table hash of the key. */
+    size_t length;                      /**< Key length in bytes, excluding the terminator. */
+    char bytes[];                       /**< NUL-terminated copy of the key in DICTIONARY_KEY_COPY mode. */
+};
+
+/**
+ * @struct DictionaryTable
+ * @brief Bucket array of a Dictionary.
+ */
+struct DictionaryTable {
+    struct DictionaryNode **buckets;    /**< Array of bucket heads. */
+    size_t capacity;                    /**< Number of buckets, always a power of two (0 if unallocated). */
 };
 
 /**
@@ -30,11 +71,107 @@ struct DictionaryNode {
  *
  * Stores key-value pairs in an array of buckets, with collisions resolved
  * using separate chaining. Access is synchronized with a mutex.
+ *
+ * The table grows and shrinks with its load factor. Resizing is incremental:
+ * a second table is allocated and every write operation migrates a few
+ * buckets from tables[0] to tables[1], so no single operation pays for a
+ * full-table rehash. Lookups consult both tables while a rehash is running.
  */
 struct Dictionary {
     struct IDictionary super;           /**< IDictionary interface implemented by this type. */
-    struct DictionaryNode **buckets;    /**< Array of bucket heads. */
-    size_t capacity;                    /**< Number of buckets. */
+    struct DictionaryTable tables[2];   /**< Active table and, while rehashing, the migration target. */
+    size_t rehash_index;                /**< Next bucket of tables[0] to migrate, or SIZE_MAX when not rehashing. */
+    size_t min_capacity;                /**< Lower bound for shrinking, derived from the capacity hint. */
     size_t size;                        /**< Number of stored key-value pairs. */
+    uint64_t seed;                      /**< Per-instance hash seed. */
+    enum DictionaryKeyMode key_mode;    /**< How put() stores keys. */
+    struct IInternPool *intern_pool;    /**< Pool that owns the keys in DICTIONARY_KEY_INTERN mode. */
+    const struct CollectionKeyOps *key_ops; /**< Key callbacks in DICTIONARY_KEY_CUSTOM mode, owned by the wrapper. */
     Mutex mutex;                        /**< Mutex protecting dictionary operations. */
 };
+
+/*
+ * Operations on a Dictionary with a precomputed key length and table hash,
+ * for wrappers that also use the hash to pick a Dictionary. String-keyed
+ * wrappers pass hash_table_key(), or hash_u64() of a caller's cached
+ * collection_hash(); IKeyDictionary passes its hash callback or hash_bytes().
+ * A wrapper must hash every key of an instance with the same seed. Each takes
+ * the instance lock itself.
+ */
+
+/**
+ * @brief Returns the value associated with a key, or NULL.
+ */
+void *dictionary_get_hashed(struct Dictionary *this, const char *key, size_t length, uint64_t hash);
+
+/**
+ * @brief Inserts a key-value pair; returns false if allocation fails.
+ */
+bool dictionary_put_hashed(struct Dictionary *this, const char *key, size_t length, uint64_t hash, const void *value);
+
+/**
+ * @brief Returns whether a key exists.
+ */
+bool dictionary_contains_key_hashed(struct Dictionary *this, const char *key, size_t length, uint64_t hash);
+
+/**
+ * @brief Removes a key and returns its value, or NULL if it was absent.
+ */
+void *dictionary_remove_hashed(struct Dictionary *this, const char *key, size_t length, uint64_t hash);
+
+/**
+ * @brief Replaces the value of an existing key and returns the previous value, or NULL if it was absent.
+ */
+void *dictionary_replace_hashed(struct Dictionary *this, const char *key, size_t length, uint64_t hash, const void *value);
+
+/**
+ * @brief Creates a Dictionary that handles keys through callbacks, for wrappers that hash keys themselves.
+ *
+ * @param ops Key callbacks; must outlive the Dictionary. hash is not used here.
+ * @return A new Dictionary, or NULL if allocation fails.
+ */
+struct Dictionary *dictionary_new_with_key_ops(const struct CollectionKeyOps *ops);
+
+/**
+ * @brief Inserts a key-value pair only if the key is absent; returns whether it was inserted.
+ */
+bool dictionary_put_if_absent_hashed(struct Dictionary *this, const char *key, size_t length, uint64_t hash, const void *value);
+
+/**
+ * @brief Updates the value of an existing key or inserts the pair; returns the previous value, or NULL.
+ */
+void *dictionary_upsert_hashed(struct Dictionary *this, const char *key, size_t length, uint64_t hash, const void *value);
+
+/**
+ * @brief Returns the value of a key, inserting the non-NULL result of factory if the key is absent.
+ */
+void *dictionary_get_or_insert_with_hashed(struct Dictionary *this, const char *key, size_t length, uint64_t hash,
+                                           void *(*factory)(const char *key, void *context), void *context);
+
+/**
+ * @brief Recomputes the value of a key under the lock; returns the resulting value, or NULL if none is stored.
+ */
+void *dictionary_compute_hashed(struct Dictionary *this, const char *key, size_t length, uint64_t hash,
+                                bool (*function)(const char *key, void **value, void *context), void *context);
+
+/**
+ * @brief Looks up a batch of pre-hashed keys under one shared lock, writing each value to values[key.index].
+ */
+size_t dictionary_get_many_hashed(struct Dictionary *this, const struct HashedKey *keys, size_t count, void **values);
+
+/**
+ * @brief Stores a batch of pre-hashed keys with values[key.index] under one exclusive lock.
+ *
+ * In DICTIONARY_KEY_INTERN mode the keys are interned in place before locking.
+ */
+size_t dictionary_put_many_hashed(struct Dictionary *this, struct HashedKey *keys, size_t count, const void *const *values);
+
+/**
+ * @brief Removes a batch of pre-hashed keys under one exclusive lock, writing each removed value to values[key.index] if values is not NULL.
+ */
+size_t dictionary_remove_many_hashed(struct Dictionary *this, const struct HashedKey *keys, size_t count, void **values);
+
+/**
+ * @brief Removes every key-value pair. The caller holds the exclusive lock.
+ */
+void dictionary_clear_locked(struct Dictionary *this, void (*destructor)(void *value));
@@ -0,0 +1,163 @@
+/**
+ * @file epoch.c
+ * @internal
+ * @brief Epoch-Based Reclamation Implementation
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "epoch.h"
+#include "compiler.h"
+#include "collection/i_platform.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#define LIMBO_LISTS 3               // Objects retired in epochs e, e - 1 and e - 2 may still be referenced.
+#define ADVANCE_INTERVAL 64         // Retirements between attempts to advance the global epoch.
+
+/**
+ * @brief Per-thread reclamation state. Records are never freed; an exited thread's record is reused.
+ */
+struct EpochRecord {
+    _Atomic uint64_t state;                         // Announced epoch << 1 | 1 while inside a critical section.
+    atomic_bool in_use;                             // Owned by a live thread or by a collector.
+    size_t depth;                                   // Nesting depth of critical sections.
+    size_t retired;                                 // Retirements since the last advance attempt.
+    struct EpochEntry *limbo[LIMBO_LISTS];          // Retired entries, one list per epoch modulo 3.
+    uint64_t limbo_epoch[LIMBO_LISTS];              // Epoch each limbo list was filled in.
+    struct EpochRecord *next;                       // Next record in the global registry.
+    char pad[CACHE_LINE_SIZE];                      // Keeps state of neighboring records apart.
+};
+
+static _Atomic uint64_t global_epoch = LIMBO_LISTS;  // Starts past 0 so limbo_epoch + 2 never wraps.
+static _Atomic(struct EpochRecord *) records;
+static THREAD_LOCAL struct EpochRecord *local;
+
+static MutexOnce once = MUTEX_ONCE_INIT;
+static ThreadKey exit_key;                          // Releases a thread's record when it exits.
+static bool exit_key_valid;
+
+// Reclaims every limbo list of a record that no reader can reference any more.
+static void collect(struct EpochRecord *record, const uint64_t epoch) {
+    for (size_t i = 0; i < LIMBO_LISTS; i++) {
+        if (record->limbo[i] == NULL || record->limbo_epoch[i] + 2 > epoch) continue;
+
+        struct EpochEntry *entry = record->limbo[i];
+        record->limbo[i] = NULL;
+        while (entry) {
+            struct EpochEntry *next = entry->next;
+            entry->reclaim(entry);
+            entry = next;
+        }
+    }
+}
+
+// Advances the global epoch if every active thread has observed the current one, collecting abandoned records.
+static void try_advance(void) {
+    uint64_t epoch = atomic_load(&global_epoch);
+
+    for (struct EpochRecord *record = atomic_load(&records); record; record = record->next) {
+        const uint64_t state = atomic_load(&record->state);
+        if ((state & 1) && (state >> 1) != epoch) return; // A reader is still in an older epoch.
+    }
+    atomic_compare_exchange_strong(&global_epoch, &epoch, epoch + 1);
+
+    // Records of exited threads still hold their last retirements; reclaim what has become safe.
+    const uint64_t current = atomic_load(&global_epoch);
+    for (struct EpochRecord *record = atomic_load(&records); record; record = record->next) {
+        bool expected = false;
+        if (atomic_load_explicit(&record->in_use, memory_order_relaxed) ||
+            !atomic_compare_exchange_strong(&record->in_use, &expected, true)) continue;
+        collect(record, current);
+        atomic_store(&record->in_use, false);
+    }
+}
+
+// Releases an exiting thread's record for reuse; its pending retirements stay attached to it.
+static void release_record(void *value) {
+    struct EpochRecord *record = value;
+    collect(record, atomic_load(&global_epoch));
+    atomic_store(&record->state, 0);
+    atomic_store(&record->in_use, false);
+    local = NULL;
+}
+
+// Initializes the thread exit hook.
+static void init_once(void) {
+    exit_key_valid = thread_key_create(&exit_key, release_record) == 0;
+}
+
+// Returns the calling thread's record, claiming a free one or registering a new one. NULL if allocation fails.
+static struct EpochRecord *acquire_record(void) {
+    mutex_once(&once, init_once);
+
+    struct EpochRecord *record;
+    for (record = atomic_load(&records); record; record = record->next) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&record->in_use, &expected, true)) break;
+    }
+
+    if (record == NULL) {
+        record = calloc(1, sizeof(struct EpochRecord));
+        if (record == NULL) {
+            fprintf(stderr, "\033[0;31m[Collection::Epoch::acquire_record] Error: Failed to allocate record.\033[0m\n");
+            return NULL;
+        }
+        atomic_init(&record->state, 0);
+        atomic_init(&record->in_use, true);
+
+        struct EpochRecord *head = atomic_load(&records);
+        do {
+            record->next = head;
+        } while (!atomic_compare_exchange_weak(&records, &head, record));
+    }
+
+    if (exit_key_valid) thread_key_set(exit_key, record);
+    local = record;
+    return record;
+}
+
+// Enters a read-side critical section.
+bool epoch_enter(void) {
+    struct EpochRecord *record = local ? local : acquire_record();
+    if (record == NULL) return false;
+    if (record->depth++ > 0) return true;
+
+    // Publish the announcement before any shared pointer is read; pairs with the scan in try_advance().
+    atomic_store_explicit(&record->state, atomic_load(&global_epoch) << 1 | 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    return true;
+}
+
+// Leaves a read-side critical section.
+void epoch_exit(void) {
+    struct EpochRecord *record = local;
+    if (--record->depth > 0) return;
+
+    const uint64_t state = atomic_load_explicit(&record->state, memory_order_relaxed);
+    atomic_store_explicit(&record->state, state & ~(uint64_t) 1, memory_order_release);
+}
+
+// Adds an unlinked object to the calling thread's limbo list for the current epoch.
+void epoch_retire(struct EpochEntry *entry, void (*reclaim)(struct EpochEntry *entry)) {
+    struct EpochRecord *record = local;
+    const uint64_t epoch = atomic_load(&global_epoch);
+
+    collect(record, epoch); // Frees the list this epoch's slot held three epochs ago.
+
+    const size_t slot = epoch % LIMBO_LISTS;
+    entry->reclaim = reclaim;
+    entry->next = record->limbo[slot];
+    record->limbo[slot] = entry;
+    record->limbo_epoch[slot] = epoch;
+
+    if (++record->retired >= ADVANCE_INTERVAL) {
+        record->retired = 0;
+        try_advance();
+        collect(record, atomic_load(&global_epoch));
+    }
+}
@@ -0,0 +1,52 @@
+/**
+ * @file epoch.h
+ * @internal
+ * @brief Epoch-Based Reclamation Header
+ *
+ * Safe memory reclamation for lock-free structures. Readers bracket every
+ * access to shared nodes with epoch_enter() and epoch_exit(). A node that has
+ * been unlinked is handed to epoch_retire() and is reclaimed only after the
+ * global epoch has advanced twice, which cannot happen while any thread that
+ * might still hold a reference is inside a critical section.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * @struct EpochEntry
+ * @brief Link embedded in every object that may be retired.
+ */
+struct EpochEntry {
+    struct EpochEntry *next;                        /**< Next retired entry of the same epoch. */
+    void (*reclaim)(struct EpochEntry *entry);      /**< Frees the object containing the entry. */
+};
+
+/**
+ * @brief Enters a read-side critical section on the calling thread. Sections may nest.
+ *
+ * A thread's first call allocates its reclamation record. If that fails, no
+ * section is entered: the caller must not touch shared nodes and must not
+ * call epoch_exit().
+ *
+ * @return true if the section was entered; false if the record could not be allocated.
+ */
+bool epoch_enter(void);
+
+/**
+ * @brief Leaves the innermost read-side critical section on the calling thread.
+ */
+void epoch_exit(void);
+
+/**
+ * @brief Schedules an unlinked object for reclamation once no reader can still reference it.
+ *
+ * Must be called inside a critical section.
+ *
+ * @param entry Link embedded in the object.
+ * @param reclaim Callback that frees the object.
+ */
+void epoch_retire(struct EpochEntry *entry, void (*reclaim)(struct EpochEntry *entry));
@@ -0,0 +1,217 @@
+/**
+ * @file hash.c
+ * @internal
+ * @brief Key Hashing Implementation
+ *
+ * The mixing function follows wyhash (final version 4) by Wang Yi, released
+ * into the public domain: 64x64->128-bit multiplies fold 16 input bytes per
+ * step, with three independent lanes for long keys.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#ifdef _WIN32
+#define _CRT_RAND_S                 /* Exposes rand_s() from stdlib.h. */
+#endif
+
+#include "hash.h"
+#include "collection/i_dictionary.h"
+#include "collection/i_platform.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#pragma intrinsic(_umul128)
+#endif
+
+#if defined(__linux__)
+#include <sys/random.h>
+#endif
+
+static const uint64_t secret_constants[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+};
+
+static MutexOnce once = MUTEX_ONCE_INIT;
+static uint64_t process_secret;             // Random per process; never exposed.
+static atomic_uint_fast64_t seed_counter;   // Makes every seed derived from the secret distinct.
+static uint64_t key_seed;                   // Seed of collection_hash(), shared by every table.
+
+// Multiplies two 64-bit values into a 128-bit product, returned as its low and high halves.
+static void multiply(uint64_t *a, uint64_t *b) {
+#if defined(__SIZEOF_INT128__)
+    const __uint128_t product = (__uint128_t) *a * *b;
+    *a = (uint64_t) product;
+    *b = (uint64_t) (product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    *a = _umul128(*a, *b, b);
+#else
+    const uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t) *a, lb = (uint32_t) *b;
+    const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64_t t = rl + (rm0 << 32);
+    uint64_t carry = t < rl;
+    const uint64_t lo = t + (rm1 << 32);
+    carry += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+// Folds two 64-bit values into one through a full-width multiply.
+static uint64_t mix(uint64_t a, uint64_t b) {
+    multiply(&a, &b);
+    return a ^ b;
+}
+
+// Reads 8 little-endian bytes.
+static uint64_t read64(const uint8_t *p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value)); // Compiles to a single unaligned load.
+    return value;
+}
+
+// Reads 4 little-endian bytes.
+static uint64_t read32(const uint8_t *p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Computes the hash value for a byte string.
+uint64_t hash_bytes(const void *key, const size_t length, uint64_t seed) {
+    const uint8_t *p = key;
+    const uint64_t *secret = secret_constants;
+    uint64_t a, b;
+
+    seed ^= mix(seed ^ secret[0], secret[1]);
+    if (length <= 16) {
+        if (length >= 4) { // Two possibly overlapping 4-byte reads from each end cover 4..16 bytes.
+            const size_t offset = (length >> 3) << 2;
+            a = read32(p) << 32 | read32(p + offset);
+            b = read32(p + length - 4) << 32 | read32(p + length - 4 - offset);
+        } else if (length > 0) {
+            a = (uint64_t) p[0] << 16 | (uint64_t) p[length >> 1] << 8 | p[length - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t remaining = length;
+        if (remaining >= 48) { // Three independent lanes keep the multiplier busy on long keys.
+            uint64_t lane1 = seed, lane2 = seed;
+            do {
+                seed = mix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+                lane1 = mix(read64(p + 16) ^ secret[2], read64(p + 24) ^ lane1);
+                lane2 = mix(read64(p + 32) ^ secret[3], read64(p + 40) ^ lane2);
+                p += 48;
+                remaining -= 48;
+            } while (remaining >= 48);
+            seed ^= lane1 ^ lane2;
+        }
+        while (remaining > 16) {
+            seed = mix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        a = read64(p + remaining - 16); // The last 16 bytes, overlapping what was already consumed.
+        b = read64(p + remaining - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    multiply(&a, &b);
+    return mix(a ^ secret[0] ^ length, b ^ secret[1]);
+}
+
+// Computes the hash value for an integer key with two multiply-xorshift rounds (MurmurHash3 fmix64).
+uint64_t hash_u64(uint64_t key, const uint64_t seed) {
+    key ^= seed;
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+// Fills a buffer from the operating system's entropy source. Returns whether it succeeded.
+static int os_random(uint64_t *out) {
+#if defined(_WIN32)
+    unsigned int low, high;
+    if (rand_s(&low) != 0 || rand_s(&high) != 0) return 0;
+    *out = (uint64_t) high << 32 | low;
+    return 1;
+#elif defined(__linux__)
+    return getrandom(out, sizeof(*out), 0) == (ssize_t) sizeof(*out);
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+    arc4random_buf(out, sizeof(*out));
+    return 1;
+#else
+    (void) out;
+    return 0;
+#endif
+}
+
+// Draws the process secret, falling back to weaker sources if the OS cannot provide entropy.
+static void init_once(void) {
+    uint64_t secret;
+    if (!os_random(&secret)) {
+        secret = (uint64_t) time(NULL) ^ clock_monotonic_ns() ^ (uint64_t) (uintptr_t) &secret;
+    }
+    process_secret = mix(secret ^ secret_constants[0], secret_constants[2]);
+    key_seed = mix(process_secret ^ secret_constants[1], secret_constants[3]);
+    atomic_init(&seed_counter, 0);
+}
+
+// Returns a seed derived from the process secret and a per-call counter.
+uint64_t hash_seed(void) {
+    mutex_once(&once, init_once);
+    const uint64_t n = atomic_fetch_add_explicit(&seed_counter, 1, memory_order_relaxed);
+    return mix(process_secret ^ n, secret_constants[3] ^ n);
+}
+
+// Hashes a byte string with the process-wide key seed.
+uint64_t collection_hash(const void *key, const size_t length) {
+    mutex_once(&once, init_once);
+    return hash_bytes(key, length, key_seed);
+}
+
+// Bundles a null-terminated key with its length and hash.
+struct CollectionKey collection_key(const char *key) {
+    const size_t length = strlen(key);
+    return (struct CollectionKey) {key, length, collection_hash(key, length)};
+}
+
+// Scrambles the process-wide hash of a key with a table's seed.
+uint64_t hash_table_key(const void *key, const size_t length, const uint64_t seed) {
+    return hash_u64(collection_hash(key, length), seed);
+}
+
+// Hashes a batch of keys into the caller's buffer, or into a heap array when the batch does not fit.
+struct HashedKey *hash_keys(const char *const *keys, const size_t count, const uint64_t seed,
+                            struct HashedKey *buffer, const size_t capacity) {
+    struct HashedKey *hashed = buffer;
+    if (count > capacity) {
+        hashed = count <= SIZE_MAX / sizeof(struct HashedKey) ? malloc(count * sizeof(struct HashedKey)) : NULL;
+        if (hashed == NULL) {
+            fprintf(stderr, "\033[0;31m[Collection::Hash::hash_keys] Error: Failed to allocate key batch.\033[0m\n");
+            return NULL;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const size_t length = strlen(keys[i]);
+        hashed[i] = (struct HashedKey) {keys[i], length, hash_table_key(keys[i], length, seed), i};
+    }
+    return hashed;
+}
+
+// Releases a key batch unless it lives in the caller's buffer.
+void hash_keys_free(struct HashedKey *hashed, const struct HashedKey *buffer) {
+    if (hashed != buffer) free(hashed);
+}
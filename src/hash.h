@@ -0,0 +1,92 @@
+/**
+ * @file hash.h
+ * @internal
+ * @brief Key Hashing Header
+ *
+ * Seeded hash function shared by the dictionary implementations. Keys are
+ * consumed eight bytes at a time and every output bit depends on every input
+ * byte, so callers may take bucket indices from the low bits and shard or
+ * group indices from the high bits of the same value. Each dictionary hashes
+ * with its own seed, derived from a secret drawn from the operating system,
+ * so an attacker cannot precompute colliding keys. String-keyed dictionaries
+ * first hash with the process-wide collection_hash() and then scramble the
+ * result with their seed, so callers can cache one hash for every table.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HASH_KEYS_INLINE 64    // Batch size that hash_keys() serves from a caller's stack buffer.
+
+/**
+ * @brief A key of a batch operation, hashed ahead of the lookup.
+ */
+struct HashedKey {
+    const char *key;    /**< Null-terminated key string. */
+    size_t length;      /**< Key length in bytes. */
+    uint64_t hash;      /**< Key hash under the table's seed. */
+    size_t index;       /**< Position of the key in the caller's key and value arrays. */
+};
+
+/**
+ * @brief Computes the 64-bit hash of a byte string.
+ *
+ * @param key Bytes to hash. May be NULL when length is 0.
+ * @param length Number of bytes.
+ * @param seed Seed returned by hash_seed().
+ * @return The hash value.
+ */
+uint64_t hash_bytes(const void *key, size_t length, uint64_t seed);
+
+/**
+ * @brief Mixes a 64-bit integer key into a 64-bit hash.
+ *
+ * @param key Key to hash.
+ * @param seed Seed returned by hash_seed().
+ * @return The hash value.
+ */
+uint64_t hash_u64(uint64_t key, uint64_t seed);
+
+/**
+ * @brief Computes a table's hash of a byte string: collection_hash() scrambled with the table's seed.
+ *
+ * Tables that accept caller-cached collection_hash() values hash with this
+ * function, so a cached hash converts to the table's hash with hash_u64() alone.
+ *
+ * @param key Bytes to hash. May be NULL when length is 0.
+ * @param length Number of bytes.
+ * @param seed Seed returned by hash_seed().
+ * @return The hash value.
+ */
+uint64_t hash_table_key(const void *key, size_t length, uint64_t seed);
+
+/**
+ * @brief Returns a fresh, unpredictable seed for a new hash table.
+ *
+ * @return The seed.
+ */
+uint64_t hash_seed(void);
+
+/**
+ * @brief Hashes a batch of null-terminated keys up front.
+ *
+ * @param keys Keys to hash.
+ * @param count Number of keys.
+ * @param seed Seed of the table the keys are looked up in.
+ * @param buffer Caller buffer used when count fits in capacity.
+ * @param capacity Number of entries in buffer.
+ * @return buffer or a heap array of count entries, or NULL if allocation fails. Release with hash_keys_free().
+ */
+struct HashedKey *hash_keys(const char *const *keys, size_t count, uint64_t seed, struct HashedKey *buffer, size_t capacity);
+
+/**
+ * @brief Releases an array returned by hash_keys().
+ *
+ * @param hashed Array returned by hash_keys().
+ * @param buffer Caller buffer passed to hash_keys().
+ */
+void hash_keys_free(struct HashedKey *hashed, const struct HashedKey *buffer);
@@ -0,0 +1,286 @@
+/**
+* @file int_dictionary.c
+* @internal
+* @brief Integer-Keyed Dictionary Implementation
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#include "int_dictionary.h"
+#include "hash.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 16
+#define EMPTY_KEY 0
+
+// Returns the number of entries a table with the given slot count holds before growing (3/4 load factor).
+static size_t max_load(const size_t capacity) {
+    return capacity - capacity / 4;
+}
+
+// Returns the home slot of a key.
+static size_t home(const struct IntDictionary *this, const uint64_t key) {
+    return (size_t) hash_u64(key, this->seed) & this->mask;
+}
+
+// Returns the slot index of a non-zero key, or SIZE_MAX if it is absent.
+static size_t find_index(const struct IntDictionary *this, const uint64_t key) {
+    for (size_t index = home(this, key);; index = (index + 1) & this->mask) { // The load factor guarantees an empty slot.
+        const uint64_t stored = this->slots[index].key;
+        if (stored == key) return index;
+        if (stored == EMPTY_KEY) return SIZE_MAX;
+    }
+}
+
+// Rebuilds the table with the given number of slots. Caller holds the exclusive lock.
+static bool resize(struct IntDictionary *this, const size_t capacity) {
+    struct IntSlot *slots = capacity <= SIZE_MAX / sizeof(struct IntSlot) ? calloc(capacity, sizeof(struct IntSlot)) : NULL;
+    if (slots == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::IntDictionary::resize] Error: Failed to allocate slots.\033[0m\n");
+        return false;
+    }
+
+    struct IntSlot *old = this->slots;
+    const size_t old_capacity = this->mask + 1;
+    this->slots = slots;
+    this->mask = capacity - 1;
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old[i].key == EMPTY_KEY) continue;
+        size_t index = home(this, old[i].key);
+        while (slots[index].key != EMPTY_KEY) index = (index + 1) & this->mask;
+        slots[index] = old[i];
+    }
+
+    free(old);
+    return true;
+}
+
+// Returns the value associated with the specified key.
+static void *get(const struct IIntDictionary *self, const uint64_t key) {
+    struct IntDictionary *this = (struct IntDictionary *) self;
+    mutex_lock_shared(&this->mutex);
+
+    const void *value;
+    if (key == EMPTY_KEY) {
+        value = this->has_zero ? this->zero_value : NULL;
+    } else {
+        const size_t index = find_index(this, key);
+        value = index != SIZE_MAX ? this->slots[index].value : NULL;
+    }
+
+    mutex_unlock(&this->mutex);
+    return (void *) value;
+}
+
+// Inserts a key-value pair, or updates the value of an existing key.
+static bool put(struct IIntDictionary *self, const uint64_t key, const void *value) {
+    struct IntDictionary *this = (struct IntDictionary *) self;
+    bool added = true;
+
+    mutex_lock(&this->mutex);
+
+    if (key == EMPTY_KEY) {
+        this->has_zero = true;
+        this->zero_value = value;
+        goto out_unlock;
+    }
+
+    size_t index = find_index(this, key);
+    if (index != SIZE_MAX) {
+        this->slots[index].value = value;
+        goto out_unlock;
+    }
+
+    if (this->size + 1 > max_load(this->mask + 1)) {
+        if (this->mask + 1 > SIZE_MAX / 2 || !resize(this, (this->mask + 1) * 2)) {
+            added = false;
+            goto out_unlock;
+        }
+    }
+
+    for (index = home(this, key); this->slots[index].key != EMPTY_KEY; index = (index + 1) & this->mask) {}
+    this->slots[index] = (struct IntSlot) {key, value};
+    this->size++;
+
+out_unlock:
+    mutex_unlock(&this->mutex);
+    return added;
+}
+
+// Returns whether the specified key exists.
+static bool contains_key(const struct IIntDictionary *self, const uint64_t key) {
+    struct IntDictionary *this = (struct IntDictionary *) self;
+    mutex_lock_shared(&this->mutex);
+
+    const bool found = key == EMPTY_KEY ? this->has_zero : find_index(this, key) != SIZE_MAX;
+
+    mutex_unlock(&this->mutex);
+    return found;
+}
+
+// Empties a slot and shifts later entries of the cluster back so no probe sequence is broken.
+static void erase(struct IntDictionary *this, size_t hole) {
+    for (size_t index = (hole + 1) & this->mask; this->slots[index].key != EMPTY_KEY; index = (index + 1) & this->mask) {
+        // Move the entry into the hole unless its home lies cyclically in (hole, index].
+        const size_t distance = (index - home(this, this->slots[index].key)) & this->mask;
+        if (distance >= ((index - hole) & this->mask)) {
+            this->slots[hole] = this->slots[index];
+            hole = index;
+        }
+    }
+    this->slots[hole] = (struct IntSlot) {EMPTY_KEY, NULL};
+}
+
+// Removes the specified key-value pair.
+static void *remove_item(struct IIntDictionary *self, const uint64_t key) {
+    struct IntDictionary *this = (struct IntDictionary *) self;
+    const void *value = NULL;
+
+    mutex_lock(&this->mutex);
+
+    if (key == EMPTY_KEY) {
+        if (this->has_zero) value = this->zero_value;
+        this->has_zero = false;
+        this->zero_value = NULL;
+    } else {
+        const size_t index = find_index(this, key);
+        if (index != SIZE_MAX) {
+            value = this->slots[index].value;
+            erase(this, index);
+            this->size--;
+        }
+    }
+
+    mutex_unlock(&this->mutex);
+    return (void *) value;
+}
+
+// Replaces the value associated with the specified key.
+static void *replace(const struct IIntDictionary *self, const uint64_t key, const void *value) {
+    struct IntDictionary *this = (struct IntDictionary *) self;
+    const void *temp = NULL;
+
+    mutex_lock(&this->mutex);
+
+    if (key == EMPTY_KEY) {
+        if (this->has_zero) {
+            temp = this->zero_value;
+            this->zero_value = value;
+        }
+    } else {
+        const size_t index = find_index(this, key);
+        if (index != SIZE_MAX) {
+            temp = this->slots[index].value;
+            this->slots[index].value = value;
+        }
+    }
+
+    mutex_unlock(&this->mutex);
+    return (void *) temp;
+}
+
+// Removes all key-value pairs from the dictionary, keeping the slot array.
+static bool clear(const struct IIntDictionary *self, void (*destructor)(void *value)) {
+    struct IntDictionary *this = (struct IntDictionary *) self;
+    mutex_lock(&this->mutex);
+
+    if (destructor) {
+        for (size_t i = 0; i <= this->mask; i++) {
+            if (this->slots[i].key != EMPTY_KEY) destructor((void *) this->slots[i].value);
+        }
+        if (this->has_zero) destructor((void *) this->zero_value);
+    }
+    memset(this->slots, 0, (this->mask + 1) * sizeof(struct IntSlot));
+    this->size = 0;
+    this->has_zero = false;
+    this->zero_value = NULL;
+
+    mutex_unlock(&this->mutex);
+    return true;
+}
+
+// Releases an IntDictionary instance and its slots.
+static void dealloc(struct IIntDictionary *self, void (*destructor)(void *value)) {
+    struct IntDictionary *this = (struct IntDictionary *) self;
+
+    clear(self, destructor);
+
+    free(this->slots);
+    mutex_destroy(&this->mutex);
+
+    free(this);
+}
+
+// Returns the aligned allocation size for IntDictionary.
+static size_t size(void) {
+    return (sizeof(struct IntDictionary) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u);
+}
+
+// Allocates an IntDictionary instance.
+static struct IIntDictionary *alloc() {
+    struct IIntDictionary *dictionary = malloc(size());
+
+    if (dictionary == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::IntDictionary::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return dictionary;
+}
+
+// Initializes an IntDictionary instance with room for at least the given number of entries.
+static struct IIntDictionary *init(struct IIntDictionary *dictionary, const size_t capacity) {
+    if (dictionary == NULL) return NULL;
+
+    struct IntDictionary *this = (struct IntDictionary *) dictionary;
+    memset(this, 0, sizeof(struct IntDictionary));
+
+    size_t slots = INITIAL_CAPACITY;
+    while (max_load(slots) < capacity && slots <= SIZE_MAX / 2 / sizeof(struct IntSlot)) slots <<= 1;
+
+    this->seed = hash_seed();
+    this->mask = slots - 1;
+    this->slots = calloc(slots, sizeof(struct IntSlot)); // All-zero slots are empty.
+    if (this->slots == NULL) goto exception;
+
+    if (mutex_init(&this->mutex) != 0) goto exception;
+    mutex_set_name(&this->mutex, "Collection::IntDictionary");
+
+    this->super.get = get;
+    this->super.put = put;
+    this->super.contains_key = contains_key;
+    this->super.remove_item = remove_item;
+    this->super.replace = replace;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return dictionary;
+
+exception:
+    free(this->slots);
+    free(dictionary);
+    return NULL;
+}
+
+// Creates a new integer-keyed dictionary instance.
+struct IIntDictionary *collection_int_dictionary_new(void) {
+    return init(alloc(), 0);
+}
+
+// Creates a new integer-keyed dictionary instance pre-sized for the expected number of entries.
+struct IIntDictionary *collection_int_dictionary_new_with_capacity(const size_t capacity) {
+    return init(alloc(), capacity);
+}
+
+// Destroys an integer-keyed dictionary instance. (Optional destructor to free entries)
+void collection_int_dictionary_dealloc(struct IIntDictionary **dictionary, void (*destructor)(void *item)) {
+    if (dictionary == NULL || *dictionary == NULL) return;
+
+    (*dictionary)->dealloc(*dictionary, destructor);
+    *dictionary = NULL;
+}
@@ -0,0 +1,43 @@
+/**
+* @file int_dictionary.h
+* @internal
+* @brief Integer-Keyed Dictionary Header
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#pragma once
+
+#include "collection/i_int_dictionary.h"
+#include "collection/i_platform.h"
+
+#include <stdint.h>
+
+/**
+ * @struct IntSlot
+ * @brief Slot of the flat table; four share a cache line.
+ */
+struct IntSlot {
+    uint64_t key;                       /**< Stored key, or 0 when the slot is empty. */
+    const void *value;                  /**< Associated value. */
+};
+
+/**
+ * @struct IntDictionary
+ * @brief Open-addressing implementation of IIntDictionary.
+ *
+ * Slots are probed linearly from the hash of the key, and removal shifts
+ * displaced entries back so probe sequences never contain tombstones. Key 0
+ * marks empty slots, so an entry with key 0 is kept beside the table.
+ * Access is synchronized with a mutex.
+ */
+struct IntDictionary {
+    struct IIntDictionary super;        /**< IIntDictionary interface implemented by this type. */
+    struct IntSlot *slots;              /**< Slot array. */
+    size_t mask;                        /**< Number of slots minus one; the slot count is a power of two. */
+    size_t size;                        /**< Number of entries in slots. */
+    uint64_t seed;                      /**< Per-instance hash seed. */
+    bool has_zero;                      /**< Whether key 0 is present. */
+    const void *zero_value;             /**< Value of key 0. */
+    Mutex mutex;                        /**< Mutex protecting dictionary operations. */
+};
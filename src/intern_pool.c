@@ -0,0 +1,184 @@
+/**
+* @file intern_pool.c
+* @internal
+* @brief Intern Pool Implementation
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#include "intern_pool.h"
+#include "hash.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 64
+
+// Returns the entry holding a string, or NULL. Caller holds the lock.
+static struct InternEntry *find(const struct InternPool *this, const char *string, const size_t length, const uint64_t h) {
+    for (struct InternEntry *cursor = this->buckets[h & (this->capacity - 1)]; cursor; cursor = cursor->next) {
+        if (cursor->hash == h && cursor->length == length && memcmp(cursor->string, string, length) == 0) return cursor;
+    }
+    return NULL;
+}
+
+// Doubles the bucket array once the pool holds one string per bucket. Caller holds the exclusive lock.
+static void grow_if_needed(struct InternPool *this) {
+    if (this->size < this->capacity || this->capacity > SIZE_MAX / 2 / sizeof(struct InternEntry *)) return;
+
+    const size_t capacity = this->capacity * 2;
+    struct InternEntry **buckets = calloc(capacity, sizeof(struct InternEntry *));
+    if (buckets == NULL) return; // Longer chains are still correct; retried on the next insert.
+
+    for (size_t i = 0; i < this->capacity; i++) {
+        for (struct InternEntry *cursor = this->buckets[i]; cursor;) {
+            struct InternEntry *next = cursor->next;
+            const size_t slot = cursor->hash & (capacity - 1);
+            cursor->next = buckets[slot];
+            buckets[slot] = cursor;
+            cursor = next;
+        }
+    }
+
+    free(this->buckets);
+    this->buckets = buckets;
+    this->capacity = capacity;
+}
+
+// Returns the canonical copy of a string, adding it to the pool if needed.
+static const char *intern(struct IInternPool *self, const char *string) {
+    struct InternPool *this = (struct InternPool *) self;
+    const size_t length = strlen(string);
+    const uint64_t h = hash_bytes(string, length, this->seed);
+
+    mutex_lock_shared(&this->mutex); // Fast path: the string is usually interned already.
+    const struct InternEntry *entry = find(this, string, length, h);
+    mutex_unlock(&this->mutex);
+    if (entry) return entry->string;
+
+    mutex_lock(&this->mutex);
+
+    struct InternEntry *added = find(this, string, length, h); // Another thread may have won the race.
+    if (added == NULL) {
+        added = malloc(sizeof(struct InternEntry) + length + 1);
+        if (added == NULL) {
+            fprintf(stderr, "\033[0;31m[Collection::InternPool::intern] Error: Failed to allocate InternEntry.\033[0m\n");
+            mutex_unlock(&this->mutex);
+            return NULL;
+        }
+        added->hash = h;
+        added->length = length;
+        memcpy(added->string, string, length + 1);
+
+        struct InternEntry **bucket = &this->buckets[h & (this->capacity - 1)];
+        added->next = *bucket;
+        *bucket = added;
+        this->size++;
+        grow_if_needed(this);
+    }
+
+    mutex_unlock(&this->mutex);
+    return added->string;
+}
+
+// Returns the canonical copy of a string without adding it.
+static const char *lookup(const struct IInternPool *self, const char *string) {
+    struct InternPool *this = (struct InternPool *) self;
+    const size_t length = strlen(string);
+    const uint64_t h = hash_bytes(string, length, this->seed);
+
+    mutex_lock_shared(&this->mutex);
+    const struct InternEntry *entry = find(this, string, length, h);
+    mutex_unlock(&this->mutex);
+
+    return entry ? entry->string : NULL;
+}
+
+// Returns the number of interned strings.
+static size_t count(const struct IInternPool *self) {
+    struct InternPool *this = (struct InternPool *) self;
+    mutex_lock_shared(&this->mutex);
+
+    const size_t count = this->size;
+
+    mutex_unlock(&this->mutex);
+    return count;
+}
+
+// Releases an InternPool instance and every interned string.
+static void dealloc(struct IInternPool *self) {
+    struct InternPool *this = (struct InternPool *) self;
+
+    for (size_t i = 0; i < this->capacity; i++) {
+        struct InternEntry *current = this->buckets[i];
+        while (current != NULL) {
+            struct InternEntry *entry = current;
+            current = current->next;
+            free(entry);
+        }
+    }
+
+    free(this->buckets);
+    mutex_destroy(&this->mutex);
+    free(this);
+}
+
+// Returns the aligned allocation size for InternPool.
+static size_t size(void) {
+    return (sizeof(struct InternPool) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u);
+}
+
+// Allocates an InternPool instance.
+static struct IInternPool *alloc() {
+    struct IInternPool *pool = malloc(size());
+
+    if (pool == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::InternPool::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return pool;
+}
+
+// Initializes an InternPool instance.
+static struct IInternPool *init(struct IInternPool *pool) {
+    if (pool == NULL) return NULL;
+
+    struct InternPool *this = (struct InternPool *) pool;
+    memset(this, 0, sizeof(struct InternPool));
+
+    this->capacity = INITIAL_CAPACITY;
+    this->seed = hash_seed();
+    this->buckets = calloc(this->capacity, sizeof(struct InternEntry *));
+    if (this->buckets == NULL) goto exception;
+
+    if (mutex_init(&this->mutex) != 0) goto exception;
+    mutex_set_name(&this->mutex, "Collection::InternPool");
+
+    this->super.intern = intern;
+    this->super.lookup = lookup;
+    this->super.count = count;
+    this->super.dealloc = dealloc;
+
+    return pool;
+
+exception:
+    free(this->buckets);
+    free(pool);
+    return NULL;
+}
+
+// Creates a new intern pool instance.
+struct IInternPool *collection_intern_pool_new(void) {
+    return init(alloc());
+}
+
+// Destroys an intern pool instance.
+void collection_intern_pool_dealloc(struct IInternPool **pool) {
+    if (pool == NULL || *pool == NULL) return;
+
+    (*pool)->dealloc(*pool);
+    *pool = NULL;
+}
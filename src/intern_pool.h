@@ -0,0 +1,43 @@
+/**
+* @file intern_pool.h
+* @internal
+* @brief Intern Pool Header
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#pragma once
+
+#include "collection/i_intern_pool.h"
+#include "collection/i_platform.h"
+
+#include <stdint.h>
+
+/**
+ * @struct InternEntry
+ * @brief Interned string, allocated together with its chain link.
+ */
+struct InternEntry {
+    struct InternEntry *next;           /**< Next entry in the bucket chain. */
+    uint64_t hash;                      /**< Cached hash of the string. */
+    size_t length;                      /**< String length in bytes, excluding the terminator. */
+    char string[];                      /**< NUL-terminated canonical string. */
+};
+
+/**
+ * @struct InternPool
+ * @brief Chained hash set implementation of IInternPool.
+ *
+ * Lookups of strings already in the pool take the lock in shared mode, so
+ * concurrent readers proceed in parallel; only the first intern of a string
+ * takes it exclusively. Entries are never removed before the pool is
+ * destroyed, which is what keeps returned pointers stable.
+ */
+struct InternPool {
+    struct IInternPool super;           /**< IInternPool interface implemented by this type. */
+    struct InternEntry **buckets;       /**< Array of bucket heads. */
+    size_t capacity;                    /**< Number of buckets, always a power of two. */
+    size_t size;                        /**< Number of interned strings. */
+    uint64_t seed;                      /**< Per-instance hash seed. */
+    Mutex mutex;                        /**< Mutex protecting the table. */
+};
@@ -0,0 +1,129 @@
+/**
+* @file key_dictionary.c
+* @internal
+* @brief Generic-Key Dictionary Implementation
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#include "key_dictionary.h"
+#include "hash.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+// Hashes a key with the caller's callback or the built-in byte hash.
+static uint64_t hash_key(const struct KeyDictionary *this, const void *key, const size_t length) {
+    return this->ops.hash ? this->ops.hash(key, length, this->table->seed) : hash_bytes(key, length, this->table->seed);
+}
+
+// Returns the value associated with the specified key.
+static void *get(const struct IKeyDictionary *self, const void *key, const size_t length) {
+    struct KeyDictionary *this = (struct KeyDictionary *) self;
+    return dictionary_get_hashed(this->table, key, length, hash_key(this, key, length));
+}
+
+// Inserts a new key-value pair.
+static bool put(struct IKeyDictionary *self, const void *key, const size_t length, const void *value) {
+    struct KeyDictionary *this = (struct KeyDictionary *) self;
+    return dictionary_put_hashed(this->table, key, length, hash_key(this, key, length), value);
+}
+
+// Returns whether the specified key exists.
+static bool contains_key(const struct IKeyDictionary *self, const void *key, const size_t length) {
+    struct KeyDictionary *this = (struct KeyDictionary *) self;
+    return dictionary_contains_key_hashed(this->table, key, length, hash_key(this, key, length));
+}
+
+// Removes the specified key-value pair.
+static void *remove_item(struct IKeyDictionary *self, const void *key, const size_t length) {
+    struct KeyDictionary *this = (struct KeyDictionary *) self;
+    return dictionary_remove_hashed(this->table, key, length, hash_key(this, key, length));
+}
+
+// Replaces the value associated with the specified key.
+static void *replace(const struct IKeyDictionary *self, const void *key, const size_t length, const void *value) {
+    struct KeyDictionary *this = (struct KeyDictionary *) self;
+    return dictionary_replace_hashed(this->table, key, length, hash_key(this, key, length), value);
+}
+
+// Removes all key-value pairs from the dictionary.
+static bool clear(const struct IKeyDictionary *self, void (*destructor)(void *value)) {
+    struct KeyDictionary *this = (struct KeyDictionary *) self;
+    struct IDictionary *table = (struct IDictionary *) this->table;
+    return table->clear(table, destructor);
+}
+
+// Releases a KeyDictionary instance and its table.
+static void dealloc(struct IKeyDictionary *self, void (*destructor)(void *value)) {
+    struct KeyDictionary *this = (struct KeyDictionary *) self;
+
+    struct IDictionary *table = (struct IDictionary *) this->table;
+    collection_dictionary_dealloc(&table, destructor);
+
+    free(this);
+}
+
+// Returns the aligned allocation size for KeyDictionary.
+static size_t size(void) {
+    return (sizeof(struct KeyDictionary) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u);
+}
+
+// Allocates a KeyDictionary instance.
+static struct IKeyDictionary *alloc() {
+    struct IKeyDictionary *dictionary = malloc(size());
+
+    if (dictionary == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::KeyDictionary::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return dictionary;
+}
+
+// Initializes a KeyDictionary instance and creates its table.
+static struct IKeyDictionary *init(struct IKeyDictionary *dictionary, const struct CollectionKeyOps *ops) {
+    if (dictionary == NULL) return NULL;
+
+    struct KeyDictionary *this = (struct KeyDictionary *) dictionary;
+    memset(this, 0, sizeof(struct KeyDictionary));
+
+    if (ops) this->ops = *ops;
+    this->table = dictionary_new_with_key_ops(&this->ops);
+    if (this->table == NULL) goto exception;
+    mutex_set_name(&this->table->mutex, "Collection::KeyDictionary");
+
+    this->super.get = get;
+    this->super.put = put;
+    this->super.contains_key = contains_key;
+    this->super.remove_item = remove_item;
+    this->super.replace = replace;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return dictionary;
+
+exception:
+    free(dictionary);
+    return NULL;
+}
+
+// Creates a new dictionary instance keyed by byte strings.
+struct IKeyDictionary *collection_key_dictionary_new(void) {
+    return init(alloc(), NULL);
+}
+
+// Creates a new dictionary instance with caller-supplied key handling.
+struct IKeyDictionary *collection_key_dictionary_new_with_ops(const struct CollectionKeyOps *ops) {
+    return init(alloc(), ops);
+}
+
+// Destroys a generic-key dictionary instance. (Optional destructor to free entries)
+void collection_key_dictionary_dealloc(struct IKeyDictionary **dictionary, void (*destructor)(void *item)) {
+    if (dictionary == NULL || *dictionary == NULL) return;
+
+    (*dictionary)->dealloc(*dictionary, destructor);
+    *dictionary = NULL;
+}
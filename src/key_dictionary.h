@@ -0,0 +1,26 @@
+/**
+* @file key_dictionary.h
+* @internal
+* @brief Generic-Key Dictionary Header
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#pragma once
+
+#include "collection/i_key_dictionary.h"
+#include "dictionary.h"
+
+/**
+ * @struct KeyDictionary
+ * @brief IKeyDictionary implemented on top of the chained Dictionary.
+ *
+ * Hashes each key once, with the caller's hash callback if any, and passes
+ * the key, its length, and the hash to the Dictionary, which stores them
+ * like any other key and consults the remaining callbacks.
+ */
+struct KeyDictionary {
+    struct IKeyDictionary super;        /**< IKeyDictionary interface implemented by this type. */
+    struct CollectionKeyOps ops;        /**< Copy of the caller's callbacks, referenced by the table. */
+    struct Dictionary *table;           /**< Table holding the entries. */
+};
@@ -0,0 +1,333 @@
+/**
+* @file lock_profile.c
+* @internal
+* @brief Lock Profiling Implementation
+*
+* Each lock name owns one record of relaxed atomic counters, kept in a
+* registry for the life of the process. Exclusive hold times are stamped in
+* the Mutex itself, which only its holder touches; shared hold times are kept
+* on a small per-thread stack, since many readers may hold the lock at once.
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#include "lock_profile.h"
+#include "compiler.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef COLLECTION_LOCK_PROFILING
+
+#define SHARED_HOLDS 16                 // Shared holds timed per thread; deeper nesting is counted but not timed.
+
+/**
+ * @struct lock_profile_record
+ * @brief Live counters of every mutex with one name.
+ */
+struct lock_profile_record {
+    struct lock_profile_record *next;   /**< Next record in the registry. */
+    char name[LOCK_PROFILE_NAME_LENGTH]; /**< Lock name. */
+    atomic_size_t locks;                /**< Mutexes attached to the record. */
+    atomic_uint_fast64_t acquisitions[LOCK_MODE_COUNT];
+    atomic_uint_fast64_t contended[LOCK_MODE_COUNT];
+    atomic_uint_fast64_t wait_ns[LOCK_MODE_COUNT];
+    atomic_uint_fast64_t hold_ns[LOCK_MODE_COUNT];
+    atomic_uint_fast64_t wait_histogram[LOCK_MODE_COUNT][LOCK_PROFILE_BUCKETS];
+    atomic_uint_fast64_t hold_histogram[LOCK_MODE_COUNT][LOCK_PROFILE_BUCKETS];
+};
+
+struct SharedHold {
+    const Mutex *mutex;
+    uint64_t since;
+};
+
+static MutexOnce once = MUTEX_ONCE_INIT;
+static Monitor monitor;                 // Protects the registry list; a Monitor, so it is never profiled itself.
+static bool monitor_valid;              // False if the registry lock could not be created.
+static struct lock_profile_record unnamed = {.name = "(unnamed)"};
+static struct lock_profile_record *registry = &unnamed;
+
+static THREAD_LOCAL struct SharedHold shared_holds[SHARED_HOLDS];
+static THREAD_LOCAL size_t shared_depth;
+
+// Initializes the registry lock.
+static void init_once(void) {
+    if (monitor_init(&monitor) != 0) {
+        fprintf(stderr, "\033[0;31m[Collection::LockProfile::init] Error: Registry lock initialization failed.\033[0m\n");
+        return;
+    }
+    monitor_valid = true;
+}
+
+// Returns whether the registry can be used, initializing it on first use.
+static bool registry_ready(void) {
+    mutex_once(&once, init_once);
+    return monitor_valid;
+}
+
+// Adds a value to a statistics counter.
+static void add(atomic_uint_fast64_t *counter, const uint64_t value) {
+    atomic_fetch_add_explicit(counter, value, memory_order_relaxed);
+}
+
+// Returns the histogram bucket of a duration: the position of its highest set bit.
+static size_t bucket_of(const uint64_t ns) {
+    size_t bucket = 0;
+    for (uint64_t rest = ns >> 1; rest && bucket < LOCK_PROFILE_BUCKETS - 1; rest >>= 1) bucket++;
+    return bucket;
+}
+
+// Attaches a mutex to the unnamed profile.
+void lock_profile_attach(Mutex *mutex) {
+    mutex->profile = &unnamed;
+    mutex->held_exclusive = 0;
+    atomic_fetch_add_explicit(&unnamed.locks, 1, memory_order_relaxed);
+}
+
+// Detaches a mutex from its profile.
+void lock_profile_detach(Mutex *mutex) {
+    if (mutex->profile) atomic_fetch_sub_explicit(&mutex->profile->locks, 1, memory_order_relaxed);
+    mutex->profile = NULL;
+}
+
+// Counts an acquisition and starts timing the hold.
+void lock_profile_acquired(Mutex *mutex, const enum lock_mode mode, const bool contended, const uint64_t wait_begin) {
+    struct lock_profile_record *profile = mutex->profile;
+    if (profile == NULL) return;
+
+    const uint64_t now = clock_monotonic_ns();
+    add(&profile->acquisitions[mode], 1);
+    if (contended) {
+        const uint64_t wait = now - wait_begin;
+        add(&profile->contended[mode], 1);
+        add(&profile->wait_ns[mode], wait);
+        add(&profile->wait_histogram[mode][bucket_of(wait)], 1);
+    }
+
+    if (mode == LOCK_EXCLUSIVE) {
+        mutex->held_since = now;
+        mutex->held_exclusive = 1;
+    } else {
+        if (shared_depth < SHARED_HOLDS) shared_holds[shared_depth] = (struct SharedHold) {mutex, now};
+        shared_depth++;
+    }
+}
+
+// Records the hold time of the calling thread's hold.
+void lock_profile_released(Mutex *mutex) {
+    struct lock_profile_record *profile = mutex->profile;
+    if (profile == NULL) return;
+
+    const uint64_t now = clock_monotonic_ns();
+    if (mutex->held_exclusive) {
+        mutex->held_exclusive = 0;
+        add(&profile->hold_ns[LOCK_EXCLUSIVE], now - mutex->held_since);
+        add(&profile->hold_histogram[LOCK_EXCLUSIVE][bucket_of(now - mutex->held_since)], 1);
+        return;
+    }
+
+    if (shared_depth == 0) return;
+    const size_t top = shared_depth < SHARED_HOLDS ? shared_depth : SHARED_HOLDS;
+    shared_depth--;
+    for (size_t i = top; i > 0; i--) { // Usually the innermost hold; nested locks may be released out of order.
+        if (shared_holds[i - 1].mutex != mutex) continue;
+
+        const uint64_t hold = now - shared_holds[i - 1].since;
+        memmove(&shared_holds[i - 1], &shared_holds[i], (top - i) * sizeof(struct SharedHold));
+        add(&profile->hold_ns[LOCK_SHARED], hold);
+        add(&profile->hold_histogram[LOCK_SHARED][bucket_of(hold)], 1);
+        return;
+    }
+}
+
+// Names a mutex, moving it to the profile of that name.
+int mutex_set_name(Mutex *mutex, const char *name) {
+    if (mutex == NULL || name == NULL || mutex->profile == NULL || !registry_ready()) return -1;
+
+    monitor_lock(&monitor);
+    struct lock_profile_record *profile = registry;
+    while (profile && strncmp(profile->name, name, LOCK_PROFILE_NAME_LENGTH - 1) != 0) profile = profile->next;
+    if (profile == NULL && (profile = calloc(1, sizeof(struct lock_profile_record))) != NULL) {
+        snprintf(profile->name, sizeof(profile->name), "%s", name);
+        profile->next = registry;
+        registry = profile;
+    }
+    monitor_unlock(&monitor);
+
+    if (profile == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::LockProfile::mutex_set_name] Error: Profile allocation failed.\033[0m\n");
+        return -1;
+    }
+    atomic_fetch_sub_explicit(&mutex->profile->locks, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&profile->locks, 1, memory_order_relaxed);
+    mutex->profile = profile;
+    return 0;
+}
+
+// Reports that profiling is compiled in.
+int lock_profile_enabled(void) {
+    return 1;
+}
+
+// Copies one record's counters.
+static void snapshot(const struct lock_profile_record *profile, struct lock_profile_stats *out) {
+    memcpy(out->name, profile->name, sizeof(out->name));
+    out->locks = atomic_load_explicit(&profile->locks, memory_order_relaxed);
+    for (size_t mode = 0; mode < LOCK_MODE_COUNT; mode++) {
+        out->acquisitions[mode] = atomic_load_explicit(&profile->acquisitions[mode], memory_order_relaxed);
+        out->contended[mode] = atomic_load_explicit(&profile->contended[mode], memory_order_relaxed);
+        out->wait_ns[mode] = atomic_load_explicit(&profile->wait_ns[mode], memory_order_relaxed);
+        out->hold_ns[mode] = atomic_load_explicit(&profile->hold_ns[mode], memory_order_relaxed);
+        for (size_t b = 0; b < LOCK_PROFILE_BUCKETS; b++) {
+            out->wait_histogram[mode][b] = atomic_load_explicit(&profile->wait_histogram[mode][b], memory_order_relaxed);
+            out->hold_histogram[mode][b] = atomic_load_explicit(&profile->hold_histogram[mode][b], memory_order_relaxed);
+        }
+    }
+}
+
+// Orders profiles by contended acquisitions, then total wait time, most first.
+static int compare_contention(const void *left, const void *right) {
+    const struct lock_profile_stats *a = left, *b = right;
+    const uint64_t contended_a = a->contended[LOCK_EXCLUSIVE] + a->contended[LOCK_SHARED];
+    const uint64_t contended_b = b->contended[LOCK_EXCLUSIVE] + b->contended[LOCK_SHARED];
+    if (contended_a != contended_b) return contended_a < contended_b ? 1 : -1;
+
+    const uint64_t wait_a = a->wait_ns[LOCK_EXCLUSIVE] + a->wait_ns[LOCK_SHARED];
+    const uint64_t wait_b = b->wait_ns[LOCK_EXCLUSIVE] + b->wait_ns[LOCK_SHARED];
+    if (wait_a != wait_b) return wait_a < wait_b ? 1 : -1;
+    return strcmp(a->name, b->name);
+}
+
+// Copies every profile, most contended first.
+size_t lock_profile_snapshot(struct lock_profile_stats *out, const size_t capacity) {
+    if (!registry_ready()) return 0;
+
+    monitor_lock(&monitor);
+    size_t count = 0;
+    for (const struct lock_profile_record *profile = registry; profile; profile = profile->next) count++;
+
+    struct lock_profile_stats *all = calloc(count, sizeof(struct lock_profile_stats));
+    if (all == NULL) {
+        monitor_unlock(&monitor);
+        fprintf(stderr, "\033[0;31m[Collection::LockProfile::snapshot] Error: Snapshot allocation failed.\033[0m\n");
+        return 0;
+    }
+    size_t i = 0;
+    for (const struct lock_profile_record *profile = registry; profile; profile = profile->next) snapshot(profile, &all[i++]);
+    monitor_unlock(&monitor);
+
+    qsort(all, count, sizeof(struct lock_profile_stats), compare_contention);
+    if (out) memcpy(out, all, (capacity < count ? capacity : count) * sizeof(struct lock_profile_stats));
+    free(all);
+    return count;
+}
+
+// Returns the lower bound of the bucket holding the given fraction of both modes' samples.
+static uint64_t percentile(const uint64_t histogram[LOCK_MODE_COUNT][LOCK_PROFILE_BUCKETS], const double fraction) {
+    uint64_t samples = 0;
+    for (size_t mode = 0; mode < LOCK_MODE_COUNT; mode++) {
+        for (size_t b = 0; b < LOCK_PROFILE_BUCKETS; b++) samples += histogram[mode][b];
+    }
+
+    if (samples == 0) return 0;
+
+    const uint64_t rank = (uint64_t) (fraction * (double) (samples - 1)) + 1;
+    uint64_t seen = 0;
+    for (size_t b = 0; b < LOCK_PROFILE_BUCKETS; b++) {
+        seen += histogram[LOCK_EXCLUSIVE][b] + histogram[LOCK_SHARED][b];
+        if (seen >= rank) return b == 0 ? 0 : (uint64_t) 1 << b;
+    }
+    return 0;
+}
+
+// Prints the most contended lock names.
+void lock_profile_print(const size_t limit) {
+    const size_t count = lock_profile_snapshot(NULL, 0);
+    struct lock_profile_stats *profiles = calloc(count ? count : 1, sizeof(struct lock_profile_stats));
+    if (profiles == NULL) return;
+    const size_t total = lock_profile_snapshot(profiles, count);
+    const size_t shown = total < count ? total : count;
+    const size_t printed = limit && limit < shown ? limit : shown;
+
+    printf("\nLock Profile (%zu of %zu lock names, most contended first; W = exclusive, R = shared):\n", printed, total);
+    printf("%-32s %6s %21s %19s %7s %10s %10s %10s %10s %10s\n", "name", "locks", "acquired W/R", "contended W/R",
+           "cont %", "wait ms", "p50 wait", "p99 wait", "hold ms", "p99 hold");
+    for (size_t i = 0; i < printed; i++) {
+        const struct lock_profile_stats *p = &profiles[i];
+        const uint64_t acquired = p->acquisitions[LOCK_EXCLUSIVE] + p->acquisitions[LOCK_SHARED];
+        const uint64_t contended = p->contended[LOCK_EXCLUSIVE] + p->contended[LOCK_SHARED];
+        char acquisitions[32], contention[32];
+        snprintf(acquisitions, sizeof(acquisitions), "%llu/%llu", (unsigned long long) p->acquisitions[LOCK_EXCLUSIVE],
+                 (unsigned long long) p->acquisitions[LOCK_SHARED]);
+        snprintf(contention, sizeof(contention), "%llu/%llu", (unsigned long long) p->contended[LOCK_EXCLUSIVE],
+                 (unsigned long long) p->contended[LOCK_SHARED]);
+
+        printf("%-32s %6zu %21s %19s %6.2f%% %10.3f %8lluns %8lluns %10.3f %8lluns\n", p->name, p->locks, acquisitions,
+               contention, acquired ? 100.0 * (double) contended / (double) acquired : 0.0,
+               (double) (p->wait_ns[LOCK_EXCLUSIVE] + p->wait_ns[LOCK_SHARED]) / 1e6,
+               (unsigned long long) percentile(p->wait_histogram, 0.50),
+               (unsigned long long) percentile(p->wait_histogram, 0.99),
+               (double) (p->hold_ns[LOCK_EXCLUSIVE] + p->hold_ns[LOCK_SHARED]) / 1e6,
+               (unsigned long long) percentile(p->hold_histogram, 0.99));
+    }
+    fflush(stdout);
+    free(profiles);
+}
+
+// Clears one record's counters.
+static void reset(struct lock_profile_record *profile) {
+    for (size_t mode = 0; mode < LOCK_MODE_COUNT; mode++) {
+        atomic_store_explicit(&profile->acquisitions[mode], 0, memory_order_relaxed);
+        atomic_store_explicit(&profile->contended[mode], 0, memory_order_relaxed);
+        atomic_store_explicit(&profile->wait_ns[mode], 0, memory_order_relaxed);
+        atomic_store_explicit(&profile->hold_ns[mode], 0, memory_order_relaxed);
+        for (size_t b = 0; b < LOCK_PROFILE_BUCKETS; b++) {
+            atomic_store_explicit(&profile->wait_histogram[mode][b], 0, memory_order_relaxed);
+            atomic_store_explicit(&profile->hold_histogram[mode][b], 0, memory_order_relaxed);
+        }
+    }
+}
+
+// Clears every profile counter.
+void lock_profile_reset(void) {
+    if (!registry_ready()) return;
+
+    monitor_lock(&monitor);
+    for (struct lock_profile_record *profile = registry; profile; profile = profile->next) reset(profile);
+    monitor_unlock(&monitor);
+}
+
+#else
+
+// Ignores the name; mutexes are not profiled in this build.
+int mutex_set_name(Mutex *mutex, const char *name) {
+    return mutex == NULL || name == NULL ? -1 : 0;
+}
+
+// Reports that profiling is not compiled in.
+int lock_profile_enabled(void) {
+    return 0;
+}
+
+// Reports no profiles.
+size_t lock_profile_snapshot(struct lock_profile_stats *out, const size_t capacity) {
+    (void) out;
+    (void) capacity;
+    return 0;
+}
+
+// Explains how to enable profiling.
+void lock_profile_print(const size_t limit) {
+    (void) limit;
+    printf("\nLock Profile: disabled; configure with -DCOLLECTION_ENABLE_LOCK_PROFILING=ON.\n");
+    fflush(stdout);
+}
+
+// Does nothing; there are no counters.
+void lock_profile_reset(void) {
+}
+
+#endif
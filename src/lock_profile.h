@@ -0,0 +1,49 @@
+/**
+* @file lock_profile.h
+* @internal
+* @brief Lock Profiling Hooks
+*
+* Called by the platform Mutex implementations when the library is built with
+* COLLECTION_LOCK_PROFILING.
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#pragma once
+
+#include "collection/i_platform.h"
+
+#include <stdbool.h>
+
+#ifdef COLLECTION_LOCK_PROFILING
+/**
+ * @brief Attaches a newly initialized mutex to the "(unnamed)" profile.
+ *
+ * @param mutex Mutex being initialized.
+ */
+void lock_profile_attach(Mutex *mutex);
+
+/**
+ * @brief Detaches a mutex being destroyed from its profile.
+ *
+ * @param mutex Mutex being destroyed.
+ */
+void lock_profile_detach(Mutex *mutex);
+
+/**
+ * @brief Counts an acquisition and starts timing the hold. Called with the lock held.
+ *
+ * @param mutex Acquired mutex.
+ * @param mode Mode it was acquired in.
+ * @param contended Whether the non-blocking attempt failed and the caller waited.
+ * @param wait_begin clock_monotonic_ns() before the caller waited; ignored when uncontended.
+ */
+void lock_profile_acquired(Mutex *mutex, enum lock_mode mode, bool contended, uint64_t wait_begin);
+
+/**
+ * @brief Records the hold time of the calling thread's hold. Called just before the lock is released.
+ *
+ * @param mutex Mutex about to be released.
+ */
+void lock_profile_released(Mutex *mutex);
+#endif
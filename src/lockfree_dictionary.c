@@ -0,0 +1,702 @@
+/**
+* @file lockfree_dictionary.c
+* @internal
+* @brief Lock-Free Dictionary Implementation
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#include "lockfree_dictionary.h"
+#include "compiler.h"
+#include "hash.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define SEGMENT_BITS 6                      // The first segment holds 2^SEGMENT_BITS buckets.
+#define MAX_LOAD 2                          // Average entries per bucket before the bucket count doubles.
+#define MARK ((uintptr_t) 1)                // Deletion mark in SplitNode::next.
+
+static const char tombstone_value;
+#define TOMBSTONE ((const void *) &tombstone_value)
+
+// Returns the index of the highest set bit of a non-zero value.
+static unsigned floor_log2(size_t n) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned) (sizeof(size_t) * 8 - 1) - (unsigned) (sizeof(size_t) == 8 ? __builtin_clzll(n) : __builtin_clz((unsigned) n));
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanReverse64(&index, n);
+    return (unsigned) index;
+#else
+    unsigned log = 0;
+    while (n >>= 1) log++;
+    return log;
+#endif
+}
+
+// Reverses the bit order of a 64-bit value.
+static uint64_t reverse_bits(uint64_t x) {
+    x = (x >> 1 & 0x5555555555555555ULL) | (x & 0x5555555555555555ULL) << 1;
+    x = (x >> 2 & 0x3333333333333333ULL) | (x & 0x3333333333333333ULL) << 2;
+    x = (x >> 4 & 0x0F0F0F0F0F0F0F0FULL) | (x & 0x0F0F0F0F0F0F0F0FULL) << 4;
+    x = (x >> 8 & 0x00FF00FF00FF00FFULL) | (x & 0x00FF00FF00FF00FFULL) << 8;
+    x = (x >> 16 & 0x0000FFFF0000FFFFULL) | (x & 0x0000FFFF0000FFFFULL) << 16;
+    return x >> 32 | x << 32;
+}
+
+// Returns the split order of a regular node: the reversed hash with the lowest bit set.
+static uint64_t regular_order(const uint64_t hash) {
+    return reverse_bits(hash | (1ULL << 63));
+}
+
+// Returns the split order of a bucket sentinel: the reversed bucket index, always even.
+static uint64_t sentinel_order(const size_t bucket) {
+    return reverse_bits((uint64_t) bucket);
+}
+
+// Returns the node pointer of a possibly marked link.
+static struct SplitNode *unmarked(const uintptr_t link) {
+    return (struct SplitNode *) (link & ~MARK);
+}
+
+// Frees a node once epoch reclamation has determined no reader can reach it.
+static void reclaim_node(struct EpochEntry *entry) {
+    free((char *) entry - offsetof(struct SplitNode, retire));
+}
+
+// Allocates an unlinked node. key is NULL for a sentinel.
+static struct SplitNode *node_new(const uint64_t order, const char *key, const size_t length, const void *value) {
+    struct SplitNode *node = malloc(sizeof(struct SplitNode) + length + 1); // Key is stored in the same allocation.
+    if (node == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::LockFreeDictionary::node_new] Error: Failed to allocate SplitNode.\033[0m\n");
+        return NULL;
+    }
+
+    atomic_init(&node->next, (uintptr_t) 0);
+    node->order = order;
+    atomic_init(&node->value, value);
+    node->length = length;
+    if (key) memcpy(node->key, key, length);
+    node->key[length] = '\0';
+    return node;
+}
+
+// Orders a node against a search position: split order first, then length and key bytes for colliding hashes.
+static int compare(const struct SplitNode *node, const uint64_t order, const char *key, const size_t length) {
+    if (node->order != order) return node->order < order ? -1 : 1;
+    if (key == NULL) return 0; // Sentinel orders are unique.
+    if (node->length != length) return node->length < length ? -1 : 1;
+    return memcmp(node->key, key, length);
+}
+
+// Unlinks the marked node *curr from *prev and retires it. Returns false if *prev changed first. Caller is inside an epoch.
+static bool unlink_node(_Atomic(uintptr_t) *prev, struct SplitNode *curr, const uintptr_t next) {
+    uintptr_t expected = (uintptr_t) curr;
+    if (!atomic_compare_exchange_strong_explicit(prev, &expected, next & ~MARK,
+                                                 memory_order_acq_rel, memory_order_acquire)) {
+        return false; // The predecessor changed or was itself deleted.
+    }
+    epoch_retire(&curr->retire, reclaim_node);
+    return true;
+}
+
+/*
+ * Searches the list from `start` for the first node not ordered before (order, key),
+ * unlinking and retiring marked nodes on the way. On return *prev is the link that
+ * points at *curr. Returns whether *curr matches. Caller is inside an epoch.
+ */
+static bool find(struct SplitNode *start, const uint64_t order, const char *key, const size_t length,
+                 _Atomic(uintptr_t) **prev, struct SplitNode **curr) {
+retry:
+    *prev = &start->next;
+    *curr = unmarked(atomic_load_explicit(*prev, memory_order_acquire));
+
+    while (*curr) {
+        const uintptr_t next = atomic_load_explicit(&(*curr)->next, memory_order_acquire);
+
+        if (next & MARK) { // Logically deleted; unlink it before moving on.
+            if (!unlink_node(*prev, *curr, next)) goto retry;
+            *curr = unmarked(next);
+            continue;
+        }
+
+        const int order_cmp = compare(*curr, order, key, length);
+        if (order_cmp >= 0) return order_cmp == 0;
+
+        *prev = &(*curr)->next;
+        *curr = unmarked(next);
+    }
+    return false;
+}
+
+// Unlinks and retires every marked node after `start`. Caller is inside an epoch.
+static void purge(struct SplitNode *start) {
+retry:;
+    _Atomic(uintptr_t) *prev = &start->next;
+    struct SplitNode *curr = unmarked(atomic_load_explicit(prev, memory_order_acquire));
+
+    while (curr) {
+        const uintptr_t next = atomic_load_explicit(&curr->next, memory_order_acquire);
+        if (next & MARK) {
+            if (!unlink_node(prev, curr, next)) goto retry;
+        } else {
+            prev = &curr->next;
+        }
+        curr = unmarked(next);
+    }
+}
+
+// Returns the slot of a bucket in its segment, allocating the segment on first use. NULL if that fails.
+static _Atomic(struct SplitNode *) *bucket_slot(struct LockFreeDictionary *this, const size_t bucket) {
+    size_t segment = 0;
+    size_t index = bucket;
+    size_t length = (size_t) 1 << SEGMENT_BITS;
+    if (bucket >= length) {
+        const unsigned log = floor_log2(bucket);
+        segment = log - SEGMENT_BITS + 1;
+        length = (size_t) 1 << log;
+        index = bucket - length;
+    }
+
+    _Atomic(struct SplitNode *) *slots = atomic_load_explicit(&this->segments[segment], memory_order_acquire);
+    if (slots == NULL) {
+        _Atomic(struct SplitNode *) *fresh = calloc(length, sizeof(*fresh)); // NULL pointers are all-zero on supported platforms.
+        if (fresh == NULL) return NULL;
+        if (atomic_compare_exchange_strong_explicit(&this->segments[segment], &slots, fresh,
+                                                    memory_order_acq_rel, memory_order_acquire)) {
+            slots = fresh;
+        } else {
+            free(fresh); // Another thread installed the segment first.
+        }
+    }
+    return &slots[index];
+}
+
+// Returns the sentinel of a bucket, creating it and its ancestors if needed. Falls back to an ancestor on failure.
+static struct SplitNode *bucket_sentinel(struct LockFreeDictionary *this, const size_t bucket) {
+    _Atomic(struct SplitNode *) *slot = bucket_slot(this, bucket);
+    struct SplitNode *sentinel = slot ? atomic_load_explicit(slot, memory_order_acquire) : NULL;
+    if (sentinel) return sentinel;
+
+    // A bucket splits from the bucket with its highest bit cleared; bucket 0 always exists.
+    struct SplitNode *parent = bucket_sentinel(this, bucket & ~((size_t) 1 << floor_log2(bucket)));
+    if (slot == NULL) return parent; // Searching from an ancestor is slower but still correct.
+
+    struct SplitNode *node = node_new(sentinel_order(bucket), NULL, 0, NULL);
+    if (node == NULL) return parent;
+
+    _Atomic(uintptr_t) *prev;
+    struct SplitNode *curr;
+    for (;;) {
+        if (find(parent, node->order, NULL, 0, &prev, &curr)) { // Another thread inserted it first.
+            free(node);
+            node = curr;
+            break;
+        }
+        atomic_store_explicit(&node->next, (uintptr_t) curr, memory_order_relaxed);
+        uintptr_t expected = (uintptr_t) curr;
+        if (atomic_compare_exchange_strong_explicit(prev, &expected, (uintptr_t) node,
+                                                    memory_order_release, memory_order_relaxed)) break;
+    }
+
+    struct SplitNode *empty = NULL;
+    atomic_compare_exchange_strong_explicit(slot, &empty, node, memory_order_release, memory_order_relaxed);
+    return node;
+}
+
+// Returns the sentinel from which to search for a hash.
+static struct SplitNode *start_for(struct LockFreeDictionary *this, const uint64_t hash) {
+    const size_t buckets = atomic_load_explicit(&this->bucket_count, memory_order_acquire);
+    return bucket_sentinel(this, (size_t) hash & (buckets - 1));
+}
+
+// Doubles the bucket count when the average chain grows past MAX_LOAD.
+static void grow_if_needed(struct LockFreeDictionary *this, const size_t size) {
+    size_t buckets = atomic_load_explicit(&this->bucket_count, memory_order_relaxed);
+    if (size / buckets > MAX_LOAD && buckets <= SIZE_MAX / 4) {
+        atomic_compare_exchange_strong(&this->bucket_count, &buckets, buckets * 2); // Losing to another grower is fine.
+    }
+}
+
+// Marks a node as deleted so searches unlink it.
+static void mark(struct SplitNode *node) {
+    atomic_fetch_or_explicit(&node->next, MARK, memory_order_acq_rel);
+}
+
+// Returns the value of a pre-hashed key, or NULL.
+static void *lookup(struct LockFreeDictionary *this, const char *key, const size_t length, const uint64_t hash) {
+    if (!epoch_enter()) return NULL;
+
+    _Atomic(uintptr_t) *prev;
+    struct SplitNode *curr;
+    const void *value = NULL;
+    if (find(start_for(this, hash), regular_order(hash), key, length, &prev, &curr)) {
+        value = atomic_load_explicit(&curr->value, memory_order_acquire);
+        if (value == TOMBSTONE) value = NULL;
+    }
+
+    epoch_exit();
+    return (void *) value;
+}
+
+// Returns the value associated with the specified key.
+static void *get(const struct IDictionary *self, const char *key) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    const size_t length = strlen(key);
+    return lookup(this, key, length, hash_table_key(key, length, this->seed));
+}
+
+/*
+ * Inserts a pre-hashed key-value pair, or updates the value if the key exists and `only_if_absent` is false.
+ * *previous receives the value the key held, or NULL. Returns whether `value` was stored.
+ */
+static bool store(struct LockFreeDictionary *this, const char *key, const size_t length, const uint64_t hash,
+                  const void *value, const bool only_if_absent, const void **previous) {
+    const uint64_t order = regular_order(hash);
+    struct SplitNode *node = NULL;
+    bool stored = false;
+    *previous = NULL;
+
+    if (!epoch_enter()) return false;
+
+    struct SplitNode *start = start_for(this, hash);
+    _Atomic(uintptr_t) *prev;
+    struct SplitNode *curr;
+    for (;;) {
+        if (find(start, order, key, length, &prev, &curr)) {
+            const void *current = atomic_load_explicit(&curr->value, memory_order_acquire);
+            if (current == TOMBSTONE) { // Being removed; help finish so the key can be inserted afresh.
+                mark(curr);
+                continue;
+            }
+            if (only_if_absent) {
+                *previous = current;
+                break;
+            }
+            if (atomic_compare_exchange_weak_explicit(&curr->value, &current, value,
+                                                      memory_order_acq_rel, memory_order_acquire)) {
+                *previous = current;
+                stored = true;
+                break;
+            }
+            continue;
+        }
+
+        if (node == NULL && (node = node_new(order, key, length, value)) == NULL) break;
+        atomic_store_explicit(&node->next, (uintptr_t) curr, memory_order_relaxed);
+        uintptr_t expected = (uintptr_t) curr;
+        if (atomic_compare_exchange_strong_explicit(prev, &expected, (uintptr_t) node,
+                                                    memory_order_release, memory_order_relaxed)) {
+            grow_if_needed(this, atomic_fetch_add_explicit(&this->size, 1, memory_order_relaxed) + 1);
+            node = NULL;
+            stored = true;
+            break;
+        }
+    }
+
+    epoch_exit();
+    free(node); // Allocated for an insert that became an update.
+    return stored;
+}
+
+// Inserts a key-value pair, or updates the value if the key exists.
+static bool put(struct IDictionary *self, const char *key, const void *value) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    const size_t length = strlen(key);
+    const void *previous;
+    return store(this, key, length, hash_table_key(key, length, this->seed), value, false, &previous);
+}
+
+// Returns whether a pre-hashed key exists.
+static bool contains(struct LockFreeDictionary *this, const char *key, const size_t length, const uint64_t hash) {
+    if (!epoch_enter()) return false;
+
+    _Atomic(uintptr_t) *prev;
+    struct SplitNode *curr;
+    const bool found = find(start_for(this, hash), regular_order(hash), key, length, &prev, &curr) &&
+                       atomic_load_explicit(&curr->value, memory_order_acquire) != TOMBSTONE;
+
+    epoch_exit();
+    return found;
+}
+
+// Returns whether the specified key exists.
+static bool contains_key(const struct IDictionary *self, const char *key) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    const size_t length = strlen(key);
+    return contains(this, key, length, hash_table_key(key, length, this->seed));
+}
+
+// Takes the value of a node by replacing it with the tombstone. Returns false if another remover won.
+static bool take_value(struct SplitNode *node, const void **value) {
+    const void *current = atomic_load_explicit(&node->value, memory_order_acquire);
+    do {
+        if (current == TOMBSTONE) return false;
+    } while (!atomic_compare_exchange_weak_explicit(&node->value, &current, TOMBSTONE,
+                                                    memory_order_acq_rel, memory_order_acquire));
+    *value = current;
+    return true;
+}
+
+// Removes a pre-hashed key and returns its value, or NULL.
+static void *erase(struct LockFreeDictionary *this, const char *key, const size_t length, const uint64_t hash) {
+    const uint64_t order = regular_order(hash);
+    const void *value = NULL;
+
+    if (!epoch_enter()) return NULL;
+
+    struct SplitNode *start = start_for(this, hash);
+    _Atomic(uintptr_t) *prev;
+    struct SplitNode *curr;
+    if (find(start, order, key, length, &prev, &curr) && take_value(curr, &value)) {
+        atomic_fetch_sub_explicit(&this->size, 1, memory_order_relaxed);
+        mark(curr);
+        find(start, order, key, length, &prev, &curr); // Unlink it now rather than on some later search.
+    }
+
+    epoch_exit();
+    return (void *) value;
+}
+
+// Removes the specified key-value pair.
+static void *remove_item(struct IDictionary *self, const char *key) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    const size_t length = strlen(key);
+    return erase(this, key, length, hash_table_key(key, length, this->seed));
+}
+
+// Replaces the value associated with the specified key.
+static void *replace(const struct IDictionary *self, const char *key, const void *value) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t hash = hash_table_key(key, length, this->seed);
+
+    if (!epoch_enter()) return NULL;
+
+    _Atomic(uintptr_t) *prev;
+    struct SplitNode *curr;
+    const void *current = NULL;
+    if (find(start_for(this, hash), regular_order(hash), key, length, &prev, &curr)) {
+        current = atomic_load_explicit(&curr->value, memory_order_acquire);
+        while (current != TOMBSTONE && !atomic_compare_exchange_weak_explicit(&curr->value, &current, value,
+                                                                              memory_order_acq_rel, memory_order_acquire)) {}
+        if (current == TOMBSTONE) current = NULL;
+    }
+
+    epoch_exit();
+    return (void *) current;
+}
+
+// Inserts a key-value pair only if the key is absent.
+static bool put_if_absent(struct IDictionary *self, const char *key, const void *value) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    const size_t length = strlen(key);
+    const void *previous;
+    return store(this, key, length, hash_table_key(key, length, this->seed), value, true, &previous);
+}
+
+// Updates or inserts a key-value pair, returning the previous value.
+static void *upsert(struct IDictionary *self, const char *key, const void *value) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    const size_t length = strlen(key);
+    const void *previous;
+    store(this, key, length, hash_table_key(key, length, this->seed), value, false, &previous);
+    return (void *) previous;
+}
+
+// Returns the value of a key, inserting one from factory if it is absent. A value created by a losing racer is not stored.
+static void *get_or_insert_with(struct IDictionary *self, const char *key,
+                                void *(*factory)(const char *key, void *context), void *context) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t hash = hash_table_key(key, length, this->seed);
+
+    void *value = lookup(this, key, length, hash);
+    if (value) return value;
+
+    const void *created = factory(key, context);
+    if (created == NULL) return NULL;
+
+    const void *previous;
+    return store(this, key, length, hash, created, true, &previous) ? (void *) created : (void *) previous;
+}
+
+// Recomputes the value of a key with compare-and-swap, calling function again whenever another writer intervenes.
+static void *compute(struct IDictionary *self, const char *key,
+                     bool (*function)(const char *key, void **value, void *context), void *context) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t hash = hash_table_key(key, length, this->seed);
+    const uint64_t order = regular_order(hash);
+    struct SplitNode *node = NULL;
+    void *value = NULL;
+
+    if (!epoch_enter()) return NULL;
+
+    struct SplitNode *start = start_for(this, hash);
+    _Atomic(uintptr_t) *prev;
+    struct SplitNode *curr;
+    for (;;) {
+        if (find(start, order, key, length, &prev, &curr)) {
+            const void *current = atomic_load_explicit(&curr->value, memory_order_acquire);
+            if (current == TOMBSTONE) { // Being removed; help finish so the key can be inserted afresh.
+                mark(curr);
+                continue;
+            }
+
+            value = (void *) current;
+            if (function(key, &value, context)) {
+                if (atomic_compare_exchange_strong_explicit(&curr->value, &current, value,
+                                                            memory_order_acq_rel, memory_order_acquire)) break;
+            } else if (atomic_compare_exchange_strong_explicit(&curr->value, &current, TOMBSTONE,
+                                                               memory_order_acq_rel, memory_order_acquire)) {
+                atomic_fetch_sub_explicit(&this->size, 1, memory_order_relaxed);
+                mark(curr);
+                find(start, order, key, length, &prev, &curr); // Unlink it now rather than on some later search.
+                value = NULL;
+                break;
+            }
+            continue;
+        }
+
+        value = NULL;
+        if (!function(key, &value, context)) {
+            value = NULL;
+            break;
+        }
+        if (node == NULL && (node = node_new(order, key, length, value)) == NULL) {
+            value = NULL;
+            break;
+        }
+        atomic_store_explicit(&node->value, value, memory_order_relaxed);
+        atomic_store_explicit(&node->next, (uintptr_t) curr, memory_order_relaxed);
+        uintptr_t expected = (uintptr_t) curr;
+        if (atomic_compare_exchange_strong_explicit(prev, &expected, (uintptr_t) node,
+                                                    memory_order_release, memory_order_relaxed)) {
+            grow_if_needed(this, atomic_fetch_add_explicit(&this->size, 1, memory_order_relaxed) + 1);
+            node = NULL;
+            break;
+        }
+    }
+
+    epoch_exit();
+    free(node); // Allocated for an insert that lost to another writer.
+    return value;
+}
+
+// Looks up a batch of keys in one epoch section, warming the bucket sentinels of keys PREFETCH_DISTANCE ahead.
+static size_t get_many(const struct IDictionary *self, const char *const *keys, const size_t count, void **values) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    struct HashedKey buffer[HASH_KEYS_INLINE];
+    struct HashedKey *hashed = hash_keys(keys, count, this->seed, buffer, HASH_KEYS_INLINE);
+    if (hashed == NULL) {
+        for (size_t i = 0; i < count; i++) values[i] = NULL;
+        return 0;
+    }
+
+    size_t found = 0;
+
+    if (!epoch_enter()) {
+        for (size_t i = 0; i < count; i++) values[i] = NULL;
+        hash_keys_free(hashed, buffer);
+        return 0;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (i + PREFETCH_DISTANCE < count) {
+            const struct SplitNode *ahead = start_for(this, hashed[i + PREFETCH_DISTANCE].hash);
+            PREFETCH(unmarked(atomic_load_explicit(&ahead->next, memory_order_relaxed)));
+        }
+        values[i] = lookup(this, hashed[i].key, hashed[i].length, hashed[i].hash);
+        if (values[i]) found++;
+    }
+
+    epoch_exit();
+
+    hash_keys_free(hashed, buffer);
+    return found;
+}
+
+// Inserts or updates a batch of key-value pairs.
+static size_t put_many(struct IDictionary *self, const char *const *keys, const void *const *values, const size_t count) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    struct HashedKey buffer[HASH_KEYS_INLINE];
+    struct HashedKey *hashed = hash_keys(keys, count, this->seed, buffer, HASH_KEYS_INLINE);
+    if (hashed == NULL) return 0;
+
+    size_t stored = 0;
+    const void *previous;
+
+    if (!epoch_enter()) {
+        hash_keys_free(hashed, buffer);
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (store(this, hashed[i].key, hashed[i].length, hashed[i].hash, values[i], false, &previous)) stored++;
+    }
+    epoch_exit();
+
+    hash_keys_free(hashed, buffer);
+    return stored;
+}
+
+// Removes a batch of keys.
+static size_t remove_many(struct IDictionary *self, const char *const *keys, const size_t count, void **values) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    struct HashedKey buffer[HASH_KEYS_INLINE];
+    struct HashedKey *hashed = hash_keys(keys, count, this->seed, buffer, HASH_KEYS_INLINE);
+    if (hashed == NULL) {
+        for (size_t i = 0; values && i < count; i++) values[i] = NULL;
+        return 0;
+    }
+
+    size_t removed = 0;
+
+    if (!epoch_enter()) {
+        for (size_t i = 0; values && i < count; i++) values[i] = NULL;
+        hash_keys_free(hashed, buffer);
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        void *value = erase(this, hashed[i].key, hashed[i].length, hashed[i].hash);
+        if (value) removed++;
+        if (values) values[i] = value;
+    }
+    epoch_exit();
+
+    hash_keys_free(hashed, buffer);
+    return removed;
+}
+
+// Returns the value associated with a pre-hashed key.
+static void *get_hashed(const struct IDictionary *self, const struct CollectionKey *key) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    return lookup(this, key->key, key->length, hash_u64(key->hash, this->seed));
+}
+
+// Inserts a pre-hashed key-value pair, or updates the value if the key exists.
+static bool put_hashed(struct IDictionary *self, const struct CollectionKey *key, const void *value) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    const void *previous;
+    return store(this, key->key, key->length, hash_u64(key->hash, this->seed), value, false, &previous);
+}
+
+// Returns whether a pre-hashed key exists.
+static bool contains_key_hashed(const struct IDictionary *self, const struct CollectionKey *key) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+    return contains(this, key->key, key->length, hash_u64(key->hash, this->seed));
+}
+
+// Removes every key-value pair present when each is visited; sentinels stay in place.
+static bool clear(const struct IDictionary *self, void (*destructor)(void *value)) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+
+    if (!epoch_enter()) return false;
+
+    struct SplitNode *head = bucket_sentinel(this, 0);
+    for (struct SplitNode *node = head; node; node = unmarked(atomic_load_explicit(&node->next, memory_order_acquire))) {
+        const void *value;
+        if ((node->order & 1) && take_value(node, &value)) {
+            atomic_fetch_sub_explicit(&this->size, 1, memory_order_relaxed);
+            mark(node);
+            if (destructor) destructor((void *) value);
+        }
+    }
+
+    purge(head);
+
+    epoch_exit();
+    return true;
+}
+
+// Releases a LockFreeDictionary instance. No other thread may be using it.
+static void dealloc(struct IDictionary *self, void (*destructor)(void *value)) {
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) self;
+
+    struct SplitNode *node = atomic_load_explicit(&this->segments[0], memory_order_relaxed)[0];
+    while (node) { // Every node still linked, marked or not, is freed here; unlinked ones belong to the epoch lists.
+        struct SplitNode *next = unmarked(atomic_load_explicit(&node->next, memory_order_relaxed));
+        const void *value = atomic_load_explicit(&node->value, memory_order_relaxed);
+        if ((node->order & 1) && value != TOMBSTONE && destructor) destructor((void *) value);
+        free(node);
+        node = next;
+    }
+
+    for (size_t i = 0; i < LOCKFREE_SEGMENTS; i++) free((void *) atomic_load_explicit(&this->segments[i], memory_order_relaxed));
+    free(this);
+}
+
+// Returns the aligned allocation size for LockFreeDictionary.
+static size_t size(void) {
+    return (sizeof(struct LockFreeDictionary) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u);
+}
+
+// Allocates a LockFreeDictionary instance.
+static struct IDictionary *alloc() {
+    struct IDictionary *dictionary = malloc(size());
+
+    if (dictionary == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::LockFreeDictionary::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return dictionary;
+}
+
+// Initializes a LockFreeDictionary instance with the sentinel of bucket 0 as the list head.
+static struct IDictionary *init(struct IDictionary *dictionary) {
+    if (dictionary == NULL) return NULL;
+
+    struct LockFreeDictionary *this = (struct LockFreeDictionary *) dictionary;
+    memset(this, 0, sizeof(struct LockFreeDictionary));
+
+    for (size_t i = 0; i < LOCKFREE_SEGMENTS; i++) atomic_init(&this->segments[i], NULL);
+    atomic_init(&this->bucket_count, (size_t) 2);
+    atomic_init(&this->size, (size_t) 0);
+    this->seed = hash_seed();
+
+    _Atomic(struct SplitNode *) *slot = bucket_slot(this, 0);
+    struct SplitNode *head = node_new(sentinel_order(0), NULL, 0, NULL);
+    if (slot == NULL || head == NULL) {
+        free(head);
+        free((void *) atomic_load_explicit(&this->segments[0], memory_order_relaxed));
+        goto exception;
+    }
+    atomic_store_explicit(slot, head, memory_order_relaxed);
+
+    this->super.get = get;
+    this->super.put = put;
+    this->super.contains_key = contains_key;
+    this->super.remove_item = remove_item;
+    this->super.replace = replace;
+    this->super.put_if_absent = put_if_absent;
+    this->super.upsert = upsert;
+    this->super.get_or_insert_with = get_or_insert_with;
+    this->super.compute = compute;
+    this->super.get_many = get_many;
+    this->super.put_many = put_many;
+    this->super.remove_many = remove_many;
+    this->super.get_hashed = get_hashed;
+    this->super.put_hashed = put_hashed;
+    this->super.contains_key_hashed = contains_key_hashed;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return dictionary;
+
+exception:
+    free(dictionary);
+    return NULL;
+}
+
+// Creates a new lock-free dictionary instance.
+struct IDictionary *collection_dictionary_new_lockfree(void) {
+    return init(alloc());
+}
@@ -0,0 +1,58 @@
+/**
+* @file lockfree_dictionary.h
+* @internal
+* @brief Lock-Free Dictionary Header
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#pragma once
+
+#include "collection/i_dictionary.h"
+#include "compiler.h"
+#include "epoch.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+/**
+ * @brief Maximum number of bucket segments: one for the first SEGMENT_BITS buckets, then one per doubling.
+ */
+#define LOCKFREE_SEGMENTS (sizeof(size_t) * 8 - 5)
+
+/**
+ * @struct SplitNode
+ * @brief Entry of the split-ordered list; either a bucket sentinel or a key-value pair.
+ *
+ * The low bit of next marks the node as logically deleted. A regular node's
+ * value is set to a tombstone before it is marked, which is the point at which
+ * its removal takes effect.
+ */
+struct SplitNode {
+    _Atomic(uintptr_t) next;            /**< Successor pointer; bit 0 is the deletion mark. */
+    uint64_t order;                     /**< Bit-reversed hash: odd for regular nodes, even for sentinels. */
+    _Atomic(const void *) value;        /**< Associated value, or the tombstone once removed. */
+    struct EpochEntry retire;           /**< Link used to defer freeing until no reader can see the node. */
+    size_t length;                      /**< Key length in bytes; 0 for sentinels. */
+    char key[];                         /**< NUL-terminated key; empty for sentinels. */
+};
+
+/**
+ * @struct LockFreeDictionary
+ * @brief Split-ordered list implementation of IDictionary (Shalev and Shavit, JACM 2006).
+ *
+ * All entries live in one lock-free sorted linked list (Harris/Michael) ordered
+ * by the bit-reversed hash. Each bucket points at a sentinel node inside that
+ * list, so doubling the bucket count never moves an entry: new buckets are
+ * initialized lazily by inserting a sentinel after their parent bucket's.
+ * Buckets live in segments allocated on demand, so the directory grows
+ * without copying. Unlinked nodes are freed through epoch-based reclamation.
+ */
+struct LockFreeDictionary {
+    struct IDictionary super;                                       /**< IDictionary interface implemented by this type. */
+    _Atomic(_Atomic(struct SplitNode *) *) segments[LOCKFREE_SEGMENTS]; /**< Bucket segments, allocated on demand. */
+    atomic_size_t bucket_count;                                     /**< Number of buckets in use, a power of two. */
+    uint64_t seed;                                                  /**< Per-instance hash seed. */
+    char pad[CACHE_LINE_SIZE];                                      /**< Keeps writer-updated size off the lines readers use. */
+    atomic_size_t size;                                             /**< Approximate number of stored key-value pairs. */
+};
@@ -0,0 +1,167 @@
+/**
+ * @file mpmc_queue.c
+ * @internal
+ * @brief Lock-Free MPMC Queue Implementation
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "mpmc_queue.h"
+#include "array_unsupported.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MIN_CAPACITY 2
+
+// Appends an element to the tail of the queue, failing if it is full.
+static bool push(struct IArray *self, const void *item) {
+    struct MpmcQueue *this = (struct MpmcQueue *) self;
+
+    size_t pos = atomic_load_explicit(&this->enqueue_pos, memory_order_relaxed);
+    for (;;) {
+        struct MpmcCell *cell = &this->cells[pos & this->mask];
+        const size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        const intptr_t diff = (intptr_t) sequence - (intptr_t) pos;
+
+        if (diff == 0) { // Cell is free for this lap; try to claim the position.
+            if (atomic_compare_exchange_weak_explicit(&this->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                cell->item = item;
+                atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) { // Cell still holds the item from the previous lap.
+            return false;
+        } else { // Another producer claimed pos; reload and retry.
+            pos = atomic_load_explicit(&this->enqueue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+// Removes and returns the element at the head of the queue, or NULL if it is empty.
+static const void *shift(struct IArray *self) {
+    struct MpmcQueue *this = (struct MpmcQueue *) self;
+
+    size_t pos = atomic_load_explicit(&this->dequeue_pos, memory_order_relaxed);
+    for (;;) {
+        struct MpmcCell *cell = &this->cells[pos & this->mask];
+        const size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        const intptr_t diff = (intptr_t) sequence - (intptr_t) (pos + 1);
+
+        if (diff == 0) { // Cell has been published for this lap; try to claim the position.
+            if (atomic_compare_exchange_weak_explicit(&this->dequeue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                const void *item = cell->item;
+                atomic_store_explicit(&cell->sequence, pos + this->mask + 1, memory_order_release);
+                return item;
+            }
+        } else if (diff < 0) { // Nothing published at pos yet.
+            return NULL;
+        } else { // Another consumer claimed pos; reload and retry.
+            pos = atomic_load_explicit(&this->dequeue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+// Returns the number of elements; a snapshot when other threads are active.
+static size_t count(const struct IArray *self) {
+    struct MpmcQueue *this = (struct MpmcQueue *) self;
+
+    // Read the consumer side first so the difference cannot underflow past a concurrent shift.
+    const size_t head = atomic_load_explicit(&this->dequeue_pos, memory_order_acquire);
+    const size_t tail = atomic_load_explicit(&this->enqueue_pos, memory_order_acquire);
+
+    const size_t count = tail - head;
+    return count > this->mask + 1 ? this->mask + 1 : count;
+}
+
+// Removes the elements present at the time of the call by draining the queue.
+static void clear(struct IArray *self, void (*destructor)(void *item)) {
+    for (size_t remaining = count(self); remaining > 0; remaining--) {
+        const void *item = shift(self);
+        if (destructor && item) destructor((void *) item);
+    }
+}
+
+// Releases an MpmcQueue instance and its ring.
+static void dealloc(struct IArray *self, void (*destructor)(void *item)) {
+    struct MpmcQueue *this = (struct MpmcQueue *) self;
+
+    clear(self, destructor);
+
+    free(this->cells);
+    free(this);
+}
+
+// Returns the aligned allocation size for MpmcQueue.
+static size_t size(void) {
+    return (sizeof(struct MpmcQueue) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u); // Align to pointer size.
+}
+
+// Allocates an MpmcQueue instance.
+static struct IArray *alloc() {
+    struct IArray *array = malloc(size());
+
+    if (array == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::MpmcQueue::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return array;
+}
+
+// Initializes an MpmcQueue instance with room for at least `capacity` elements.
+static struct IArray *init(struct IArray *array, const size_t capacity) {
+    if (array == NULL) return NULL;
+
+    struct MpmcQueue *this = (struct MpmcQueue *) array;
+    memset(this, 0, sizeof(struct MpmcQueue));
+
+    size_t cells = MIN_CAPACITY;
+    while (cells < capacity && cells <= SIZE_MAX / 2 / sizeof(struct MpmcCell)) cells <<= 1;
+
+    this->cells = malloc(cells * sizeof(struct MpmcCell));
+    if (this->cells == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::MpmcQueue::init] ERROR: Ring allocation failed.\033[0m\n");
+        goto exception;
+    }
+
+    for (size_t i = 0; i < cells; i++) {
+        atomic_init(&this->cells[i].sequence, i);
+        this->cells[i].item = NULL;
+    }
+    this->mask = cells - 1;
+    atomic_init(&this->enqueue_pos, 0);
+    atomic_init(&this->dequeue_pos, 0);
+
+    this->super.get = array_unsupported_get;
+    this->super.put = array_unsupported_put;
+    this->super.for_each = array_unsupported_for_each;
+    this->super.find = array_unsupported_find;
+    this->super.first_index = array_unsupported_index;
+    this->super.last_index = array_unsupported_index;
+    this->super.unshift = array_unsupported_unshift;
+    this->super.push = push;
+    this->super.contains_value = array_unsupported_contains_value;
+    this->super.shift = shift;
+    this->super.pop = array_unsupported_pop;
+    this->super.remove_item = array_unsupported_remove_item;
+    this->super.clone = array_unsupported_clone;
+    this->super.count = count;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return array;
+
+exception:
+    free(array);
+    return NULL;
+}
+
+// Creates a new lock-free bounded MPMC queue.
+struct IArray *collection_array_new_mpmc(const size_t capacity) {
+    return init(alloc(), capacity);
+}
@@ -0,0 +1,46 @@
+/**
+ * @file mpmc_queue.h
+ * @internal
+ * @brief Lock-Free MPMC Queue Header
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include "collection/i_array.h"
+#include "compiler.h"
+
+#include <stdatomic.h>
+
+/**
+ * @struct MpmcCell
+ * @brief Ring slot guarded by a sequence number.
+ *
+ * A cell at position p is writable when sequence == p and readable when
+ * sequence == p + 1. Consumers advance it to p + capacity for the next lap.
+ */
+struct MpmcCell {
+    atomic_size_t sequence;             /**< Lap-tagged state of the cell. */
+    const void *item;                   /**< Stored item pointer, published by sequence. */
+};
+
+/**
+ * @struct MpmcQueue
+ * @brief Bounded multi-producer/multi-consumer queue implementation of IArray.
+ *
+ * Follows Dmitry Vyukov's bounded MPMC design: producers and consumers each
+ * claim positions with a CAS on their own counter and synchronize with each
+ * other only through the per-cell sequence numbers, so no operation blocks or
+ * enters the kernel. The counters live on separate cache lines.
+ */
+struct MpmcQueue {
+    struct IArray super;                /**< IArray interface implemented by this type. */
+    struct MpmcCell *cells;             /**< Ring of cells. */
+    size_t mask;                        /**< Capacity - 1; the capacity is a power of two. */
+    char pad0[CACHE_LINE_SIZE];         /**< Keeps enqueue_pos off the read-mostly line above. */
+    atomic_size_t enqueue_pos;          /**< Next position to claim for push. */
+    char pad1[CACHE_LINE_SIZE - sizeof(atomic_size_t)];
+    atomic_size_t dequeue_pos;          /**< Next position to claim for shift. */
+    char pad2[CACHE_LINE_SIZE - sizeof(atomic_size_t)];
+};
@@ -0,0 +1,284 @@
+/**
+ * @file node_pool.c
+ * @internal
+ * @brief Node Pool Implementation
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "node_pool.h"
+#include "compiler.h"
+#include "collection/i_platform.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+#ifdef COLLECTION_NODE_POOL
+
+#define BATCH_SIZE 64                   // Nodes exchanged between a thread cache and its pool at once.
+#define CACHE_LIMIT (2 * BATCH_SIZE)    // Cached nodes per pool before a batch is returned.
+#define SLAB_SIZE (64 * 1024)           // Bytes per slab, including its header; also the Windows allocation granularity.
+#define SLAB_ALIGNMENT 16               // Alignment of the first node in a slab.
+
+/**
+ * @brief Header at the start of every slab.
+ */
+struct NodePoolSlab {
+    struct NodePoolSlab *next;          // Next slab on the pool's partial list.
+    struct NodePoolSlab *prev;          // Previous slab on the pool's partial list.
+    struct NodePoolBatch *free;         // Nodes returned to this slab.
+    char *cursor;                       // Next uncarved node.
+    char *end;                          // End of the slab.
+    size_t used;                        // Nodes held by thread caches or callers.
+    bool listed;                        // Whether the slab is on the pool's partial list.
+};
+
+/**
+ * @brief Per-thread free lists, one per pool.
+ */
+struct ThreadCache {
+    struct NodePoolBatch *head[NODE_POOL_COUNT];    // Cached free nodes.
+    size_t count[NODE_POOL_COUNT];                  // Approximate number of cached nodes.
+    struct NodePool *pools[NODE_POOL_COUNT];        // Pools this thread has used, for flushing on exit.
+    bool registered;                                // Whether the exit hook is armed for this thread.
+};
+
+static THREAD_LOCAL struct ThreadCache cache;
+
+static MutexOnce once = MUTEX_ONCE_INIT;
+static Mutex mutex;                     // Protects the shared state of every pool.
+static bool mutex_valid;                // False if the lock could not be created; pools then never hand out nodes.
+static ThreadKey exit_key;              // Flushes a thread's cache when it exits.
+static bool exit_key_valid;
+
+// Returns the slab a node was carved from.
+static struct NodePoolSlab *slab_of(const void *node) {
+    return (struct NodePoolSlab *) ((uintptr_t) node & ~(uintptr_t) (SLAB_SIZE - 1));
+}
+
+// Maps an empty slab aligned to its own size, so slab_of() can find it from any of its nodes.
+static struct NodePoolSlab *slab_alloc(void) {
+#ifdef _WIN32
+    struct NodePoolSlab *slab = VirtualAlloc(NULL, SLAB_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE); // 64 KiB granular.
+#else
+    // Map twice the size and unmap both ends so the slab starts on a SLAB_SIZE boundary.
+    struct NodePoolSlab *slab = NULL;
+    char *memory = mmap(NULL, 2 * SLAB_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory != MAP_FAILED) {
+        char *start = (char *) (((uintptr_t) memory + SLAB_SIZE - 1) & ~(uintptr_t) (SLAB_SIZE - 1));
+        if (start != memory) munmap(memory, (size_t) (start - memory));
+        munmap(start + SLAB_SIZE, (size_t) (memory + SLAB_SIZE - start));
+        slab = (struct NodePoolSlab *) start;
+    }
+#endif
+    if (slab == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::NodePool::slab_alloc] Error: Failed to map slab.\033[0m\n");
+        return NULL;
+    }
+
+    const size_t header = (sizeof(struct NodePoolSlab) + SLAB_ALIGNMENT - 1) & ~(size_t) (SLAB_ALIGNMENT - 1);
+    *slab = (struct NodePoolSlab) {
+        .cursor = (char *) slab + header,
+        .end = (char *) slab + SLAB_SIZE,
+    };
+    return slab;
+}
+
+// Unmaps a slab, returning its pages to the operating system.
+static void slab_free(struct NodePoolSlab *slab) {
+#ifdef _WIN32
+    VirtualFree(slab, 0, MEM_RELEASE);
+#else
+    munmap(slab, SLAB_SIZE);
+#endif
+}
+
+// Links a slab at the head of the pool's partial list.
+static void slab_link(struct NodePool *pool, struct NodePoolSlab *slab) {
+    slab->prev = NULL;
+    slab->next = pool->partial;
+    if (pool->partial) pool->partial->prev = slab;
+    pool->partial = slab;
+    slab->listed = true;
+}
+
+// Unlinks a slab from the pool's partial list.
+static void slab_unlink(struct NodePool *pool, struct NodePoolSlab *slab) {
+    if (slab->prev) slab->prev->next = slab->next;
+    else pool->partial = slab->next;
+    if (slab->next) slab->next->prev = slab->prev;
+    slab->next = slab->prev = NULL;
+    slab->listed = false;
+}
+
+// Returns the distance between consecutive nodes of a pool.
+static size_t stride(const struct NodePool *pool) {
+    const size_t size = pool->node_size < sizeof(struct NodePoolBatch) ? sizeof(struct NodePoolBatch) : pool->node_size;
+    return (size + (sizeof(uint64_t) - 1u)) & ~(sizeof(uint64_t) - 1u);
+}
+
+// Takes up to BATCH_SIZE nodes from the pool's most recently used slab, allocating a slab if none has room.
+static struct NodePoolBatch *take_batch(struct NodePool *pool, size_t *count) {
+    const size_t node_stride = stride(pool);
+
+    struct NodePoolSlab *slab = pool->partial;
+    if (slab == NULL) {
+        slab = slab_alloc();
+        if (slab == NULL) return NULL;
+        slab_link(pool, slab);
+    }
+
+    // Reuse returned nodes first, then carve in address order so consecutive allocations are adjacent in memory.
+    struct NodePoolBatch *head = NULL, **tail = &head;
+    size_t taken = 0;
+    for (; taken < BATCH_SIZE && slab->free; taken++) {
+        *tail = slab->free;
+        slab->free = slab->free->next;
+        tail = &(*tail)->next;
+    }
+    for (; taken < BATCH_SIZE && (size_t) (slab->end - slab->cursor) >= node_stride; taken++) {
+        *tail = (struct NodePoolBatch *) slab->cursor;
+        slab->cursor += node_stride;
+        tail = &(*tail)->next;
+    }
+    *tail = NULL;
+
+    slab->used += taken;
+    if (slab->free == NULL && (size_t) (slab->end - slab->cursor) < node_stride) slab_unlink(pool, slab); // Exhausted.
+
+    *count = taken;
+    return head;
+}
+
+// Returns a list of nodes to their slabs and releases slabs left without nodes in use.
+static void give_back(struct NodePool *pool, struct NodePoolBatch *node) {
+    while (node) {
+        struct NodePoolBatch *next = node->next;
+        struct NodePoolSlab *slab = slab_of(node);
+
+        node->next = slab->free;
+        slab->free = node;
+        if (!slab->listed) slab_link(pool, slab);
+
+        // Keep the pool's last partial slab so alternating alloc/free at a batch boundary does not thrash mmap/munmap.
+        if (--slab->used == 0 && (pool->partial != slab || slab->next != NULL)) {
+            slab_unlink(pool, slab);
+            slab_free(slab);
+        }
+        node = next;
+    }
+}
+
+// Returns every cached node of an exiting thread to the shared pools.
+static void flush_thread(void *value) {
+    struct ThreadCache *thread_cache = value;
+
+    mutex_lock(&mutex);
+    for (size_t id = 0; id < NODE_POOL_COUNT; id++) {
+        if (thread_cache->head[id] == NULL) continue;
+
+        give_back(thread_cache->pools[id], thread_cache->head[id]);
+        thread_cache->head[id] = NULL;
+        thread_cache->count[id] = 0;
+    }
+    mutex_unlock(&mutex);
+
+    thread_cache->registered = false;
+}
+
+// Initializes the shared lock and the thread exit hook.
+static void init_once(void) {
+    if (mutex_init(&mutex) != 0) {
+        fprintf(stderr, "\033[0;31m[Collection::NodePool::init] Error: Mutex initialization failed.\033[0m\n");
+        return;
+    }
+    mutex_valid = true;
+    mutex_set_name(&mutex, "Collection::NodePool");
+    exit_key_valid = thread_key_create(&exit_key, flush_thread) == 0;
+}
+
+// Arms the thread exit hook the first time a thread touches a pool. Returns false if the pools are unusable.
+static bool register_thread(struct NodePool *pool) {
+    mutex_once(&once, init_once);
+    if (!mutex_valid) return false;
+
+    cache.pools[pool->id] = pool;
+    if (!cache.registered && exit_key_valid) {
+        cache.registered = thread_key_set(exit_key, &cache) == 0;
+    }
+    return true;
+}
+
+// Moves one batch from the shared pool into the calling thread's cache.
+static bool refill(struct NodePool *pool) {
+    if (!register_thread(pool)) return false;
+
+    size_t count = 0;
+    mutex_lock(&mutex);
+    struct NodePoolBatch *batch = take_batch(pool, &count);
+    mutex_unlock(&mutex);
+
+    if (batch == NULL) return false;
+
+    cache.head[pool->id] = batch;
+    cache.count[pool->id] = count;
+    return true;
+}
+
+// Allocates one node from the pool.
+void *node_pool_alloc(struct NodePool *pool) {
+    struct NodePoolBatch *node = cache.head[pool->id];
+    if (node == NULL) {
+        if (!refill(pool)) return NULL;
+        node = cache.head[pool->id];
+    }
+
+    cache.head[pool->id] = node->next;
+    if (cache.count[pool->id] > 0) cache.count[pool->id]--;
+    return node;
+}
+
+// Returns a node to the pool.
+void node_pool_free(struct NodePool *pool, void *node) {
+    if (node == NULL) return;
+    if (!cache.registered) register_thread(pool);
+
+    struct NodePoolBatch *free_node = node;
+    free_node->next = cache.head[pool->id];
+    cache.head[pool->id] = free_node;
+    cache.pools[pool->id] = pool;
+
+    if (++cache.count[pool->id] <= CACHE_LIMIT) return;
+
+    // Detach the most recently freed batch and hand it back under one lock acquisition.
+    struct NodePoolBatch *tail = free_node;
+    for (size_t i = 1; i < BATCH_SIZE && tail->next; i++) tail = tail->next;
+    cache.head[pool->id] = tail->next;
+    cache.count[pool->id] -= BATCH_SIZE;
+    tail->next = NULL;
+
+    mutex_lock(&mutex);
+    give_back(pool, free_node);
+    mutex_unlock(&mutex);
+}
+
+#else
+
+// Allocates one node from the system allocator.
+void *node_pool_alloc(struct NodePool *pool) {
+    return malloc(pool->node_size);
+}
+
+// Returns a node to the system allocator.
+void node_pool_free(struct NodePool *pool, void *node) {
+    (void) pool;
+    free(node);
+}
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file node_pool.h
+ * @internal
+ * @brief Node Pool Header
+ *
+ * Fixed-size node allocator used for list and hash chain nodes. Nodes are
+ * carved from large slabs, cached per thread, and exchanged with the shared
+ * pool in whole batches, so steady-state node churn never reaches the
+ * operating system and rarely takes a lock. Slabs are mapped directly from the
+ * operating system, and those whose nodes have all been returned are unmapped.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * @brief Identifies a pool's slot in the per-thread caches.
+ */
+enum NodePoolId {
+    NODE_POOL_ARRAY_NODE,               /**< struct ArrayNode. */
+    NODE_POOL_DICTIONARY_NODE,          /**< struct DictionaryNode with an inline key. */
+    NODE_POOL_DICTIONARY_REF_NODE,      /**< struct DictionaryNode referring to a borrowed or interned key. */
+    NODE_POOL_COUNT                     /**< Number of pools. */
+};
+
+/**
+ * @struct NodePoolBatch
+ * @brief Free node linked into a thread's cache or its slab's free list.
+ */
+struct NodePoolBatch {
+    struct NodePoolBatch *next;         /**< Next free node in this batch or slab. */
+};
+
+struct NodePoolSlab;
+
+/**
+ * @struct NodePool
+ * @brief Shared state of a fixed-size node pool.
+ *
+ * Pools are process-global, one per node type, so containers filled at the same
+ * time share slabs; nodes a thread allocates in sequence come from the same slab
+ * and sit next to each other. A slab is released once every node carved from it
+ * is back in the pool, except the last slab with free nodes, which is kept to
+ * absorb the next burst. Fields other than id and node_size are protected by a
+ * lock shared by all pools.
+ */
+struct NodePool {
+    const enum NodePoolId id;           /**< Slot in the per-thread caches. */
+    const size_t node_size;             /**< Requested node size in bytes. */
+    struct NodePoolSlab *partial;       /**< Slabs with free or uncarved nodes, most recently used first. */
+};
+
+/**
+ * @brief Static initializer for a NodePool.
+ */
+#define NODE_POOL_INIT(pool_id, size) { (pool_id), (size), NULL }
+
+/**
+ * @brief Allocates one node from the pool.
+ *
+ * @param pool Pool to allocate from.
+ * @return Uninitialized node of at least pool->node_size bytes, or NULL if allocation fails.
+ */
+void *node_pool_alloc(struct NodePool *pool);
+
+/**
+ * @brief Returns a node to the pool.
+ *
+ * @param pool Pool the node was allocated from.
+ * @param node Node to release. May be NULL.
+ */
+void node_pool_free(struct NodePool *pool, void *node);
@@ -0,0 +1,92 @@
+#include "collection/i_platform.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Clock used for timed waits; macOS cannot bind condition variables to the monotonic clock.
+#ifdef __APPLE__
+#define CONDITION_CLOCK CLOCK_REALTIME
+#else
+#define CONDITION_CLOCK CLOCK_MONOTONIC
+#endif
+
+// Initializes a monitor lock.
+int monitor_init(Monitor *monitor) {
+    if (monitor == NULL) return -1;
+    return pthread_mutex_init(&monitor->mutex, NULL);
+}
+
+// Acquires a monitor lock.
+int monitor_lock(Monitor *monitor) {
+    if (monitor == NULL) return -1;
+    return pthread_mutex_lock(&monitor->mutex);
+}
+
+// Releases a monitor lock.
+int monitor_unlock(Monitor *monitor) {
+    if (monitor == NULL) return -1;
+    return pthread_mutex_unlock(&monitor->mutex);
+}
+
+// Destroys a monitor lock.
+int monitor_destroy(Monitor *monitor) {
+    if (monitor == NULL) return -1;
+    return pthread_mutex_destroy(&monitor->mutex);
+}
+
+// Initializes a condition variable.
+int condition_init(Condition *condition) {
+    if (condition == NULL) return -1;
+
+    pthread_condattr_t attr;
+    int result = pthread_condattr_init(&attr);
+    if (result != 0) return result;
+#ifndef __APPLE__
+    result = pthread_condattr_setclock(&attr, CONDITION_CLOCK); // Immune to wall-clock adjustments.
+#endif
+    if (result == 0) result = pthread_cond_init(&condition->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    return result;
+}
+
+// Waits for a signal or until the timeout elapses.
+int condition_wait(Condition *condition, Monitor *monitor, const long timeout_ms) {
+    if (condition == NULL || monitor == NULL) return -1;
+    if (timeout_ms < 0) return pthread_cond_wait(&condition->cond, &monitor->mutex);
+
+    struct timespec deadline;
+    clock_gettime(CONDITION_CLOCK, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return pthread_cond_timedwait(&condition->cond, &monitor->mutex, &deadline);
+}
+
+// Wakes at least one waiting thread.
+int condition_signal(Condition *condition) {
+    if (condition == NULL) return -1;
+    return pthread_cond_signal(&condition->cond);
+}
+
+// Wakes every waiting thread.
+int condition_broadcast(Condition *condition) {
+    if (condition == NULL) return -1;
+    return pthread_cond_broadcast(&condition->cond);
+}
+
+// Destroys a condition variable.
+int condition_destroy(Condition *condition) {
+    if (condition == NULL) return -1;
+    return pthread_cond_destroy(&condition->cond);
+}
+
+// Returns nanoseconds on the monotonic clock.
+uint64_t clock_monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
@@ -1,4 +1,5 @@
 #include "collection/i_platform.h"
+#include "lock_profile.h"
 
 #include <pthread.h>
 #include <stdlib.h>
@@ -6,30 +7,62 @@
 // Initializes a mutex.
 int mutex_init(Mutex *mutex) {
     if (mutex == NULL) return -1;
-    return pthread_rwlock_init(&mutex->rwlock, NULL);
+    const int result = pthread_rwlock_init(&mutex->rwlock, NULL);
+#ifdef COLLECTION_LOCK_PROFILING
+    if (result == 0) lock_profile_attach(mutex);
+#endif
+    return result;
 }
 
 // Acquires an exclusive mutex lock.
 int mutex_lock(Mutex *mutex) {
     if (mutex == NULL) return -1;
+#ifdef COLLECTION_LOCK_PROFILING
+    if (pthread_rwlock_trywrlock(&mutex->rwlock) == 0) {
+        lock_profile_acquired(mutex, LOCK_EXCLUSIVE, false, 0);
+        return 0;
+    }
+    const uint64_t begin = clock_monotonic_ns();
+    const int result = pthread_rwlock_wrlock(&mutex->rwlock);
+    if (result == 0) lock_profile_acquired(mutex, LOCK_EXCLUSIVE, true, begin);
+    return result;
+#else
     return pthread_rwlock_wrlock(&mutex->rwlock);
+#endif
 }
 
 // Acquires a shared mutex lock.
 int mutex_lock_shared(Mutex *mutex) {
     if (mutex == NULL) return -1;
+#ifdef COLLECTION_LOCK_PROFILING
+    if (pthread_rwlock_tryrdlock(&mutex->rwlock) == 0) {
+        lock_profile_acquired(mutex, LOCK_SHARED, false, 0);
+        return 0;
+    }
+    const uint64_t begin = clock_monotonic_ns();
+    const int result = pthread_rwlock_rdlock(&mutex->rwlock);
+    if (result == 0) lock_profile_acquired(mutex, LOCK_SHARED, true, begin);
+    return result;
+#else
     return pthread_rwlock_rdlock(&mutex->rwlock);
+#endif
 }
 
 // Releases a mutex lock.
 int mutex_unlock(Mutex *mutex) {
     if (mutex == NULL) return -1;
+#ifdef COLLECTION_LOCK_PROFILING
+    lock_profile_released(mutex);
+#endif
     return pthread_rwlock_unlock(&mutex->rwlock);
 }
 
 // Destroys a mutex.
 int mutex_destroy(Mutex *mutex) {
     if (mutex == NULL) return -1;
+#ifdef COLLECTION_LOCK_PROFILING
+    lock_profile_detach(mutex);
+#endif
     return pthread_rwlock_destroy(&mutex->rwlock);
 }
 
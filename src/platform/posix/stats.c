@@ -0,0 +1,59 @@
+#include "collection/i_platform.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// Returns the current resident set size in bytes, or 0 where /proc is unavailable.
+static double current_rss_bytes(void) {
+#ifdef __linux__
+    unsigned long size, resident;
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (file != NULL) {
+        const int fields = fscanf(file, "%lu %lu", &size, &resident);
+        fclose(file);
+        if (fields == 2) return (double) resident * (double) sysconf(_SC_PAGESIZE);
+    }
+
+    file = fopen("/proc/self/status", "r"); // Fallback when statm is masked, e.g. by some sandboxes.
+    if (file != NULL) {
+        char line[128];
+        unsigned long kilobytes = 0;
+        while (fgets(line, sizeof(line), file) != NULL) {
+            if (strncmp(line, "VmRSS:", 6) == 0) {
+                sscanf(line + 6, "%lu", &kilobytes);
+                break;
+            }
+        }
+        fclose(file);
+        return (double) kilobytes * 1024.0;
+    }
+#endif
+    return 0;
+}
+
+// Collects resource usage of the calling process.
+int process_stats_collect(struct process_stats *out) {
+    if (out == NULL) return -1;
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+
+#ifdef __APPLE__
+    out->max_rss_mb = (double) usage.ru_maxrss / (1024.0 * 1024.0); // Reported in bytes.
+#else
+    out->max_rss_mb = (double) usage.ru_maxrss / 1024.0; // Reported in kilobytes.
+#endif
+    out->current_rss_mb = current_rss_bytes() / (1024.0 * 1024.0);
+
+    out->user_cpu_sec = (double) usage.ru_utime.tv_sec + (double) usage.ru_utime.tv_usec / 1e6;
+    out->system_cpu_sec = (double) usage.ru_stime.tv_sec + (double) usage.ru_stime.tv_usec / 1e6;
+
+    out->minor_page_faults = usage.ru_minflt;
+    out->major_page_faults = usage.ru_majflt;
+
+    out->voluntary_ctx_switches = usage.ru_nvcsw;
+    out->involuntary_ctx_switches = usage.ru_nivcsw;
+    return 0;
+}
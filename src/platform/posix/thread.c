@@ -0,0 +1,24 @@
+#include "collection/i_platform.h"
+
+#include <pthread.h>
+
+// Creates a thread-specific storage key.
+int thread_key_create(ThreadKey *key, void (*destructor)(void *value)) {
+    if (key == NULL) return -1;
+    return pthread_key_create(key, destructor);
+}
+
+// Associates a value with a key for the calling thread.
+int thread_key_set(const ThreadKey key, void *value) {
+    return pthread_setspecific(key, value);
+}
+
+// Returns the calling thread's value for a key.
+void *thread_key_get(const ThreadKey key) {
+    return pthread_getspecific(key);
+}
+
+// Deletes a thread-specific storage key.
+int thread_key_delete(const ThreadKey key) {
+    return pthread_key_delete(key);
+}
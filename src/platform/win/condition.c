@@ -0,0 +1,76 @@
+#include "collection/i_platform.h"
+
+#include <stdlib.h>
+
+// Initializes a monitor lock.
+int monitor_init(Monitor *monitor) {
+    if (monitor == NULL) return -1;
+    InitializeCriticalSection(&monitor->cs);
+    return 0;
+}
+
+// Acquires a monitor lock.
+int monitor_lock(Monitor *monitor) {
+    if (monitor == NULL) return -1;
+    EnterCriticalSection(&monitor->cs);
+    return 0;
+}
+
+// Releases a monitor lock.
+int monitor_unlock(Monitor *monitor) {
+    if (monitor == NULL) return -1;
+    LeaveCriticalSection(&monitor->cs);
+    return 0;
+}
+
+// Destroys a monitor lock.
+int monitor_destroy(Monitor *monitor) {
+    if (monitor == NULL) return -1;
+    DeleteCriticalSection(&monitor->cs);
+    return 0;
+}
+
+// Initializes a condition variable.
+int condition_init(Condition *condition) {
+    if (condition == NULL) return -1;
+    InitializeConditionVariable(&condition->cv);
+    return 0;
+}
+
+// Waits for a signal or until the timeout elapses.
+int condition_wait(Condition *condition, Monitor *monitor, const long timeout_ms) {
+    if (condition == NULL || monitor == NULL) return -1;
+    const DWORD timeout = timeout_ms < 0 ? INFINITE : (DWORD) timeout_ms;
+    return SleepConditionVariableCS(&condition->cv, &monitor->cs, timeout) ? 0 : -1;
+}
+
+// Wakes at least one waiting thread.
+int condition_signal(Condition *condition) {
+    if (condition == NULL) return -1;
+    WakeConditionVariable(&condition->cv);
+    return 0;
+}
+
+// Wakes every waiting thread.
+int condition_broadcast(Condition *condition) {
+    if (condition == NULL) return -1;
+    WakeAllConditionVariable(&condition->cv);
+    return 0;
+}
+
+// Destroys a condition variable. Windows condition variables hold no resources.
+int condition_destroy(Condition *condition) {
+    if (condition == NULL) return -1;
+    return 0;
+}
+
+// Returns nanoseconds on the performance counter.
+uint64_t clock_monotonic_ns(void) {
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency); // Fixed at boot; racing writers store the same value.
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (uint64_t) (now.QuadPart / frequency.QuadPart) * 1000000000u
+           + (uint64_t) (now.QuadPart % frequency.QuadPart) * 1000000000u / (uint64_t) frequency.QuadPart;
+}
@@ -1,4 +1,5 @@
 #include "collection/i_platform.h"
+#include "lock_profile.h"
 
 #include <stdlib.h>
 
@@ -6,26 +7,52 @@
 int mutex_init(Mutex *mutex) {
     if (mutex == NULL) return -1;
     InitializeCriticalSection(&mutex->cs);
+#ifdef COLLECTION_LOCK_PROFILING
+    lock_profile_attach(mutex);
+#endif
     return 0;
 }
 
 // Acquires an exclusive mutex lock.
 int mutex_lock(Mutex *mutex) {
     if (mutex == NULL) return -1;
+#ifdef COLLECTION_LOCK_PROFILING
+    if (TryEnterCriticalSection(&mutex->cs)) {
+        lock_profile_acquired(mutex, LOCK_EXCLUSIVE, false, 0);
+        return 0;
+    }
+    const uint64_t begin = clock_monotonic_ns();
     EnterCriticalSection(&mutex->cs);
+    lock_profile_acquired(mutex, LOCK_EXCLUSIVE, true, begin);
+#else
+    EnterCriticalSection(&mutex->cs);
+#endif
     return 0;
 }
 
 // Acquires a shared mutex lock.
 int mutex_lock_shared(Mutex *mutex) {
     if (mutex == NULL) return -1;
+#ifdef COLLECTION_LOCK_PROFILING
+    if (TryEnterCriticalSection(&mutex->cs)) {
+        lock_profile_acquired(mutex, LOCK_SHARED, false, 0);
+        return 0;
+    }
+    const uint64_t begin = clock_monotonic_ns();
+    EnterCriticalSection(&mutex->cs);
+    lock_profile_acquired(mutex, LOCK_SHARED, true, begin);
+#else
     EnterCriticalSection(&mutex->cs);
+#endif
     return 0;
 }
 
 // Releases a mutex lock.
 int mutex_unlock(Mutex *mutex) {
     if (mutex == NULL) return -1;
+#ifdef COLLECTION_LOCK_PROFILING
+    lock_profile_released(mutex);
+#endif
     LeaveCriticalSection(&mutex->cs);
     return 0;
 }
@@ -33,6 +60,9 @@ int mutex_unlock(Mutex *mutex) {
 // Destroys a mutex.
 int mutex_destroy(Mutex *mutex) {
     if (mutex == NULL) return -1;
+#ifdef COLLECTION_LOCK_PROFILING
+    lock_profile_detach(mutex);
+#endif
     DeleteCriticalSection(&mutex->cs);
     return 0;
 }
@@ -0,0 +1,36 @@
+#include "collection/i_platform.h"
+
+#ifndef PSAPI_VERSION
+#define PSAPI_VERSION 2 // Resolve GetProcessMemoryInfo from kernel32 without linking psapi.lib.
+#endif
+#include <psapi.h>
+
+// Converts a FILETIME duration in 100 ns ticks to seconds.
+static double filetime_seconds(const FILETIME time) {
+    const ULARGE_INTEGER ticks = {.LowPart = time.dwLowDateTime, .HighPart = time.dwHighDateTime};
+    return (double) ticks.QuadPart / 1e7;
+}
+
+// Collects resource usage of the calling process. Windows does not count context switches per process.
+int process_stats_collect(struct process_stats *out) {
+    if (out == NULL) return -1;
+
+    const HANDLE process = GetCurrentProcess();
+    PROCESS_MEMORY_COUNTERS memory;
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessMemoryInfo(process, &memory, sizeof(memory))) return -1;
+    if (!GetProcessTimes(process, &creation, &exit, &kernel, &user)) return -1;
+
+    out->max_rss_mb = (double) memory.PeakWorkingSetSize / (1024.0 * 1024.0);
+    out->current_rss_mb = (double) memory.WorkingSetSize / (1024.0 * 1024.0);
+
+    out->user_cpu_sec = filetime_seconds(user);
+    out->system_cpu_sec = filetime_seconds(kernel);
+
+    out->minor_page_faults = (long) memory.PageFaultCount; // Soft and hard faults are not distinguished.
+    out->major_page_faults = 0;
+
+    out->voluntary_ctx_switches = 0;
+    out->involuntary_ctx_switches = 0;
+    return 0;
+}
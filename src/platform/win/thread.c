@@ -0,0 +1,26 @@
+#include "collection/i_platform.h"
+
+// Creates a thread-specific storage key.
+int thread_key_create(ThreadKey *key, void (*destructor)(void *value)) {
+    if (key == NULL) return -1;
+
+    // FLS callbacks run on thread exit like pthread key destructors. The callback type only differs
+    // by calling convention, which is the same as the C default on x64 and ARM64.
+    *key = FlsAlloc((PFLS_CALLBACK_FUNCTION) destructor);
+    return *key == FLS_OUT_OF_INDEXES ? -1 : 0;
+}
+
+// Associates a value with a key for the calling thread.
+int thread_key_set(const ThreadKey key, void *value) {
+    return FlsSetValue(key, value) ? 0 : -1;
+}
+
+// Returns the calling thread's value for a key.
+void *thread_key_get(const ThreadKey key) {
+    return FlsGetValue(key);
+}
+
+// Deletes a thread-specific storage key.
+int thread_key_delete(const ThreadKey key) {
+    return FlsFree(key) ? 0 : -1;
+}
@@ -0,0 +1,232 @@
+/**
+* @file recording_array.c
+* @internal
+* @brief Recording Array Implementation
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#include "recording_array.h"
+#include "trace.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @struct CountingPredicate
+ * @brief Forwards to the caller's predicate while counting how often it is invoked.
+ */
+struct CountingPredicate {
+    bool (*predicate)(const void *element, const void *data); /**< Caller's predicate. */
+    const void *data;                   /**< Caller's predicate data. */
+    uint64_t calls;                     /**< Number of invocations so far. */
+};
+
+// Invokes the caller's predicate and counts the call.
+static bool counting_predicate(const void *element, const void *data) {
+    struct CountingPredicate *counting = (struct CountingPredicate *) data;
+    counting->calls++;
+    return counting->predicate(element, counting->data);
+}
+
+// Records an array operation.
+static void record(const struct RecordingArray *this, const enum CollectionTraceOp op, const bool succeeded,
+                   const uint64_t index) {
+    struct CollectionTraceRecord record = {
+        .op = (uint8_t) op, .flags = succeeded ? COLLECTION_TRACE_SUCCEEDED : 0, .index = index
+    };
+    trace_append(this->trace, &record, 1);
+}
+
+// Returns the element at the specified index.
+static const void *get(const struct IArray *self, const size_t index) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    const void *item = this->inner->get(this->inner, index);
+    record(this, COLLECTION_TRACE_ARRAY_GET, item != NULL, index);
+    return item;
+}
+
+// Replaces the element at the specified index.
+static void *put(struct IArray *self, const void *item, const size_t index) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    void *previous = this->inner->put(this->inner, item, index);
+    record(this, COLLECTION_TRACE_ARRAY_PUT, previous != NULL, index);
+    return previous;
+}
+
+// Invokes a callback for each element.
+static void for_each(const struct IArray *self, void (*consumer)(const void *element, const void *data), const void *data) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    this->inner->for_each(this->inner, consumer, data);
+    record(this, COLLECTION_TRACE_ARRAY_FOR_EACH, true, 0);
+}
+
+// Finds the first element matching a predicate.
+static const void *find(const struct IArray *self, bool (*predicate)(const void *element, const void *data), const void *data) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    struct CountingPredicate counting = {.predicate = predicate, .data = data};
+    const void *item = this->inner->find(this->inner, counting_predicate, &counting);
+    record(this, COLLECTION_TRACE_ARRAY_FIND, item != NULL, counting.calls);
+    return item;
+}
+
+// Returns the index of the first matching element.
+static size_t first_index(const struct IArray *self, bool (*predicate)(const void *element, const void *data), const void *data) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    struct CountingPredicate counting = {.predicate = predicate, .data = data};
+    const size_t index = this->inner->first_index(this->inner, counting_predicate, &counting);
+    record(this, COLLECTION_TRACE_ARRAY_FIRST_INDEX, index != SIZE_MAX, counting.calls);
+    return index;
+}
+
+// Returns the index of the last matching element.
+static size_t last_index(const struct IArray *self, bool (*predicate)(const void *element, const void *data), const void *data) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    struct CountingPredicate counting = {.predicate = predicate, .data = data};
+    const size_t index = this->inner->last_index(this->inner, counting_predicate, &counting);
+    record(this, COLLECTION_TRACE_ARRAY_LAST_INDEX, index != SIZE_MAX, counting.calls);
+    return index;
+}
+
+// Inserts an element at the beginning.
+static const void *unshift(struct IArray *self, const void *item) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    const void *inserted = this->inner->unshift(this->inner, item);
+    record(this, COLLECTION_TRACE_ARRAY_UNSHIFT, inserted != NULL, 0);
+    return inserted;
+}
+
+// Appends an element to the end.
+static bool push(struct IArray *self, const void *item) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    const bool pushed = this->inner->push(this->inner, item);
+    record(this, COLLECTION_TRACE_ARRAY_PUSH, pushed, 0);
+    return pushed;
+}
+
+// Determines whether the array contains the specified element.
+static bool contains_value(const struct IArray *self, const void *item) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    const bool found = this->inner->contains_value(this->inner, item);
+    record(this, COLLECTION_TRACE_ARRAY_CONTAINS_VALUE, found, 0);
+    return found;
+}
+
+// Removes and returns the first element.
+static const void *shift(struct IArray *self) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    const void *item = this->inner->shift(this->inner);
+    record(this, COLLECTION_TRACE_ARRAY_SHIFT, item != NULL, 0);
+    return item;
+}
+
+// Removes and returns the last element.
+static const void *pop(struct IArray *self) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    const void *item = this->inner->pop(this->inner);
+    record(this, COLLECTION_TRACE_ARRAY_POP, item != NULL, 0);
+    return item;
+}
+
+// Removes the specified element.
+static void *remove_item(struct IArray *self, const void *item) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    void *removed = this->inner->remove_item(this->inner, item);
+    record(this, COLLECTION_TRACE_ARRAY_REMOVE_ITEM, removed != NULL, 0);
+    return removed;
+}
+
+// Returns an unrecorded copy of the wrapped array.
+static struct IArray *clone(const struct IArray *self) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    struct IArray *copy = this->inner->clone(this->inner);
+    record(this, COLLECTION_TRACE_ARRAY_CLONE, copy != NULL, 0);
+    return copy;
+}
+
+// Returns the number of elements.
+static size_t count(const struct IArray *self) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    const size_t n = this->inner->count(this->inner);
+    record(this, COLLECTION_TRACE_ARRAY_COUNT, true, 0);
+    return n;
+}
+
+// Removes all elements.
+static void clear(struct IArray *self, void (*destructor)(void *item)) {
+    const struct RecordingArray *this = (const struct RecordingArray *) self;
+    this->inner->clear(this->inner, destructor);
+    record(this, COLLECTION_TRACE_ARRAY_CLEAR, true, 0);
+}
+
+// Records the deallocation, then releases the wrapped array and the decorator.
+static void dealloc(struct IArray *self, void (*destructor)(void *item)) {
+    struct RecordingArray *this = (struct RecordingArray *) self;
+
+    record(this, COLLECTION_TRACE_ARRAY_DEALLOC, true, 0);
+    this->inner->dealloc(this->inner, destructor);
+    free(this);
+}
+
+// Returns the aligned allocation size for RecordingArray.
+static size_t size(void) {
+    return (sizeof(struct RecordingArray) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u); // Align to pointer size.
+}
+
+// Allocates a RecordingArray instance.
+static struct IArray *alloc(void) {
+    struct IArray *array = malloc(size());
+
+    if (array == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::RecordingArray::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return array;
+}
+
+// Initializes a RecordingArray around an existing array.
+static struct IArray *init(struct IArray *array, struct IArray *inner, struct ITrace *trace) {
+    if (array == NULL) return NULL;
+
+    struct RecordingArray *this = (struct RecordingArray *) array;
+    memset(this, 0, sizeof(struct RecordingArray));
+
+    if (inner == NULL || trace == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::RecordingArray::init] Error: Array and trace are required.\033[0m\n");
+        goto exception;
+    }
+
+    this->inner = inner;
+    this->trace = trace;
+
+    this->super.get = get;
+    this->super.put = put;
+    this->super.for_each = for_each;
+    this->super.find = find;
+    this->super.first_index = first_index;
+    this->super.last_index = last_index;
+    this->super.unshift = unshift;
+    this->super.push = push;
+    this->super.contains_value = contains_value;
+    this->super.shift = shift;
+    this->super.pop = pop;
+    this->super.remove_item = remove_item;
+    this->super.clone = clone;
+    this->super.count = count;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return array;
+
+exception:
+    free(array);
+    return NULL;
+}
+
+// Creates an array that records every operation on the wrapped array.
+struct IArray *collection_array_new_recording(struct IArray *array, struct ITrace *trace) {
+    return init(alloc(), array, trace);
+}
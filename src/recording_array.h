@@ -0,0 +1,22 @@
+/**
+* @file recording_array.h
+* @internal
+* @brief Recording Array Header
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#pragma once
+
+#include "collection/i_array.h"
+#include "collection/i_trace.h"
+
+/**
+ * @struct RecordingArray
+ * @brief IArray decorator that appends a trace record for every forwarded operation.
+ */
+struct RecordingArray {
+    struct IArray super;                /**< IArray interface implemented by this type. */
+    struct IArray *inner;               /**< Wrapped array, owned by the decorator. */
+    struct ITrace *trace;               /**< Trace receiving the records. */
+};
@@ -0,0 +1,268 @@
+/**
+* @file recording_dictionary.c
+* @internal
+* @brief Recording Dictionary Implementation
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#include "recording_dictionary.h"
+#include "trace.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BATCH_INLINE 64                 // Batch records kept on the stack before allocating.
+
+// Records an operation on a key.
+static void record_key(const struct RecordingDictionary *this, const enum CollectionTraceOp op, const char *key,
+                       const bool succeeded) {
+    const size_t length = strlen(key);
+    struct CollectionTraceRecord record = {
+        .op = (uint8_t) op, .flags = succeeded ? COLLECTION_TRACE_SUCCEEDED : 0,
+        .key_length = (uint32_t) length, .key_hash = collection_hash(key, length)
+    };
+    trace_append(this->trace, &record, 1);
+}
+
+// Records an operation on a pre-hashed key.
+static void record_hashed(const struct RecordingDictionary *this, const enum CollectionTraceOp op,
+                          const struct CollectionKey *key, const bool succeeded) {
+    struct CollectionTraceRecord record = {
+        .op = (uint8_t) op, .flags = succeeded ? COLLECTION_TRACE_SUCCEEDED : 0,
+        .key_length = (uint32_t) key->length, .key_hash = key->hash
+    };
+    trace_append(this->trace, &record, 1);
+}
+
+// Records an operation on the whole dictionary.
+static void record_all(const struct RecordingDictionary *this, const enum CollectionTraceOp op, const bool succeeded) {
+    struct CollectionTraceRecord record = {.op = (uint8_t) op, .flags = succeeded ? COLLECTION_TRACE_SUCCEEDED : 0};
+    trace_append(this->trace, &record, 1);
+}
+
+// Records a batch as one contiguous run; each key succeeded if its value is non-NULL, or if every key succeeded.
+static void record_batch(const struct RecordingDictionary *this, const enum CollectionTraceOp op,
+                         const char *const *keys, const size_t count, void *const *values, const bool all_succeeded) {
+    struct CollectionTraceRecord inline_records[BATCH_INLINE];
+    struct CollectionTraceRecord *records = inline_records;
+    if (count > BATCH_INLINE && (records = malloc(count * sizeof(struct CollectionTraceRecord))) == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::RecordingDictionary::record_batch] Error: Batch not recorded.\033[0m\n");
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const size_t length = strlen(keys[i]);
+        const bool succeeded = values ? values[i] != NULL : all_succeeded;
+        records[i] = (struct CollectionTraceRecord) {
+            .op = (uint8_t) op, .flags = succeeded ? COLLECTION_TRACE_SUCCEEDED : 0,
+            .key_length = (uint32_t) length, .key_hash = collection_hash(keys[i], length), .index = count - i
+        };
+    }
+    trace_append(this->trace, records, count);
+
+    if (records != inline_records) free(records);
+}
+
+// Retrieves the value associated with the specified key.
+static void *get(const struct IDictionary *self, const char *key) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    void *value = this->inner->get(this->inner, key);
+    record_key(this, COLLECTION_TRACE_DICTIONARY_GET, key, value != NULL);
+    return value;
+}
+
+// Inserts a key-value pair.
+static bool put(struct IDictionary *self, const char *key, const void *value) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    const bool stored = this->inner->put(this->inner, key, value);
+    record_key(this, COLLECTION_TRACE_DICTIONARY_PUT, key, stored);
+    return stored;
+}
+
+// Returns whether the specified key exists.
+static bool contains_key(const struct IDictionary *self, const char *key) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    const bool found = this->inner->contains_key(this->inner, key);
+    record_key(this, COLLECTION_TRACE_DICTIONARY_CONTAINS_KEY, key, found);
+    return found;
+}
+
+// Removes the specified key-value pair.
+static void *remove_item(struct IDictionary *self, const char *key) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    void *value = this->inner->remove_item(this->inner, key);
+    record_key(this, COLLECTION_TRACE_DICTIONARY_REMOVE_ITEM, key, value != NULL);
+    return value;
+}
+
+// Replaces the value associated with the specified key.
+static void *replace(const struct IDictionary *self, const char *key, const void *value) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    void *previous = this->inner->replace(this->inner, key, value);
+    record_key(this, COLLECTION_TRACE_DICTIONARY_REPLACE, key, previous != NULL);
+    return previous;
+}
+
+// Inserts a key-value pair only if the key is absent.
+static bool put_if_absent(struct IDictionary *self, const char *key, const void *value) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    const bool stored = this->inner->put_if_absent(this->inner, key, value);
+    record_key(this, COLLECTION_TRACE_DICTIONARY_PUT_IF_ABSENT, key, stored);
+    return stored;
+}
+
+// Updates or inserts a key-value pair; succeeded means the key already existed.
+static void *upsert(struct IDictionary *self, const char *key, const void *value) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    void *previous = this->inner->upsert(this->inner, key, value);
+    record_key(this, COLLECTION_TRACE_DICTIONARY_UPSERT, key, previous != NULL);
+    return previous;
+}
+
+// Returns the value for a key, inserting one produced by the factory if absent.
+static void *get_or_insert_with(struct IDictionary *self, const char *key,
+                                void *(*factory)(const char *key, void *context), void *context) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    void *value = this->inner->get_or_insert_with(this->inner, key, factory, context);
+    record_key(this, COLLECTION_TRACE_DICTIONARY_GET_OR_INSERT_WITH, key, value != NULL);
+    return value;
+}
+
+// Applies a function to the entry of a key.
+static void *compute(struct IDictionary *self, const char *key,
+                     bool (*function)(const char *key, void **value, void *context), void *context) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    void *value = this->inner->compute(this->inner, key, function, context);
+    record_key(this, COLLECTION_TRACE_DICTIONARY_COMPUTE, key, value != NULL);
+    return value;
+}
+
+// Looks up a batch of keys.
+static size_t get_many(const struct IDictionary *self, const char *const *keys, const size_t count, void **values) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    const size_t found = this->inner->get_many(this->inner, keys, count, values);
+    record_batch(this, COLLECTION_TRACE_DICTIONARY_GET_MANY, keys, count, values, false);
+    return found;
+}
+
+// Inserts a batch of key-value pairs.
+static size_t put_many(struct IDictionary *self, const char *const *keys, const void *const *values, const size_t count) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    const size_t stored = this->inner->put_many(this->inner, keys, values, count);
+    record_batch(this, COLLECTION_TRACE_DICTIONARY_PUT_MANY, keys, count, NULL, stored == count);
+    return stored;
+}
+
+// Removes a batch of keys.
+static size_t remove_many(struct IDictionary *self, const char *const *keys, const size_t count, void **values) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    const size_t removed = this->inner->remove_many(this->inner, keys, count, values);
+    record_batch(this, COLLECTION_TRACE_DICTIONARY_REMOVE_MANY, keys, count, values, false);
+    return removed;
+}
+
+// Retrieves the value associated with a pre-hashed key.
+static void *get_hashed(const struct IDictionary *self, const struct CollectionKey *key) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    void *value = this->inner->get_hashed(this->inner, key);
+    record_hashed(this, COLLECTION_TRACE_DICTIONARY_GET_HASHED, key, value != NULL);
+    return value;
+}
+
+// Inserts a key-value pair under a pre-hashed key.
+static bool put_hashed(struct IDictionary *self, const struct CollectionKey *key, const void *value) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    const bool stored = this->inner->put_hashed(this->inner, key, value);
+    record_hashed(this, COLLECTION_TRACE_DICTIONARY_PUT_HASHED, key, stored);
+    return stored;
+}
+
+// Returns whether a pre-hashed key exists.
+static bool contains_key_hashed(const struct IDictionary *self, const struct CollectionKey *key) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    const bool found = this->inner->contains_key_hashed(this->inner, key);
+    record_hashed(this, COLLECTION_TRACE_DICTIONARY_CONTAINS_KEY_HASHED, key, found);
+    return found;
+}
+
+// Removes all key-value pairs.
+static bool clear(const struct IDictionary *self, void (*destructor)(void *value)) {
+    const struct RecordingDictionary *this = (const struct RecordingDictionary *) self;
+    const bool cleared = this->inner->clear(this->inner, destructor);
+    record_all(this, COLLECTION_TRACE_DICTIONARY_CLEAR, cleared);
+    return cleared;
+}
+
+// Records the deallocation, then releases the wrapped dictionary and the decorator.
+static void dealloc(struct IDictionary *self, void (*destructor)(void *value)) {
+    struct RecordingDictionary *this = (struct RecordingDictionary *) self;
+
+    record_all(this, COLLECTION_TRACE_DICTIONARY_DEALLOC, true);
+    this->inner->dealloc(this->inner, destructor);
+    free(this);
+}
+
+// Returns the aligned allocation size for RecordingDictionary.
+static size_t size(void) {
+    return (sizeof(struct RecordingDictionary) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u); // Align to pointer size.
+}
+
+// Allocates a RecordingDictionary instance.
+static struct IDictionary *alloc(void) {
+    struct IDictionary *dictionary = malloc(size());
+
+    if (dictionary == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::RecordingDictionary::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return dictionary;
+}
+
+// Initializes a RecordingDictionary around an existing dictionary.
+static struct IDictionary *init(struct IDictionary *dictionary, struct IDictionary *inner, struct ITrace *trace) {
+    if (dictionary == NULL) return NULL;
+
+    struct RecordingDictionary *this = (struct RecordingDictionary *) dictionary;
+    memset(this, 0, sizeof(struct RecordingDictionary));
+
+    if (inner == NULL || trace == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::RecordingDictionary::init] Error: Dictionary and trace are required.\033[0m\n");
+        goto exception;
+    }
+
+    this->inner = inner;
+    this->trace = trace;
+
+    this->super.get = get;
+    this->super.put = put;
+    this->super.contains_key = contains_key;
+    this->super.remove_item = remove_item;
+    this->super.replace = replace;
+    this->super.put_if_absent = put_if_absent;
+    this->super.upsert = upsert;
+    this->super.get_or_insert_with = get_or_insert_with;
+    this->super.compute = compute;
+    this->super.get_many = get_many;
+    this->super.put_many = put_many;
+    this->super.remove_many = remove_many;
+    this->super.get_hashed = get_hashed;
+    this->super.put_hashed = put_hashed;
+    this->super.contains_key_hashed = contains_key_hashed;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return dictionary;
+
+exception:
+    free(dictionary);
+    return NULL;
+}
+
+// Creates a dictionary that records every operation on the wrapped dictionary.
+struct IDictionary *collection_dictionary_new_recording(struct IDictionary *dictionary, struct ITrace *trace) {
+    return init(alloc(), dictionary, trace);
+}
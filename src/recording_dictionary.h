@@ -0,0 +1,22 @@
+/**
+* @file recording_dictionary.h
+* @internal
+* @brief Recording Dictionary Header
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#pragma once
+
+#include "collection/i_dictionary.h"
+#include "collection/i_trace.h"
+
+/**
+ * @struct RecordingDictionary
+ * @brief IDictionary decorator that appends a trace record for every forwarded operation.
+ */
+struct RecordingDictionary {
+    struct IDictionary super;           /**< IDictionary interface implemented by this type. */
+    struct IDictionary *inner;          /**< Wrapped dictionary, owned by the decorator. */
+    struct ITrace *trace;               /**< Trace receiving the records. */
+};
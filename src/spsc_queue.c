@@ -0,0 +1,213 @@
+/**
+ * @file spsc_queue.c
+ * @internal
+ * @brief Wait-Free SPSC Queue Implementation
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "spsc_queue.h"
+#include "array_unsupported.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MIN_CAPACITY 2
+
+// Returns how many slots the producer may fill, refreshing its view of head only when fewer than `wanted` are known free.
+static size_t writable(struct SpscQueue *this, const size_t tail, const size_t wanted) {
+    size_t free_slots = this->mask + 1 - (tail - this->cached_head);
+    if (free_slots < wanted) {
+        this->cached_head = atomic_load_explicit(&this->head, memory_order_acquire);
+        free_slots = this->mask + 1 - (tail - this->cached_head);
+    }
+    return free_slots;
+}
+
+// Returns how many slots the consumer may drain, refreshing its view of tail only when fewer than `wanted` are known filled.
+static size_t readable(struct SpscQueue *this, const size_t head, const size_t wanted) {
+    size_t filled = this->cached_tail - head;
+    if (filled < wanted) {
+        this->cached_tail = atomic_load_explicit(&this->tail, memory_order_acquire);
+        filled = this->cached_tail - head;
+    }
+    return filled;
+}
+
+// Appends an element to the tail of the queue, failing if it is full. Producer thread only.
+static bool push(struct IArray *self, const void *item) {
+    struct SpscQueue *this = (struct SpscQueue *) self;
+
+    const size_t tail = atomic_load_explicit(&this->tail, memory_order_relaxed);
+    if (writable(this, tail, 1) == 0) return false;
+
+    this->items[tail & this->mask] = item;
+    atomic_store_explicit(&this->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+// Removes and returns the element at the head of the queue, or NULL if it is empty. Consumer thread only.
+static const void *shift(struct IArray *self) {
+    struct SpscQueue *this = (struct SpscQueue *) self;
+
+    const size_t head = atomic_load_explicit(&this->head, memory_order_relaxed);
+    if (readable(this, head, 1) == 0) return NULL;
+
+    const void *item = this->items[head & this->mask];
+    atomic_store_explicit(&this->head, head + 1, memory_order_release);
+    return item;
+}
+
+// Returns the number of elements; exact on the producer or consumer thread, a snapshot on any other.
+static size_t count(const struct IArray *self) {
+    struct SpscQueue *this = (struct SpscQueue *) self;
+
+    // The consumer only advances head up to a tail it has seen, so head never passes tail and a tail
+    // loaded after head is at least that head. The producer may have refilled slots freed since head
+    // was loaded, so the difference is clamped to the capacity.
+    const size_t head = atomic_load_explicit(&this->head, memory_order_acquire);
+    const size_t tail = atomic_load_explicit(&this->tail, memory_order_acquire);
+
+    const size_t count = tail - head;
+    return count > this->mask + 1 ? this->mask + 1 : count;
+}
+
+// Removes the elements present at the time of the call by draining the queue. Consumer thread only.
+static void clear(struct IArray *self, void (*destructor)(void *item)) {
+    for (size_t remaining = count(self); remaining > 0; remaining--) {
+        const void *item = shift(self);
+        if (destructor && item) destructor((void *) item);
+    }
+}
+
+// Releases an SpscQueue instance and its ring.
+static void dealloc(struct IArray *self, void (*destructor)(void *item)) {
+    struct SpscQueue *this = (struct SpscQueue *) self;
+
+    clear(self, destructor);
+
+    free(this->items);
+    free(this);
+}
+
+// Returns the aligned allocation size for SpscQueue.
+static size_t size(void) {
+    return (sizeof(struct SpscQueue) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u); // Align to pointer size.
+}
+
+// Allocates an SpscQueue instance.
+static struct IArray *alloc() {
+    struct IArray *array = malloc(size());
+
+    if (array == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::SpscQueue::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return array;
+}
+
+// Initializes an SpscQueue instance with room for at least `capacity` elements.
+static struct IArray *init(struct IArray *array, const size_t capacity) {
+    if (array == NULL) return NULL;
+
+    struct SpscQueue *this = (struct SpscQueue *) array;
+    memset(this, 0, sizeof(struct SpscQueue));
+
+    size_t slots = MIN_CAPACITY;
+    while (slots < capacity && slots <= SIZE_MAX / 2 / sizeof(void *)) slots <<= 1;
+
+    this->items = malloc(slots * sizeof(void *));
+    if (this->items == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::SpscQueue::init] ERROR: Ring allocation failed.\033[0m\n");
+        goto exception;
+    }
+
+    this->mask = slots - 1;
+    atomic_init(&this->tail, 0);
+    atomic_init(&this->head, 0);
+    this->cached_head = 0;
+    this->cached_tail = 0;
+
+    this->super.get = array_unsupported_get;
+    this->super.put = array_unsupported_put;
+    this->super.for_each = array_unsupported_for_each;
+    this->super.find = array_unsupported_find;
+    this->super.first_index = array_unsupported_index;
+    this->super.last_index = array_unsupported_index;
+    this->super.unshift = array_unsupported_unshift;
+    this->super.push = push;
+    this->super.contains_value = array_unsupported_contains_value;
+    this->super.shift = shift;
+    this->super.pop = array_unsupported_pop;
+    this->super.remove_item = array_unsupported_remove_item;
+    this->super.clone = array_unsupported_clone;
+    this->super.count = count;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return array;
+
+exception:
+    free(array);
+    return NULL;
+}
+
+// Creates a new wait-free bounded SPSC queue.
+struct IArray *collection_array_new_spsc(const size_t capacity) {
+    return init(alloc(), capacity);
+}
+
+// Returns whether an array is an SPSC queue.
+static bool is_spsc_queue(const struct IArray *array) {
+    return array->dealloc == dealloc;
+}
+
+// Appends up to n elements with a single publication of the tail. Producer thread only.
+size_t collection_array_spsc_push_n(struct IArray *array, const void *const *items, const size_t n) {
+    if (array == NULL || items == NULL) return 0;
+    if (!is_spsc_queue(array)) {
+        fprintf(stderr, "\033[0;31m[Collection::SpscQueue::push_n] Error: Array is not an SPSC queue.\033[0m\n");
+        return 0;
+    }
+    struct SpscQueue *this = (struct SpscQueue *) array;
+
+    const size_t tail = atomic_load_explicit(&this->tail, memory_order_relaxed);
+    const size_t free_slots = writable(this, tail, n);
+    const size_t total = n < free_slots ? n : free_slots;
+    if (total == 0) return 0;
+
+    // Copy in at most two runs: up to the end of the ring, then from its start.
+    const size_t start = tail & this->mask;
+    const size_t first = this->mask + 1 - start < total ? this->mask + 1 - start : total;
+    memcpy(this->items + start, items, first * sizeof(void *));
+    if (total > first) memcpy(this->items, items + first, (total - first) * sizeof(void *));
+
+    atomic_store_explicit(&this->tail, tail + total, memory_order_release);
+    return total;
+}
+
+// Removes up to n elements with a single publication of the head. Consumer thread only.
+size_t collection_array_spsc_shift_n(struct IArray *array, const void **items, const size_t n) {
+    if (array == NULL || items == NULL) return 0;
+    if (!is_spsc_queue(array)) {
+        fprintf(stderr, "\033[0;31m[Collection::SpscQueue::shift_n] Error: Array is not an SPSC queue.\033[0m\n");
+        return 0;
+    }
+    struct SpscQueue *this = (struct SpscQueue *) array;
+
+    const size_t head = atomic_load_explicit(&this->head, memory_order_relaxed);
+    const size_t filled = readable(this, head, n);
+    const size_t total = n < filled ? n : filled;
+    if (total == 0) return 0;
+
+    const size_t start = head & this->mask;
+    const size_t first = this->mask + 1 - start < total ? this->mask + 1 - start : total;
+    memcpy(items, this->items + start, first * sizeof(void *));
+    if (total > first) memcpy(items + first, this->items, (total - first) * sizeof(void *));
+
+    atomic_store_explicit(&this->head, head + total, memory_order_release);
+    return total;
+}
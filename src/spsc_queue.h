@@ -0,0 +1,37 @@
+/**
+ * @file spsc_queue.h
+ * @internal
+ * @brief Wait-Free SPSC Queue Header
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include "collection/i_array.h"
+#include "compiler.h"
+
+#include <stdatomic.h>
+
+/**
+ * @struct SpscQueue
+ * @brief Bounded single-producer/single-consumer ring implementation of IArray.
+ *
+ * The producer owns tail and the consumer owns head; each publishes its index
+ * with a release store and reads the other's with an acquire load. Each side
+ * also keeps a private copy of the opposite index and only reloads the shared
+ * one when the copy says the ring is full (producer) or empty (consumer), so
+ * the steady state touches no cache line written by the other thread.
+ */
+struct SpscQueue {
+    struct IArray super;                /**< IArray interface implemented by this type. */
+    const void **items;                 /**< Ring of item pointers. */
+    size_t mask;                        /**< Capacity - 1; the capacity is a power of two. */
+    char pad0[CACHE_LINE_SIZE];         /**< Keeps the producer line off the read-mostly line above. */
+    atomic_size_t tail;                 /**< Next position to write; stored by the producer. */
+    size_t cached_head;                 /**< Producer's last observed head. */
+    char pad1[CACHE_LINE_SIZE - sizeof(atomic_size_t) - sizeof(size_t)];
+    atomic_size_t head;                 /**< Next position to read; stored by the consumer. */
+    size_t cached_tail;                 /**< Consumer's last observed tail. */
+    char pad2[CACHE_LINE_SIZE - sizeof(atomic_size_t) - sizeof(size_t)];
+};
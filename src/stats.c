@@ -0,0 +1,185 @@
+/**
+ * @file stats.c
+ * @internal
+ * @brief Process Statistics Reporting and Stats Regions
+ *
+ * Platform files collect the raw process statistics; this file reports them
+ * and measures regions, adding perf_event_open() counters on Linux.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "collection/i_platform.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef PERF_FLAG_FD_CLOEXEC
+#define PERF_FLAG_FD_CLOEXEC (1UL << 3)
+#endif
+
+// perf_event_open() type and config of each counter.
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} counter_events[STATS_COUNTER_COUNT] = {
+    [STATS_CYCLES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    [STATS_INSTRUCTIONS] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    [STATS_CACHE_REFERENCES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+    [STATS_CACHE_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    [STATS_BRANCH_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    [STATS_TASK_CLOCK_NS] = {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+    [STATS_CPU_MIGRATIONS] = {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS},
+};
+
+// Opens a disabled user-space counter on the calling thread and the threads it creates, or returns -1.
+static int counter_open(const enum stats_counter counter) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = counter_events[counter].type;
+    attr.config = counter_events[counter].config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1; // Permitted at the default perf_event_paranoid level of 2.
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+    return fd < 0 ? -1 : (int) fd;
+}
+
+// Reads a counter, scaling for time it was multiplexed off the PMU; false if it never ran.
+static bool counter_read(const int fd, uint64_t *value) {
+    struct {
+        uint64_t value;
+        uint64_t enabled;
+        uint64_t running;
+    } sample;
+
+    if (read(fd, &sample, sizeof(sample)) != (ssize_t) sizeof(sample) || sample.running == 0) return false;
+
+    *value = sample.running < sample.enabled
+                 ? (uint64_t) ((double) sample.value * (double) sample.enabled / (double) sample.running)
+                 : sample.value;
+    return true;
+}
+#endif
+
+// Opens and starts every permitted counter; unavailable ones are left at -1.
+static void counters_start(struct stats_region *region) {
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++) region->counters[i] = -1;
+#ifdef __linux__
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++) region->counters[i] = counter_open((enum stats_counter) i);
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++) {
+        if (region->counters[i] >= 0) ioctl(region->counters[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+// Stops, reads, and closes the region's counters.
+static void counters_stop(struct stats_region *region, struct stats_delta *out) {
+#ifdef __linux__
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++) {
+        if (region->counters[i] >= 0) ioctl(region->counters[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++) {
+        if (region->counters[i] < 0) continue;
+        if (counter_read(region->counters[i], &out->counters[i])) out->available |= 1u << i;
+        close(region->counters[i]);
+    }
+#else
+    (void) out;
+#endif
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++) region->counters[i] = -1;
+}
+
+// Prints current process resource usage statistics.
+void process_stats_print(void) {
+    struct process_stats stats;
+    if (process_stats_collect(&stats) != 0) {
+        fprintf(stderr, "\033[0;31m[Collection::Stats::process_stats_print] Error: Statistics unavailable.\033[0m\n");
+        return;
+    }
+
+    printf("[Stats] RSS %.2f MB (peak %.2f MB), CPU %.3f s user / %.3f s system, "
+           "page faults %ld minor / %ld major, context switches %ld voluntary / %ld involuntary\n",
+           stats.current_rss_mb, stats.max_rss_mb, stats.user_cpu_sec, stats.system_cpu_sec,
+           stats.minor_page_faults, stats.major_page_faults,
+           stats.voluntary_ctx_switches, stats.involuntary_ctx_switches);
+}
+
+// Snapshots process statistics and starts the counters last, so setup is not counted.
+int stats_region_begin(struct stats_region *region) {
+    if (region == NULL) return -1;
+
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++) region->counters[i] = -1;
+    if (process_stats_collect(&region->start) != 0) return -1;
+
+    counters_start(region);
+    region->start_ns = clock_monotonic_ns();
+    return 0;
+}
+
+// Stops the counters first, so teardown is not counted, then computes the deltas.
+int stats_region_end(struct stats_region *region, struct stats_delta *out) {
+    if (region == NULL || out == NULL) return -1;
+
+    const uint64_t end_ns = clock_monotonic_ns();
+    memset(out, 0, sizeof(struct stats_delta));
+    counters_stop(region, out);
+
+    struct process_stats end;
+    if (process_stats_collect(&end) != 0) return -1;
+
+    out->wall_sec = (double) (end_ns - region->start_ns) / 1e9;
+    out->rss_mb = end.current_rss_mb - region->start.current_rss_mb;
+    out->max_rss_mb = end.max_rss_mb;
+    out->user_cpu_sec = end.user_cpu_sec - region->start.user_cpu_sec;
+    out->system_cpu_sec = end.system_cpu_sec - region->start.system_cpu_sec;
+    out->minor_page_faults = end.minor_page_faults - region->start.minor_page_faults;
+    out->major_page_faults = end.major_page_faults - region->start.major_page_faults;
+    out->voluntary_ctx_switches = end.voluntary_ctx_switches - region->start.voluntary_ctx_switches;
+    out->involuntary_ctx_switches = end.involuntary_ctx_switches - region->start.involuntary_ctx_switches;
+    return 0;
+}
+
+// Prints a region delta followed by whichever counters were read.
+void stats_delta_print(const char *name, const struct stats_delta *delta) {
+    if (delta == NULL) return;
+
+    static const char *const names[STATS_COUNTER_COUNT] = {
+        [STATS_CYCLES] = "cycles",
+        [STATS_INSTRUCTIONS] = "instructions",
+        [STATS_CACHE_REFERENCES] = "cache-references",
+        [STATS_CACHE_MISSES] = "cache-misses",
+        [STATS_BRANCH_MISSES] = "branch-misses",
+        [STATS_TASK_CLOCK_NS] = "task-clock-ns",
+        [STATS_CPU_MIGRATIONS] = "cpu-migrations",
+    };
+
+    printf("[Stats] %s: wall %.3f s, CPU %.3f s user / %.3f s system, RSS %+.2f MB (peak %.2f MB), "
+           "page faults %ld minor / %ld major, context switches %ld voluntary / %ld involuntary\n",
+           name ? name : "region", delta->wall_sec, delta->user_cpu_sec, delta->system_cpu_sec,
+           delta->rss_mb, delta->max_rss_mb, delta->minor_page_faults, delta->major_page_faults,
+           delta->voluntary_ctx_switches, delta->involuntary_ctx_switches);
+
+    if (delta->available == 0) return;
+    printf("        ");
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++) {
+        if (delta->available & 1u << i) printf(" %s %llu", names[i], (unsigned long long) delta->counters[i]);
+    }
+
+    const unsigned ipc = 1u << STATS_CYCLES | 1u << STATS_INSTRUCTIONS;
+    if ((delta->available & ipc) == ipc && delta->counters[STATS_CYCLES] > 0) {
+        printf(" (IPC %.2f)", (double) delta->counters[STATS_INSTRUCTIONS] / (double) delta->counters[STATS_CYCLES]);
+    }
+    printf("\n");
+}
@@ -0,0 +1,298 @@
+/**
+* @file striped_dictionary.c
+* @internal
+* @brief Striped Dictionary Implementation
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#include "striped_dictionary.h"
+#include "hash.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DEFAULT_STRIPES 16
+#define MAX_STRIPES 4096
+#define STRIPE_CAPACITY 16      // Initial buckets per stripe.
+
+// Returns the stripe that owns a hash.
+static struct Dictionary *stripe(const struct StripedDictionary *this, const uint64_t hash) {
+    return this->stripe_count == 1 ? this->stripes[0] : this->stripes[hash >> this->shift];
+}
+
+// Returns the value associated with the specified key.
+static void *get(const struct IDictionary *self, const char *key) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t hash = hash_table_key(key, length, this->seed);
+    return dictionary_get_hashed(stripe(this, hash), key, length, hash);
+}
+
+// Inserts a new key-value pair.
+static bool put(struct IDictionary *self, const char *key, const void *value) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t hash = hash_table_key(key, length, this->seed);
+    return dictionary_put_hashed(stripe(this, hash), key, length, hash, value);
+}
+
+// Returns whether the specified key exists.
+static bool contains_key(const struct IDictionary *self, const char *key) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t hash = hash_table_key(key, length, this->seed);
+    return dictionary_contains_key_hashed(stripe(this, hash), key, length, hash);
+}
+
+// Removes the specified key-value pair.
+static void *remove_item(struct IDictionary *self, const char *key) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t hash = hash_table_key(key, length, this->seed);
+    return dictionary_remove_hashed(stripe(this, hash), key, length, hash);
+}
+
+// Replaces the value associated with the specified key.
+static void *replace(const struct IDictionary *self, const char *key, const void *value) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t hash = hash_table_key(key, length, this->seed);
+    return dictionary_replace_hashed(stripe(this, hash), key, length, hash, value);
+}
+
+// Inserts a key-value pair only if the key is absent.
+static bool put_if_absent(struct IDictionary *self, const char *key, const void *value) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t hash = hash_table_key(key, length, this->seed);
+    return dictionary_put_if_absent_hashed(stripe(this, hash), key, length, hash, value);
+}
+
+// Updates or inserts a key-value pair, returning the previous value.
+static void *upsert(struct IDictionary *self, const char *key, const void *value) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t hash = hash_table_key(key, length, this->seed);
+    return dictionary_upsert_hashed(stripe(this, hash), key, length, hash, value);
+}
+
+// Returns the value of a key, inserting one from factory if it is absent.
+static void *get_or_insert_with(struct IDictionary *self, const char *key,
+                                void *(*factory)(const char *key, void *context), void *context) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t hash = hash_table_key(key, length, this->seed);
+    return dictionary_get_or_insert_with_hashed(stripe(this, hash), key, length, hash, factory, context);
+}
+
+// Atomically recomputes the value of a key while holding only its stripe's lock.
+static void *compute(struct IDictionary *self, const char *key,
+                     bool (*function)(const char *key, void **value, void *context), void *context) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t hash = hash_table_key(key, length, this->seed);
+    return dictionary_compute_hashed(stripe(this, hash), key, length, hash, function, context);
+}
+
+// Orders batch keys by hash, and so by stripe, keeping the caller's order among equal hashes.
+static int compare_hashed(const void *a, const void *b) {
+    const struct HashedKey *left = a, *right = b;
+    if (left->hash != right->hash) return left->hash < right->hash ? -1 : 1;
+    return left->index < right->index ? -1 : left->index > right->index;
+}
+
+// Hashes a batch and sorts it so that each stripe's keys are contiguous.
+static struct HashedKey *prepare(const struct StripedDictionary *this, const char *const *keys, const size_t count,
+                                 struct HashedKey *buffer) {
+    struct HashedKey *hashed = hash_keys(keys, count, this->seed, buffer, HASH_KEYS_INLINE);
+    if (hashed && this->stripe_count > 1) qsort(hashed, count, sizeof(struct HashedKey), compare_hashed);
+    return hashed;
+}
+
+// Returns the length of the run of batch keys starting at `first` that share its stripe.
+static size_t stripe_run(const struct StripedDictionary *this, const struct HashedKey *hashed, const size_t first,
+                         const size_t count) {
+    const struct Dictionary *owner = stripe(this, hashed[first].hash);
+    size_t last = first + 1;
+    while (last < count && stripe(this, hashed[last].hash) == owner) last++;
+    return last - first;
+}
+
+// Looks up a batch of keys, locking each stripe once.
+static size_t get_many(const struct IDictionary *self, const char *const *keys, const size_t count, void **values) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    struct HashedKey buffer[HASH_KEYS_INLINE];
+    struct HashedKey *hashed = prepare(this, keys, count, buffer);
+    if (hashed == NULL) {
+        for (size_t i = 0; i < count; i++) values[i] = NULL;
+        return 0;
+    }
+
+    size_t found = 0;
+    for (size_t i = 0, run; i < count; i += run) {
+        run = stripe_run(this, hashed, i, count);
+        found += dictionary_get_many_hashed(stripe(this, hashed[i].hash), hashed + i, run, values);
+    }
+
+    hash_keys_free(hashed, buffer);
+    return found;
+}
+
+// Inserts a batch of key-value pairs, locking each stripe once.
+static size_t put_many(struct IDictionary *self, const char *const *keys, const void *const *values, const size_t count) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    struct HashedKey buffer[HASH_KEYS_INLINE];
+    struct HashedKey *hashed = prepare(this, keys, count, buffer);
+    if (hashed == NULL) return 0;
+
+    size_t stored = 0;
+    for (size_t i = 0, run; i < count; i += run) {
+        run = stripe_run(this, hashed, i, count);
+        stored += dictionary_put_many_hashed(stripe(this, hashed[i].hash), hashed + i, run, values);
+    }
+
+    hash_keys_free(hashed, buffer);
+    return stored;
+}
+
+// Removes a batch of keys, locking each stripe once.
+static size_t remove_many(struct IDictionary *self, const char *const *keys, const size_t count, void **values) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    struct HashedKey buffer[HASH_KEYS_INLINE];
+    struct HashedKey *hashed = prepare(this, keys, count, buffer);
+    if (hashed == NULL) {
+        for (size_t i = 0; values && i < count; i++) values[i] = NULL;
+        return 0;
+    }
+
+    size_t removed = 0;
+    for (size_t i = 0, run; i < count; i += run) {
+        run = stripe_run(this, hashed, i, count);
+        removed += dictionary_remove_many_hashed(stripe(this, hashed[i].hash), hashed + i, run, values);
+    }
+
+    hash_keys_free(hashed, buffer);
+    return removed;
+}
+
+// Returns the value associated with a pre-hashed key.
+static void *get_hashed(const struct IDictionary *self, const struct CollectionKey *key) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    const uint64_t hash = hash_u64(key->hash, this->seed);
+    return dictionary_get_hashed(stripe(this, hash), key->key, key->length, hash);
+}
+
+// Inserts a pre-hashed key-value pair.
+static bool put_hashed(struct IDictionary *self, const struct CollectionKey *key, const void *value) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    const uint64_t hash = hash_u64(key->hash, this->seed);
+    return dictionary_put_hashed(stripe(this, hash), key->key, key->length, hash, value);
+}
+
+// Returns whether a pre-hashed key exists.
+static bool contains_key_hashed(const struct IDictionary *self, const struct CollectionKey *key) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+    const uint64_t hash = hash_u64(key->hash, this->seed);
+    return dictionary_contains_key_hashed(stripe(this, hash), key->key, key->length, hash);
+}
+
+// Removes all key-value pairs, holding every stripe lock so the dictionary is empty at a single instant.
+static bool clear(const struct IDictionary *self, void (*destructor)(void *value)) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+
+    for (size_t i = 0; i < this->stripe_count; i++) mutex_lock(&this->stripes[i]->mutex); // Fixed order avoids deadlock.
+    for (size_t i = 0; i < this->stripe_count; i++) dictionary_clear_locked(this->stripes[i], destructor);
+    for (size_t i = this->stripe_count; i > 0; i--) mutex_unlock(&this->stripes[i - 1]->mutex);
+
+    return true;
+}
+
+// Releases a StripedDictionary instance and all of its stripes.
+static void dealloc(struct IDictionary *self, void (*destructor)(void *value)) {
+    struct StripedDictionary *this = (struct StripedDictionary *) self;
+
+    for (size_t i = 0; i < this->stripe_count; i++) {
+        struct IDictionary *stripe = (struct IDictionary *) this->stripes[i];
+        collection_dictionary_dealloc(&stripe, destructor);
+    }
+
+    free(this);
+}
+
+// Returns the aligned allocation size for a StripedDictionary with the given number of stripes.
+static size_t size(const size_t stripe_count) {
+    const size_t bytes = sizeof(struct StripedDictionary) + stripe_count * sizeof(struct Dictionary *);
+    return (bytes + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u);
+}
+
+// Allocates a StripedDictionary instance.
+static struct IDictionary *alloc(const size_t stripe_count) {
+    struct IDictionary *dictionary = malloc(size(stripe_count));
+
+    if (dictionary == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::StripedDictionary::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return dictionary;
+}
+
+// Initializes a StripedDictionary instance and creates its stripes.
+static struct IDictionary *init(struct IDictionary *dictionary, const size_t stripe_count) {
+    if (dictionary == NULL) return NULL;
+
+    struct StripedDictionary *this = (struct StripedDictionary *) dictionary;
+    memset(this, 0, size(stripe_count));
+
+    unsigned bits = 0;
+    while (((size_t) 1 << bits) < stripe_count) bits++;
+    this->shift = 64 - bits;
+    this->stripe_count = stripe_count;
+    this->seed = hash_seed();
+
+    for (size_t i = 0; i < stripe_count; i++) {
+        this->stripes[i] = (struct Dictionary *) collection_dictionary_new_with_capacity(STRIPE_CAPACITY);
+        if (this->stripes[i] == NULL) goto exception;
+        mutex_set_name(&this->stripes[i]->mutex, "Collection::StripedDictionary");
+    }
+
+    this->super.get = get;
+    this->super.put = put;
+    this->super.contains_key = contains_key;
+    this->super.remove_item = remove_item;
+    this->super.replace = replace;
+    this->super.put_if_absent = put_if_absent;
+    this->super.upsert = upsert;
+    this->super.get_or_insert_with = get_or_insert_with;
+    this->super.compute = compute;
+    this->super.get_many = get_many;
+    this->super.put_many = put_many;
+    this->super.remove_many = remove_many;
+    this->super.get_hashed = get_hashed;
+    this->super.put_hashed = put_hashed;
+    this->super.contains_key_hashed = contains_key_hashed;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return dictionary;
+
+exception:
+    for (size_t i = 0; i < stripe_count && this->stripes[i]; i++) {
+        struct IDictionary *stripe = (struct IDictionary *) this->stripes[i];
+        collection_dictionary_dealloc(&stripe, NULL);
+    }
+    free(dictionary);
+    return NULL;
+}
+
+// Creates a new lock-striped dictionary instance.
+struct IDictionary *collection_dictionary_new_striped(const size_t stripes) {
+    size_t stripe_count = 1;
+    const size_t requested = stripes ? stripes : DEFAULT_STRIPES;
+    while (stripe_count < requested && stripe_count < MAX_STRIPES) stripe_count <<= 1;
+
+    return init(alloc(stripe_count), stripe_count);
+}
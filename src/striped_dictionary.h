@@ -0,0 +1,29 @@
+/**
+* @file striped_dictionary.h
+* @internal
+* @brief Striped Dictionary Header
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#pragma once
+
+#include "dictionary.h"
+
+/**
+ * @struct StripedDictionary
+ * @brief Lock-striped implementation of IDictionary.
+ *
+ * Splits the key space across a power-of-two number of independent
+ * Dictionary stripes, each with its own lock and its own incremental rehash.
+ * A key's stripe is chosen from the high bits of its hash, while the stripe
+ * indexes its buckets with the low bits of the same value, so the hash is
+ * computed once per operation. Operations on different stripes never contend.
+ */
+struct StripedDictionary {
+    struct IDictionary super;           /**< IDictionary interface implemented by this type. */
+    unsigned shift;                     /**< 64 - log2(stripe_count); the hash is shifted right by this much. */
+    size_t stripe_count;                /**< Number of stripes, a power of two. */
+    uint64_t seed;                      /**< Hash seed shared by all stripes, so one hash picks the stripe and the bucket. */
+    struct Dictionary *stripes[];       /**< Independently locked stripes. */
+};
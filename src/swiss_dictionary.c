@@ -0,0 +1,616 @@
+/**
+* @file swiss_dictionary.c
+* @internal
+* @brief Swiss Table Dictionary Implementation
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#include "swiss_dictionary.h"
+#include "compiler.h"
+#include "hash.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SWISS_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define GROUP_WIDTH 16
+#define INITIAL_CAPACITY 16
+
+#define CTRL_EMPTY ((int8_t) -128)  // 0b10000000
+#define CTRL_DELETED ((int8_t) -2)  // 0b11111110
+#define CTRL_SENTINEL ((int8_t) -1) // Any control byte below this is EMPTY or DELETED.
+
+// Returns the index of the lowest set bit of a non-zero mask.
+static unsigned trailing_zeros(const uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned) index;
+#else
+    return (unsigned) __builtin_ctz(mask);
+#endif
+}
+
+#ifdef SWISS_SSE2
+
+// Returns a bitmask of the group's control bytes equal to tag.
+static uint32_t group_match(const int8_t *group, const int8_t tag) {
+    const __m128i ctrl = _mm_load_si128((const __m128i *) group);
+    return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), ctrl));
+}
+
+// Returns a bitmask of the group's EMPTY or DELETED control bytes.
+static uint32_t group_match_free(const int8_t *group) {
+    const __m128i ctrl = _mm_load_si128((const __m128i *) group);
+    return (uint32_t) _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(CTRL_SENTINEL), ctrl));
+}
+
+#else
+
+// Returns a bitmask of the group's control bytes equal to tag.
+static uint32_t group_match(const int8_t *group, const int8_t tag) {
+    uint32_t mask = 0;
+    for (unsigned i = 0; i < GROUP_WIDTH; i++) {
+        if (group[i] == tag) mask |= 1u << i;
+    }
+    return mask;
+}
+
+// Returns a bitmask of the group's EMPTY or DELETED control bytes.
+static uint32_t group_match_free(const int8_t *group) {
+    uint32_t mask = 0;
+    for (unsigned i = 0; i < GROUP_WIDTH; i++) {
+        if (group[i] < CTRL_SENTINEL) mask |= 1u << i;
+    }
+    return mask;
+}
+
+#endif
+
+// Returns a bitmask of the group's EMPTY control bytes.
+static uint32_t group_match_empty(const int8_t *group) {
+    return group_match(group, CTRL_EMPTY);
+}
+
+// Returns the 7-bit tag stored in the control byte of a full slot.
+static int8_t tag_of(const uint64_t h) {
+    return (int8_t) (h & 0x7F);
+}
+
+// Returns the first group of the probe sequence.
+static size_t first_group(const uint64_t h, const size_t group_mask) {
+    return (size_t) (h >> 7) & group_mask;
+}
+
+// Returns the number of entries a table of the given capacity holds before resizing (7/8 load factor).
+static size_t max_load(const size_t capacity) {
+    return capacity - capacity / 8;
+}
+
+// Returns the slot index of key, or SIZE_MAX if it is absent.
+static size_t find_index(const struct SwissDictionary *this, const char *key, const size_t length, const uint64_t h) {
+    const size_t group_mask = this->capacity / GROUP_WIDTH - 1;
+    const int8_t tag = tag_of(h);
+
+    size_t group = first_group(h, group_mask);
+    for (size_t step = 1; step <= group_mask + 1; step++) { // Triangular probing visits every group once.
+        const int8_t *ctrl = this->ctrl + group * GROUP_WIDTH;
+
+        for (uint32_t mask = group_match(ctrl, tag); mask; mask &= mask - 1) {
+            const size_t index = group * GROUP_WIDTH + trailing_zeros(mask);
+            const struct SwissSlot *slot = &this->slots[index];
+            if (slot->hash == h && slot->length == length && memcmp(slot->key, key, length) == 0) return index;
+        }
+
+        if (group_match_empty(ctrl)) break; // Key would have been placed here.
+        group = (group + step) & group_mask;
+    }
+
+    return SIZE_MAX;
+}
+
+// Returns the first EMPTY or DELETED slot on the probe sequence of h.
+static size_t find_free_index(const int8_t *ctrl, const size_t capacity, const uint64_t h) {
+    const size_t group_mask = capacity / GROUP_WIDTH - 1;
+
+    size_t group = first_group(h, group_mask);
+    for (size_t step = 1;; step++) { // The load factor guarantees a free slot exists.
+        const uint32_t mask = group_match_free(ctrl + group * GROUP_WIDTH);
+        if (mask) return group * GROUP_WIDTH + trailing_zeros(mask);
+        group = (group + step) & group_mask;
+    }
+}
+
+// Allocates control bytes aligned to the group width, all set to EMPTY.
+static int8_t *ctrl_alloc(const size_t capacity, void **allocation) {
+    *allocation = malloc(capacity + GROUP_WIDTH - 1);
+    if (*allocation == NULL) return NULL;
+
+    int8_t *ctrl = (int8_t *) (((uintptr_t) *allocation + GROUP_WIDTH - 1) & ~(uintptr_t) (GROUP_WIDTH - 1));
+    memset(ctrl, CTRL_EMPTY, capacity);
+    return ctrl;
+}
+
+// Rebuilds the table with the given capacity, dropping all DELETED markers.
+static bool resize(struct SwissDictionary *this, const size_t capacity) {
+    void *allocation;
+    int8_t *ctrl = ctrl_alloc(capacity, &allocation);
+    struct SwissSlot *slots = malloc(capacity * sizeof(struct SwissSlot));
+    if (ctrl == NULL || slots == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::SwissDictionary::resize] Error: Failed to allocate table.\033[0m\n");
+        free(allocation);
+        free(slots);
+        return false;
+    }
+
+    for (size_t i = 0; i < this->capacity; i++) {
+        if (this->ctrl[i] < 0) continue;
+        const size_t index = find_free_index(ctrl, capacity, this->slots[i].hash); // Stored hash, no key re-read.
+        ctrl[index] = this->ctrl[i];
+        slots[index] = this->slots[i];
+    }
+
+    free(this->ctrl_allocation);
+    free(this->slots);
+
+    this->ctrl = ctrl;
+    this->ctrl_allocation = allocation;
+    this->slots = slots;
+    this->capacity = capacity;
+    this->growth_left = max_load(capacity) - this->size;
+    return true;
+}
+
+// Hashes a key with the instance seed.
+static uint64_t hash_key(const struct SwissDictionary *this, const char *key, const size_t length) {
+    return hash_table_key(key, length, this->seed);
+}
+
+// Returns the value associated with the specified key.
+static void *get(const struct IDictionary *self, const char *key) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    const size_t length = strlen(key);
+
+    mutex_lock_shared(&this->mutex);
+
+    const size_t index = find_index(this, key, length, hash_key(this, key, length));
+    void *value = index != SIZE_MAX ? (void *) this->slots[index].value : NULL;
+
+    mutex_unlock(&this->mutex);
+    return value;
+}
+
+// Inserts a key known to be absent and returns its slot, or SIZE_MAX on failure. Caller holds the exclusive lock.
+static size_t insert_locked(struct SwissDictionary *this, const char *key, const size_t length, const uint64_t h,
+                            const void *value) {
+    char *copy = malloc(length + 1); // Own a copy of the key because the caller may release or mutate its string.
+    if (copy == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::SwissDictionary::put] Error: Failed to allocate key.\033[0m\n");
+        return SIZE_MAX;
+    }
+    memcpy(copy, key, length);
+    copy[length] = '\0';
+
+    size_t index = find_free_index(this->ctrl, this->capacity, h);
+    if (this->growth_left == 0 && this->ctrl[index] == CTRL_EMPTY) {
+        // Reclaim tombstones in place when they make up the load, otherwise double.
+        const size_t capacity = this->size < max_load(this->capacity) / 2 ? this->capacity : this->capacity * 2;
+        if (!resize(this, capacity)) {
+            free((void *) copy);
+            return SIZE_MAX;
+        }
+        index = find_free_index(this->ctrl, this->capacity, h);
+    }
+
+    if (this->ctrl[index] == CTRL_EMPTY) this->growth_left--;
+    this->ctrl[index] = tag_of(h);
+    this->slots[index] = (struct SwissSlot) {copy, value, h, length};
+    this->size++;
+    return index;
+}
+
+// Frees the key of a full slot and marks it free. Caller holds the exclusive lock.
+static void erase_locked(struct SwissDictionary *this, const size_t index) {
+    free((void *) this->slots[index].key);
+
+    // A group that still has an EMPTY slot never made a probe continue past it, so the slot
+    // can become EMPTY again. Otherwise leave a tombstone to keep later probe chains intact.
+    const int8_t *group = this->ctrl + index / GROUP_WIDTH * GROUP_WIDTH;
+    if (group_match_empty(group)) {
+        this->ctrl[index] = CTRL_EMPTY;
+        this->growth_left++;
+    } else {
+        this->ctrl[index] = CTRL_DELETED;
+    }
+    this->size--;
+}
+
+// Inserts a pre-hashed key-value pair, or updates the value of an existing key.
+static bool store(struct SwissDictionary *this, const char *key, const size_t length, const uint64_t h, const void *value) {
+    mutex_lock(&this->mutex);
+
+    size_t index = find_index(this, key, length, h);
+    if (index != SIZE_MAX) {
+        this->slots[index].value = value;
+    } else {
+        index = insert_locked(this, key, length, h, value);
+    }
+
+    mutex_unlock(&this->mutex);
+    return index != SIZE_MAX;
+}
+
+// Inserts a key-value pair, or updates the value of an existing key.
+static bool put(struct IDictionary *self, const char *key, const void *value) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    const size_t length = strlen(key);
+    return store(this, key, length, hash_key(this, key, length), value);
+}
+
+// Returns whether the specified key exists.
+static bool contains_key(const struct IDictionary *self, const char *key) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    const size_t length = strlen(key);
+
+    mutex_lock_shared(&this->mutex);
+    const bool found = find_index(this, key, length, hash_key(this, key, length)) != SIZE_MAX;
+    mutex_unlock(&this->mutex);
+
+    return found;
+}
+
+// Removes the specified key-value pair.
+static void *remove_item(struct IDictionary *self, const char *key) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    const size_t length = strlen(key);
+    void *value = NULL;
+
+    mutex_lock(&this->mutex);
+
+    const size_t index = find_index(this, key, length, hash_key(this, key, length));
+    if (index != SIZE_MAX) {
+        value = (void *) this->slots[index].value;
+        erase_locked(this, index);
+    }
+
+    mutex_unlock(&this->mutex);
+    return value;
+}
+
+// Replaces the value associated with the specified key.
+static void *replace(const struct IDictionary *self, const char *key, const void *value) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    const size_t length = strlen(key);
+    void *temp = NULL;
+
+    mutex_lock(&this->mutex);
+
+    const size_t index = find_index(this, key, length, hash_key(this, key, length));
+    if (index != SIZE_MAX) {
+        temp = (void *) this->slots[index].value;
+        this->slots[index].value = value;
+    }
+
+    mutex_unlock(&this->mutex);
+    return temp;
+}
+
+// Inserts a key-value pair only if the key is absent.
+static bool put_if_absent(struct IDictionary *self, const char *key, const void *value) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t h = hash_key(this, key, length);
+
+    mutex_lock(&this->mutex);
+    const bool added = find_index(this, key, length, h) == SIZE_MAX && insert_locked(this, key, length, h, value) != SIZE_MAX;
+    mutex_unlock(&this->mutex);
+
+    return added;
+}
+
+// Updates or inserts a key-value pair, returning the previous value.
+static void *upsert(struct IDictionary *self, const char *key, const void *value) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t h = hash_key(this, key, length);
+    void *previous = NULL;
+
+    mutex_lock(&this->mutex);
+
+    const size_t index = find_index(this, key, length, h);
+    if (index != SIZE_MAX) {
+        previous = (void *) this->slots[index].value;
+        this->slots[index].value = value;
+    } else {
+        insert_locked(this, key, length, h, value);
+    }
+
+    mutex_unlock(&this->mutex);
+    return previous;
+}
+
+// Returns the value of a key, inserting one from factory if it is absent.
+static void *get_or_insert_with(struct IDictionary *self, const char *key,
+                                void *(*factory)(const char *key, void *context), void *context) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t h = hash_key(this, key, length);
+
+    mutex_lock(&this->mutex);
+
+    void *value = NULL;
+    const size_t index = find_index(this, key, length, h);
+    if (index != SIZE_MAX) {
+        value = (void *) this->slots[index].value;
+    } else {
+        value = factory(key, context); // Ask first; the table is only touched, and may only grow, for a created value.
+        if (value != NULL && insert_locked(this, key, length, h, value) == SIZE_MAX) value = NULL;
+    }
+
+    mutex_unlock(&this->mutex);
+    return value;
+}
+
+// Atomically recomputes the value of a key.
+static void *compute(struct IDictionary *self, const char *key,
+                     bool (*function)(const char *key, void **value, void *context), void *context) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    const size_t length = strlen(key);
+    const uint64_t h = hash_key(this, key, length);
+
+    mutex_lock(&this->mutex);
+
+    void *value = NULL;
+    const size_t index = find_index(this, key, length, h);
+    if (index != SIZE_MAX) {
+        value = (void *) this->slots[index].value;
+        if (function(key, &value, context)) {
+            this->slots[index].value = value;
+        } else {
+            erase_locked(this, index);
+            value = NULL;
+        }
+    } else {
+        // Ask first; the table is only touched, and may only grow, when the function stores a value.
+        if (!function(key, &value, context) || insert_locked(this, key, length, h, value) == SIZE_MAX) value = NULL;
+    }
+
+    mutex_unlock(&this->mutex);
+    return value;
+}
+
+// Prefetches the first control group a batch key probes, PREFETCH_DISTANCE keys ahead of position i. Caller holds the lock.
+static void prefetch_ahead(const struct SwissDictionary *this, const struct HashedKey *keys, const size_t count, const size_t i) {
+    const size_t group_mask = this->capacity / GROUP_WIDTH - 1;
+    if (i == 0) {
+        for (size_t j = 0; j < count && j < PREFETCH_DISTANCE; j++) {
+            PREFETCH(this->ctrl + first_group(keys[j].hash, group_mask) * GROUP_WIDTH);
+        }
+    } else if (i + PREFETCH_DISTANCE - 1 < count) {
+        PREFETCH(this->ctrl + first_group(keys[i + PREFETCH_DISTANCE - 1].hash, group_mask) * GROUP_WIDTH);
+    }
+}
+
+// Looks up a batch of keys under one shared lock.
+static size_t get_many(const struct IDictionary *self, const char *const *keys, const size_t count, void **values) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    struct HashedKey buffer[HASH_KEYS_INLINE];
+    struct HashedKey *hashed = hash_keys(keys, count, this->seed, buffer, HASH_KEYS_INLINE);
+    if (hashed == NULL) {
+        for (size_t i = 0; i < count; i++) values[i] = NULL;
+        return 0;
+    }
+
+    size_t found = 0;
+
+    mutex_lock_shared(&this->mutex);
+
+    for (size_t i = 0; i < count; i++) {
+        prefetch_ahead(this, hashed, count, i);
+        const size_t index = find_index(this, hashed[i].key, hashed[i].length, hashed[i].hash);
+        values[i] = index != SIZE_MAX ? (void *) this->slots[index].value : NULL;
+        if (index != SIZE_MAX) found++;
+    }
+
+    mutex_unlock(&this->mutex);
+
+    hash_keys_free(hashed, buffer);
+    return found;
+}
+
+// Inserts or updates a batch of key-value pairs under one exclusive lock.
+static size_t put_many(struct IDictionary *self, const char *const *keys, const void *const *values, const size_t count) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    struct HashedKey buffer[HASH_KEYS_INLINE];
+    struct HashedKey *hashed = hash_keys(keys, count, this->seed, buffer, HASH_KEYS_INLINE);
+    if (hashed == NULL) return 0;
+
+    size_t stored = 0;
+
+    mutex_lock(&this->mutex);
+
+    for (size_t i = 0; i < count; i++) {
+        prefetch_ahead(this, hashed, count, i);
+        size_t index = find_index(this, hashed[i].key, hashed[i].length, hashed[i].hash);
+        if (index != SIZE_MAX) {
+            this->slots[index].value = values[i];
+        } else {
+            index = insert_locked(this, hashed[i].key, hashed[i].length, hashed[i].hash, values[i]);
+        }
+        if (index != SIZE_MAX) stored++;
+    }
+
+    mutex_unlock(&this->mutex);
+
+    hash_keys_free(hashed, buffer);
+    return stored;
+}
+
+// Removes a batch of keys under one exclusive lock.
+static size_t remove_many(struct IDictionary *self, const char *const *keys, const size_t count, void **values) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    struct HashedKey buffer[HASH_KEYS_INLINE];
+    struct HashedKey *hashed = hash_keys(keys, count, this->seed, buffer, HASH_KEYS_INLINE);
+    if (hashed == NULL) {
+        for (size_t i = 0; values && i < count; i++) values[i] = NULL;
+        return 0;
+    }
+
+    size_t removed = 0;
+
+    mutex_lock(&this->mutex);
+
+    for (size_t i = 0; i < count; i++) {
+        prefetch_ahead(this, hashed, count, i);
+        void *value = NULL;
+        const size_t index = find_index(this, hashed[i].key, hashed[i].length, hashed[i].hash);
+        if (index != SIZE_MAX) {
+            value = (void *) this->slots[index].value;
+            erase_locked(this, index);
+            removed++;
+        }
+        if (values) values[i] = value;
+    }
+
+    mutex_unlock(&this->mutex);
+
+    hash_keys_free(hashed, buffer);
+    return removed;
+}
+
+// Returns the value associated with a pre-hashed key.
+static void *get_hashed(const struct IDictionary *self, const struct CollectionKey *key) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+
+    mutex_lock_shared(&this->mutex);
+
+    const size_t index = find_index(this, key->key, key->length, hash_u64(key->hash, this->seed));
+    void *value = index != SIZE_MAX ? (void *) this->slots[index].value : NULL;
+
+    mutex_unlock(&this->mutex);
+    return value;
+}
+
+// Inserts a pre-hashed key-value pair, or updates the value of an existing key.
+static bool put_hashed(struct IDictionary *self, const struct CollectionKey *key, const void *value) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    return store(this, key->key, key->length, hash_u64(key->hash, this->seed), value);
+}
+
+// Returns whether a pre-hashed key exists.
+static bool contains_key_hashed(const struct IDictionary *self, const struct CollectionKey *key) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+
+    mutex_lock_shared(&this->mutex);
+    const bool found = find_index(this, key->key, key->length, hash_u64(key->hash, this->seed)) != SIZE_MAX;
+    mutex_unlock(&this->mutex);
+
+    return found;
+}
+
+// Removes all key-value pairs from the dictionary.
+static bool clear(const struct IDictionary *self, void (*destructor)(void *value)) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+    mutex_lock(&this->mutex);
+
+    for (size_t i = 0; i < this->capacity; i++) {
+        if (this->ctrl[i] < 0) continue;
+        free((void *) this->slots[i].key);
+        if (destructor) destructor((void *) this->slots[i].value);
+    }
+    memset(this->ctrl, CTRL_EMPTY, this->capacity);
+    this->size = 0;
+    this->growth_left = max_load(this->capacity);
+
+    mutex_unlock(&this->mutex);
+    return true;
+}
+
+// Releases a SwissDictionary instance and its table.
+static void dealloc(struct IDictionary *self, void (*destructor)(void *value)) {
+    struct SwissDictionary *this = (struct SwissDictionary *) self;
+
+    clear(self, destructor);
+
+    free(this->ctrl_allocation);
+    free(this->slots);
+    mutex_destroy(&this->mutex);
+
+    free(this);
+}
+
+// Returns the aligned allocation size for SwissDictionary.
+static size_t size(void) {
+    return (sizeof(struct SwissDictionary) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u);
+}
+
+// Allocates a SwissDictionary instance.
+static struct IDictionary *alloc() {
+    struct IDictionary *dictionary = malloc(size());
+
+    if (dictionary == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::SwissDictionary::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return dictionary;
+}
+
+// Initializes a SwissDictionary instance.
+static struct IDictionary *init(struct IDictionary *dictionary) {
+    if (dictionary == NULL) return NULL;
+
+    struct SwissDictionary *this = (struct SwissDictionary *) dictionary;
+    memset(this, 0, sizeof(struct SwissDictionary));
+
+    this->capacity = INITIAL_CAPACITY;
+    this->growth_left = max_load(this->capacity);
+    this->seed = hash_seed();
+    this->ctrl = ctrl_alloc(this->capacity, &this->ctrl_allocation);
+    this->slots = malloc(this->capacity * sizeof(struct SwissSlot));
+    if (this->ctrl == NULL || this->slots == NULL) goto exception;
+
+    if (mutex_init(&this->mutex) != 0) goto exception;
+    mutex_set_name(&this->mutex, "Collection::SwissDictionary");
+
+    this->super.get = get;
+    this->super.put = put;
+    this->super.contains_key = contains_key;
+    this->super.remove_item = remove_item;
+    this->super.replace = replace;
+    this->super.put_if_absent = put_if_absent;
+    this->super.upsert = upsert;
+    this->super.get_or_insert_with = get_or_insert_with;
+    this->super.compute = compute;
+    this->super.get_many = get_many;
+    this->super.put_many = put_many;
+    this->super.remove_many = remove_many;
+    this->super.get_hashed = get_hashed;
+    this->super.put_hashed = put_hashed;
+    this->super.contains_key_hashed = contains_key_hashed;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return dictionary;
+
+exception:
+    free(this->ctrl_allocation);
+    free(this->slots);
+    free(dictionary);
+    return NULL;
+}
+
+// Creates a new Swiss table dictionary instance.
+struct IDictionary *collection_dictionary_new_swiss(void) {
+    return init(alloc());
+}
@@ -0,0 +1,47 @@
+/**
+* @file swiss_dictionary.h
+* @internal
+* @brief Swiss Table Dictionary Header
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#pragma once
+
+#include "collection/i_dictionary.h"
+#include "collection/i_platform.h"
+
+#include <stdint.h>
+
+/**
+ * @struct SwissSlot
+ * @brief Key-value pair stored inline in the slot array.
+ */
+struct SwissSlot {
+    const char *key;                    /**< Heap-allocated key string. */
+    const void *value;                  /**< Associated value. */
+    uint64_t hash;                      /**< Full hash of the key, reused when resizing. */
+    size_t length;                      /**< Key length in bytes, excluding the terminator. */
+};
+
+/**
+ * @struct SwissDictionary
+ * @brief Open-addressing implementation of IDictionary.
+ *
+ * The table is split into groups of 16 slots. Each slot has a control byte that
+ * is either EMPTY, DELETED, or the low 7 bits of the key's hash (H2). Lookups
+ * select a start group from the remaining hash bits (H1), compare all 16 control
+ * bytes against H2 at once, and only touch slots whose tag matches. Probing stops
+ * at the first group that contains an EMPTY byte. Access is synchronized with a mutex.
+ */
+struct SwissDictionary {
+    struct IDictionary super;           /**< IDictionary interface implemented by this type. */
+    int8_t *ctrl;                       /**< Control bytes, one per slot, aligned to the group width. */
+    void *ctrl_allocation;              /**< Unaligned allocation backing ctrl. */
+    struct SwissSlot *slots;            /**< Slot array. */
+    size_t capacity;                    /**< Number of slots, a power of two and a multiple of the group width. */
+    size_t size;                        /**< Number of stored key-value pairs. */
+    size_t growth_left;                 /**< Inserts into EMPTY slots remaining before a resize. */
+    uint64_t seed;                      /**< Per-instance hash seed. */
+    Mutex mutex;                        /**< Mutex protecting dictionary operations. */
+};
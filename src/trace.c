@@ -0,0 +1,299 @@
+/**
+* @file trace.c
+* @internal
+* @brief Trace Writer and Loader Implementation
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#include "trace.h"
+#include "compiler.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+static atomic_uint next_thread;             // Number given to the next thread that records.
+static THREAD_LOCAL unsigned thread_number; // This thread's number plus one, or 0 before its first record.
+static atomic_uint_fast64_t next_trace;     // Id of the most recently created trace.
+static THREAD_LOCAL uint64_t cached_trace;  // Id of the trace whose buffer this thread last used, or 0.
+static THREAD_LOCAL struct TraceBuffer *cached_buffer; // This thread's buffer of that trace.
+
+// Returns the calling thread's trace number, assigning one on first use.
+static unsigned current_thread(void) {
+    if (thread_number == 0) thread_number = atomic_fetch_add_explicit(&next_thread, 1, memory_order_relaxed) + 1;
+    return thread_number - 1;
+}
+
+// Stores a value in little-endian byte order.
+static void store_le(unsigned char *bytes, uint64_t value, const size_t size) {
+    for (size_t i = 0; i < size; i++, value >>= 8) bytes[i] = (unsigned char) value;
+}
+
+// Loads a little-endian value.
+static uint64_t load_le(const unsigned char *bytes, const size_t size) {
+    uint64_t value = 0;
+    for (size_t i = size; i > 0; i--) value = value << 8 | bytes[i - 1];
+    return value;
+}
+
+// Serializes a record into TRACE_RECORD_SIZE bytes.
+static void encode(unsigned char *bytes, const struct CollectionTraceRecord *record) {
+    bytes[0] = record->op;
+    bytes[1] = record->flags;
+    store_le(bytes + 2, record->thread, 2);
+    store_le(bytes + 4, record->key_length, 4);
+    store_le(bytes + 8, record->key_hash, 8);
+    store_le(bytes + 16, record->index, 8);
+    store_le(bytes + 24, record->sequence, 8);
+}
+
+// Deserializes a record.
+static void decode(const unsigned char *bytes, struct CollectionTraceRecord *record) {
+    record->op = bytes[0];
+    record->flags = bytes[1];
+    record->thread = (uint16_t) load_le(bytes + 2, 2);
+    record->key_length = (uint32_t) load_le(bytes + 4, 4);
+    record->key_hash = load_le(bytes + 8, 8);
+    record->index = load_le(bytes + 16, 8);
+    record->sequence = load_le(bytes + 24, 8);
+}
+
+// Writes a buffer to the file. Caller holds the buffer's and the trace's locks.
+static bool write_locked(struct Trace *this, struct TraceBuffer *buffer) {
+    if (buffer->buffered == 0 || this->failed) {
+        buffer->buffered = 0;
+        return !this->failed;
+    }
+
+    if (fwrite(buffer->bytes, TRACE_RECORD_SIZE, buffer->buffered, this->file) != buffer->buffered) {
+        fprintf(stderr, "\033[0;31m[Collection::Trace::flush] Error: Trace write failed; later records are dropped.\033[0m\n");
+        this->failed = true;
+    }
+    buffer->buffered = 0;
+    return !this->failed;
+}
+
+// Returns the calling thread's buffer for a trace, creating it on first use.
+static struct TraceBuffer *thread_buffer(struct Trace *this, const unsigned thread) {
+    if (cached_trace == this->id) return cached_buffer;
+
+    mutex_lock(&this->mutex);
+    struct TraceBuffer *buffer = this->buffers;
+    while (buffer != NULL && buffer->owner != thread) buffer = buffer->next;
+
+    if (buffer == NULL) {
+        buffer = malloc(sizeof(struct TraceBuffer) + TRACE_BUFFER_RECORDS * TRACE_RECORD_SIZE);
+        if (buffer == NULL || mutex_init(&buffer->mutex) != 0) {
+            fprintf(stderr, "\033[0;31m[Collection::Trace::append] Error: Buffer allocation failed; records are dropped.\033[0m\n");
+            mutex_unlock(&this->mutex);
+            free(buffer);
+            return NULL;
+        }
+        mutex_set_name(&buffer->mutex, "Collection::Trace::Buffer");
+        buffer->owner = thread;
+        buffer->bytes = (unsigned char *) (buffer + 1);
+        buffer->buffered = 0;
+        buffer->next = this->buffers;
+        this->buffers = buffer;
+    }
+    mutex_unlock(&this->mutex);
+
+    cached_trace = this->id;
+    cached_buffer = buffer;
+    return buffer;
+}
+
+// Appends records as one contiguous run.
+void trace_append(struct ITrace *trace, struct CollectionTraceRecord *records, const size_t count) {
+    struct Trace *this = (struct Trace *) trace;
+    const unsigned thread = current_thread();
+
+    struct TraceBuffer *buffer = thread_buffer(this, thread);
+    if (buffer == NULL) return;
+
+    uint64_t sequence = atomic_fetch_add_explicit(&this->sequence, count, memory_order_relaxed);
+    mutex_lock(&buffer->mutex);
+    for (size_t i = 0; i < count; i++) {
+        if (buffer->buffered == TRACE_BUFFER_RECORDS) {
+            mutex_lock(&this->mutex);
+            write_locked(this, buffer);
+            mutex_unlock(&this->mutex);
+        }
+        records[i].thread = (uint16_t) thread;
+        records[i].sequence = sequence++;
+        encode(buffer->bytes + buffer->buffered * TRACE_RECORD_SIZE, &records[i]);
+        buffer->buffered++;
+    }
+    mutex_unlock(&buffer->mutex);
+}
+
+// Writes every thread's buffered records and flushes the file.
+static bool flush(struct ITrace *self) {
+    struct Trace *this = (struct Trace *) self;
+
+    mutex_lock(&this->mutex);
+    struct TraceBuffer *buffer = this->buffers;
+    mutex_unlock(&this->mutex);
+
+    bool written = true;
+    for (; buffer != NULL; buffer = buffer->next) { // Buffers are only ever linked at the head, so next is stable.
+        mutex_lock(&buffer->mutex);
+        mutex_lock(&this->mutex);
+        written = write_locked(this, buffer) && written;
+        mutex_unlock(&this->mutex);
+        mutex_unlock(&buffer->mutex);
+    }
+
+    mutex_lock(&this->mutex);
+    written = !this->failed && fflush(this->file) == 0 && written;
+    mutex_unlock(&this->mutex);
+    return written;
+}
+
+// Returns the number of records appended so far.
+static size_t count(const struct ITrace *self) {
+    struct Trace *this = (struct Trace *) self;
+    return (size_t) atomic_load_explicit(&this->sequence, memory_order_relaxed);
+}
+
+// Flushes and closes the trace.
+static void dealloc(struct ITrace *self) {
+    struct Trace *this = (struct Trace *) self;
+
+    flush(self);
+    if (fclose(this->file) != 0) {
+        fprintf(stderr, "\033[0;31m[Collection::Trace::dealloc] Error: Trace file could not be closed.\033[0m\n");
+    }
+    while (this->buffers != NULL) {
+        struct TraceBuffer *next = this->buffers->next;
+        mutex_destroy(&this->buffers->mutex);
+        free(this->buffers);
+        this->buffers = next;
+    }
+    mutex_destroy(&this->mutex);
+    free(this);
+}
+
+// Returns the aligned allocation size for Trace.
+static size_t size(void) {
+    return (sizeof(struct Trace) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u); // Align to pointer size.
+}
+
+// Allocates a Trace instance.
+static struct ITrace *alloc(void) {
+    struct ITrace *trace = malloc(size());
+
+    if (trace == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Trace::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return trace;
+}
+
+// Initializes a Trace instance writing to a new file.
+static struct ITrace *init(struct ITrace *trace, const char *path) {
+    if (trace == NULL) return NULL;
+
+    struct Trace *this = (struct Trace *) trace;
+    memset(this, 0, sizeof(struct Trace));
+
+    if (path == NULL || (this->file = fopen(path, "wb")) == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Trace::init] Error: Trace file could not be created.\033[0m\n");
+        goto exception;
+    }
+
+    unsigned char header[TRACE_HEADER_SIZE];
+    memcpy(header, TRACE_MAGIC, 4);
+    store_le(header + 4, TRACE_VERSION, 2);
+    store_le(header + 6, TRACE_RECORD_SIZE, 2);
+    if (fwrite(header, 1, sizeof(header), this->file) != sizeof(header)) {
+        fprintf(stderr, "\033[0;31m[Collection::Trace::init] Error: Trace header could not be written.\033[0m\n");
+        goto exception;
+    }
+
+    if (mutex_init(&this->mutex) != 0) {
+        fprintf(stderr, "\033[0;31m[Collection::Trace::init] Error: Mutex initialization failed.\033[0m\n");
+        goto exception;
+    }
+    mutex_set_name(&this->mutex, "Collection::Trace");
+    this->id = atomic_fetch_add_explicit(&next_trace, 1, memory_order_relaxed) + 1;
+    atomic_init(&this->sequence, 0);
+
+    this->super.flush = flush;
+    this->super.count = count;
+    this->super.dealloc = dealloc;
+
+    return trace;
+
+exception:
+    if (this->file) fclose(this->file);
+    free(trace);
+    return NULL;
+}
+
+// Creates a new trace writing to the specified file.
+struct ITrace *collection_trace_new(const char *path) {
+    return init(alloc(), path);
+}
+
+// Deallocates a trace and nulls the caller's pointer.
+void collection_trace_dealloc(struct ITrace **trace) {
+    if (trace == NULL || *trace == NULL) return;
+    (*trace)->dealloc(*trace);
+    *trace = NULL;
+}
+
+// Orders records by sequence number.
+static int compare_sequence(const void *a, const void *b) {
+    const uint64_t x = ((const struct CollectionTraceRecord *) a)->sequence;
+    const uint64_t y = ((const struct CollectionTraceRecord *) b)->sequence;
+    return (x > y) - (x < y);
+}
+
+// Reads every record of a trace file in sequence order.
+struct CollectionTraceRecord *collection_trace_load(const char *path, size_t *count) {
+    if (count) *count = 0;
+    if (path == NULL || count == NULL) return NULL;
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Trace::load] Error: Trace file could not be opened.\033[0m\n");
+        return NULL;
+    }
+
+    struct CollectionTraceRecord *records = NULL;
+    size_t capacity = 0;
+    unsigned char header[TRACE_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, TRACE_MAGIC, 4) != 0 ||
+        load_le(header + 4, 2) != TRACE_VERSION || load_le(header + 6, 2) != TRACE_RECORD_SIZE) {
+        fprintf(stderr, "\033[0;31m[Collection::Trace::load] Error: Not a version %d trace file.\033[0m\n", TRACE_VERSION);
+        goto exception;
+    }
+
+    unsigned char bytes[TRACE_RECORD_SIZE];
+    while (fread(bytes, 1, sizeof(bytes), file) == sizeof(bytes)) {
+        if (*count == capacity) {
+            capacity = capacity ? capacity * 2 : 1024;
+            struct CollectionTraceRecord *grown = realloc(records, capacity * sizeof(struct CollectionTraceRecord));
+            if (grown == NULL) {
+                fprintf(stderr, "\033[0;31m[Collection::Trace::load] Error: Record allocation failed.\033[0m\n");
+                goto exception;
+            }
+            records = grown;
+        }
+        decode(bytes, &records[(*count)++]);
+    }
+    if (ferror(file) || *count == 0) goto exception;
+
+    fclose(file);
+    qsort(records, *count, sizeof(struct CollectionTraceRecord), compare_sequence); // Each thread's buffers are written as separate runs.
+    return records;
+
+exception:
+    fclose(file);
+    free(records);
+    *count = 0;
+    return NULL;
+}
@@ -0,0 +1,62 @@
+/**
+* @file trace.h
+* @internal
+* @brief Trace Writer Header
+*
+* @author Saad Shams https://linkedin.com/in/muizz
+* @copyright BSD 3-Clause License
+*/
+#pragma once
+
+#include "collection/i_trace.h"
+#include "collection/i_platform.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define TRACE_MAGIC "CTRC"              // First four bytes of every trace file.
+#define TRACE_VERSION 2                 // Format version following the magic.
+#define TRACE_HEADER_SIZE 8             // Magic, 16-bit version, 16-bit record size.
+#define TRACE_RECORD_SIZE 32            // Bytes per serialized record.
+#define TRACE_BUFFER_RECORDS 1024       // Records each thread buffers before writing them to the file.
+
+/**
+ * @struct TraceBuffer
+ * @brief Records serialized by one thread and not yet written.
+ */
+struct TraceBuffer {
+    struct TraceBuffer *next;           /**< Next buffer of the same trace. */
+    unsigned owner;                     /**< Number of the only thread that appends to this buffer. */
+    unsigned char *bytes;               /**< Room for TRACE_BUFFER_RECORDS serialized records. */
+    size_t buffered;                    /**< Number of records in bytes. */
+    Mutex mutex;                        /**< Taken by the owner to append and by flush() to drain; otherwise uncontended. */
+};
+
+/**
+ * @struct Trace
+ * @brief ITrace writing little-endian fixed-size records through per-thread buffers.
+ *
+ * Every record takes the next value of one atomic sequence counter, so threads
+ * never wait for each other to append. Each full buffer is written as one run,
+ * and collection_trace_load() merges the runs back into sequence order.
+ */
+struct Trace {
+    struct ITrace super;                /**< ITrace interface implemented by this type. */
+    FILE *file;                         /**< Open trace file. */
+    uint64_t id;                        /**< Tells this trace from earlier ones at the same address in thread caches. */
+    atomic_uint_fast64_t sequence;      /**< Sequence number of the next record, and so the number appended. */
+    struct TraceBuffer *buffers;        /**< Buffers of every thread that has recorded, newest first. */
+    bool failed;                        /**< Set once a write fails; later records are dropped. */
+    Mutex mutex;                        /**< Protects the file, the buffer list and failed. */
+};
+
+/**
+ * @brief Appends records as one contiguous run, stamping them with the calling thread and their sequence numbers.
+ *
+ * @param trace Trace to append to.
+ * @param records Records to append; their thread and sequence members are overwritten.
+ * @param count Number of records.
+ */
+void trace_append(struct ITrace *trace, struct CollectionTraceRecord *records, size_t count);
@@ -0,0 +1,377 @@
+/**
+ * @file vector.c
+ * @internal
+ * @brief Vector Implementation
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "vector.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 8
+
+// Reallocates the item buffer to exactly `capacity` slots. Caller holds the exclusive lock.
+static bool resize(struct Vector *this, const size_t capacity) {
+    if (capacity > SIZE_MAX / sizeof(void *)) return false;
+
+    const void **items = realloc(this->items, (capacity ? capacity : 1) * sizeof(void *));
+    if (items == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Vector::resize] Error: Failed to allocate item buffer.\033[0m\n");
+        return false;
+    }
+
+    this->items = items;
+    this->capacity = capacity;
+    return true;
+}
+
+// Makes room for one more item, doubling the capacity when full. Caller holds the exclusive lock.
+static bool grow(struct Vector *this) {
+    if (this->size < this->capacity) return true;
+    return resize(this, this->capacity ? this->capacity * 2 : INITIAL_CAPACITY);
+}
+
+// Returns the element at the specified index, or NULL if out of range.
+static const void *get(const struct IArray *self, const size_t index) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock_shared(&this->mutex);
+
+    const void *item = index < this->size ? this->items[index] : NULL;
+
+    mutex_unlock(&this->mutex);
+    return item;
+}
+
+// Replaces the element at the specified index.
+static void *put(struct IArray *self, const void *item, const size_t index) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock(&this->mutex);
+
+    void *temp = NULL;
+    if (index < this->size) {
+        temp = (void *) this->items[index];
+        this->items[index] = item;
+    }
+
+    mutex_unlock(&this->mutex);
+    return temp;
+}
+
+// Invokes a callback for each element.
+static void for_each(const struct IArray *self, void (*consumer)(const void *element, const void *data), const void *data) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock_shared(&this->mutex);
+
+    for (size_t i = 0; i < this->size; i++) {
+        consumer(this->items[i], data);
+    }
+
+    mutex_unlock(&this->mutex);
+}
+
+// Finds the first element matching a predicate.
+static const void *find(const struct IArray *self, bool (*predicate)(const void *element, const void *data), const void *data) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock_shared(&this->mutex);
+
+    const void *item = NULL;
+    for (size_t i = 0; i < this->size; i++) {
+        if (predicate(this->items[i], data)) {
+            item = this->items[i];
+            break;
+        }
+    }
+
+    mutex_unlock(&this->mutex);
+    return item;
+}
+
+// Returns the index of the first matching element.
+static size_t first_index(const struct IArray *self, bool (*predicate)(const void *element, const void *data), const void *data) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock_shared(&this->mutex);
+
+    size_t index = (size_t) -1; // No matching element found.
+    for (size_t i = 0; i < this->size; i++) {
+        if (predicate(this->items[i], data)) {
+            index = i;
+            break;
+        }
+    }
+
+    mutex_unlock(&this->mutex);
+    return index;
+}
+
+// Returns the index of the last matching element.
+static size_t last_index(const struct IArray *self, bool (*predicate)(const void *element, const void *data), const void *data) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock_shared(&this->mutex);
+
+    size_t index = (size_t) -1;
+    for (size_t i = this->size; i > 0; i--) { // Scan backwards and stop at the first match.
+        if (predicate(this->items[i - 1], data)) {
+            index = i - 1;
+            break;
+        }
+    }
+
+    mutex_unlock(&this->mutex);
+    return index;
+}
+
+// Inserts an element at the beginning of the array.
+static const void *unshift(struct IArray *self, const void *item) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock(&this->mutex);
+
+    if (!grow(this)) {
+        mutex_unlock(&this->mutex);
+        return NULL;
+    }
+
+    memmove(this->items + 1, this->items, this->size * sizeof(void *));
+    this->items[0] = item;
+    this->size++;
+
+    mutex_unlock(&this->mutex);
+    return item;
+}
+
+// Appends an element to the end of the array.
+static bool push(struct IArray *self, const void *item) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock(&this->mutex);
+
+    const bool success = grow(this);
+    if (success) this->items[this->size++] = item;
+
+    mutex_unlock(&this->mutex);
+    return success;
+}
+
+// Returns whether the array contains the specified element.
+static bool contains_value(const struct IArray *self, const void *item) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock_shared(&this->mutex);
+
+    bool found = false;
+    for (size_t i = 0; i < this->size; i++) {
+        if (this->items[i] == item) {
+            found = true;
+            break;
+        }
+    }
+
+    mutex_unlock(&this->mutex);
+    return found;
+}
+
+// Removes and returns the first element.
+static const void *shift(struct IArray *self) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock(&this->mutex);
+
+    const void *item = NULL;
+    if (this->size > 0) {
+        item = this->items[0];
+        this->size--;
+        memmove(this->items, this->items + 1, this->size * sizeof(void *));
+    }
+
+    mutex_unlock(&this->mutex);
+    return item;
+}
+
+// Removes and returns the last element.
+static const void *pop(struct IArray *self) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock(&this->mutex);
+
+    const void *item = this->size > 0 ? this->items[--this->size] : NULL;
+
+    mutex_unlock(&this->mutex);
+    return item;
+}
+
+// Removes the specified element.
+static void *remove_item(struct IArray *self, const void *item) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock(&this->mutex);
+
+    void *data = NULL;
+    for (size_t i = 0; i < this->size; i++) {
+        if (this->items[i] == item) {
+            data = (void *) this->items[i];
+            this->size--;
+            memmove(this->items + i, this->items + i + 1, (this->size - i) * sizeof(void *));
+            break;
+        }
+    }
+
+    mutex_unlock(&this->mutex);
+    return data;
+}
+
+// Creates a shallow copy of the array.
+static struct IArray *vector_clone(const struct IArray *self) {
+    struct Vector *this = (struct Vector *) self;
+
+    struct IArray *arr = collection_array_new_vector(); // Create a new array container
+    if (arr == NULL) return NULL;
+    struct Vector *copy = (struct Vector *) arr;
+
+    mutex_lock_shared(&this->mutex); // Acquire read lock
+
+    if (!resize(copy, this->size)) {
+        mutex_unlock(&this->mutex);
+        collection_array_dealloc(&arr, NULL);
+        return NULL;
+    }
+    if (this->size > 0) memcpy(copy->items, this->items, this->size * sizeof(void *)); // Shallow copy item pointers
+    copy->size = this->size;
+
+    mutex_unlock(&this->mutex);
+    return arr;
+}
+
+// Returns the number of elements.
+static size_t count(const struct IArray *self) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock_shared(&this->mutex);
+
+    const size_t count = this->size;
+
+    mutex_unlock(&this->mutex);
+    return count;
+}
+
+// Removes all elements from the array, keeping the allocated capacity.
+static void clear(struct IArray *self, void (*destructor)(void *item)) {
+    struct Vector *this = (struct Vector *) self;
+    mutex_lock(&this->mutex);
+
+    if (destructor) {
+        for (size_t i = 0; i < this->size; i++) destructor((void *) this->items[i]);
+    }
+    this->size = 0;
+
+    mutex_unlock(&this->mutex);
+}
+
+// Releases a Vector instance and its buffer.
+static void dealloc(struct IArray *self, void (*destructor)(void *item)) {
+    struct Vector *this = (struct Vector *) self;
+
+    clear(self, destructor);
+    mutex_destroy(&this->mutex);
+
+    free(this->items);
+    free(this);
+}
+
+// Returns the aligned allocation size for Vector.
+static size_t size(void) {
+    return (sizeof(struct Vector) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u); // Align to pointer size.
+}
+
+// Allocates a Vector instance.
+static struct IArray *alloc() {
+    struct IArray *array = malloc(size());
+
+    if (array == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::Vector::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return array;
+}
+
+// Initializes a Vector instance.
+static struct IArray *init(struct IArray *array) {
+    if (array == NULL) return NULL;
+
+    struct Vector *this = (struct Vector *) array;
+    memset(this, 0, sizeof(struct Vector));
+
+    if (mutex_init(&this->mutex) != 0) goto exception;
+    mutex_set_name(&this->mutex, "Collection::Vector");
+
+    this->items = NULL; // Allocated lazily on first insert or reserve.
+    this->super.get = get;
+    this->super.put = put;
+    this->super.for_each = for_each;
+    this->super.find = find;
+    this->super.first_index = first_index;
+    this->super.last_index = last_index;
+    this->super.unshift = unshift;
+    this->super.push = push;
+    this->super.contains_value = contains_value;
+    this->super.shift = shift;
+    this->super.pop = pop;
+    this->super.remove_item = remove_item;
+    this->super.clone = vector_clone;
+    this->super.count = count;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return array;
+
+exception:
+    free(array);
+    return NULL;
+}
+
+// Creates a new vector-backed array instance.
+struct IArray *collection_array_new_vector(void) {
+    return init(alloc());
+}
+
+// Returns whether an array is a vector: every vector, and nothing else, uses this file's dealloc.
+static bool is_vector(const struct IArray *array) {
+    return array->dealloc == dealloc;
+}
+
+// Ensures capacity for at least the given number of elements.
+bool collection_array_vector_reserve(struct IArray *array, const size_t capacity) {
+    if (array == NULL) return false;
+    if (!is_vector(array)) {
+        fprintf(stderr, "\033[0;31m[Collection::Vector::reserve] Error: Array is not a vector.\033[0m\n");
+        return false;
+    }
+    struct Vector *this = (struct Vector *) array;
+    mutex_lock(&this->mutex);
+
+    const bool success = capacity <= this->capacity || resize(this, capacity);
+
+    mutex_unlock(&this->mutex);
+    return success;
+}
+
+// Shrinks the buffer to the number of stored elements.
+bool collection_array_vector_shrink_to_fit(struct IArray *array) {
+    if (array == NULL) return false;
+    if (!is_vector(array)) {
+        fprintf(stderr, "\033[0;31m[Collection::Vector::shrink_to_fit] Error: Array is not a vector.\033[0m\n");
+        return false;
+    }
+    struct Vector *this = (struct Vector *) array;
+    mutex_lock(&this->mutex);
+
+    bool success = true;
+    if (this->size == 0) {
+        free(this->items);
+        this->items = NULL;
+        this->capacity = 0;
+    } else if (this->size < this->capacity) {
+        success = resize(this, this->size);
+    }
+
+    mutex_unlock(&this->mutex);
+    return success;
+}
@@ -0,0 +1,27 @@
+/**
+ * @file vector.h
+ * @internal
+ * @brief Vector Header
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include "collection/i_array.h"
+#include "collection/i_platform.h"
+
+/**
+ * @struct Vector
+ * @brief Contiguous buffer implementation of IArray.
+ *
+ * Stores item pointers in a single heap buffer that grows geometrically,
+ * protected by a mutex.
+ */
+struct Vector {
+    struct IArray super;            /**< IArray interface implemented by this type. */
+    const void **items;             /**< Item buffer. */
+    size_t size;                    /**< Number of stored items. */
+    size_t capacity;                /**< Number of item slots in the buffer. */
+    Mutex mutex;                    /**< Mutex protecting vector operations. */
+};
@@ -0,0 +1,211 @@
+/**
+ * @file work_stealing_deque.c
+ * @internal
+ * @brief Work-Stealing Deque Implementation
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "work_stealing_deque.h"
+#include "array_unsupported.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define INITIAL_CAPACITY 32
+
+// Allocates a ring with the given power-of-two capacity.
+static struct WorkStealingBuffer *buffer_new(const size_t capacity) {
+    if (capacity > (SIZE_MAX - sizeof(struct WorkStealingBuffer)) / sizeof(_Atomic(const void *))) return NULL;
+
+    struct WorkStealingBuffer *buffer = malloc(sizeof(struct WorkStealingBuffer) + capacity * sizeof(_Atomic(const void *)));
+    if (buffer == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::WorkStealingDeque::buffer_new] Error: Failed to allocate ring buffer.\033[0m\n");
+        return NULL;
+    }
+
+    buffer->mask = capacity - 1;
+    buffer->retired = NULL;
+    return buffer;
+}
+
+// Replaces the ring with one twice as large holding the elements in [top, bottom). Owner thread only.
+static struct WorkStealingBuffer *grow(struct WorkStealingDeque *this, struct WorkStealingBuffer *old,
+                                       const size_t top, const size_t bottom) {
+    struct WorkStealingBuffer *buffer = buffer_new((old->mask + 1) * 2);
+    if (buffer == NULL) return NULL;
+
+    for (size_t i = top; i != bottom; i++) {
+        const void *item = atomic_load_explicit(&old->items[i & old->mask], memory_order_relaxed);
+        atomic_store_explicit(&buffer->items[i & buffer->mask], item, memory_order_relaxed);
+    }
+
+    buffer->retired = old; // Thieves that loaded the old ring may still read it.
+    atomic_store_explicit(&this->buffer, buffer, memory_order_release);
+    return buffer;
+}
+
+// Pushes an element at the bottom, growing the ring when full. Owner thread only.
+static bool push(struct IArray *self, const void *item) {
+    struct WorkStealingDeque *this = (struct WorkStealingDeque *) self;
+
+    const size_t bottom = atomic_load_explicit(&this->bottom, memory_order_relaxed);
+    const size_t top = atomic_load_explicit(&this->top, memory_order_acquire);
+    struct WorkStealingBuffer *buffer = atomic_load_explicit(&this->buffer, memory_order_relaxed);
+
+    if (bottom - top > buffer->mask) {
+        buffer = grow(this, buffer, top, bottom);
+        if (buffer == NULL) return false;
+    }
+
+    atomic_store_explicit(&buffer->items[bottom & buffer->mask], item, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&this->bottom, bottom + 1, memory_order_relaxed);
+    return true;
+}
+
+// Steals the element at the top, retrying lost races until it succeeds or the deque is empty. Any thread.
+static const void *shift(struct IArray *self) {
+    struct WorkStealingDeque *this = (struct WorkStealingDeque *) self;
+
+    for (;;) {
+        size_t top = atomic_load_explicit(&this->top, memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        const size_t bottom = atomic_load_explicit(&this->bottom, memory_order_acquire);
+
+        if ((ptrdiff_t) (bottom - top) <= 0) return NULL;
+
+        // The C11 paper uses consume here; acquire is the portable equivalent.
+        struct WorkStealingBuffer *buffer = atomic_load_explicit(&this->buffer, memory_order_acquire);
+        const void *item = atomic_load_explicit(&buffer->items[top & buffer->mask], memory_order_relaxed);
+
+        if (atomic_compare_exchange_strong_explicit(&this->top, &top, top + 1,
+                                                    memory_order_seq_cst, memory_order_relaxed)) {
+            return item;
+        }
+        // Another thief or the owner took this element; try the next one.
+    }
+}
+
+// Pops the element at the bottom. Owner thread only.
+static const void *pop(struct IArray *self) {
+    struct WorkStealingDeque *this = (struct WorkStealingDeque *) self;
+
+    const size_t bottom = atomic_load_explicit(&this->bottom, memory_order_relaxed) - 1;
+    struct WorkStealingBuffer *buffer = atomic_load_explicit(&this->buffer, memory_order_relaxed);
+    atomic_store_explicit(&this->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    size_t top = atomic_load_explicit(&this->top, memory_order_relaxed);
+
+    if ((ptrdiff_t) (bottom - top) < 0) { // Already empty; undo the reservation.
+        atomic_store_explicit(&this->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    const void *item = atomic_load_explicit(&buffer->items[bottom & buffer->mask], memory_order_relaxed);
+    if (bottom == top) { // Last element; race the thieves for it.
+        if (!atomic_compare_exchange_strong_explicit(&this->top, &top, top + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            item = NULL;
+        }
+        atomic_store_explicit(&this->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return item;
+}
+
+// Returns the number of elements; a snapshot when other threads are active.
+static size_t count(const struct IArray *self) {
+    struct WorkStealingDeque *this = (struct WorkStealingDeque *) self;
+
+    const size_t top = atomic_load_explicit(&this->top, memory_order_acquire);
+    const size_t bottom = atomic_load_explicit(&this->bottom, memory_order_acquire);
+
+    const ptrdiff_t count = (ptrdiff_t) (bottom - top);
+    return count > 0 ? (size_t) count : 0;
+}
+
+// Pops every element. Owner thread only.
+static void clear(struct IArray *self, void (*destructor)(void *item)) {
+    while (count(self) > 0) {
+        const void *item = pop(self);
+        if (destructor && item) destructor((void *) item);
+    }
+}
+
+// Releases a WorkStealingDeque instance, its ring and every retired ring.
+static void dealloc(struct IArray *self, void (*destructor)(void *item)) {
+    struct WorkStealingDeque *this = (struct WorkStealingDeque *) self;
+
+    clear(self, destructor);
+
+    struct WorkStealingBuffer *buffer = atomic_load_explicit(&this->buffer, memory_order_relaxed);
+    while (buffer) {
+        struct WorkStealingBuffer *retired = buffer->retired;
+        free(buffer);
+        buffer = retired;
+    }
+    free(this);
+}
+
+// Returns the aligned allocation size for WorkStealingDeque.
+static size_t size(void) {
+    return (sizeof(struct WorkStealingDeque) + (sizeof(void *) - 1u)) & ~(sizeof(void *) - 1u); // Align to pointer size.
+}
+
+// Allocates a WorkStealingDeque instance.
+static struct IArray *alloc() {
+    struct IArray *array = malloc(size());
+
+    if (array == NULL) {
+        fprintf(stderr, "\033[0;31m[Collection::WorkStealingDeque::alloc] ERROR: Instance allocation failed.\033[0m\n");
+        return NULL;
+    }
+
+    return array;
+}
+
+// Initializes a WorkStealingDeque instance.
+static struct IArray *init(struct IArray *array) {
+    if (array == NULL) return NULL;
+
+    struct WorkStealingDeque *this = (struct WorkStealingDeque *) array;
+    memset(this, 0, sizeof(struct WorkStealingDeque));
+
+    struct WorkStealingBuffer *buffer = buffer_new(INITIAL_CAPACITY);
+    if (buffer == NULL) goto exception;
+
+    atomic_init(&this->buffer, buffer);
+    atomic_init(&this->bottom, 0);
+    atomic_init(&this->top, 0);
+
+    this->super.get = array_unsupported_get;
+    this->super.put = array_unsupported_put;
+    this->super.for_each = array_unsupported_for_each;
+    this->super.find = array_unsupported_find;
+    this->super.first_index = array_unsupported_index;
+    this->super.last_index = array_unsupported_index;
+    this->super.unshift = array_unsupported_unshift;
+    this->super.push = push;
+    this->super.contains_value = array_unsupported_contains_value;
+    this->super.shift = shift;
+    this->super.pop = pop;
+    this->super.remove_item = array_unsupported_remove_item;
+    this->super.clone = array_unsupported_clone;
+    this->super.count = count;
+    this->super.clear = clear;
+    this->super.dealloc = dealloc;
+
+    return array;
+
+exception:
+    free(array);
+    return NULL;
+}
+
+// Creates a new Chase-Lev work-stealing deque.
+struct IArray *collection_array_new_work_stealing(void) {
+    return init(alloc());
+}
@@ -0,0 +1,48 @@
+/**
+ * @file work_stealing_deque.h
+ * @internal
+ * @brief Work-Stealing Deque Header
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+#include "collection/i_array.h"
+#include "compiler.h"
+
+#include <stdatomic.h>
+
+/**
+ * @struct WorkStealingBuffer
+ * @brief Circular array of a work-stealing deque.
+ *
+ * Slots are atomic because a thief may read a slot while the owner writes a
+ * different lap of the same index; the value is only used if the thief then
+ * wins the CAS on top. Replaced buffers are kept on the retired chain until
+ * the deque is destroyed, since a thief may still be reading them.
+ */
+struct WorkStealingBuffer {
+    size_t mask;                            /**< Capacity - 1; the capacity is a power of two. */
+    struct WorkStealingBuffer *retired;     /**< Buffer this one replaced, or NULL. */
+    _Atomic(const void *) items[];          /**< Ring of item pointers. */
+};
+
+/**
+ * @struct WorkStealingDeque
+ * @brief Chase-Lev dynamic circular work-stealing deque implementation of IArray.
+ *
+ * The owner thread pushes and pops at bottom without locks; any thread steals
+ * from top with a single CAS. Follows the C11 formulation of Lê, Pop, Cohen
+ * and Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory
+ * Models" (PPoPP 2013). top is on its own cache line because thieves CAS it.
+ */
+struct WorkStealingDeque {
+    struct IArray super;                                /**< IArray interface implemented by this type. */
+    char pad0[CACHE_LINE_SIZE];                         /**< Keeps the owner line off the vtable. */
+    atomic_size_t bottom;                               /**< One past the newest element; written by the owner. */
+    _Atomic(struct WorkStealingBuffer *) buffer;        /**< Current ring; replaced by the owner on growth. */
+    char pad1[CACHE_LINE_SIZE - sizeof(atomic_size_t) - sizeof(void *)];
+    atomic_size_t top;                                  /**< Oldest element; advanced by CAS. */
+    char pad2[CACHE_LINE_SIZE - sizeof(atomic_size_t)];
+};
@@ -1,17 +1,29 @@
 /**
  * @file test_array.c
- * @brief Array unit tests.
+ * @brief Array unit tests, run against every IArray flavor with list semantics.
  *
  * @author Saad Shams https://linkedin.com/in/muizz
  * @copyright BSD 3-Clause License
  */
 #include "test_array.h"
 #include "collection/i_array.h"
+#include "collection/i_platform.h"
 
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef DWORD WINAPI ThreadResult;
+#define THREAD_RETURN 0
+#else
+typedef pthread_t Thread;
+typedef void *ThreadResult;
+#define THREAD_RETURN NULL
+#endif
+
 static void before_all(void) { }
 static void before_each(void) { }
 static void after_each(void) { }
@@ -29,28 +41,47 @@ static void test(const char *name, void (*callback)(void)) {
     fflush(stdout);
 }
 
+// Constructors of every IArray flavor that keeps full list semantics; each runs the whole suite.
+static const struct {
+    const char *name;
+    struct IArray *(*create)(void);
+} flavors[] = {
+    {"list", collection_array_new},
+    {"vector", collection_array_new_vector},
+    {"deque", collection_array_new_deque},
+};
+
+// Constructor of the flavor currently under test.
+static struct IArray *(*array_new)(void);
+
 int main(void) {
     printf("\n\033[1;36m================================================\033[0m\n");
     printf("\033[1;36m[SUITE] %s\033[0m\n", "ArrayTest");
     printf("\033[1;36m================================================\033[0m\n\n");
 
     before_all();
-    test("test_get", test_get);
-    test("test_put", test_put);
-    test("test_for_each", test_for_each);
-    test("test_find", test_find);
-    test("test_first_index", test_first_index);
-    test("test_last_index", test_last_index);
-    test("test_unshift", test_unshift);
-    test("test_push", test_push);
-    test("test_shift", test_shift);
-    test("test_pop", test_pop);
-    test("test_remove_item", test_remove_item);
-    test("test_contains_value", test_contains_value);
-    test("test_clone", test_clone);
-    test("test_count", test_count);
-    test("test_clear", test_clear);
-    test("test_dealloc", test_dealloc);
+    for (size_t i = 0; i < sizeof(flavors) / sizeof(flavors[0]); i++) {
+        printf("\033[1;36m[FLAVOR] %s\033[0m\n", flavors[i].name);
+        array_new = flavors[i].create;
+
+        test("test_get", test_get);
+        test("test_put", test_put);
+        test("test_for_each", test_for_each);
+        test("test_find", test_find);
+        test("test_first_index", test_first_index);
+        test("test_last_index", test_last_index);
+        test("test_unshift", test_unshift);
+        test("test_push", test_push);
+        test("test_shift", test_shift);
+        test("test_pop", test_pop);
+        test("test_remove_item", test_remove_item);
+        test("test_contains_value", test_contains_value);
+        test("test_clone", test_clone);
+        test("test_count", test_count);
+        test("test_clear", test_clear);
+        test("test_dealloc", test_dealloc);
+        test("test_concurrent_churn", test_concurrent_churn);
+    }
     after_all();
 
     printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
@@ -67,7 +98,7 @@ struct Value {
 
 // Verifies retrieving elements by index.
 void test_get(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     array->push(array, &(struct Test){"name0"});
@@ -85,7 +116,7 @@ void test_get(void) {
 
 // Verifies replacing elements by index.
 void test_put(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     array->push(array, &(struct Test){"name0"});
@@ -112,7 +143,7 @@ static void consumer(const void *element, const void *data) {
 
 // Verifies iterating over all elements.
 void test_for_each(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     const int multiplier = 2;
@@ -139,7 +170,7 @@ static bool predicate_find(const void *element, const void *data) {
 
 // Verifies finding elements using a predicate.
 void test_find(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     array->push(array, &(struct Value){1});
@@ -165,7 +196,7 @@ static bool predicate_first_index(const void *element, const void *data) {
 
 // Verifies locating the first matching element.
 void test_first_index(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     array->push(array, &(struct Value){1});
@@ -191,7 +222,7 @@ static bool predicte_last_index(const void *element, const void *data) {
 
 // Verifies locating the last matching element.
 void test_last_index(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     array->push(array, &(struct Value){1});
@@ -217,7 +248,7 @@ void test_last_index(void) {
 
 // Verifies inserting elements at the beginning.
 void test_unshift(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     const struct Test *test1 = &(struct Test) {"name1"};
@@ -233,7 +264,7 @@ void test_unshift(void) {
 
 // Verifies appending elements to the end.
 void test_push(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     const struct Test *test1 = &(struct Test) {"name1"};
@@ -253,7 +284,7 @@ void test_push(void) {
 
 // Verifies removing elements from the beginning.
 void test_shift(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     if (array->shift(array) != NULL) abort();
@@ -276,7 +307,7 @@ void test_shift(void) {
 
 // Verifies removing elements from the end.
 void test_pop(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     if (array->pop(array) != NULL) abort();
@@ -299,7 +330,7 @@ void test_pop(void) {
 
 // Verifies removing a specific element.
 void test_remove_item(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     if (array->remove_item(array, NULL) != NULL) abort();
@@ -323,7 +354,7 @@ void test_remove_item(void) {
 
 // Verifies checking for element existence.
 void test_contains_value(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     if (array->contains_value(array, NULL) != false) abort();
@@ -356,7 +387,7 @@ void test_contains_value(void) {
 
 // Verifies cloning an array.
 void test_clone(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     const struct Test *test1 = &(struct Test) {"name1"};
@@ -385,7 +416,7 @@ void test_clone(void) {
 
 // Verifies counting the number of elements.
 void test_count(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     const struct Test *test1 = &(struct Test) {"name1"};
@@ -415,7 +446,7 @@ void test_count(void) {
 
 // Verifies clearing all elements.
 void test_clear(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     array->clear(array, NULL);
@@ -439,7 +470,7 @@ void test_clear(void) {
 
 // Verifies destroying an array and releasing resources.
 void test_dealloc(void) {
-    struct IArray *array = collection_array_new();
+    struct IArray *array = array_new();
     if (array == NULL) abort();
 
     struct Test *test1 = malloc(sizeof(struct Test));
@@ -456,3 +487,55 @@ void test_dealloc(void) {
     // Pass free if stored items are heap allocated
     collection_array_dealloc(&array, free);
 }
+
+#define CHURN_THREADS 8
+#define CHURN_ITERATIONS 20000
+
+// Creates a platform thread.
+static void thread_create(Thread *thread, ThreadResult (*routine)(void *), void *arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+    if (*thread == NULL) abort();
+#else
+    if (pthread_create(thread, NULL, routine, arg) != 0) abort();
+#endif
+}
+
+// Waits for a platform thread to finish.
+static void thread_join(Thread thread) {
+#ifdef _WIN32
+    if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0) abort();
+    CloseHandle(thread);
+#else
+    if (pthread_join(thread, NULL) != 0) abort();
+#endif
+}
+
+// Pushes and shifts items so nodes are freed by threads other than the one that allocated them.
+static ThreadResult churn_thread(void *arg) {
+    struct IArray *array = arg;
+    for (uintptr_t i = 1; i <= CHURN_ITERATIONS; i++) {
+        if (array->push(array, (void *) i) != true) abort();
+        if (array->shift(array) == NULL) abort(); // Keeps the list short.
+    }
+    return THREAD_RETURN;
+}
+
+// Verifies concurrent node allocation and release across threads that exit.
+void test_concurrent_churn(void) {
+    struct IArray *array = array_new();
+    if (array == NULL) abort();
+
+    for (int round = 0; round < 2; round++) { // The second round reuses nodes flushed by exited threads.
+        Thread threads[CHURN_THREADS];
+        for (int i = 0; i < CHURN_THREADS; ++i)
+            thread_create(&threads[i], churn_thread, array);
+
+        for (int i = 0; i < CHURN_THREADS; ++i)
+            thread_join(threads[i]);
+    }
+
+    if (array->count(array) != 0) abort();
+
+    collection_array_dealloc(&array, NULL);
+}
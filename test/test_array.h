@@ -23,3 +23,4 @@ void test_clone(void);
 void test_count(void);
 void test_clear(void);
 void test_dealloc(void);
+void test_concurrent_churn(void);
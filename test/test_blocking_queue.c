@@ -0,0 +1,295 @@
+/**
+ * @file test_blocking_queue.c
+ * @brief Blocking queue unit tests.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_blocking_queue.h"
+#include "collection/i_array.h"
+#include "collection/i_platform.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __linux__
+#include <poll.h>
+#endif
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef DWORD WINAPI ThreadResult;
+#define THREAD_RETURN 0
+#else
+typedef pthread_t Thread;
+typedef void *ThreadResult;
+#define THREAD_RETURN NULL
+#endif
+
+#define ITEMS 20000
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "BlockingQueueTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_push_shift", test_push_shift);
+    test("test_array_operations", test_array_operations);
+    test("test_clone", test_clone);
+    test("test_timeout", test_timeout);
+    test("test_handoff", test_handoff);
+    test("test_eventfd", test_eventfd);
+    test("test_other_arrays", test_other_arrays);
+    test("test_dealloc", test_dealloc);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+// Creates a platform thread.
+static void thread_create(Thread *thread, ThreadResult (*routine)(void *), void *arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+    if (*thread == NULL) abort();
+#else
+    if (pthread_create(thread, NULL, routine, arg) != 0) abort();
+#endif
+}
+
+// Waits for a platform thread to finish.
+static void thread_join(Thread thread) {
+#ifdef _WIN32
+    if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0) abort();
+    CloseHandle(thread);
+#else
+    if (pthread_join(thread, NULL) != 0) abort();
+#endif
+}
+
+// Verifies FIFO order and that non-waiting operations respect the capacity.
+void test_push_shift(void) {
+    struct IArray *queue = collection_array_new_blocking(3);
+    if (queue == NULL) abort();
+
+    if (queue->shift(queue) != NULL) abort();
+    if (queue->pop(queue) != NULL) abort();
+
+    for (uintptr_t round = 0; round < 5; round++) { // Cycle through several laps of the ring.
+        for (uintptr_t i = 1; i <= 3; i++) {
+            if (queue->push(queue, (void *) i) != true) abort();
+        }
+        if (queue->push(queue, (void *) 4) != false) abort();
+        if (queue->unshift(queue, (void *) 4) != NULL) abort();
+        if (queue->count(queue) != 3) abort();
+        for (uintptr_t i = 1; i <= 3; i++) {
+            if (queue->shift(queue) != (void *) i) abort();
+        }
+    }
+
+    collection_array_dealloc(&queue, NULL);
+}
+
+// Matches the element equal to data.
+static bool equals(const void *element, const void *data) {
+    return element == data;
+}
+
+// Verifies indexed, search and removal operations on a wrapped ring.
+void test_array_operations(void) {
+    struct IArray *queue = collection_array_new_blocking(5);
+    if (queue == NULL) abort();
+
+    queue->push(queue, (void *) 9);
+    queue->push(queue, (void *) 9);
+    queue->shift(queue);
+    queue->shift(queue); // Head is now at slot 2, so the elements below wrap.
+
+    for (uintptr_t i = 2; i <= 4; i++) queue->push(queue, (void *) i);
+    if (queue->unshift(queue, (void *) 1) != (void *) 1) abort();
+    queue->push(queue, (void *) 2); // [1, 2, 3, 4, 2]
+
+    if (queue->get(queue, 0) != (void *) 1) abort();
+    if (queue->get(queue, 4) != (void *) 2) abort();
+    if (queue->get(queue, 5) != NULL) abort();
+    if (queue->put(queue, (void *) 5, 4) != (void *) 2) abort(); // [1, 2, 3, 4, 5]
+
+    if (queue->find(queue, equals, (void *) 3) != (void *) 3) abort();
+    if (queue->first_index(queue, equals, (void *) 4) != 3) abort();
+    if (queue->last_index(queue, equals, (void *) 1) != 0) abort();
+    if (queue->first_index(queue, equals, (void *) 7) != SIZE_MAX) abort();
+    if (queue->contains_value(queue, (void *) 5) != true) abort();
+
+    if (queue->remove_item(queue, (void *) 2) != (void *) 2) abort(); // [1, 3, 4, 5]
+    if (queue->remove_item(queue, (void *) 4) != (void *) 4) abort(); // [1, 3, 5]
+    if (queue->remove_item(queue, (void *) 7) != NULL) abort();
+    if (queue->pop(queue) != (void *) 5) abort();
+    if (queue->shift(queue) != (void *) 1) abort();
+    if (queue->shift(queue) != (void *) 3) abort();
+    if (queue->count(queue) != 0) abort();
+
+    collection_array_dealloc(&queue, NULL);
+}
+
+// Verifies that a clone has the same elements and capacity.
+void test_clone(void) {
+    struct IArray *queue = collection_array_new_blocking(2);
+    if (queue == NULL) abort();
+
+    queue->push(queue, (void *) 1);
+    queue->push(queue, (void *) 2);
+    queue->shift(queue);
+    queue->push(queue, (void *) 3); // Wrapped: [2, 3]
+
+    struct IArray *copy = queue->clone(queue);
+    if (copy == NULL) abort();
+    if (copy->count(copy) != 2) abort();
+    if (copy->push(copy, (void *) 4) != false) abort();
+    if (copy->shift(copy) != (void *) 2) abort();
+    if (copy->shift(copy) != (void *) 3) abort();
+
+    collection_array_dealloc(&copy, NULL);
+    collection_array_dealloc(&queue, NULL);
+}
+
+// Verifies that timed waits give up after roughly their timeout.
+void test_timeout(void) {
+    struct IArray *queue = collection_array_new_blocking(1);
+    if (queue == NULL) abort();
+
+    if (collection_array_blocking_shift_wait(queue, 0) != NULL) abort();
+
+    uint64_t start = clock_monotonic_ns();
+    if (collection_array_blocking_shift_wait(queue, 50) != NULL) abort();
+    if (clock_monotonic_ns() - start < 45000000u) abort();
+
+    if (collection_array_blocking_push_wait(queue, (void *) 1, 0) != true) abort();
+    if (collection_array_blocking_push_wait(queue, (void *) 2, 0) != false) abort();
+
+    start = clock_monotonic_ns();
+    if (collection_array_blocking_push_wait(queue, (void *) 2, 50) != false) abort();
+    if (clock_monotonic_ns() - start < 45000000u) abort();
+
+    if (collection_array_blocking_shift_wait(queue, 50) != (void *) 1) abort();
+
+    collection_array_dealloc(&queue, NULL);
+}
+
+// Pushes 1..ITEMS, blocking whenever the small queue is full.
+static ThreadResult producer_thread(void *arg) {
+    struct IArray *queue = arg;
+    for (uintptr_t i = 1; i <= ITEMS; i++) {
+        if (!collection_array_blocking_push_wait(queue, (void *) i, -1)) abort();
+    }
+    return THREAD_RETURN;
+}
+
+// Verifies ordered handoff between a blocked producer and a blocked consumer.
+void test_handoff(void) {
+    struct IArray *queue = collection_array_new_blocking(4);
+    if (queue == NULL) abort();
+
+    Thread thread;
+    thread_create(&thread, producer_thread, queue);
+
+    for (uintptr_t i = 1; i <= ITEMS; i++) {
+        if (collection_array_blocking_shift_wait(queue, -1) != (void *) i) abort();
+    }
+    thread_join(thread);
+    if (queue->count(queue) != 0) abort();
+
+    collection_array_dealloc(&queue, NULL);
+}
+
+#ifdef __linux__
+// Returns whether a descriptor is readable without blocking.
+static bool readable(const int fd) {
+    struct pollfd pfd = {fd, POLLIN, 0};
+    return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+}
+#endif
+
+// Verifies that the eventfd is readable exactly while the queue is non-empty.
+void test_eventfd(void) {
+    struct IArray *queue = collection_array_new_blocking(4);
+    if (queue == NULL) abort();
+
+    queue->push(queue, (void *) 1); // Created after an insert, so it must start readable.
+    const int fd = collection_array_blocking_eventfd(queue);
+#ifdef __linux__
+    if (fd < 0) abort();
+    if (collection_array_blocking_eventfd(queue) != fd) abort();
+    if (!readable(fd)) abort();
+
+    queue->push(queue, (void *) 2);
+    queue->pop(queue);
+    if (!readable(fd)) abort();
+    queue->shift(queue);
+    if (readable(fd)) abort();
+
+    if (collection_array_blocking_push_wait(queue, (void *) 3, 0) != true) abort();
+    if (!readable(fd)) abort();
+    queue->clear(queue, NULL);
+    if (readable(fd)) abort();
+
+    queue->unshift(queue, (void *) 4);
+    if (!readable(fd)) abort();
+    if (collection_array_blocking_shift_wait(queue, 0) != (void *) 4) abort();
+    if (readable(fd)) abort();
+#else
+    if (fd != -1) abort();
+#endif
+
+    collection_array_dealloc(&queue, NULL);
+}
+
+// Verifies that the blocking functions refuse arrays of other types.
+void test_other_arrays(void) {
+    struct IArray *array = collection_array_new_vector();
+    if (array == NULL) abort();
+
+    if (collection_array_blocking_push_wait(array, (void *) 1, 0) != false) abort();
+    if (array->count(array) != 0) abort();
+    if (array->push(array, (void *) 1) != true) abort();
+    if (collection_array_blocking_shift_wait(array, 0) != NULL) abort();
+    if (array->count(array) != 1) abort();
+    if (collection_array_blocking_eventfd(array) != -1) abort();
+
+    collection_array_dealloc(&array, NULL);
+}
+
+// Verifies destroying a queue and releasing remaining elements.
+void test_dealloc(void) {
+    struct IArray *queue = collection_array_new_blocking(4);
+    if (queue == NULL) abort();
+
+    for (int i = 0; i < 3; i++) {
+        int *value = malloc(sizeof(int));
+        if (value == NULL) abort();
+        *value = i;
+        if (queue->push(queue, value) != true) abort();
+    }
+
+    // Pass free if stored items are heap allocated
+    collection_array_dealloc(&queue, free);
+    if (queue != NULL) abort();
+}
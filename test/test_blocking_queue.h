@@ -0,0 +1,17 @@
+/**
+ * @file test_blocking_queue.h
+ * @brief Blocking Queue Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_push_shift(void);
+void test_array_operations(void);
+void test_clone(void);
+void test_timeout(void);
+void test_handoff(void);
+void test_eventfd(void);
+void test_other_arrays(void);
+void test_dealloc(void);
@@ -0,0 +1,364 @@
+/**
+ * @file test_cache.c
+ * @brief Cache unit tests.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_cache.h"
+#include "collection/i_cache.h"
+#include "collection/i_platform.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef DWORD WINAPI ThreadResult;
+#define THREAD_RETURN 0
+#else
+typedef pthread_t Thread;
+typedef void *ThreadResult;
+#define THREAD_RETURN NULL
+#endif
+
+#define THREADS 4
+#define KEYS 512
+#define ROUNDS 20000
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "CacheTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_get", test_get);
+    test("test_put", test_put);
+    test("test_remove_item", test_remove_item);
+    test("test_capacity_eviction", test_capacity_eviction);
+    test("test_byte_limit", test_byte_limit);
+    test("test_ttl", test_ttl);
+    test("test_clear", test_clear);
+    test("test_dealloc", test_dealloc);
+    test("test_concurrent_access", test_concurrent_access);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+struct Evictions {
+    size_t count;
+    char last_key[32];
+    void *last_value;
+};
+
+// Records the most recent eviction.
+static void record_eviction(const char *key, void *value, void *context) {
+    struct Evictions *evictions = context;
+    evictions->count++;
+    snprintf(evictions->last_key, sizeof(evictions->last_key), "%s", key);
+    evictions->last_value = value;
+}
+
+// Charges each value its own numeric value in bytes.
+static size_t value_size(const void *value) {
+    return (size_t) (uintptr_t) value;
+}
+
+// Waits until the monotonic clock has advanced past a deadline.
+static void wait_until(const uint64_t deadline) {
+    while (clock_monotonic_ns() <= deadline) {}
+}
+
+// Verifies retrieving values by key.
+void test_get(void) {
+    struct ICache *cache = collection_cache_new(NULL);
+    if (cache == NULL) abort();
+
+    if (cache->get(cache, "key1") != NULL) abort();
+    if (cache->put(cache, "key1", (void *) 1) != true) abort();
+    if (cache->get(cache, "key1") != (void *) 1) abort();
+    if (cache->get(cache, "key2") != NULL) abort();
+    if (cache->contains_key(cache, "key1") != true) abort();
+    if (cache->contains_key(cache, "key2") != false) abort();
+
+    collection_cache_dealloc(&cache, NULL);
+    if (cache != NULL) abort();
+}
+
+// Verifies that put inserts many keys and that updates report the replaced value.
+void test_put(void) {
+    struct Evictions evictions = {0};
+    const struct CollectionCacheOptions options = {.on_evict = record_eviction, .context = &evictions};
+    struct ICache *cache = collection_cache_new(&options);
+    if (cache == NULL) abort();
+
+    char key[32];
+    for (uintptr_t i = 0; i < 1000; i++) { // Enough to grow the index.
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+        if (cache->put(cache, key, (void *) (i + 1)) != true) abort();
+    }
+    if (cache->count(cache) != 1000 || evictions.count != 0) abort();
+
+    if (cache->put(cache, "key5", (void *) 60) != true) abort();
+    if (evictions.count != 1 || strcmp(evictions.last_key, "key5") != 0 || evictions.last_value != (void *) 6) abort();
+    if (cache->put(cache, "key5", (void *) 60) != true) abort(); // Storing the same value again is not a replacement.
+    if (evictions.count != 1) abort();
+
+    for (uintptr_t i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+        if (cache->get(cache, key) != (i == 5 ? (void *) 60 : (void *) (i + 1))) abort();
+    }
+
+    collection_cache_dealloc(&cache, NULL);
+}
+
+// Verifies that remove_item returns the value without reporting it as evicted.
+void test_remove_item(void) {
+    struct Evictions evictions = {0};
+    const struct CollectionCacheOptions options = {.on_evict = record_eviction, .context = &evictions};
+    struct ICache *cache = collection_cache_new(&options);
+    if (cache == NULL) abort();
+
+    cache->put(cache, "key1", (void *) 1);
+    cache->put(cache, "key2", (void *) 2);
+
+    if (cache->remove_item(cache, "key1") != (void *) 1) abort();
+    if (cache->remove_item(cache, "key1") != NULL) abort();
+    if (cache->contains_key(cache, "key1") || !cache->contains_key(cache, "key2")) abort();
+    if (cache->count(cache) != 1 || evictions.count != 0) abort();
+
+    collection_cache_dealloc(&cache, NULL);
+}
+
+// Verifies that a full cache evicts an unreferenced entry and spares recently read ones.
+void test_capacity_eviction(void) {
+    struct Evictions evictions = {0};
+    const struct CollectionCacheOptions options = {.capacity = 4, .on_evict = record_eviction, .context = &evictions};
+    struct ICache *cache = collection_cache_new(&options);
+    if (cache == NULL) abort();
+
+    cache->put(cache, "a", (void *) 1);
+    cache->put(cache, "b", (void *) 2);
+    cache->put(cache, "c", (void *) 3);
+    cache->put(cache, "d", (void *) 4);
+    if (cache->get(cache, "a") != (void *) 1 || cache->get(cache, "b") != (void *) 2) abort();
+
+    if (cache->put(cache, "e", (void *) 5) != true) abort();
+    if (cache->count(cache) != 4 || evictions.count != 1) abort();
+    if (strcmp(evictions.last_key, "c") != 0 || evictions.last_value != (void *) 3) abort();
+    if (!cache->contains_key(cache, "a") || !cache->contains_key(cache, "b")) abort();
+    if (!cache->contains_key(cache, "d") || !cache->contains_key(cache, "e")) abort();
+
+    char key[32];
+    for (uintptr_t i = 0; i < 100; i++) { // Churn never exceeds the limit or evicts the entry being inserted.
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+        if (cache->put(cache, key, (void *) (i + 10)) != true) abort();
+        if (cache->get(cache, key) != (void *) (i + 10)) abort();
+        if (cache->count(cache) > 4) abort();
+    }
+    if (evictions.count != 101) abort();
+
+    collection_cache_dealloc(&cache, NULL);
+}
+
+// Verifies eviction by total value size and rejection of values larger than the limit.
+void test_byte_limit(void) {
+    struct Evictions evictions = {0};
+    const struct CollectionCacheOptions options = {
+        .max_bytes = 100, .size_of = value_size, .on_evict = record_eviction, .context = &evictions
+    };
+    struct ICache *cache = collection_cache_new(&options);
+    if (cache == NULL) abort();
+
+    cache->put(cache, "first", (void *) 40);
+    cache->put(cache, "second", (void *) 40);
+    if (cache->bytes(cache) != 80) abort();
+
+    if (cache->put(cache, "third", (void *) 30) != true) abort();
+    if (cache->bytes(cache) != 70 || evictions.count != 1 || strcmp(evictions.last_key, "first") != 0) abort();
+
+    if (cache->put(cache, "second", (void *) 10) != true) abort(); // Shrinking an entry updates the total.
+    if (cache->bytes(cache) != 40) abort();
+
+    if (cache->put(cache, "huge", (void *) 101) != false) abort();
+    if (cache->contains_key(cache, "huge") || cache->bytes(cache) != 40) abort();
+
+    collection_cache_dealloc(&cache, NULL);
+}
+
+// Verifies per-entry and default time-to-live, lazy expiry, and purge_expired.
+void test_ttl(void) {
+    struct Evictions evictions = {0};
+    const struct CollectionCacheOptions options = {.ttl_ns = 1000, .on_evict = record_eviction, .context = &evictions};
+    struct ICache *cache = collection_cache_new(&options);
+    if (cache == NULL) abort();
+
+    const uint64_t start = clock_monotonic_ns();
+    cache->put(cache, "short", (void *) 1);
+    cache->put_with_ttl(cache, "forever", (void *) 2, 0);
+    cache->put_with_ttl(cache, "long", (void *) 3, 3600ULL * 1000000000ULL);
+    wait_until(start + 1000000); // 1 ms, well past the 1 us default.
+
+    if (cache->get(cache, "short") != NULL || cache->contains_key(cache, "short")) abort();
+    if (cache->get(cache, "forever") != (void *) 2 || cache->get(cache, "long") != (void *) 3) abort();
+    if (cache->count(cache) != 3) abort(); // Expired entries linger until reclaimed.
+
+    if (cache->purge_expired(cache) != 1) abort();
+    if (cache->count(cache) != 2 || evictions.count != 1 || evictions.last_value != (void *) 1) abort();
+
+    cache->put(cache, "again", (void *) 4);
+    wait_until(clock_monotonic_ns() + 1000000);
+    if (cache->remove_item(cache, "again") != NULL) abort(); // Expired: reported as evicted, not returned.
+    if (evictions.count != 2 || evictions.last_value != (void *) 4) abort();
+
+    collection_cache_dealloc(&cache, NULL);
+}
+
+// Verifies that clear releases every value through the destructor.
+void test_clear(void) {
+    struct ICache *cache = collection_cache_new(&(struct CollectionCacheOptions) {.capacity = 8});
+    if (cache == NULL) abort();
+
+    for (int i = 0; i < 8; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "key%d", i);
+        int *value = malloc(sizeof(int));
+        if (value == NULL) abort();
+        *value = i;
+        cache->put(cache, key, value);
+    }
+
+    cache->clear(cache, free);
+    if (cache->count(cache) != 0 || cache->bytes(cache) != 0) abort();
+    if (cache->contains_key(cache, "key1")) abort();
+
+    if (cache->put(cache, "key1", (void *) 1) != true) abort();
+    if (cache->get(cache, "key1") != (void *) 1) abort();
+
+    collection_cache_dealloc(&cache, NULL);
+}
+
+// Verifies that dealloc releases heap-allocated values.
+void test_dealloc(void) {
+    struct ICache *cache = collection_cache_new(NULL);
+    if (cache == NULL) abort();
+
+    for (int i = 0; i < 3; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "key%d", i);
+        int *value = malloc(sizeof(int));
+        if (value == NULL) abort();
+        *value = i;
+        cache->put(cache, key, value);
+    }
+
+    // Pass free if stored items are heap allocated
+    collection_cache_dealloc(&cache, free);
+}
+
+// Creates a platform thread.
+static void thread_create(Thread *thread, ThreadResult (*routine)(void *), void *arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+    if (*thread == NULL) abort();
+#else
+    if (pthread_create(thread, NULL, routine, arg) != 0) abort();
+#endif
+}
+
+// Waits for a platform thread to finish.
+static void thread_join(Thread thread) {
+#ifdef _WIN32
+    if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0) abort();
+    CloseHandle(thread);
+#else
+    if (pthread_join(thread, NULL) != 0) abort();
+#endif
+}
+
+// Returns a small pseudo-random number (xorshift).
+static uint32_t next_random(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+struct Worker {
+    struct ICache *cache;
+    uint32_t seed;
+};
+
+// Mixes hits with inserts and removals on a key range larger than the cache.
+static ThreadResult worker_thread(void *arg) {
+    struct Worker *worker = arg;
+    struct ICache *cache = worker->cache;
+    char key[32];
+
+    for (size_t i = 0; i < ROUNDS; i++) {
+        const uintptr_t k = next_random(&worker->seed) % KEYS;
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) k);
+
+        // Values always encode their key, so any non-NULL result must match it.
+        const void *value;
+        switch (next_random(&worker->seed) % 8) {
+            case 0: case 1:
+                if (cache->put(cache, key, (void *) (k + 1)) != true) abort();
+                break;
+            case 2:
+                value = cache->remove_item(cache, key);
+                if (value != NULL && value != (void *) (k + 1)) abort();
+                break;
+            default:
+                value = cache->get(cache, key);
+                if (value != NULL && value != (void *) (k + 1)) abort();
+                break;
+        }
+    }
+    return THREAD_RETURN;
+}
+
+// Verifies that concurrent readers and writers keep the cache within its limit and observe only stored values.
+void test_concurrent_access(void) {
+    struct ICache *cache = collection_cache_new(&(struct CollectionCacheOptions) {.capacity = KEYS / 4});
+    if (cache == NULL) abort();
+
+    Thread threads[THREADS];
+    struct Worker workers[THREADS];
+    for (uint32_t i = 0; i < THREADS; i++) {
+        workers[i] = (struct Worker) {cache, 0x9E3779B9u * (i + 1)};
+        thread_create(&threads[i], worker_thread, &workers[i]);
+    }
+    for (size_t i = 0; i < THREADS; i++) thread_join(threads[i]);
+
+    if (cache->count(cache) > KEYS / 4) abort();
+    char key[32];
+    for (uintptr_t k = 0; k < KEYS; k++) {
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) k);
+        const void *value = cache->get(cache, key);
+        if (value != NULL && value != (void *) (k + 1)) abort();
+    }
+
+    collection_cache_dealloc(&cache, NULL);
+}
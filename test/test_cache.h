@@ -0,0 +1,18 @@
+/**
+ * @file test_cache.h
+ * @brief Cache Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_get(void);
+void test_put(void);
+void test_remove_item(void);
+void test_capacity_eviction(void);
+void test_byte_limit(void);
+void test_ttl(void);
+void test_clear(void);
+void test_dealloc(void);
+void test_concurrent_access(void);
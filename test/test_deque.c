@@ -0,0 +1,98 @@
+/**
+ * @file test_deque.c
+ * @brief Deque-specific unit tests; the shared IArray behaviour is covered by test_array.c.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_deque.h"
+#include "collection/i_array.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "DequeTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_wrap_around", test_wrap_around);
+    test("test_remove_wrapped", test_remove_wrapped);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+// Verifies queue and stack usage across ring wrap-around and growth.
+void test_wrap_around(void) {
+    struct IArray *array = collection_array_new_deque();
+    if (array == NULL) abort();
+
+    uintptr_t next = 1, expected = 1;
+    for (int round = 0; round < 1000; round++) { // Head walks around the ring many times.
+        for (int i = 0; i < 7; i++) array->push(array, (void *) next++);
+        for (int i = 0; i < 5; i++) {
+            if (array->shift(array) != (void *) expected++) abort();
+        }
+    }
+    if (array->count(array) != 2000) abort();
+
+    for (size_t i = 0; i < 2000; i++) {
+        if (array->get(array, i) != (void *) (expected + i)) abort();
+    }
+
+    if (array->unshift(array, (void *) 0) != (void *) 0) abort();
+    if (array->get(array, 0) != (void *) 0) abort();
+    if (array->pop(array) != (void *) (next - 1)) abort();
+    if (array->count(array) != 2000) abort();
+
+    struct IArray *clone = array->clone(array);
+    if (clone == NULL) abort();
+    if (clone->count(clone) != 2000) abort();
+    if (clone->get(clone, 1) != (void *) expected) abort();
+
+    collection_array_dealloc(&clone, NULL);
+    collection_array_dealloc(&array, NULL);
+}
+
+// Verifies removing elements from both halves of a wrapped ring.
+void test_remove_wrapped(void) {
+    struct IArray *array = collection_array_new_deque();
+    if (array == NULL) abort();
+
+    for (uintptr_t i = 1; i <= 10; i++) array->push(array, (void *) i);
+    for (uintptr_t i = 1; i <= 10; i++) array->shift(array);
+    for (uintptr_t i = 1; i <= 10; i++) array->push(array, (void *) i); // Wraps past the end of the ring.
+
+    if (array->remove_item(array, (void *) 2) != (void *) 2) abort();
+    if (array->remove_item(array, (void *) 9) != (void *) 9) abort();
+    if (array->remove_item(array, (void *) 42) != NULL) abort();
+
+    const uintptr_t expected[] = {1, 3, 4, 5, 6, 7, 8, 10};
+    if (array->count(array) != 8) abort();
+    for (size_t i = 0; i < 8; i++) {
+        if (array->get(array, i) != (void *) expected[i]) abort();
+    }
+
+    collection_array_dealloc(&array, NULL);
+}
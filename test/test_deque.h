@@ -0,0 +1,11 @@
+/**
+ * @file test_deque.h
+ * @brief Deque Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_wrap_around(void);
+void test_remove_wrapped(void);
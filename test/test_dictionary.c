@@ -1,15 +1,34 @@
 /**
  * @file test_dictionary.c
- * @brief Dictionary unit tests.
+ * @brief Dictionary unit tests; the IDictionary behaviour tests run against every flavor.
  *
  * @author Saad Shams https://linkedin.com/in/muizz
  * @copyright BSD 3-Clause License
  */
 #include "test_dictionary.h"
 #include "collection/i_dictionary.h"
+#include "collection/i_intern_pool.h"
+#include "collection/i_platform.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef DWORD WINAPI ThreadResult;
+#define THREAD_RETURN 0
+#else
+typedef pthread_t Thread;
+typedef void *ThreadResult;
+#define THREAD_RETURN NULL
+#endif
+
+#define THREADS 4
+#define COUNTERS 16
+#define COUNTER_ROUNDS 8000
+#define BATCH 200
 
 static void before_all(void) { }
 static void before_each(void) { }
@@ -28,19 +47,65 @@ static void test(const char *name, void (*callback)(void)) {
     fflush(stdout);
 }
 
+// Creates a striped dictionary with enough stripes to spread the test keys.
+static struct IDictionary *new_striped(void) {
+    return collection_dictionary_new_striped(8);
+}
+
+// Constructors of every IDictionary flavor; each runs the shared behaviour tests.
+static const struct Flavor {
+    const char *name;
+    struct IDictionary *(*create)(void);
+    bool unique_keys; // put() on an existing key updates it instead of adding a duplicate.
+} flavors[] = {
+    {"chained", collection_dictionary_new, false},
+    {"swiss", collection_dictionary_new_swiss, true},
+    {"striped", new_striped, false},
+    {"lockfree", collection_dictionary_new_lockfree, true},
+};
+
+// Flavor currently under test.
+static const struct Flavor *flavor;
+
 int main(void) {
     printf("\n\033[1;36m================================================\033[0m\n");
     printf("\033[1;36m[SUITE] %s\033[0m\n", "DictionaryTest");
     printf("\033[1;36m================================================\033[0m\n\n");
 
     before_all();
-    test("test_get", test_get);
-    test("test_put", test_put);
-    test("test_contains_key", test_contains_key);
-    test("test_remove_item", test_remove_item);
-    test("test_replace", test_replace);
-    test("test_clear", test_clear);
-    test("test_dealloc", test_dealloc);
+    for (size_t i = 0; i < sizeof(flavors) / sizeof(flavors[0]); i++) {
+        printf("\033[1;36m[FLAVOR] %s\033[0m\n", flavors[i].name);
+        flavor = &flavors[i];
+
+        test("test_get", test_get);
+        test("test_put", test_put);
+        test("test_contains_key", test_contains_key);
+        test("test_remove_item", test_remove_item);
+        test("test_replace", test_replace);
+        test("test_clear", test_clear);
+        test("test_dealloc", test_dealloc);
+        test("test_key_lengths", test_key_lengths);
+        test("test_atomic_updates", test_atomic_updates);
+        test("test_concurrent_compute", test_concurrent_compute);
+        test("test_batch_operations", test_batch_operations);
+        test("test_hashed_keys", test_hashed_keys);
+    }
+
+    printf("\033[1;36m[FLAVOR] %s\033[0m\n", "chained only");
+    test("test_rehash", test_rehash);
+    test("test_new_with_capacity", test_new_with_capacity);
+    test("test_inline_key_boundary", test_inline_key_boundary);
+    test("test_borrowed_keys", test_borrowed_keys);
+    test("test_interned_keys", test_interned_keys);
+    test("test_put_if_absent", test_put_if_absent);
+    test("test_upsert", test_upsert);
+    test("test_get_or_insert_with", test_get_or_insert_with);
+    test("test_compute", test_compute);
+    test("test_get_many", test_get_many);
+    test("test_put_many", test_put_many);
+    test("test_remove_many", test_remove_many);
+    test("test_collection_key", test_collection_key);
+    test("test_shared_key_handle", test_shared_key_handle);
     after_all();
 
     printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
@@ -53,7 +118,7 @@ struct Test {
 
 // Verifies retrieving values by key.
 void test_get(void) {
-    struct IDictionary *dictionary = collection_dictionary_new();
+    struct IDictionary *dictionary = flavor->create();
     if (dictionary == NULL) abort();
 
     if (dictionary->get(dictionary, "key99") != NULL) abort();
@@ -76,11 +141,12 @@ void test_get(void) {
     if (test3->value != 3) abort();
 
     collection_dictionary_dealloc(&dictionary, NULL);
+    if (dictionary != NULL) abort();
 }
 
-// Verifies inserting key-value pairs.
+// Verifies inserting key-value pairs, and updating in place where keys are unique.
 void test_put(void) {
-    struct IDictionary *dictionary = collection_dictionary_new();
+    struct IDictionary *dictionary = flavor->create();
     if (dictionary == NULL) abort();
 
     const struct Test *test1 = &(struct Test) {1};
@@ -99,12 +165,19 @@ void test_put(void) {
     if (test2->value != 2) abort();
     if (test3->value != 3) abort();
 
+    if (flavor->unique_keys) {
+        if (dictionary->put(dictionary, "key1", test2) != true) abort(); // Updates in place
+        if (dictionary->get(dictionary, "key1") != test2) abort();
+        if (dictionary->remove_item(dictionary, "key1") != test2) abort();
+        if (dictionary->get(dictionary, "key1") != NULL) abort();
+    }
+
     collection_dictionary_dealloc(&dictionary, NULL);
 }
 
 // Verifies checking for key existence.
 void test_contains_key(void) {
-    struct IDictionary *dictionary = collection_dictionary_new();
+    struct IDictionary *dictionary = flavor->create();
     if (dictionary == NULL) abort();
 
     dictionary->put(dictionary, "key1", "test1");
@@ -121,7 +194,7 @@ void test_contains_key(void) {
 
 // Verifies removing a key-value pair.
 void test_remove_item(void) {
-    struct IDictionary *dictionary = collection_dictionary_new();
+    struct IDictionary *dictionary = flavor->create();
     if (dictionary == NULL) abort();
 
     const struct Test *test1 = &(struct Test) {1};
@@ -144,9 +217,9 @@ void test_remove_item(void) {
     collection_dictionary_dealloc(&dictionary, NULL);
 }
 
-// Verifies replacing an existing value.
+// Verifies replacing an existing value and ignoring a missing key.
 void test_replace(void) {
-    struct IDictionary *dictionary = collection_dictionary_new();
+    struct IDictionary *dictionary = flavor->create();
     if (dictionary == NULL) abort();
 
     const struct Test *test1 = &(struct Test) {1};
@@ -167,12 +240,15 @@ void test_replace(void) {
     if (dictionary->get(dictionary, "key3") != test4) abort();
     if (test4->value != 4) abort();
 
+    if (dictionary->replace(dictionary, "key99", test4) != NULL) abort();
+    if (dictionary->contains_key(dictionary, "key99") != false) abort();
+
     collection_dictionary_dealloc(&dictionary, NULL);
 }
 
-// Verifies clearing all key-value pairs.
+// Verifies clearing all key-value pairs and reusing the dictionary afterwards.
 void test_clear(void) {
-    struct IDictionary *dictionary = collection_dictionary_new();
+    struct IDictionary *dictionary = flavor->create();
     if (dictionary == NULL) abort();
 
     const struct Test *test1 = &(struct Test){1};
@@ -193,12 +269,15 @@ void test_clear(void) {
     if (dictionary->contains_key(dictionary, "key2") != false) abort();
     if (dictionary->contains_key(dictionary, "key3") != false) abort();
 
+    if (dictionary->put(dictionary, "key1", test1) != true) abort();
+    if (dictionary->get(dictionary, "key1") != test1) abort();
+
     collection_dictionary_dealloc(&dictionary, NULL);
 }
 
 // Verifies destroying a dictionary and releasing resources.
 void test_dealloc(void) {
-    struct IDictionary *dictionary = collection_dictionary_new();
+    struct IDictionary *dictionary = flavor->create();
     if (dictionary == NULL) abort();
 
     struct Test *test1 = malloc(sizeof(struct Test));
@@ -215,3 +294,560 @@ void test_dealloc(void) {
     // Pass free if stored items are heap allocated
     collection_dictionary_dealloc(&dictionary, free);
 }
+
+// Verifies keys of every length from empty to past the long-key loop, including keys that are prefixes of each other.
+void test_key_lengths(void) {
+    struct IDictionary *dictionary = flavor->create();
+    if (dictionary == NULL) abort();
+
+    char key[201];
+    for (uintptr_t length = 0; length <= 200; length++) { // "", "a", "ab", ... so every key prefixes the next.
+        for (size_t i = 0; i < length; i++) key[i] = (char) ('a' + i % 26);
+        key[length] = '\0';
+        if (dictionary->put(dictionary, key, (void *) (length + 1)) != true) abort();
+    }
+
+    for (uintptr_t length = 0; length <= 200; length++) {
+        for (size_t i = 0; i < length; i++) key[i] = (char) ('a' + i % 26);
+        key[length] = '\0';
+        if (dictionary->get(dictionary, key) != (void *) (length + 1)) abort();
+
+        if (length == 0) continue;
+        key[length - 1] = 'Z'; // Same length, last byte differs.
+        if (dictionary->contains_key(dictionary, key)) abort();
+    }
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+static size_t created; // Values returned by create_value.
+
+// Returns the context as the created value.
+static void *create_value(const char *key, void *context) {
+    (void) key;
+    created++;
+    return context;
+}
+
+// Adds one to the counter stored in *value.
+static bool increment(const char *key, void **value, void *context) {
+    (void) key;
+    (void) context;
+    *value = (void *) ((uintptr_t) *value + 1);
+    return true;
+}
+
+// Removes the key when its counter reaches the limit passed as context.
+static bool decrement_or_remove(const char *key, void **value, void *context) {
+    (void) key;
+    if ((uintptr_t) *value <= (uintptr_t) context) return false;
+    *value = (void *) ((uintptr_t) *value - 1);
+    return true;
+}
+
+// Verifies put_if_absent, upsert, get_or_insert_with and compute.
+void test_atomic_updates(void) {
+    struct IDictionary *dictionary = flavor->create();
+    if (dictionary == NULL) abort();
+
+    if (dictionary->put_if_absent(dictionary, "key1", (void *) 1) != true) abort();
+    if (dictionary->put_if_absent(dictionary, "key1", (void *) 2) != false) abort();
+    if (dictionary->upsert(dictionary, "key1", (void *) 3) != (void *) 1) abort();
+    if (dictionary->upsert(dictionary, "key2", (void *) 4) != NULL) abort();
+    if (dictionary->get(dictionary, "key1") != (void *) 3 || dictionary->get(dictionary, "key2") != (void *) 4) abort();
+
+    created = 0;
+    if (dictionary->get_or_insert_with(dictionary, "key3", create_value, (void *) 5) != (void *) 5) abort();
+    if (dictionary->get_or_insert_with(dictionary, "key3", create_value, (void *) 6) != (void *) 5) abort();
+    if (dictionary->get_or_insert_with(dictionary, "key4", create_value, NULL) != NULL) abort();
+    if (created != 2 || dictionary->contains_key(dictionary, "key4")) abort();
+
+    char key[32];
+    for (uintptr_t i = 0; i < 1000; i++) { // Enough inserts to grow the table in between.
+        snprintf(key, sizeof(key), "counter%lu", (unsigned long) (i % 100));
+        dictionary->compute(dictionary, key, increment, NULL);
+    }
+    for (uintptr_t i = 0; i < 100; i++) {
+        snprintf(key, sizeof(key), "counter%lu", (unsigned long) i);
+        if (dictionary->get(dictionary, key) != (void *) 10) abort();
+        if (dictionary->compute(dictionary, key, decrement_or_remove, (void *) 10) != NULL) abort();
+        if (dictionary->contains_key(dictionary, key)) abort();
+    }
+    if (dictionary->compute(dictionary, "missing", decrement_or_remove, (void *) 1) != NULL) abort();
+    if (dictionary->contains_key(dictionary, "missing")) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Creates a platform thread.
+static void thread_create(Thread *thread, ThreadResult (*routine)(void *), void *arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+    if (*thread == NULL) abort();
+#else
+    if (pthread_create(thread, NULL, routine, arg) != 0) abort();
+#endif
+}
+
+// Waits for a platform thread to finish.
+static void thread_join(Thread thread) {
+#ifdef _WIN32
+    if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0) abort();
+    CloseHandle(thread);
+#else
+    if (pthread_join(thread, NULL) != 0) abort();
+#endif
+}
+
+struct Counter {
+    struct IDictionary *dictionary;
+    unsigned long id;
+};
+
+// Increments a shared set of counters through compute.
+static ThreadResult counter_thread(void *arg) {
+    struct Counter *counter = arg;
+    char key[32];
+
+    for (unsigned long i = 0; i < COUNTER_ROUNDS; i++) {
+        snprintf(key, sizeof(key), "counter%lu", (i + counter->id) % COUNTERS);
+        if (counter->dictionary->compute(counter->dictionary, key, increment, NULL) == NULL) abort();
+    }
+    return THREAD_RETURN;
+}
+
+// Verifies that concurrent increments through compute are never lost.
+void test_concurrent_compute(void) {
+    struct IDictionary *dictionary = flavor->create();
+    if (dictionary == NULL) abort();
+
+    Thread threads[THREADS];
+    struct Counter counters[THREADS];
+    for (unsigned long i = 0; i < THREADS; i++) {
+        counters[i] = (struct Counter) {dictionary, i};
+        thread_create(&threads[i], counter_thread, &counters[i]);
+    }
+    for (size_t i = 0; i < THREADS; i++) thread_join(threads[i]);
+
+    char key[32];
+    for (unsigned long i = 0; i < COUNTERS; i++) {
+        snprintf(key, sizeof(key), "counter%lu", i);
+        if (dictionary->get(dictionary, key) != (void *) (uintptr_t) (THREADS * COUNTER_ROUNDS / COUNTERS)) abort();
+    }
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Fills a batch of distinct keys and their values.
+static void fill_batch(char storage[][16], const char **keys, const void **values) {
+    for (uintptr_t i = 0; i < BATCH; i++) {
+        snprintf(storage[i], 16, "key%lu", (unsigned long) i);
+        keys[i] = storage[i];
+        values[i] = (void *) (i + 1);
+    }
+}
+
+// Verifies get_many, put_many and remove_many on a batch larger than the inline key buffer.
+void test_batch_operations(void) {
+    struct IDictionary *dictionary = flavor->create();
+    if (dictionary == NULL) abort();
+
+    static char storage[BATCH][16];
+    const char *keys[BATCH];
+    const void *values[BATCH];
+    void *results[BATCH];
+    fill_batch(storage, keys, values);
+
+    if (dictionary->put_many(dictionary, keys, values, BATCH / 2) != BATCH / 2) abort();
+    if (dictionary->get_many(dictionary, keys, BATCH, results) != BATCH / 2) abort();
+    for (uintptr_t i = 0; i < BATCH; i++) {
+        if (results[i] != (i < BATCH / 2 ? (void *) (i + 1) : NULL)) abort();
+    }
+
+    if (dictionary->put_many(dictionary, keys + BATCH / 2, values + BATCH / 2, BATCH / 2) != BATCH / 2) abort();
+    if (dictionary->remove_many(dictionary, keys, BATCH / 4, NULL) != BATCH / 4) abort();
+    if (dictionary->remove_many(dictionary, keys, BATCH, results) != BATCH - BATCH / 4) abort();
+    for (uintptr_t i = 0; i < BATCH; i++) {
+        if (results[i] != (i < BATCH / 4 ? NULL : (void *) (i + 1))) abort();
+        if (dictionary->contains_key(dictionary, keys[i])) abort();
+    }
+
+    if (dictionary->get_many(dictionary, keys, 0, results) != 0) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies that get_hashed, put_hashed and contains_key_hashed agree with the string operations.
+void test_hashed_keys(void) {
+    struct IDictionary *dictionary = flavor->create();
+    if (dictionary == NULL) abort();
+
+    char key[32];
+    for (uintptr_t i = 0; i < 500; i++) {
+        snprintf(key, sizeof(key), "route%lu", (unsigned long) i);
+        const struct CollectionKey handle = collection_key(key);
+        if (i % 2 == 0) {
+            if (dictionary->put_hashed(dictionary, &handle, (void *) (i + 1)) != true) abort();
+        } else if (dictionary->put(dictionary, key, (void *) (i + 1)) != true) {
+            abort();
+        }
+    }
+
+    for (uintptr_t i = 0; i < 500; i++) {
+        snprintf(key, sizeof(key), "route%lu", (unsigned long) i);
+        const struct CollectionKey handle = collection_key(key);
+        if (dictionary->get_hashed(dictionary, &handle) != (void *) (i + 1)) abort();
+        if (dictionary->get(dictionary, key) != (void *) (i + 1)) abort();
+        if (!dictionary->contains_key_hashed(dictionary, &handle)) abort();
+    }
+
+    const struct CollectionKey route = collection_key("route7");
+    if (dictionary->remove_item(dictionary, "route7") != (void *) 8) abort();
+    if (dictionary->contains_key_hashed(dictionary, &route)) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies that entries stay reachable while the table grows and shrinks.
+void test_rehash(void) {
+    struct IDictionary *dictionary = collection_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    char key[32];
+    for (uintptr_t i = 1; i <= 10000; i++) {
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+        if (dictionary->put(dictionary, key, (void *) i) != true) abort();
+        if (dictionary->get(dictionary, "key1") != (void *) 1) abort(); // Readable mid-rehash
+    }
+
+    for (uintptr_t i = 1; i <= 10000; i++) {
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+        if (dictionary->get(dictionary, key) != (void *) i) abort();
+    }
+
+    for (uintptr_t i = 1; i <= 9990; i++) {
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+        if (dictionary->remove_item(dictionary, key) != (void *) i) abort();
+    }
+
+    for (uintptr_t i = 1; i <= 10000; i++) {
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+        if (dictionary->contains_key(dictionary, key) != (i > 9990)) abort();
+    }
+
+    if (dictionary->replace(dictionary, "key10000", (void *) 1) != (void *) 10000) abort();
+    if (dictionary->get(dictionary, "key10000") != (void *) 1) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies creating a pre-sized dictionary.
+void test_new_with_capacity(void) {
+    struct IDictionary *dictionary = collection_dictionary_new_with_capacity(100000);
+    if (dictionary == NULL) abort();
+
+    char key[32];
+    for (uintptr_t i = 1; i <= 1000; i++) {
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+        if (dictionary->put(dictionary, key, (void *) i) != true) abort();
+    }
+
+    for (uintptr_t i = 1; i <= 1000; i++) {
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+        if (dictionary->remove_item(dictionary, key) != (void *) i) abort();
+    }
+
+    if (dictionary->get(dictionary, "key1") != NULL) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies removing and reinserting keys on both sides of the inline key limit.
+void test_inline_key_boundary(void) {
+    struct IDictionary *dictionary = collection_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    const char *keys[] = {
+        "0123456789abcdefghijkl",       // 22 bytes
+        "0123456789abcdefghijklm",      // 23 bytes, the longest inline key
+        "0123456789abcdefghijklmn",     // 24 bytes
+        "0123456789abcdefghijklmno",    // 25 bytes
+    };
+
+    for (uintptr_t round = 0; round < 3; round++) {
+        for (uintptr_t i = 0; i < 4; i++) {
+            if (dictionary->put(dictionary, keys[i], (void *) (i + 1)) != true) abort();
+        }
+        for (uintptr_t i = 0; i < 4; i++) {
+            if (dictionary->get(dictionary, keys[i]) != (void *) (i + 1)) abort();
+            if (dictionary->remove_item(dictionary, keys[i]) != (void *) (i + 1)) abort();
+            if (dictionary->contains_key(dictionary, keys[i])) abort();
+        }
+    }
+
+    for (uintptr_t i = 0; i < 4; i++) {
+        if (dictionary->put(dictionary, keys[i], (void *) (i + 1)) != true) abort();
+    }
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies that a borrowing dictionary matches keys by content and does not copy them.
+void test_borrowed_keys(void) {
+    struct IDictionary *dictionary = collection_dictionary_new_borrowed();
+    if (dictionary == NULL) abort();
+
+    static const char *keys[] = {"alpha", "beta", "a key longer than the inline key limit"};
+    for (uintptr_t i = 0; i < 3; i++) {
+        if (dictionary->put(dictionary, keys[i], (void *) (i + 1)) != true) abort();
+    }
+
+    char copy[64];
+    for (uintptr_t i = 0; i < 3; i++) {
+        strcpy(copy, keys[i]); // Equal content at a different address.
+        if (dictionary->get(dictionary, copy) != (void *) (i + 1)) abort();
+        if (dictionary->get(dictionary, keys[i]) != (void *) (i + 1)) abort();
+    }
+
+    if (dictionary->remove_item(dictionary, "beta") != (void *) 2) abort();
+    if (dictionary->contains_key(dictionary, "beta")) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies that interned dictionaries share one copy of each key and accept any equal string.
+void test_interned_keys(void) {
+    struct IInternPool *pool = collection_intern_pool_new();
+    if (pool == NULL) abort();
+
+    struct IDictionary *first = collection_dictionary_new_interned(pool);
+    struct IDictionary *second = collection_dictionary_new_interned(pool);
+    if (first == NULL || second == NULL) abort();
+    if (collection_dictionary_new_interned(NULL) != NULL) abort();
+
+    char key[32];
+    for (uintptr_t i = 0; i < 100; i++) {
+        snprintf(key, sizeof(key), "session%lu", (unsigned long) i);
+        if (first->put(first, key, (void *) (i + 1)) != true) abort();
+        if (second->put(second, key, (void *) (i + 2)) != true) abort();
+    }
+    if (pool->count(pool) != 100) abort(); // Both dictionaries share the pool's copies.
+
+    for (uintptr_t i = 0; i < 100; i++) {
+        snprintf(key, sizeof(key), "session%lu", (unsigned long) i);
+        if (first->get(first, key) != (void *) (i + 1)) abort();
+        const char *interned = pool->lookup(pool, key);
+        if (interned == NULL || second->get(second, interned) != (void *) (i + 2)) abort();
+    }
+
+    if (first->remove_item(first, "session7") != (void *) 8) abort();
+    if (first->contains_key(first, "session7")) abort();
+    if (!second->contains_key(second, "session7")) abort();
+
+    // Conditional inserts intern only keys they actually store.
+    if (first->put_if_absent(first, "session8", (void *) 1) != false) abort();
+    if (first->get_or_insert_with(first, "visitor1", create_value, NULL) != NULL) abort();
+    if (first->compute(first, "visitor2", decrement_or_remove, (void *) 1) != NULL) abort();
+    if (pool->count(pool) != 100) abort();
+    if (first->upsert(first, "visitor3", (void *) 3) != NULL) abort();
+    if (first->compute(first, "visitor4", increment, NULL) != (void *) 1) abort();
+    if (pool->count(pool) != 102 || first->get(first, pool->lookup(pool, "visitor3")) != (void *) 3) abort();
+
+    collection_dictionary_dealloc(&first, NULL);
+    collection_dictionary_dealloc(&second, NULL);
+    collection_intern_pool_dealloc(&pool);
+}
+
+// Verifies that put_if_absent inserts only missing keys and leaves existing values untouched.
+void test_put_if_absent(void) {
+    struct IDictionary *dictionary = collection_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    if (dictionary->put_if_absent(dictionary, "key1", (void *) 1) != true) abort();
+    if (dictionary->put_if_absent(dictionary, "key1", (void *) 2) != false) abort();
+    if (dictionary->get(dictionary, "key1") != (void *) 1) abort();
+
+    char key[32];
+    for (uintptr_t i = 0; i < 1000; i++) { // Enough inserts to rehash in between.
+        snprintf(key, sizeof(key), "item%lu", (unsigned long) i);
+        if (dictionary->put_if_absent(dictionary, key, (void *) (i + 1)) != true) abort();
+        if (dictionary->put_if_absent(dictionary, key, NULL) != false) abort();
+    }
+    for (uintptr_t i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "item%lu", (unsigned long) i);
+        if (dictionary->get(dictionary, key) != (void *) (i + 1)) abort();
+    }
+    if (dictionary->remove_item(dictionary, "key1") != (void *) 1) abort();
+    if (dictionary->contains_key(dictionary, "key1")) abort(); // No duplicate node was left behind.
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies that upsert returns the previous value and never duplicates a key.
+void test_upsert(void) {
+    struct IDictionary *dictionary = collection_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    if (dictionary->upsert(dictionary, "key1", (void *) 1) != NULL) abort();
+    if (dictionary->upsert(dictionary, "key1", (void *) 2) != (void *) 1) abort();
+    if (dictionary->upsert(dictionary, "a key longer than the inline key limit", (void *) 3) != NULL) abort();
+    if (dictionary->get(dictionary, "key1") != (void *) 2) abort();
+
+    if (dictionary->remove_item(dictionary, "key1") != (void *) 2) abort();
+    if (dictionary->contains_key(dictionary, "key1")) abort();
+    if (dictionary->get(dictionary, "a key longer than the inline key limit") != (void *) 3) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies that get_or_insert_with calls the factory once per missing key and inserts nothing when it returns NULL.
+void test_get_or_insert_with(void) {
+    struct IDictionary *dictionary = collection_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    created = 0;
+    if (dictionary->get_or_insert_with(dictionary, "key1", create_value, (void *) 1) != (void *) 1) abort();
+    if (dictionary->get_or_insert_with(dictionary, "key1", create_value, (void *) 2) != (void *) 1) abort();
+    if (created != 1) abort();
+
+    if (dictionary->get_or_insert_with(dictionary, "key2", create_value, NULL) != NULL) abort();
+    if (dictionary->contains_key(dictionary, "key2")) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies that compute inserts, updates and removes keys, including in interned mode.
+void test_compute(void) {
+    struct IInternPool *pool = collection_intern_pool_new();
+    if (pool == NULL) abort();
+
+    struct IDictionary *dictionaries[] = {collection_dictionary_new(), collection_dictionary_new_interned(pool)};
+    for (size_t d = 0; d < 2; d++) {
+        struct IDictionary *dictionary = dictionaries[d];
+        if (dictionary == NULL) abort();
+
+        for (uintptr_t i = 1; i <= 3; i++) {
+            if (dictionary->compute(dictionary, "counter", increment, NULL) != (void *) i) abort();
+        }
+        if (dictionary->compute(dictionary, "counter", decrement_or_remove, (void *) 1) != (void *) 2) abort();
+        if (dictionary->compute(dictionary, "counter", decrement_or_remove, (void *) 1) != (void *) 1) abort();
+        if (dictionary->compute(dictionary, "counter", decrement_or_remove, (void *) 1) != NULL) abort();
+        if (dictionary->contains_key(dictionary, "counter")) abort();
+
+        if (dictionary->compute(dictionary, "missing", decrement_or_remove, (void *) 1) != NULL) abort();
+        if (dictionary->contains_key(dictionary, "missing")) abort();
+
+        collection_dictionary_dealloc(&dictionaries[d], NULL);
+    }
+
+    collection_intern_pool_dealloc(&pool);
+}
+
+// Verifies that get_many reports each key's value in the caller's order, including across a rehash.
+void test_get_many(void) {
+    struct IDictionary *dictionary = collection_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    static char storage[BATCH][16];
+    const char *keys[BATCH];
+    const void *values[BATCH];
+    void *results[BATCH];
+    fill_batch(storage, keys, values);
+
+    for (uintptr_t i = 0; i < BATCH; i += 2) {
+        if (dictionary->put(dictionary, keys[i], values[i]) != true) abort();
+    }
+
+    if (dictionary->get_many(dictionary, keys, BATCH, results) != BATCH / 2) abort(); // Past the inline buffer.
+    for (uintptr_t i = 0; i < BATCH; i++) {
+        if (results[i] != (i % 2 == 0 ? values[i] : NULL)) abort();
+    }
+    if (dictionary->get_many(dictionary, keys + 1, 3, results) != 1) abort();
+    if (results[0] != NULL || results[1] != values[2] || results[2] != NULL) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies that put_many stores every pair, also into an interned dictionary.
+void test_put_many(void) {
+    struct IInternPool *pool = collection_intern_pool_new();
+    if (pool == NULL) abort();
+
+    static char storage[BATCH][16];
+    const char *keys[BATCH];
+    const void *values[BATCH];
+    fill_batch(storage, keys, values);
+
+    struct IDictionary *dictionaries[] = {collection_dictionary_new(), collection_dictionary_new_interned(pool)};
+    for (size_t d = 0; d < 2; d++) {
+        struct IDictionary *dictionary = dictionaries[d];
+        if (dictionary == NULL) abort();
+
+        if (dictionary->put_many(dictionary, keys, values, 10) != 10) abort();
+        if (dictionary->put_many(dictionary, keys + 10, values + 10, BATCH - 10) != BATCH - 10) abort();
+        for (uintptr_t i = 0; i < BATCH; i++) {
+            if (dictionary->get(dictionary, keys[i]) != values[i]) abort();
+        }
+
+        collection_dictionary_dealloc(&dictionaries[d], NULL);
+    }
+    if (pool->count(pool) != BATCH) abort();
+
+    collection_intern_pool_dealloc(&pool);
+}
+
+// Verifies that remove_many removes present keys, reports their values, and skips absent ones.
+void test_remove_many(void) {
+    struct IDictionary *dictionary = collection_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    static char storage[BATCH][16];
+    const char *keys[BATCH];
+    const void *values[BATCH];
+    void *results[BATCH];
+    fill_batch(storage, keys, values);
+
+    if (dictionary->put_many(dictionary, keys, values, BATCH) != BATCH) abort();
+    if (dictionary->remove_many(dictionary, keys, BATCH / 2, NULL) != BATCH / 2) abort();
+    if (dictionary->remove_many(dictionary, keys, BATCH, results) != BATCH / 2) abort(); // Shrinks while removing.
+    for (uintptr_t i = 0; i < BATCH; i++) {
+        if (results[i] != (i < BATCH / 2 ? NULL : values[i])) abort();
+        if (dictionary->contains_key(dictionary, keys[i])) abort();
+    }
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies that a key handle carries the key's length and its process-wide hash.
+void test_collection_key(void) {
+    char copy[] = "tenant-42";
+    const struct CollectionKey key = collection_key("tenant-42");
+    if (strcmp(key.key, "tenant-42") != 0 || key.length != 9) abort();
+    if (key.hash != collection_hash("tenant-42", 9) || key.hash != collection_key(copy).hash) abort();
+    if (collection_hash("tenant-42", 8) == key.hash) abort();
+    if (collection_hash(NULL, 0) != collection_hash("", 0)) abort();
+}
+
+// Verifies that one cached handle resolves the same entry as its string in several dictionaries.
+void test_shared_key_handle(void) {
+    struct IDictionary *first = collection_dictionary_new();
+    struct IDictionary *second = collection_dictionary_new_with_capacity(1024);
+    if (first == NULL || second == NULL) abort();
+
+    const struct CollectionKey route = collection_key("/api/v1/orders");
+    if (first->put_hashed(first, &route, (void *) 1) != true) abort();
+    if (second->put(second, "/api/v1/orders", (void *) 2) != true) abort();
+
+    if (first->get(first, "/api/v1/orders") != (void *) 1) abort();
+    if (first->get_hashed(first, &route) != (void *) 1) abort();
+    if (second->get_hashed(second, &route) != (void *) 2) abort();
+    if (!second->contains_key_hashed(second, &route)) abort();
+
+    const struct CollectionKey missing = collection_key("/api/v1/users");
+    if (first->get_hashed(first, &missing) != NULL || first->contains_key_hashed(first, &missing)) abort();
+
+    if (second->remove_item(second, "/api/v1/orders") != (void *) 2) abort();
+    if (second->contains_key_hashed(second, &route)) abort();
+
+    collection_dictionary_dealloc(&first, NULL);
+    collection_dictionary_dealloc(&second, NULL);
+}
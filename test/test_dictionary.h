@@ -13,4 +13,23 @@ void test_contains_key(void);
 void test_remove_item(void);
 void test_replace(void);
 void test_clear(void);
-void test_dealloc(void);
\ No newline at end of file
+void test_dealloc(void);
+void test_key_lengths(void);
+void test_atomic_updates(void);
+void test_concurrent_compute(void);
+void test_batch_operations(void);
+void test_hashed_keys(void);
+void test_rehash(void);
+void test_new_with_capacity(void);
+void test_inline_key_boundary(void);
+void test_borrowed_keys(void);
+void test_interned_keys(void);
+void test_put_if_absent(void);
+void test_upsert(void);
+void test_get_or_insert_with(void);
+void test_compute(void);
+void test_get_many(void);
+void test_put_many(void);
+void test_remove_many(void);
+void test_collection_key(void);
+void test_shared_key_handle(void);
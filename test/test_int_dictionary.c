@@ -0,0 +1,284 @@
+/**
+ * @file test_int_dictionary.c
+ * @brief Integer-keyed dictionary unit tests.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_int_dictionary.h"
+#include "collection/i_int_dictionary.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHURN_KEYS 4096
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "IntDictionaryTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_get", test_get);
+    test("test_put", test_put);
+    test("test_contains_key", test_contains_key);
+    test("test_remove_item", test_remove_item);
+    test("test_replace", test_replace);
+    test("test_clear", test_clear);
+    test("test_dealloc", test_dealloc);
+    test("test_zero_key", test_zero_key);
+    test("test_pointer_keys", test_pointer_keys);
+    test("test_growth", test_growth);
+    test("test_churn", test_churn);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+struct Test {
+    int value;
+};
+
+// Verifies retrieving values by key.
+void test_get(void) {
+    struct IIntDictionary *dictionary = collection_int_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    if (dictionary->get(dictionary, 99) != NULL) abort();
+
+    const struct Test *test1 = &(struct Test) {1};
+    const struct Test *test2 = &(struct Test) {2};
+
+    if (dictionary->put(dictionary, 1, test1) != true) abort();
+    if (dictionary->put(dictionary, 2, test2) != true) abort();
+
+    if (dictionary->get(dictionary, 1) != test1) abort();
+    if (dictionary->get(dictionary, 2) != test2) abort();
+    if (dictionary->get(dictionary, 99) != NULL) abort();
+
+    collection_int_dictionary_dealloc(&dictionary, NULL);
+    if (dictionary != NULL) abort();
+}
+
+// Verifies inserting and updating key-value pairs.
+void test_put(void) {
+    struct IIntDictionary *dictionary = collection_int_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    const struct Test *test1 = &(struct Test) {1};
+    const struct Test *test2 = &(struct Test) {2};
+
+    if (dictionary->put(dictionary, UINT64_MAX, test1) != true) abort();
+    if (dictionary->put(dictionary, UINT64_MAX, test2) != true) abort(); // Updates in place
+    if (dictionary->get(dictionary, UINT64_MAX) != test2) abort();
+
+    if (dictionary->remove_item(dictionary, UINT64_MAX) != test2) abort();
+    if (dictionary->get(dictionary, UINT64_MAX) != NULL) abort();
+
+    collection_int_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies checking for key existence.
+void test_contains_key(void) {
+    struct IIntDictionary *dictionary = collection_int_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    dictionary->put(dictionary, 1, "test1");
+    dictionary->put(dictionary, 2, NULL); // A NULL value still marks the key present.
+
+    if (dictionary->contains_key(dictionary, 1) != true) abort();
+    if (dictionary->contains_key(dictionary, 2) != true) abort();
+    if (dictionary->contains_key(dictionary, 3) != false) abort();
+
+    collection_int_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies removing a key-value pair.
+void test_remove_item(void) {
+    struct IIntDictionary *dictionary = collection_int_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    const struct Test *test1 = &(struct Test) {1};
+    const struct Test *test2 = &(struct Test) {2};
+    const struct Test *test3 = &(struct Test) {3};
+
+    if (dictionary->put(dictionary, 1, test1) != true) abort();
+    if (dictionary->put(dictionary, 2, test2) != true) abort();
+    if (dictionary->put(dictionary, 3, test3) != true) abort();
+
+    if (dictionary->remove_item(dictionary, 2) != test2) abort();
+    if (dictionary->remove_item(dictionary, 1) != test1) abort();
+    if (dictionary->remove_item(dictionary, 3) != test3) abort();
+    if (dictionary->remove_item(dictionary, 99) != NULL) abort();
+
+    collection_int_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies replacing an existing value.
+void test_replace(void) {
+    struct IIntDictionary *dictionary = collection_int_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    const struct Test *test1 = &(struct Test) {1};
+    const struct Test *test2 = &(struct Test) {2};
+
+    if (dictionary->put(dictionary, 1, test1) != true) abort();
+    if (dictionary->replace(dictionary, 1, test2) != test1) abort();
+    if (dictionary->get(dictionary, 1) != test2) abort();
+    if (dictionary->replace(dictionary, 99, test2) != NULL) abort();
+    if (dictionary->contains_key(dictionary, 99) != false) abort();
+
+    collection_int_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies clearing all key-value pairs.
+void test_clear(void) {
+    struct IIntDictionary *dictionary = collection_int_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    dictionary->put(dictionary, 0, "test0");
+    dictionary->put(dictionary, 1, "test1");
+    dictionary->put(dictionary, 2, "test2");
+
+    if (dictionary->clear(dictionary, NULL) != true) abort();
+
+    if (dictionary->get(dictionary, 1) != NULL) abort();
+    if (dictionary->contains_key(dictionary, 2) != false) abort();
+    if (dictionary->contains_key(dictionary, 0) != false) abort();
+
+    if (dictionary->put(dictionary, 1, "test1") != true) abort();
+    if (dictionary->get(dictionary, 1) == NULL) abort();
+
+    collection_int_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies destroying a dictionary and releasing resources.
+void test_dealloc(void) {
+    struct IIntDictionary *dictionary = collection_int_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    struct Test *test1 = malloc(sizeof(struct Test));
+    test1->value = 1;
+    struct Test *test2 = malloc(sizeof(struct Test));
+    test2->value = 2;
+
+    if (dictionary->put(dictionary, 0, test1) != true) abort();
+    if (dictionary->put(dictionary, 2, test2) != true) abort();
+
+    // Pass free if stored items are heap allocated
+    collection_int_dictionary_dealloc(&dictionary, free);
+}
+
+// Verifies that key 0, which marks empty slots internally, behaves like any other key.
+void test_zero_key(void) {
+    struct IIntDictionary *dictionary = collection_int_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    if (dictionary->contains_key(dictionary, 0)) abort();
+    if (dictionary->replace(dictionary, 0, "x") != NULL) abort();
+    if (dictionary->contains_key(dictionary, 0)) abort();
+
+    if (dictionary->put(dictionary, 0, "zero") != true) abort();
+    if (dictionary->get(dictionary, 0) == NULL) abort();
+    if (dictionary->get(dictionary, 1) != NULL) abort();
+    if (dictionary->replace(dictionary, 0, "other") == NULL) abort();
+    if (dictionary->remove_item(dictionary, 0) == NULL) abort();
+    if (dictionary->contains_key(dictionary, 0)) abort();
+
+    collection_int_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies using object addresses as keys.
+void test_pointer_keys(void) {
+    struct IIntDictionary *dictionary = collection_int_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    struct Test objects[64];
+    for (uintptr_t i = 0; i < 64; i++) {
+        if (dictionary->put(dictionary, collection_pointer_key(&objects[i]), (void *) (i + 1)) != true) abort();
+    }
+    for (uintptr_t i = 0; i < 64; i++) {
+        if (dictionary->get(dictionary, collection_pointer_key(&objects[i])) != (void *) (i + 1)) abort();
+    }
+    if (dictionary->contains_key(dictionary, collection_pointer_key(&objects[64]))) abort(); // One past the end.
+
+    collection_int_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies that entries survive repeated table growth, including pre-sized tables.
+void test_growth(void) {
+    struct IIntDictionary *dictionaries[] = {
+        collection_int_dictionary_new(),
+        collection_int_dictionary_new_with_capacity(100000),
+    };
+
+    for (size_t d = 0; d < 2; d++) {
+        struct IIntDictionary *dictionary = dictionaries[d];
+        if (dictionary == NULL) abort();
+
+        for (uint64_t i = 1; i <= 100000; i++) {
+            if (dictionary->put(dictionary, i * 4096, (void *) (uintptr_t) i) != true) abort(); // Aligned, pointer-like keys.
+        }
+        for (uint64_t i = 1; i <= 100000; i++) {
+            if (dictionary->get(dictionary, i * 4096) != (void *) (uintptr_t) i) abort();
+        }
+        if (dictionary->get(dictionary, 4097) != NULL) abort();
+
+        collection_int_dictionary_dealloc(&dictionary, NULL);
+    }
+}
+
+// Returns the next value of a xorshift generator.
+static uint64_t next_random(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Verifies random inserts and removals against a reference array, exercising backward-shift deletion.
+void test_churn(void) {
+    struct IIntDictionary *dictionary = collection_int_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    static uintptr_t expected[CHURN_KEYS];
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+
+    for (size_t round = 0; round < 200000; round++) {
+        const uint64_t random = next_random(&state);
+        const uint64_t key = random % CHURN_KEYS;
+        if (random >> 63) {
+            if (dictionary->put(dictionary, key, (void *) (uintptr_t) (round + 1)) != true) abort();
+            expected[key] = round + 1;
+        } else {
+            if (dictionary->remove_item(dictionary, key) != (void *) expected[key]) abort();
+            expected[key] = 0;
+        }
+    }
+
+    for (uint64_t key = 0; key < CHURN_KEYS; key++) {
+        if (dictionary->get(dictionary, key) != (void *) expected[key]) abort();
+        if (dictionary->contains_key(dictionary, key) != (expected[key] != 0)) abort();
+    }
+
+    collection_int_dictionary_dealloc(&dictionary, NULL);
+}
@@ -0,0 +1,20 @@
+/**
+ * @file test_int_dictionary.h
+ * @brief Integer-Keyed Dictionary Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_get(void);
+void test_put(void);
+void test_contains_key(void);
+void test_remove_item(void);
+void test_replace(void);
+void test_clear(void);
+void test_dealloc(void);
+void test_zero_key(void);
+void test_pointer_keys(void);
+void test_growth(void);
+void test_churn(void);
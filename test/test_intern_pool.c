@@ -0,0 +1,196 @@
+/**
+ * @file test_intern_pool.c
+ * @brief Intern pool unit tests.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_intern_pool.h"
+#include "collection/i_intern_pool.h"
+#include "collection/i_platform.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef DWORD WINAPI ThreadResult;
+#define THREAD_RETURN 0
+#else
+typedef pthread_t Thread;
+typedef void *ThreadResult;
+#define THREAD_RETURN NULL
+#endif
+
+#define THREADS 4
+#define STRINGS 2000
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "InternPoolTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_intern", test_intern);
+    test("test_lookup", test_lookup);
+    test("test_growth", test_growth);
+    test("test_dealloc", test_dealloc);
+    test("test_concurrent_intern", test_concurrent_intern);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+// Verifies that equal strings intern to one pointer holding a private copy.
+void test_intern(void) {
+    struct IInternPool *pool = collection_intern_pool_new();
+    if (pool == NULL) abort();
+
+    char buffer[16] = "session";
+    const char *first = pool->intern(pool, buffer);
+    if (first == NULL || first == buffer || strcmp(first, "session") != 0) abort();
+
+    strcpy(buffer, "changed"); // The pool must not depend on the caller's storage.
+    if (strcmp(first, "session") != 0) abort();
+
+    if (pool->intern(pool, "session") != first) abort();
+    if (pool->intern(pool, "other") == first) abort();
+    if (pool->intern(pool, "") == NULL) abort();
+    if (pool->count(pool) != 3) abort();
+
+    collection_intern_pool_dealloc(&pool);
+}
+
+// Verifies that lookups return interned strings without adding missing ones.
+void test_lookup(void) {
+    struct IInternPool *pool = collection_intern_pool_new();
+    if (pool == NULL) abort();
+
+    if (pool->lookup(pool, "key") != NULL) abort();
+    if (pool->count(pool) != 0) abort();
+
+    const char *key = pool->intern(pool, "key");
+    if (pool->lookup(pool, "key") != key) abort();
+    if (pool->lookup(pool, "ke") != NULL) abort();
+    if (pool->count(pool) != 1) abort();
+
+    collection_intern_pool_dealloc(&pool);
+}
+
+// Verifies that interned pointers stay stable while the table grows.
+void test_growth(void) {
+    struct IInternPool *pool = collection_intern_pool_new();
+    if (pool == NULL) abort();
+
+    static const char *interned[STRINGS];
+    char string[32];
+    for (size_t i = 0; i < STRINGS; i++) {
+        snprintf(string, sizeof(string), "string%lu", (unsigned long) i);
+        interned[i] = pool->intern(pool, string);
+        if (interned[i] == NULL) abort();
+    }
+
+    for (size_t i = 0; i < STRINGS; i++) {
+        snprintf(string, sizeof(string), "string%lu", (unsigned long) i);
+        if (pool->intern(pool, string) != interned[i]) abort();
+    }
+    if (pool->count(pool) != STRINGS) abort();
+
+    collection_intern_pool_dealloc(&pool);
+}
+
+// Verifies deallocation resets the caller's pointer.
+void test_dealloc(void) {
+    struct IInternPool *pool = collection_intern_pool_new();
+    if (pool == NULL) abort();
+
+    pool->intern(pool, "key");
+    collection_intern_pool_dealloc(&pool);
+    if (pool != NULL) abort();
+
+    collection_intern_pool_dealloc(&pool); // No-op on NULL
+}
+
+// Creates a platform thread.
+static void thread_create(Thread *thread, ThreadResult (*routine)(void *), void *arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+    if (*thread == NULL) abort();
+#else
+    if (pthread_create(thread, NULL, routine, arg) != 0) abort();
+#endif
+}
+
+// Waits for a platform thread to finish.
+static void thread_join(Thread thread) {
+#ifdef _WIN32
+    if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0) abort();
+    CloseHandle(thread);
+#else
+    if (pthread_join(thread, NULL) != 0) abort();
+#endif
+}
+
+struct Worker {
+    struct IInternPool *pool;
+    const char **interned;
+    size_t offset;
+};
+
+// Interns the same strings as every other worker, in a different order.
+static ThreadResult worker_thread(void *arg) {
+    struct Worker *worker = arg;
+    char string[32];
+
+    for (size_t n = 0; n < STRINGS; n++) {
+        const size_t i = (n + worker->offset) % STRINGS;
+        snprintf(string, sizeof(string), "string%lu", (unsigned long) i);
+        worker->interned[i] = worker->pool->intern(worker->pool, string);
+    }
+    return THREAD_RETURN;
+}
+
+// Verifies that threads racing to intern the same strings all receive the same pointers.
+void test_concurrent_intern(void) {
+    struct IInternPool *pool = collection_intern_pool_new();
+    if (pool == NULL) abort();
+
+    static const char *interned[THREADS][STRINGS];
+    Thread threads[THREADS];
+    struct Worker workers[THREADS];
+    for (size_t i = 0; i < THREADS; i++) {
+        workers[i] = (struct Worker) {pool, interned[i], i * STRINGS / THREADS};
+        thread_create(&threads[i], worker_thread, &workers[i]);
+    }
+    for (size_t i = 0; i < THREADS; i++) thread_join(threads[i]);
+
+    for (size_t i = 0; i < STRINGS; i++) {
+        if (interned[0][i] == NULL) abort();
+        for (size_t t = 1; t < THREADS; t++) {
+            if (interned[t][i] != interned[0][i]) abort();
+        }
+    }
+    if (pool->count(pool) != STRINGS) abort();
+
+    collection_intern_pool_dealloc(&pool);
+}
@@ -0,0 +1,14 @@
+/**
+ * @file test_intern_pool.h
+ * @brief Intern Pool Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_intern(void);
+void test_lookup(void);
+void test_growth(void);
+void test_dealloc(void);
+void test_concurrent_intern(void);
@@ -0,0 +1,339 @@
+/**
+ * @file test_key_dictionary.c
+ * @brief Generic-key dictionary unit tests.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_key_dictionary.h"
+#include "collection/i_key_dictionary.h"
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "KeyDictionaryTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_get", test_get);
+    test("test_contains_key", test_contains_key);
+    test("test_remove_item", test_remove_item);
+    test("test_replace", test_replace);
+    test("test_clear", test_clear);
+    test("test_dealloc", test_dealloc);
+    test("test_embedded_nul", test_embedded_nul);
+    test("test_struct_keys", test_struct_keys);
+    test("test_growth", test_growth);
+    test("test_custom_ops", test_custom_ops);
+    test("test_copy_callbacks", test_copy_callbacks);
+    test("test_borrowed_prefix", test_borrowed_prefix);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+struct Test {
+    int value;
+};
+
+static const unsigned char uuid1[16] = {0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3, 0xa4, 0x56, 0x42, 0x66, 0x14, 0x17, 0x40, 0x00};
+static const unsigned char uuid2[16] = {0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3, 0xa4, 0x56, 0x42, 0x66, 0x14, 0x17, 0x40, 0x01};
+
+// Verifies retrieving values by binary key.
+void test_get(void) {
+    struct IKeyDictionary *dictionary = collection_key_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    const struct Test *test1 = &(struct Test) {1};
+    const struct Test *test2 = &(struct Test) {2};
+
+    if (dictionary->get(dictionary, uuid1, sizeof(uuid1)) != NULL) abort();
+    if (dictionary->put(dictionary, uuid1, sizeof(uuid1), test1) != true) abort();
+    if (dictionary->put(dictionary, uuid2, sizeof(uuid2), test2) != true) abort();
+
+    if (dictionary->get(dictionary, uuid1, sizeof(uuid1)) != test1) abort();
+    if (dictionary->get(dictionary, uuid2, sizeof(uuid2)) != test2) abort();
+    if (dictionary->get(dictionary, uuid1, 15) != NULL) abort(); // A prefix is a different key.
+
+    collection_key_dictionary_dealloc(&dictionary, NULL);
+    if (dictionary != NULL) abort();
+}
+
+// Verifies checking for key existence, including the empty key.
+void test_contains_key(void) {
+    struct IKeyDictionary *dictionary = collection_key_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    dictionary->put(dictionary, uuid1, sizeof(uuid1), "test1");
+    dictionary->put(dictionary, "", 0, "empty");
+
+    if (dictionary->contains_key(dictionary, uuid1, sizeof(uuid1)) != true) abort();
+    if (dictionary->contains_key(dictionary, "", 0) != true) abort();
+    if (dictionary->contains_key(dictionary, uuid2, sizeof(uuid2)) != false) abort();
+
+    collection_key_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies removing a key-value pair.
+void test_remove_item(void) {
+    struct IKeyDictionary *dictionary = collection_key_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    const struct Test *test1 = &(struct Test) {1};
+    const struct Test *test2 = &(struct Test) {2};
+
+    if (dictionary->put(dictionary, uuid1, sizeof(uuid1), test1) != true) abort();
+    if (dictionary->put(dictionary, uuid2, sizeof(uuid2), test2) != true) abort();
+
+    if (dictionary->remove_item(dictionary, uuid2, sizeof(uuid2)) != test2) abort();
+    if (dictionary->remove_item(dictionary, uuid2, sizeof(uuid2)) != NULL) abort();
+    if (dictionary->remove_item(dictionary, uuid1, sizeof(uuid1)) != test1) abort();
+
+    collection_key_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies replacing an existing value.
+void test_replace(void) {
+    struct IKeyDictionary *dictionary = collection_key_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    const struct Test *test1 = &(struct Test) {1};
+    const struct Test *test2 = &(struct Test) {2};
+
+    if (dictionary->put(dictionary, uuid1, sizeof(uuid1), test1) != true) abort();
+    if (dictionary->replace(dictionary, uuid1, sizeof(uuid1), test2) != test1) abort();
+    if (dictionary->get(dictionary, uuid1, sizeof(uuid1)) != test2) abort();
+    if (dictionary->replace(dictionary, uuid2, sizeof(uuid2), test2) != NULL) abort();
+
+    collection_key_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies clearing all key-value pairs.
+void test_clear(void) {
+    struct IKeyDictionary *dictionary = collection_key_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    dictionary->put(dictionary, uuid1, sizeof(uuid1), "test1");
+    dictionary->put(dictionary, uuid2, sizeof(uuid2), "test2");
+
+    if (dictionary->clear(dictionary, NULL) != true) abort();
+    if (dictionary->contains_key(dictionary, uuid1, sizeof(uuid1)) != false) abort();
+
+    if (dictionary->put(dictionary, uuid1, sizeof(uuid1), "test1") != true) abort();
+    if (dictionary->get(dictionary, uuid1, sizeof(uuid1)) == NULL) abort();
+
+    collection_key_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies destroying a dictionary and releasing resources.
+void test_dealloc(void) {
+    struct IKeyDictionary *dictionary = collection_key_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    struct Test *test1 = malloc(sizeof(struct Test));
+    test1->value = 1;
+
+    if (dictionary->put(dictionary, uuid1, sizeof(uuid1), test1) != true) abort();
+
+    // Pass free if stored items are heap allocated
+    collection_key_dictionary_dealloc(&dictionary, free);
+}
+
+// Verifies that keys are compared over their full length, past embedded NUL bytes.
+void test_embedded_nul(void) {
+    struct IKeyDictionary *dictionary = collection_key_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    if (dictionary->put(dictionary, "a\0b", 3, (void *) 1) != true) abort();
+    if (dictionary->put(dictionary, "a\0c", 3, (void *) 2) != true) abort();
+    if (dictionary->put(dictionary, "a", 1, (void *) 3) != true) abort();
+
+    if (dictionary->get(dictionary, "a\0b", 3) != (void *) 1) abort();
+    if (dictionary->get(dictionary, "a\0c", 3) != (void *) 2) abort();
+    if (dictionary->get(dictionary, "a", 1) != (void *) 3) abort();
+    if (dictionary->get(dictionary, "a\0", 2) != NULL) abort();
+
+    collection_key_dictionary_dealloc(&dictionary, NULL);
+}
+
+struct TupleKey {
+    uint32_t tenant;
+    uint16_t shard;
+    uint16_t kind;
+    uint64_t id;
+};
+
+// Verifies fixed-size struct keys hashed directly from their bytes.
+void test_struct_keys(void) {
+    struct IKeyDictionary *dictionary = collection_key_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        const struct TupleKey key = {(uint32_t) (i % 7), (uint16_t) (i % 3), 1, i};
+        if (dictionary->put(dictionary, &key, sizeof(key), (void *) (uintptr_t) (i + 1)) != true) abort();
+    }
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        struct TupleKey key;
+        memset(&key, 0, sizeof(key));
+        key.tenant = (uint32_t) (i % 7);
+        key.shard = (uint16_t) (i % 3);
+        key.kind = 1;
+        key.id = i;
+        if (dictionary->get(dictionary, &key, sizeof(key)) != (void *) (uintptr_t) (i + 1)) abort();
+        key.kind = 2;
+        if (dictionary->contains_key(dictionary, &key, sizeof(key))) abort();
+    }
+
+    collection_key_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Verifies that entries of every length survive table growth.
+void test_growth(void) {
+    struct IKeyDictionary *dictionary = collection_key_dictionary_new();
+    if (dictionary == NULL) abort();
+
+    unsigned char key[64];
+    for (uintptr_t i = 0; i < 10000; i++) {
+        memset(key, (int) (i & 0xFF), sizeof(key));
+        memcpy(key, &i, sizeof(i));
+        if (dictionary->put(dictionary, key, 8 + i % 56, (void *) (i + 1)) != true) abort();
+    }
+
+    for (uintptr_t i = 0; i < 10000; i++) {
+        memset(key, (int) (i & 0xFF), sizeof(key));
+        memcpy(key, &i, sizeof(i));
+        if (dictionary->get(dictionary, key, 8 + i % 56) != (void *) (i + 1)) abort();
+    }
+
+    collection_key_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Hashes a key case-insensitively.
+static uint64_t hash_ignore_case(const void *key, const size_t length, const uint64_t seed) {
+    const unsigned char *bytes = key;
+    uint64_t h = seed ^ 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; i++) h = (h ^ (uint64_t) tolower(bytes[i])) * 0x100000001b3ULL;
+    return h;
+}
+
+// Compares keys case-insensitively.
+static bool equals_ignore_case(const void *stored, const size_t stored_length, const void *key, const size_t length) {
+    if (stored_length != length) return false;
+    const unsigned char *a = stored, *b = key;
+    for (size_t i = 0; i < length; i++) {
+        if (tolower(a[i]) != tolower(b[i])) return false;
+    }
+    return true;
+}
+
+// Verifies caller-supplied hash and equality callbacks.
+void test_custom_ops(void) {
+    const struct CollectionKeyOps ops = {hash_ignore_case, equals_ignore_case, NULL, NULL};
+    struct IKeyDictionary *dictionary = collection_key_dictionary_new_with_ops(&ops);
+    if (dictionary == NULL) abort();
+
+    if (dictionary->put(dictionary, "Content-Type", 12, (void *) 1) != true) abort();
+    if (dictionary->get(dictionary, "content-type", 12) != (void *) 1) abort();
+    if (dictionary->get(dictionary, "CONTENT-TYPE", 12) != (void *) 1) abort();
+    if (dictionary->remove_item(dictionary, "content-TYPE", 12) != (void *) 1) abort();
+    if (dictionary->contains_key(dictionary, "Content-Type", 12)) abort();
+
+    collection_key_dictionary_dealloc(&dictionary, NULL);
+}
+
+static size_t live_keys;
+
+// Copies a key into a separate allocation.
+static void *copy_key(const void *key, const size_t length) {
+    void *copy = malloc(length ? length : 1);
+    if (copy == NULL) return NULL;
+    memcpy(copy, key, length);
+    live_keys++;
+    return copy;
+}
+
+// Releases a key allocated by copy_key.
+static void free_key(void *key) {
+    live_keys--;
+    free(key);
+}
+
+// Verifies that keys copied by a callback are released on removal, clear and dealloc.
+void test_copy_callbacks(void) {
+    const struct CollectionKeyOps ops = {NULL, NULL, copy_key, free_key};
+    struct IKeyDictionary *dictionary = collection_key_dictionary_new_with_ops(&ops);
+    if (dictionary == NULL) abort();
+
+    char key[32];
+    for (uintptr_t i = 0; i < 100; i++) {
+        const int length = snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+        if (dictionary->put(dictionary, key, (size_t) length, (void *) (i + 1)) != true) abort();
+    }
+    if (live_keys != 100) abort();
+
+    if (dictionary->get(dictionary, "key42", 5) != (void *) 43) abort();
+    if (dictionary->remove_item(dictionary, "key42", 5) != (void *) 43) abort();
+    if (live_keys != 99) abort();
+
+    if (dictionary->clear(dictionary, NULL) != true) abort();
+    if (live_keys != 0) abort();
+
+    dictionary->put(dictionary, "key", 3, (void *) 1);
+    collection_key_dictionary_dealloc(&dictionary, NULL);
+    if (live_keys != 0) abort();
+}
+
+// Returns the caller's key itself, so the dictionary borrows it.
+static void *borrow_key(const void *key, const size_t length) {
+    (void) length;
+    return (void *) key;
+}
+
+// Leaves a borrowed key to its owner.
+static void keep_key(void *key) {
+    (void) key;
+}
+
+// Verifies that a prefix of a borrowed key, passed at the same address, is a different key.
+void test_borrowed_prefix(void) {
+    const struct CollectionKeyOps ops = {NULL, NULL, borrow_key, keep_key};
+    struct IKeyDictionary *dictionary = collection_key_dictionary_new_with_ops(&ops);
+    if (dictionary == NULL) abort();
+
+    static const char key[] = "session";
+    if (dictionary->put(dictionary, key, 7, (void *) 1) != true) abort();
+    if (dictionary->get(dictionary, key, 4) != NULL) abort();
+    if (dictionary->contains_key(dictionary, key, 4)) abort();
+
+    if (dictionary->put(dictionary, key, 4, (void *) 2) != true) abort();
+    if (dictionary->get(dictionary, key, 7) != (void *) 1) abort();
+    if (dictionary->get(dictionary, key, 4) != (void *) 2) abort();
+    if (dictionary->remove_item(dictionary, key, 4) != (void *) 2) abort();
+    if (dictionary->get(dictionary, key, 7) != (void *) 1) abort();
+
+    collection_key_dictionary_dealloc(&dictionary, NULL);
+}
@@ -0,0 +1,21 @@
+/**
+ * @file test_key_dictionary.h
+ * @brief Generic-Key Dictionary Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_get(void);
+void test_contains_key(void);
+void test_remove_item(void);
+void test_replace(void);
+void test_clear(void);
+void test_dealloc(void);
+void test_embedded_nul(void);
+void test_struct_keys(void);
+void test_growth(void);
+void test_custom_ops(void);
+void test_copy_callbacks(void);
+void test_borrowed_prefix(void);
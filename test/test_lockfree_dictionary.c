@@ -0,0 +1,203 @@
+/**
+ * @file test_lockfree_dictionary.c
+ * @brief Lock-free dictionary unit tests; the shared IDictionary behaviour is covered by test_dictionary.c.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_lockfree_dictionary.h"
+#include "collection/i_dictionary.h"
+#include "collection/i_platform.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef DWORD WINAPI ThreadResult;
+#define THREAD_RETURN 0
+#else
+typedef pthread_t Thread;
+typedef void *ThreadResult;
+#define THREAD_RETURN NULL
+#endif
+
+#define THREADS 4
+#define KEYS 512
+#define ROUNDS 20000
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "LockFreeDictionaryTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_growth", test_growth);
+    test("test_clear_destructor", test_clear_destructor);
+    test("test_concurrent_access", test_concurrent_access);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+// Verifies that entries survive repeated bucket doubling while new bucket sentinels are split in.
+void test_growth(void) {
+    struct IDictionary *dictionary = collection_dictionary_new_lockfree();
+    if (dictionary == NULL) abort();
+
+    char key[32];
+    for (uintptr_t i = 1; i <= 20000; i++) {
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+        if (dictionary->put(dictionary, key, (void *) i) != true) abort();
+    }
+
+    for (uintptr_t i = 1; i <= 20000; i++) {
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+        if (dictionary->get(dictionary, key) != (void *) i) abort();
+    }
+    if (dictionary->get(dictionary, "key20001") != NULL) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Creates a platform thread.
+static void thread_create(Thread *thread, ThreadResult (*routine)(void *), void *arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+    if (*thread == NULL) abort();
+#else
+    if (pthread_create(thread, NULL, routine, arg) != 0) abort();
+#endif
+}
+
+// Waits for a platform thread to finish.
+static void thread_join(Thread thread) {
+#ifdef _WIN32
+    if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0) abort();
+    CloseHandle(thread);
+#else
+    if (pthread_join(thread, NULL) != 0) abort();
+#endif
+}
+
+static size_t destroyed;
+
+// Counts destroyed values.
+static void count_destroyed(void *value) {
+    (void) value;
+    destroyed++;
+}
+
+// Verifies that clear passes every value to the destructor once and leaves a usable dictionary.
+void test_clear_destructor(void) {
+    struct IDictionary *dictionary = collection_dictionary_new_lockfree();
+    if (dictionary == NULL) abort();
+
+    char key[32];
+    for (uintptr_t i = 1; i <= 1000; i++) {
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+        dictionary->put(dictionary, key, (void *) i);
+    }
+    dictionary->remove_item(dictionary, "key1");
+
+    destroyed = 0;
+    if (dictionary->clear(dictionary, count_destroyed) != true) abort();
+    if (destroyed != 999) abort();
+    if (dictionary->contains_key(dictionary, "key2") != false) abort();
+
+    if (dictionary->put(dictionary, "key2", (void *) 2) != true) abort();
+    if (dictionary->get(dictionary, "key2") != (void *) 2) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
+
+// Returns a small pseudo-random number (xorshift).
+static uint32_t next_random(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+struct Worker {
+    struct IDictionary *dictionary;
+    uint32_t seed;
+};
+
+// Mixes reads with inserts, updates and removals on a shared key range.
+static ThreadResult worker_thread(void *arg) {
+    struct Worker *worker = arg;
+    struct IDictionary *dictionary = worker->dictionary;
+    char key[32];
+
+    for (size_t i = 0; i < ROUNDS; i++) {
+        const uintptr_t k = next_random(&worker->seed) % KEYS;
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) k);
+
+        // Values always encode their key, so any non-NULL result must match it.
+        const void *value;
+        switch (next_random(&worker->seed) % 8) {
+            case 0: case 1:
+                if (dictionary->put(dictionary, key, (void *) (k + 1)) != true) abort();
+                break;
+            case 2:
+                value = dictionary->remove_item(dictionary, key);
+                if (value != NULL && value != (void *) (k + 1)) abort();
+                break;
+            case 3:
+                value = dictionary->replace(dictionary, key, (void *) (k + 1));
+                if (value != NULL && value != (void *) (k + 1)) abort();
+                break;
+            default:
+                value = dictionary->get(dictionary, key);
+                if (value != NULL && value != (void *) (k + 1)) abort();
+                dictionary->contains_key(dictionary, key);
+                break;
+        }
+    }
+    return THREAD_RETURN;
+}
+
+// Verifies that concurrent readers and writers observe only stored values while nodes are reclaimed.
+void test_concurrent_access(void) {
+    struct IDictionary *dictionary = collection_dictionary_new_lockfree();
+    if (dictionary == NULL) abort();
+
+    Thread threads[THREADS];
+    struct Worker workers[THREADS];
+    for (uint32_t i = 0; i < THREADS; i++) {
+        workers[i] = (struct Worker) {dictionary, 0x9E3779B9u * (i + 1)};
+        thread_create(&threads[i], worker_thread, &workers[i]);
+    }
+    for (size_t i = 0; i < THREADS; i++) thread_join(threads[i]);
+
+    // Every key is either absent or maps to its own value.
+    char key[32];
+    for (uintptr_t k = 0; k < KEYS; k++) {
+        snprintf(key, sizeof(key), "key%lu", (unsigned long) k);
+        const void *value = dictionary->get(dictionary, key);
+        if (value != NULL && value != (void *) (k + 1)) abort();
+        if (dictionary->contains_key(dictionary, key) != (value != NULL)) abort();
+    }
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
@@ -0,0 +1,12 @@
+/**
+ * @file test_lockfree_dictionary.h
+ * @brief Lock-Free Dictionary Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_growth(void);
+void test_clear_destructor(void);
+void test_concurrent_access(void);
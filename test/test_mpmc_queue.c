@@ -0,0 +1,263 @@
+/**
+ * @file test_mpmc_queue.c
+ * @brief Lock-free MPMC queue unit tests.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_mpmc_queue.h"
+#include "collection/i_array.h"
+#include "collection/i_platform.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef DWORD WINAPI ThreadResult;
+#define THREAD_RETURN 0
+#else
+#include <sched.h>
+typedef pthread_t Thread;
+typedef void *ThreadResult;
+#define THREAD_RETURN NULL
+#endif
+
+#define MAX_THREADS 4
+#define ITEMS_PER_PRODUCER 100000
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "MpmcQueueTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_push_shift", test_push_shift);
+    test("test_bounded", test_bounded);
+    test("test_unsupported", test_unsupported);
+    test("test_clear", test_clear);
+    test("test_dealloc", test_dealloc);
+    test("test_throughput_scaling", test_throughput_scaling);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+// Creates a platform thread.
+static void thread_create(Thread *thread, ThreadResult (*routine)(void *), void *arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+    if (*thread == NULL) abort();
+#else
+    if (pthread_create(thread, NULL, routine, arg) != 0) abort();
+#endif
+}
+
+// Waits for a platform thread to finish.
+static void thread_join(Thread thread) {
+#ifdef _WIN32
+    if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0) abort();
+    CloseHandle(thread);
+#else
+    if (pthread_join(thread, NULL) != 0) abort();
+#endif
+}
+
+// Yields the processor while waiting on a full or empty queue.
+static void thread_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// Returns wall-clock time in seconds.
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+// Verifies FIFO order of pushed and shifted elements.
+void test_push_shift(void) {
+    struct IArray *queue = collection_array_new_mpmc(8);
+    if (queue == NULL) abort();
+
+    if (queue->shift(queue) != NULL) abort();
+    if (queue->count(queue) != 0) abort();
+
+    for (uintptr_t round = 0; round < 10; round++) { // Cycle through several laps of the ring.
+        for (uintptr_t i = 1; i <= 5; i++) {
+            if (queue->push(queue, (void *) i) != true) abort();
+        }
+        if (queue->count(queue) != 5) abort();
+        for (uintptr_t i = 1; i <= 5; i++) {
+            if (queue->shift(queue) != (void *) i) abort();
+        }
+    }
+    if (queue->shift(queue) != NULL) abort();
+
+    collection_array_dealloc(&queue, NULL);
+}
+
+// Verifies that push fails once the capacity is reached.
+void test_bounded(void) {
+    struct IArray *queue = collection_array_new_mpmc(5); // Rounded up to 8.
+    if (queue == NULL) abort();
+
+    for (uintptr_t i = 1; i <= 8; i++) {
+        if (queue->push(queue, (void *) i) != true) abort();
+    }
+    if (queue->push(queue, (void *) 9) != false) abort();
+    if (queue->count(queue) != 8) abort();
+
+    if (queue->shift(queue) != (void *) 1) abort();
+    if (queue->push(queue, (void *) 9) != true) abort();
+
+    collection_array_dealloc(&queue, NULL);
+}
+
+// Predicate that matches every element.
+static bool match_all(const void *element, const void *data) {
+    (void) element;
+    (void) data;
+    return true;
+}
+
+// Verifies that operations without queue semantics fail cleanly.
+void test_unsupported(void) {
+    struct IArray *queue = collection_array_new_mpmc(4);
+    if (queue == NULL) abort();
+
+    if (queue->push(queue, (void *) 1) != true) abort();
+
+    if (queue->get(queue, 0) != NULL) abort();
+    if (queue->put(queue, (void *) 2, 0) != NULL) abort();
+    if (queue->find(queue, match_all, NULL) != NULL) abort();
+    if (queue->first_index(queue, match_all, NULL) != SIZE_MAX) abort();
+    if (queue->last_index(queue, match_all, NULL) != SIZE_MAX) abort();
+    if (queue->unshift(queue, (void *) 2) != NULL) abort();
+    if (queue->contains_value(queue, (void *) 1) != false) abort();
+    if (queue->pop(queue) != NULL) abort();
+    if (queue->remove_item(queue, (void *) 1) != NULL) abort();
+    if (queue->clone(queue) != NULL) abort();
+
+    if (queue->count(queue) != 1) abort();
+    if (queue->shift(queue) != (void *) 1) abort();
+
+    collection_array_dealloc(&queue, NULL);
+}
+
+// Verifies draining the queue.
+void test_clear(void) {
+    struct IArray *queue = collection_array_new_mpmc(16);
+    if (queue == NULL) abort();
+
+    for (uintptr_t i = 1; i <= 10; i++) queue->push(queue, (void *) i);
+    queue->clear(queue, NULL);
+    if (queue->count(queue) != 0) abort();
+    if (queue->shift(queue) != NULL) abort();
+    if (queue->push(queue, (void *) 1) != true) abort();
+
+    collection_array_dealloc(&queue, NULL);
+}
+
+// Verifies destroying a queue and releasing remaining elements.
+void test_dealloc(void) {
+    struct IArray *queue = collection_array_new_mpmc(4);
+    if (queue == NULL) abort();
+
+    for (int i = 0; i < 3; i++) {
+        int *value = malloc(sizeof(int));
+        if (value == NULL) abort();
+        *value = i;
+        if (queue->push(queue, value) != true) abort();
+    }
+
+    // Pass free if stored items are heap allocated
+    collection_array_dealloc(&queue, free);
+    if (queue != NULL) abort();
+}
+
+struct Worker {
+    struct IArray *queue;
+    size_t items;                       // Items to push or shift.
+    uint64_t sum;                       // Sum of shifted items (consumers only).
+};
+
+// Pushes a fixed number of items, spinning politely while the queue is full.
+static ThreadResult producer_thread(void *arg) {
+    struct Worker *worker = arg;
+    for (uintptr_t i = 1; i <= worker->items; i++) {
+        while (!worker->queue->push(worker->queue, (void *) i)) thread_yield();
+    }
+    return THREAD_RETURN;
+}
+
+// Shifts a fixed number of items, spinning politely while the queue is empty.
+static ThreadResult consumer_thread(void *arg) {
+    struct Worker *worker = arg;
+    for (size_t n = 0; n < worker->items; n++) {
+        const void *item;
+        while ((item = worker->queue->shift(worker->queue)) == NULL) thread_yield();
+        worker->sum += (uintptr_t) item;
+    }
+    return THREAD_RETURN;
+}
+
+// Verifies no element is lost or duplicated and reports throughput from 1 to MAX_THREADS producer/consumer pairs.
+void test_throughput_scaling(void) {
+    for (size_t threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        struct IArray *queue = collection_array_new_mpmc(1024);
+        if (queue == NULL) abort();
+
+        struct Worker producers[MAX_THREADS], consumers[MAX_THREADS];
+        Thread producer_ids[MAX_THREADS], consumer_ids[MAX_THREADS];
+
+        const double start = now_seconds();
+        for (size_t i = 0; i < threads; i++) {
+            producers[i] = (struct Worker) {queue, ITEMS_PER_PRODUCER, 0};
+            consumers[i] = (struct Worker) {queue, ITEMS_PER_PRODUCER, 0};
+            thread_create(&producer_ids[i], producer_thread, &producers[i]);
+            thread_create(&consumer_ids[i], consumer_thread, &consumers[i]);
+        }
+
+        uint64_t sum = 0;
+        for (size_t i = 0; i < threads; i++) {
+            thread_join(producer_ids[i]);
+            thread_join(consumer_ids[i]);
+            sum += consumers[i].sum;
+        }
+        const double elapsed = now_seconds() - start;
+
+        const uint64_t expected = (uint64_t) threads * ITEMS_PER_PRODUCER * (ITEMS_PER_PRODUCER + 1) / 2;
+        if (sum != expected) abort();
+        if (queue->count(queue) != 0) abort();
+
+        const double ops = 2.0 * (double) threads * ITEMS_PER_PRODUCER;
+        printf("    %zu producer(s) x %zu consumer(s): %.2f Mops/s\n", threads, threads, ops / elapsed / 1e6);
+
+        collection_array_dealloc(&queue, NULL);
+    }
+}
@@ -0,0 +1,15 @@
+/**
+ * @file test_mpmc_queue.h
+ * @brief Lock-Free MPMC Queue Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_push_shift(void);
+void test_bounded(void);
+void test_unsupported(void);
+void test_clear(void);
+void test_dealloc(void);
+void test_throughput_scaling(void);
@@ -6,10 +6,13 @@
  * @copyright BSD 3-Clause License
  */
 #include "test_mutex.h"
+#include "collection/i_dictionary.h"
 #include "collection/i_platform.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef _WIN32
 typedef HANDLE Thread;
@@ -50,6 +53,10 @@ int main(void) {
     test("test_mutex_basic", test_mutex_basic);
     test("test_mutex_once", test_mutex_once);
     test("test_mutex_once_with_mutex", test_mutex_once_with_mutex);
+    test("test_thread_key", test_thread_key);
+    test("test_condition", test_condition);
+    test("test_lock_profile", test_lock_profile);
+    test("test_lock_profile_contention", test_lock_profile_contention);
     after_all();
 
     printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
@@ -172,3 +179,188 @@ void test_mutex_once_with_mutex(void) {
 
     if (mutex_destroy(&init_mutex) != 0) abort();
 }
+
+static ThreadKey thread_key;
+static Mutex destructor_mutex;
+static int destructor_calls = 0;
+
+// Counts thread-specific values released at thread exit.
+static void thread_key_destructor(void *value) {
+    if (value == NULL) abort();
+    if (mutex_lock(&destructor_mutex) != 0) abort();
+    destructor_calls++;
+    if (mutex_unlock(&destructor_mutex) != 0) abort();
+}
+
+// Stores and reads back a thread-specific value.
+static ThreadResult thread_key_thread(void *arg) {
+    if (thread_key_get(thread_key) != NULL) abort();
+    if (thread_key_set(thread_key, arg) != 0) abort();
+    if (thread_key_get(thread_key) != arg) abort();
+    return THREAD_RETURN;
+}
+
+// Verifies thread-specific values are private to each thread and destroyed on exit.
+void test_thread_key(void) {
+    Thread threads[THREAD_COUNT];
+    int values[THREAD_COUNT];
+
+    if (mutex_init(&destructor_mutex) != 0) abort();
+    if (thread_key_create(&thread_key, thread_key_destructor) != 0) abort();
+    destructor_calls = 0;
+
+    for (int i = 0; i < THREAD_COUNT; ++i)
+        thread_create(&threads[i], thread_key_thread, &values[i]);
+
+    for (int i = 0; i < THREAD_COUNT; ++i)
+        thread_join(threads[i]);
+
+    if (thread_key_get(thread_key) != NULL) abort(); // Main thread never set a value.
+    if (thread_key_delete(thread_key) != 0) abort();
+    if (mutex_destroy(&destructor_mutex) != 0) abort();
+    if (destructor_calls != THREAD_COUNT) abort();
+}
+
+static Monitor condition_monitor;
+static Condition condition;
+static int condition_ready;
+
+// Sets the shared flag under the monitor and signals the waiter.
+static ThreadResult condition_thread(void *arg) {
+    (void) arg;
+    if (monitor_lock(&condition_monitor) != 0) abort();
+    condition_ready = 1;
+    if (condition_signal(&condition) != 0) abort();
+    if (monitor_unlock(&condition_monitor) != 0) abort();
+    return THREAD_RETURN;
+}
+
+// Verifies timed condition waits and wakeups from another thread.
+void test_condition(void) {
+    if (monitor_init(&condition_monitor) != 0) abort();
+    if (condition_init(&condition) != 0) abort();
+    condition_ready = 0;
+
+    // Nobody signals, so a timed wait must time out no earlier than requested.
+    if (monitor_lock(&condition_monitor) != 0) abort();
+    const uint64_t start = clock_monotonic_ns();
+    while (clock_monotonic_ns() - start < 20000000u) { // Tolerate spurious wakeups.
+        if (condition_wait(&condition, &condition_monitor, 20) == 0 && condition_ready) abort();
+    }
+    if (monitor_unlock(&condition_monitor) != 0) abort();
+
+    Thread thread;
+    if (monitor_lock(&condition_monitor) != 0) abort();
+    thread_create(&thread, condition_thread, NULL);
+    while (!condition_ready) {
+        condition_wait(&condition, &condition_monitor, -1);
+    }
+    if (monitor_unlock(&condition_monitor) != 0) abort();
+    thread_join(thread);
+
+    if (condition_broadcast(&condition) != 0) abort(); // No waiters; must still succeed.
+    if (condition_destroy(&condition) != 0) abort();
+    if (monitor_destroy(&condition_monitor) != 0) abort();
+}
+
+// Finds the snapshot of a lock name, aborting if it is missing.
+static struct lock_profile_stats find_profile(const char *name) {
+    static struct lock_profile_stats profiles[64];
+    const size_t count = lock_profile_snapshot(profiles, 64);
+    for (size_t i = 0; i < count && i < 64; i++) {
+        if (strcmp(profiles[i].name, name) == 0) return profiles[i];
+    }
+    abort();
+}
+
+// Returns the number of samples in a histogram.
+static uint64_t samples(const uint64_t *histogram) {
+    uint64_t total = 0;
+    for (size_t b = 0; b < LOCK_PROFILE_BUCKETS; b++) total += histogram[b];
+    return total;
+}
+
+// Verifies that named mutexes count exclusive and shared acquisitions and holds, and that reset keeps names.
+void test_lock_profile(void) {
+    Mutex mutex;
+    if (mutex_init(&mutex) != 0) abort();
+    if (mutex_set_name(&mutex, "Test::Profiled") != 0) abort();
+    if (mutex_set_name(NULL, "Test::Profiled") == 0) abort();
+
+    if (!lock_profile_enabled()) {
+        if (lock_profile_snapshot(NULL, 0) != 0) abort();
+        lock_profile_print(10);
+        lock_profile_reset();
+        if (mutex_destroy(&mutex) != 0) abort();
+        return;
+    }
+
+    for (int i = 0; i < 100; i++) {
+        if (mutex_lock(&mutex) != 0) abort();
+        if (mutex_unlock(&mutex) != 0) abort();
+    }
+    for (int i = 0; i < 50; i++) {
+        if (mutex_lock_shared(&mutex) != 0) abort();
+        if (mutex_unlock(&mutex) != 0) abort();
+    }
+
+    struct lock_profile_stats profile = find_profile("Test::Profiled");
+    if (profile.locks != 1) abort();
+    if (profile.acquisitions[LOCK_EXCLUSIVE] != 100 || profile.acquisitions[LOCK_SHARED] != 50) abort();
+    if (profile.contended[LOCK_EXCLUSIVE] != 0 || profile.contended[LOCK_SHARED] != 0) abort();
+    if (samples(profile.hold_histogram[LOCK_EXCLUSIVE]) != 100) abort();
+    if (samples(profile.hold_histogram[LOCK_SHARED]) != 50) abort();
+
+    struct IDictionary *dictionary = collection_dictionary_new_swiss(); // Containers name their own locks.
+    if (dictionary == NULL) abort();
+    dictionary->put(dictionary, "key", "value");
+    if (find_profile("Collection::SwissDictionary").acquisitions[LOCK_EXCLUSIVE] == 0) abort();
+    collection_dictionary_dealloc(&dictionary, NULL);
+
+    lock_profile_reset();
+    profile = find_profile("Test::Profiled");
+    if (profile.locks != 1 || profile.acquisitions[LOCK_EXCLUSIVE] != 0 || profile.hold_ns[LOCK_SHARED] != 0) abort();
+
+    lock_profile_print(5);
+    if (mutex_destroy(&mutex) != 0) abort();
+    if (find_profile("Test::Profiled").locks != 0) abort();
+}
+
+static Mutex contended_mutex;
+
+// Blocks on the mutex held by the test thread.
+static ThreadResult contending_thread(void *arg) {
+    (void) arg;
+    if (mutex_lock(&contended_mutex) != 0) abort();
+    if (mutex_unlock(&contended_mutex) != 0) abort();
+    return THREAD_RETURN;
+}
+
+// Verifies that an acquisition blocked by another holder is counted as contended with its wait time.
+void test_lock_profile_contention(void) {
+    if (!lock_profile_enabled()) return;
+    if (mutex_init(&contended_mutex) != 0) abort();
+    if (mutex_set_name(&contended_mutex, "Test::Contended") != 0) abort();
+
+    Monitor monitor;
+    Condition sleeper;
+    if (monitor_init(&monitor) != 0 || condition_init(&sleeper) != 0) abort();
+
+    if (mutex_lock(&contended_mutex) != 0) abort();
+    Thread thread;
+    thread_create(&thread, contending_thread, NULL);
+    if (monitor_lock(&monitor) != 0) abort();
+    const uint64_t start = clock_monotonic_ns();
+    while (clock_monotonic_ns() - start < 20000000u) condition_wait(&sleeper, &monitor, 20); // Let the thread block.
+    if (monitor_unlock(&monitor) != 0) abort();
+    if (mutex_unlock(&contended_mutex) != 0) abort();
+    thread_join(thread);
+
+    const struct lock_profile_stats profile = find_profile("Test::Contended");
+    if (profile.acquisitions[LOCK_EXCLUSIVE] != 2 || profile.contended[LOCK_EXCLUSIVE] != 1) abort();
+    if (profile.wait_ns[LOCK_EXCLUSIVE] == 0 || samples(profile.wait_histogram[LOCK_EXCLUSIVE]) != 1) abort();
+    if (profile.hold_ns[LOCK_EXCLUSIVE] < 10000000u) abort(); // The test thread held it for about 20 ms.
+
+    if (condition_destroy(&sleeper) != 0 || monitor_destroy(&monitor) != 0) abort();
+    if (mutex_destroy(&contended_mutex) != 0) abort();
+}
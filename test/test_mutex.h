@@ -10,3 +10,7 @@
 void test_mutex_basic(void);
 void test_mutex_once(void);
 void test_mutex_once_with_mutex(void);
+void test_thread_key(void);
+void test_condition(void);
+void test_lock_profile(void);
+void test_lock_profile_contention(void);
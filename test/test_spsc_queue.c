@@ -0,0 +1,301 @@
+/**
+ * @file test_spsc_queue.c
+ * @brief Wait-free SPSC queue unit tests.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_spsc_queue.h"
+#include "collection/i_array.h"
+#include "collection/i_platform.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef DWORD WINAPI ThreadResult;
+#define THREAD_RETURN 0
+#else
+#include <sched.h>
+typedef pthread_t Thread;
+typedef void *ThreadResult;
+#define THREAD_RETURN NULL
+#endif
+
+#define ITEMS 1000000
+#define BATCH 64
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "SpscQueueTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_push_shift", test_push_shift);
+    test("test_bounded", test_bounded);
+    test("test_batch", test_batch);
+    test("test_unsupported", test_unsupported);
+    test("test_dealloc", test_dealloc);
+    test("test_throughput", test_throughput);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+// Creates a platform thread.
+static void thread_create(Thread *thread, ThreadResult (*routine)(void *), void *arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+    if (*thread == NULL) abort();
+#else
+    if (pthread_create(thread, NULL, routine, arg) != 0) abort();
+#endif
+}
+
+// Waits for a platform thread to finish.
+static void thread_join(Thread thread) {
+#ifdef _WIN32
+    if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0) abort();
+    CloseHandle(thread);
+#else
+    if (pthread_join(thread, NULL) != 0) abort();
+#endif
+}
+
+// Yields the processor while waiting on a full or empty queue.
+static void thread_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// Returns wall-clock time in seconds.
+static double now_seconds(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+// Verifies FIFO order of pushed and shifted elements.
+void test_push_shift(void) {
+    struct IArray *queue = collection_array_new_spsc(8);
+    if (queue == NULL) abort();
+
+    if (queue->shift(queue) != NULL) abort();
+    if (queue->count(queue) != 0) abort();
+
+    for (uintptr_t round = 0; round < 10; round++) { // Cycle through several laps of the ring.
+        for (uintptr_t i = 1; i <= 5; i++) {
+            if (queue->push(queue, (void *) i) != true) abort();
+        }
+        if (queue->count(queue) != 5) abort();
+        for (uintptr_t i = 1; i <= 5; i++) {
+            if (queue->shift(queue) != (void *) i) abort();
+        }
+    }
+    if (queue->shift(queue) != NULL) abort();
+
+    collection_array_dealloc(&queue, NULL);
+}
+
+// Verifies that push fails once the capacity is reached.
+void test_bounded(void) {
+    struct IArray *queue = collection_array_new_spsc(5); // Rounded up to 8.
+    if (queue == NULL) abort();
+
+    for (uintptr_t i = 1; i <= 8; i++) {
+        if (queue->push(queue, (void *) i) != true) abort();
+    }
+    if (queue->push(queue, (void *) 9) != false) abort();
+    if (queue->count(queue) != 8) abort();
+
+    if (queue->shift(queue) != (void *) 1) abort();
+    if (queue->push(queue, (void *) 9) != true) abort();
+
+    collection_array_dealloc(&queue, NULL);
+}
+
+// Verifies partial batches, batches that wrap around the end of the ring, and that other arrays are refused.
+void test_batch(void) {
+    struct IArray *queue = collection_array_new_spsc(8);
+    if (queue == NULL) abort();
+
+    const void *in[12];
+    const void *out[12];
+    for (uintptr_t i = 0; i < 12; i++) in[i] = (void *) (i + 1);
+
+    if (collection_array_spsc_shift_n(queue, out, 4) != 0) abort();
+
+    // Offset the ring so the next batch wraps.
+    if (collection_array_spsc_push_n(queue, in, 5) != 5) abort();
+    if (collection_array_spsc_shift_n(queue, out, 5) != 5) abort();
+    for (size_t i = 0; i < 5; i++) if (out[i] != in[i]) abort();
+
+    if (collection_array_spsc_push_n(queue, in, 12) != 8) abort(); // Only 8 fit.
+    if (collection_array_spsc_push_n(queue, in + 8, 4) != 0) abort();
+    if (queue->count(queue) != 8) abort();
+
+    if (queue->shift(queue) != in[0]) abort(); // Batch and single operations interleave.
+    if (collection_array_spsc_shift_n(queue, out, 12) != 7) abort();
+    for (size_t i = 0; i < 7; i++) if (out[i] != in[i + 1]) abort();
+    if (queue->count(queue) != 0) abort();
+
+    if (collection_array_spsc_push_n(NULL, in, 1) != 0) abort();
+    if (collection_array_spsc_shift_n(queue, NULL, 1) != 0) abort();
+    collection_array_dealloc(&queue, NULL);
+
+    queue = collection_array_new_mpmc(8); // Not an SPSC queue
+    if (queue == NULL) abort();
+    if (collection_array_spsc_push_n(queue, in, 4) != 0) abort();
+    if (queue->count(queue) != 0) abort();
+    if (queue->push(queue, in[0]) != true) abort();
+    if (collection_array_spsc_shift_n(queue, out, 4) != 0) abort();
+    if (queue->count(queue) != 1) abort();
+    collection_array_dealloc(&queue, NULL);
+}
+
+// Predicate that matches every element.
+static bool match_all(const void *element, const void *data) {
+    (void) element;
+    (void) data;
+    return true;
+}
+
+// Verifies that operations without queue semantics fail cleanly.
+void test_unsupported(void) {
+    struct IArray *queue = collection_array_new_spsc(4);
+    if (queue == NULL) abort();
+
+    if (queue->push(queue, (void *) 1) != true) abort();
+
+    if (queue->get(queue, 0) != NULL) abort();
+    if (queue->put(queue, (void *) 2, 0) != NULL) abort();
+    if (queue->find(queue, match_all, NULL) != NULL) abort();
+    if (queue->first_index(queue, match_all, NULL) != SIZE_MAX) abort();
+    if (queue->last_index(queue, match_all, NULL) != SIZE_MAX) abort();
+    if (queue->unshift(queue, (void *) 2) != NULL) abort();
+    if (queue->contains_value(queue, (void *) 1) != false) abort();
+    if (queue->pop(queue) != NULL) abort();
+    if (queue->remove_item(queue, (void *) 1) != NULL) abort();
+    if (queue->clone(queue) != NULL) abort();
+
+    if (queue->count(queue) != 1) abort();
+    if (queue->shift(queue) != (void *) 1) abort();
+
+    collection_array_dealloc(&queue, NULL);
+}
+
+// Verifies destroying a queue and releasing remaining elements.
+void test_dealloc(void) {
+    struct IArray *queue = collection_array_new_spsc(4);
+    if (queue == NULL) abort();
+
+    for (int i = 0; i < 3; i++) {
+        int *value = malloc(sizeof(int));
+        if (value == NULL) abort();
+        *value = i;
+        if (queue->push(queue, value) != true) abort();
+    }
+
+    // Pass free if stored items are heap allocated
+    collection_array_dealloc(&queue, free);
+    if (queue != NULL) abort();
+}
+
+struct Producer {
+    struct IArray *queue;
+    bool batched;                       // Use collection_array_spsc_push_n instead of push.
+};
+
+// Pushes 1..ITEMS in order, spinning politely while the queue is full.
+static ThreadResult producer_thread(void *arg) {
+    struct Producer *producer = arg;
+    struct IArray *queue = producer->queue;
+
+    if (!producer->batched) {
+        for (uintptr_t i = 1; i <= ITEMS; i++) {
+            while (!queue->push(queue, (void *) i)) thread_yield();
+        }
+        return THREAD_RETURN;
+    }
+
+    const void *batch[BATCH];
+    for (uintptr_t next = 1; next <= ITEMS;) {
+        size_t n = 0;
+        while (n < BATCH && next + n <= ITEMS) {
+            batch[n] = (void *) (next + n);
+            n++;
+        }
+        for (size_t sent = 0; sent < n;) {
+            const size_t pushed = collection_array_spsc_push_n(queue, batch + sent, n - sent);
+            if (pushed == 0) thread_yield();
+            sent += pushed;
+        }
+        next += n;
+    }
+    return THREAD_RETURN;
+}
+
+// Verifies strict ordering across threads and reports single and batched throughput.
+void test_throughput(void) {
+    for (int batched = 0; batched <= 1; batched++) {
+        struct IArray *queue = collection_array_new_spsc(1024);
+        if (queue == NULL) abort();
+
+        struct Producer producer = {queue, batched};
+        Thread thread;
+
+        const double start = now_seconds();
+        thread_create(&thread, producer_thread, &producer);
+
+        uintptr_t expected = 1;
+        const void *batch[BATCH];
+        while (expected <= ITEMS) {
+            if (batched) {
+                const size_t n = collection_array_spsc_shift_n(queue, batch, BATCH);
+                if (n == 0) thread_yield();
+                for (size_t i = 0; i < n; i++) {
+                    if (batch[i] != (void *) expected++) abort();
+                }
+            } else {
+                const void *item = queue->shift(queue);
+                if (item == NULL) {
+                    thread_yield();
+                    continue;
+                }
+                if (item != (void *) expected++) abort();
+            }
+        }
+
+        thread_join(thread);
+        const double elapsed = now_seconds() - start;
+        if (queue->count(queue) != 0) abort();
+
+        printf("    %s: %.2f Mitems/s\n", batched ? "push_n/shift_n" : "push/shift", ITEMS / elapsed / 1e6);
+
+        collection_array_dealloc(&queue, NULL);
+    }
+}
@@ -0,0 +1,15 @@
+/**
+ * @file test_spsc_queue.h
+ * @brief Wait-Free SPSC Queue Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_push_shift(void);
+void test_bounded(void);
+void test_batch(void);
+void test_unsupported(void);
+void test_dealloc(void);
+void test_throughput(void);
@@ -0,0 +1,143 @@
+/**
+ * @file test_stats.c
+ * @brief Process statistics unit tests.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_stats.h"
+#include "collection/i_platform.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define REGION_BYTES (32u * 1024u * 1024u)
+
+static void before_all(void) {}
+static void before_each(void) {}
+static void after_each(void) {}
+static void after_all(void) {}
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "StatsTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_process_stats_collect", test_process_stats_collect);
+    test("test_process_stats_print", test_process_stats_print);
+    test("test_region_memory", test_region_memory);
+    test("test_region_cpu", test_region_cpu);
+    test("test_region_counters", test_region_counters);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+// Returns the user plus system CPU time consumed by the process so far, in nanoseconds.
+static uint64_t cpu_time_ns(void) {
+    struct process_stats stats;
+    if (process_stats_collect(&stats) != 0) abort();
+    return (uint64_t) ((stats.user_cpu_sec + stats.system_cpu_sec) * 1e9);
+}
+
+// Burns CPU in user space until the process has consumed at least the given number of CPU nanoseconds,
+// so the result holds regardless of how much of the wall clock other processes take.
+static uint64_t spin(const uint64_t ns) {
+    volatile uint64_t sink = 0;
+    const uint64_t deadline = cpu_time_ns() + ns;
+    while (cpu_time_ns() < deadline) {
+        for (int i = 0; i < 100000; i++) sink += (uint64_t) i * sink + 1;
+    }
+    return sink;
+}
+
+// Verifies that collected statistics are populated and plausible.
+void test_process_stats_collect(void) {
+    if (process_stats_collect(NULL) == 0) abort();
+
+    struct process_stats stats;
+    if (process_stats_collect(&stats) != 0) abort();
+    if (stats.max_rss_mb <= 0) abort();
+    if (stats.current_rss_mb < 0 || stats.user_cpu_sec < 0 || stats.system_cpu_sec < 0) abort();
+    if (stats.minor_page_faults < 0 || stats.major_page_faults < 0) abort();
+#ifdef __linux__
+    if (stats.current_rss_mb <= 0) abort();
+#endif
+}
+
+// Verifies that printing statistics succeeds.
+void test_process_stats_print(void) {
+    process_stats_print();
+}
+
+// Verifies that a region attributes touched memory to resident size and page faults.
+void test_region_memory(void) {
+    struct stats_region region;
+    struct stats_delta delta;
+    if (stats_region_begin(NULL) == 0 || stats_region_end(NULL, &delta) == 0) abort();
+
+    if (stats_region_begin(&region) != 0) abort();
+    char *block = malloc(REGION_BYTES);
+    if (block == NULL) abort();
+    for (size_t i = 0; i < REGION_BYTES; i += 4096) ((volatile char *) block)[i] = 1; // Fault every page in.
+    if (stats_region_end(&region, &delta) != 0) abort();
+    stats_delta_print("touch 32 MB", &delta);
+
+    if (delta.minor_page_faults <= 0) abort();
+    if (delta.max_rss_mb < 32.0) abort();
+#ifdef __linux__
+    if (delta.rss_mb < 16.0) abort();
+#endif
+    if (delta.wall_sec <= 0) abort();
+
+    free(block);
+}
+
+// Verifies that a region attributes CPU time to user time.
+void test_region_cpu(void) {
+    struct stats_region region;
+    struct stats_delta delta;
+
+    if (stats_region_begin(&region) != 0) abort();
+    spin(50000000); // 50 ms of CPU time
+    if (stats_region_end(&region, &delta) != 0) abort();
+    stats_delta_print("spin 50 ms", &delta);
+
+    if (delta.user_cpu_sec + delta.system_cpu_sec < 0.05) abort();
+    if (delta.wall_sec <= 0) abort();
+    if (delta.minor_page_faults < 0 || delta.voluntary_ctx_switches < 0) abort();
+}
+
+// Verifies that whichever performance counters are available report the work done.
+void test_region_counters(void) {
+    struct stats_region region;
+    struct stats_delta delta;
+
+    if (stats_region_begin(&region) != 0) abort();
+    spin(20000000); // 20 ms of CPU time
+    if (stats_region_end(&region, &delta) != 0) abort();
+    stats_delta_print("counters", &delta);
+
+    for (int i = 0; i < STATS_COUNTER_COUNT; i++) {
+        if (region.counters[i] != -1) abort(); // Closed by stats_region_end().
+        if (!(delta.available & 1u << i) && delta.counters[i] != 0) abort();
+    }
+    if (delta.available & 1u << STATS_INSTRUCTIONS && delta.counters[STATS_INSTRUCTIONS] == 0) abort();
+    if (delta.available & 1u << STATS_CYCLES && delta.counters[STATS_CYCLES] == 0) abort();
+    if (delta.available & 1u << STATS_TASK_CLOCK_NS && delta.counters[STATS_TASK_CLOCK_NS] < 10000000) abort();
+}
@@ -0,0 +1,14 @@
+/**
+ * @file test_stats.h
+ * @brief Process Statistics Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_process_stats_collect(void);
+void test_process_stats_print(void);
+void test_region_memory(void);
+void test_region_cpu(void);
+void test_region_counters(void);
@@ -0,0 +1,159 @@
+/**
+ * @file test_striped_dictionary.c
+ * @brief Striped dictionary unit tests; the shared IDictionary behaviour is covered by test_dictionary.c.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_striped_dictionary.h"
+#include "collection/i_dictionary.h"
+#include "collection/i_platform.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef DWORD WINAPI ThreadResult;
+#define THREAD_RETURN 0
+#else
+typedef pthread_t Thread;
+typedef void *ThreadResult;
+#define THREAD_RETURN NULL
+#endif
+
+#define WRITERS 4
+#define KEYS_PER_WRITER 5000
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "StripedDictionaryTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_stripe_counts", test_stripe_counts);
+    test("test_concurrent_writers", test_concurrent_writers);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+// Creates a platform thread.
+static void thread_create(Thread *thread, ThreadResult (*routine)(void *), void *arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+    if (*thread == NULL) abort();
+#else
+    if (pthread_create(thread, NULL, routine, arg) != 0) abort();
+#endif
+}
+
+// Waits for a platform thread to finish.
+static void thread_join(Thread thread) {
+#ifdef _WIN32
+    if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0) abort();
+    CloseHandle(thread);
+#else
+    if (pthread_join(thread, NULL) != 0) abort();
+#endif
+}
+
+// Verifies that many keys spread over any stripe count are all reachable and removable.
+void test_stripe_counts(void) {
+    const size_t counts[] = {0, 1, 3, 64, SIZE_MAX};
+    char key[32];
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        struct IDictionary *dictionary = collection_dictionary_new_striped(counts[c]);
+        if (dictionary == NULL) abort();
+
+        for (uintptr_t i = 1; i <= 2000; i++) {
+            snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+            if (dictionary->put(dictionary, key, (void *) i) != true) abort();
+        }
+        for (uintptr_t i = 1; i <= 2000; i++) {
+            snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+            if (dictionary->get(dictionary, key) != (void *) i) abort();
+            if (i % 2 == 0 && dictionary->remove_item(dictionary, key) != (void *) i) abort();
+        }
+        for (uintptr_t i = 1; i <= 2000; i++) {
+            snprintf(key, sizeof(key), "key%lu", (unsigned long) i);
+            if (dictionary->contains_key(dictionary, key) != (i % 2 == 1)) abort();
+        }
+
+        collection_dictionary_dealloc(&dictionary, NULL);
+    }
+}
+
+struct Writer {
+    struct IDictionary *dictionary;
+    unsigned long id;
+};
+
+// Inserts, replaces and removes a disjoint range of keys.
+static ThreadResult writer_thread(void *arg) {
+    struct Writer *writer = arg;
+    struct IDictionary *dictionary = writer->dictionary;
+    char key[32];
+
+    for (uintptr_t i = 0; i < KEYS_PER_WRITER; i++) {
+        snprintf(key, sizeof(key), "w%lu-%lu", writer->id, (unsigned long) i);
+        if (dictionary->put(dictionary, key, (void *) (i + 1)) != true) abort();
+    }
+    for (uintptr_t i = 0; i < KEYS_PER_WRITER; i++) {
+        snprintf(key, sizeof(key), "w%lu-%lu", writer->id, (unsigned long) i);
+        if (i % 3 == 0) {
+            if (dictionary->remove_item(dictionary, key) != (void *) (i + 1)) abort();
+        } else if (dictionary->replace(dictionary, key, (void *) (i + 2)) != (void *) (i + 1)) {
+            abort();
+        }
+    }
+    return THREAD_RETURN;
+}
+
+// Verifies that concurrent writers on disjoint keys neither lose nor corrupt entries.
+void test_concurrent_writers(void) {
+    struct IDictionary *dictionary = collection_dictionary_new_striped(8);
+    if (dictionary == NULL) abort();
+
+    Thread threads[WRITERS];
+    struct Writer writers[WRITERS];
+    for (unsigned long i = 0; i < WRITERS; i++) {
+        writers[i] = (struct Writer) {dictionary, i};
+        thread_create(&threads[i], writer_thread, &writers[i]);
+    }
+    for (size_t i = 0; i < WRITERS; i++) thread_join(threads[i]);
+
+    char key[32];
+    for (unsigned long w = 0; w < WRITERS; w++) {
+        for (uintptr_t i = 0; i < KEYS_PER_WRITER; i++) {
+            snprintf(key, sizeof(key), "w%lu-%lu", w, (unsigned long) i);
+            const void *expected = i % 3 == 0 ? NULL : (void *) (i + 2);
+            if (dictionary->get(dictionary, key) != expected) abort();
+        }
+    }
+
+    if (dictionary->clear(dictionary, NULL) != true) abort();
+    if (dictionary->contains_key(dictionary, "w0-1") != false) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
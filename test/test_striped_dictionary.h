@@ -0,0 +1,11 @@
+/**
+ * @file test_striped_dictionary.h
+ * @brief Striped Dictionary Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_stripe_counts(void);
+void test_concurrent_writers(void);
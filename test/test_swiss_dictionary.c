@@ -0,0 +1,70 @@
+/**
+ * @file test_swiss_dictionary.c
+ * @brief Swiss table dictionary unit tests; the shared IDictionary behaviour is covered by test_dictionary.c.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_swiss_dictionary.h"
+#include "collection/i_dictionary.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "SwissDictionaryTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_churn", test_churn);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+// Verifies lookups stay correct across interleaved inserts and removals that leave tombstones.
+void test_churn(void) {
+    struct IDictionary *dictionary = collection_dictionary_new_swiss();
+    if (dictionary == NULL) abort();
+
+    char key[32];
+    for (uintptr_t round = 0; round < 50; round++) {
+        for (uintptr_t i = 1; i <= 200; i++) {
+            snprintf(key, sizeof(key), "r%lu-%lu", (unsigned long) round, (unsigned long) i);
+            if (dictionary->put(dictionary, key, (void *) i) != true) abort();
+        }
+        for (uintptr_t i = 1; i <= 200; i += 2) { // Keep the even keys of every round.
+            snprintf(key, sizeof(key), "r%lu-%lu", (unsigned long) round, (unsigned long) i);
+            if (dictionary->remove_item(dictionary, key) != (void *) i) abort();
+        }
+    }
+
+    for (uintptr_t round = 0; round < 50; round++) {
+        for (uintptr_t i = 1; i <= 200; i++) {
+            snprintf(key, sizeof(key), "r%lu-%lu", (unsigned long) round, (unsigned long) i);
+            if (dictionary->get(dictionary, key) != (i % 2 == 0 ? (void *) i : NULL)) abort();
+        }
+    }
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+}
@@ -0,0 +1,10 @@
+/**
+ * @file test_swiss_dictionary.h
+ * @brief Swiss Table Dictionary Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_churn(void);
@@ -0,0 +1,353 @@
+/**
+ * @file test_trace.c
+ * @brief Trace unit tests.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_trace.h"
+#include "collection/i_trace.h"
+#include "collection/i_platform.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef DWORD WINAPI ThreadResult;
+#define THREAD_RETURN 0
+#else
+typedef pthread_t Thread;
+typedef void *ThreadResult;
+#define THREAD_RETURN NULL
+#endif
+
+#define TRACE_PATH "test_trace.bin"
+#define THREADS 4
+#define ROUNDS 2000
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { remove(TRACE_PATH); }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "TraceTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_dictionary_recording", test_dictionary_recording);
+    test("test_dictionary_batches", test_dictionary_batches);
+    test("test_array_recording", test_array_recording);
+    test("test_flush", test_flush);
+    test("test_load_invalid", test_load_invalid);
+    test("test_dealloc", test_dealloc);
+    test("test_concurrent_recording", test_concurrent_recording);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+// Aborts unless a record holds the expected operation, outcome and key.
+static void expect_key(const struct CollectionTraceRecord *record, const enum CollectionTraceOp op, const bool succeeded,
+                       const char *key) {
+    if (record->op != op) abort();
+    if (record->flags != (succeeded ? COLLECTION_TRACE_SUCCEEDED : 0)) abort();
+    if (record->key_length != strlen(key) || record->key_hash != collection_hash(key, strlen(key))) abort();
+}
+
+// Matches elements equal to the integer behind data.
+static bool equals(const void *element, const void *data) {
+    return element == *(const void *const *) data;
+}
+
+// Verifies that each dictionary operation is recorded with its key and outcome, in call order.
+void test_dictionary_recording(void) {
+    struct ITrace *trace = collection_trace_new(TRACE_PATH);
+    if (trace == NULL) abort();
+    struct IDictionary *dictionary = collection_dictionary_new_recording(collection_dictionary_new_swiss(), trace);
+    if (dictionary == NULL) abort();
+
+    if (dictionary->put(dictionary, "alpha", (void *) 1) != true) abort();
+    if (dictionary->get(dictionary, "alpha") != (void *) 1) abort();
+    if (dictionary->get(dictionary, "beta") != NULL) abort();
+    if (dictionary->put_if_absent(dictionary, "alpha", (void *) 2) != false) abort();
+    if (dictionary->upsert(dictionary, "beta", (void *) 3) != NULL) abort();
+    const struct CollectionKey key = collection_key("beta");
+    if (dictionary->contains_key_hashed(dictionary, &key) != true) abort();
+    if (dictionary->remove_item(dictionary, "alpha") != (void *) 1) abort();
+    if (dictionary->clear(dictionary, NULL) != true) abort();
+    if (trace->count(trace) != 8) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+    collection_trace_dealloc(&trace);
+
+    size_t count;
+    struct CollectionTraceRecord *records = collection_trace_load(TRACE_PATH, &count);
+    if (records == NULL || count != 9) abort();
+    expect_key(&records[0], COLLECTION_TRACE_DICTIONARY_PUT, true, "alpha");
+    expect_key(&records[1], COLLECTION_TRACE_DICTIONARY_GET, true, "alpha");
+    expect_key(&records[2], COLLECTION_TRACE_DICTIONARY_GET, false, "beta");
+    expect_key(&records[3], COLLECTION_TRACE_DICTIONARY_PUT_IF_ABSENT, false, "alpha");
+    expect_key(&records[4], COLLECTION_TRACE_DICTIONARY_UPSERT, false, "beta");
+    expect_key(&records[5], COLLECTION_TRACE_DICTIONARY_CONTAINS_KEY_HASHED, true, "beta");
+    expect_key(&records[6], COLLECTION_TRACE_DICTIONARY_REMOVE_ITEM, true, "alpha");
+    if (records[7].op != COLLECTION_TRACE_DICTIONARY_CLEAR || records[7].key_length != 0) abort();
+    if (records[8].op != COLLECTION_TRACE_DICTIONARY_DEALLOC) abort();
+    for (size_t i = 1; i < count; i++) {
+        if (records[i].thread != records[0].thread || records[i].index != 0) abort();
+    }
+    free(records);
+}
+
+// Verifies that batch operations are stored contiguously with a countdown and per-key outcomes.
+void test_dictionary_batches(void) {
+    struct ITrace *trace = collection_trace_new(TRACE_PATH);
+    if (trace == NULL) abort();
+    struct IDictionary *dictionary = collection_dictionary_new_recording(collection_dictionary_new_swiss(), trace);
+    if (dictionary == NULL) abort();
+
+    const char *keys[100];
+    char names[100][16];
+    const void *values[100];
+    for (size_t i = 0; i < 100; i++) { // More keys than fit in the wrapper's inline batch.
+        snprintf(names[i], sizeof(names[i]), "key%zu", i);
+        keys[i] = names[i];
+        values[i] = (void *) (uintptr_t) (i + 1);
+    }
+    if (dictionary->put_many(dictionary, keys, values, 50) != 50) abort();
+    void *found[100];
+    if (dictionary->get_many(dictionary, keys, 100, found) != 50) abort();
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+    collection_trace_dealloc(&trace);
+
+    size_t count;
+    struct CollectionTraceRecord *records = collection_trace_load(TRACE_PATH, &count);
+    if (records == NULL || count != 151) abort();
+    for (size_t i = 0; i < 50; i++) {
+        expect_key(&records[i], COLLECTION_TRACE_DICTIONARY_PUT_MANY, true, keys[i]);
+        if (records[i].index != 50 - i) abort();
+    }
+    for (size_t i = 0; i < 100; i++) {
+        expect_key(&records[50 + i], COLLECTION_TRACE_DICTIONARY_GET_MANY, i < 50, keys[i]);
+        if (records[50 + i].index != 100 - i) abort();
+    }
+    free(records);
+}
+
+// Verifies that array operations record indices, predicate calls and outcomes.
+void test_array_recording(void) {
+    struct ITrace *trace = collection_trace_new(TRACE_PATH);
+    if (trace == NULL) abort();
+    struct IArray *array = collection_array_new_recording(collection_array_new_vector(), trace);
+    if (array == NULL) abort();
+
+    for (uintptr_t i = 1; i <= 5; i++) {
+        if (array->push(array, (void *) i) != true) abort();
+    }
+    if (array->get(array, 2) != (void *) 3) abort();
+    if (array->get(array, 9) != NULL) abort();
+    const void *target = (void *) 4;
+    if (array->first_index(array, equals, &target) != 3) abort();
+    const void *missing = (void *) 42;
+    if (array->find(array, equals, &missing) != NULL) abort();
+    if (array->pop(array) != (void *) 5) abort();
+
+    struct IArray *copy = array->clone(array);
+    if (copy == NULL || copy->count(copy) != 4) abort();
+    collection_array_dealloc(&copy, NULL);
+    if (trace->count(trace) != 11) abort(); // The clone's own operations are not recorded.
+
+    collection_array_dealloc(&array, NULL);
+    collection_trace_dealloc(&trace);
+
+    size_t count;
+    struct CollectionTraceRecord *records = collection_trace_load(TRACE_PATH, &count);
+    if (records == NULL || count != 12) abort();
+    for (size_t i = 0; i < 5; i++) {
+        if (records[i].op != COLLECTION_TRACE_ARRAY_PUSH || records[i].flags != COLLECTION_TRACE_SUCCEEDED) abort();
+    }
+    if (records[5].op != COLLECTION_TRACE_ARRAY_GET || records[5].index != 2 || records[5].flags == 0) abort();
+    if (records[6].op != COLLECTION_TRACE_ARRAY_GET || records[6].index != 9 || records[6].flags != 0) abort();
+    if (records[7].op != COLLECTION_TRACE_ARRAY_FIRST_INDEX || records[7].index != 4 || records[7].flags == 0) abort();
+    if (records[8].op != COLLECTION_TRACE_ARRAY_FIND || records[8].index != 5 || records[8].flags != 0) abort();
+    if (records[9].op != COLLECTION_TRACE_ARRAY_POP || records[9].flags == 0) abort();
+    if (records[10].op != COLLECTION_TRACE_ARRAY_CLONE || records[11].op != COLLECTION_TRACE_ARRAY_DEALLOC) abort();
+    for (size_t i = 0; i < count; i++) {
+        if (records[i].key_length != 0 || records[i].key_hash != 0) abort();
+    }
+    free(records);
+}
+
+// Verifies that flush makes buffered records readable while recording continues.
+void test_flush(void) {
+    struct ITrace *trace = collection_trace_new(TRACE_PATH);
+    if (trace == NULL) abort();
+    struct IDictionary *dictionary = collection_dictionary_new_recording(collection_dictionary_new(), trace);
+    if (dictionary == NULL) abort();
+
+    size_t count;
+    if (collection_trace_load(TRACE_PATH, &count) != NULL || count != 0) abort(); // Header only.
+
+    dictionary->put(dictionary, "key", (void *) 1);
+    dictionary->get(dictionary, "key");
+    if (trace->flush(trace) != true) abort();
+
+    struct CollectionTraceRecord *records = collection_trace_load(TRACE_PATH, &count);
+    if (records == NULL || count != 2) abort();
+    free(records);
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+    collection_trace_dealloc(&trace);
+}
+
+// Verifies that missing, foreign and truncated files are rejected.
+void test_load_invalid(void) {
+    size_t count = 7;
+    if (collection_trace_load("test_trace_missing.bin", &count) != NULL || count != 0) abort();
+
+    FILE *file = fopen(TRACE_PATH, "wb");
+    if (file == NULL) abort();
+    fputs("not a trace file at all", file);
+    fclose(file);
+    if (collection_trace_load(TRACE_PATH, &count) != NULL || count != 0) abort();
+
+    file = fopen(TRACE_PATH, "wb");
+    if (file == NULL) abort();
+    fwrite("CTRC", 1, 4, file);
+    fclose(file);
+    if (collection_trace_load(TRACE_PATH, &count) != NULL) abort();
+
+    if (collection_trace_new(NULL) != NULL) abort();
+    struct ITrace *trace = collection_trace_new(TRACE_PATH);
+    if (trace == NULL) abort();
+    if (collection_dictionary_new_recording(NULL, trace) != NULL) abort();
+    if (collection_array_new_recording(NULL, trace) != NULL) abort();
+    collection_trace_dealloc(&trace);
+}
+
+// Verifies that deallocation nulls the caller's pointer and tolerates NULL.
+void test_dealloc(void) {
+    struct ITrace *trace = collection_trace_new(TRACE_PATH);
+    if (trace == NULL) abort();
+    struct IArray *array = collection_array_new_recording(collection_array_new(), trace);
+    if (array == NULL) abort();
+
+    for (int i = 0; i < 10; i++) {
+        int *value = malloc(sizeof(int));
+        if (value == NULL) abort();
+        *value = i;
+        array->push(array, value);
+    }
+
+    // Pass free if stored items are heap allocated
+    collection_array_dealloc(&array, free);
+    if (array != NULL) abort();
+    collection_trace_dealloc(&trace);
+    if (trace != NULL) abort();
+    collection_trace_dealloc(&trace);
+    collection_trace_dealloc(NULL);
+}
+
+// Creates a platform thread.
+static void thread_create(Thread *thread, ThreadResult (*routine)(void *), void *arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+    if (*thread == NULL) abort();
+#else
+    if (pthread_create(thread, NULL, routine, arg) != 0) abort();
+#endif
+}
+
+// Waits for a platform thread to finish.
+static void thread_join(Thread thread) {
+#ifdef _WIN32
+    if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0) abort();
+    CloseHandle(thread);
+#else
+    if (pthread_join(thread, NULL) != 0) abort();
+#endif
+}
+
+struct Worker {
+    struct IDictionary *dictionary;
+    size_t id;
+};
+
+// Upserts keys owned by this worker, then reads them back with one batch.
+static ThreadResult worker_thread(void *arg) {
+    const struct Worker *worker = arg;
+    char names[8][32];
+    const char *keys[8];
+    for (size_t i = 0; i < 8; i++) {
+        snprintf(names[i], sizeof(names[i]), "worker%zu-%zu", worker->id, i);
+        keys[i] = names[i];
+    }
+
+    for (size_t i = 0; i < ROUNDS; i++) {
+        worker->dictionary->upsert(worker->dictionary, keys[i % 8], (void *) (uintptr_t) (i + 1));
+    }
+    void *values[8];
+    if (worker->dictionary->get_many(worker->dictionary, keys, 8, values) != 8) abort();
+    return THREAD_RETURN;
+}
+
+// Verifies that records from concurrent threads are all kept in sequence order, carry distinct thread numbers and keep batches whole.
+void test_concurrent_recording(void) {
+    struct ITrace *trace = collection_trace_new(TRACE_PATH);
+    if (trace == NULL) abort();
+    struct IDictionary *dictionary = collection_dictionary_new_recording(collection_dictionary_new_striped(0), trace);
+    if (dictionary == NULL) abort();
+
+    Thread threads[THREADS];
+    struct Worker workers[THREADS];
+    for (size_t i = 0; i < THREADS; i++) {
+        workers[i] = (struct Worker) {dictionary, i};
+        thread_create(&threads[i], worker_thread, &workers[i]);
+    }
+    for (size_t i = 0; i < THREADS; i++) thread_join(threads[i]);
+
+    collection_dictionary_dealloc(&dictionary, NULL);
+    collection_trace_dealloc(&trace);
+
+    size_t count;
+    struct CollectionTraceRecord *records = collection_trace_load(TRACE_PATH, &count);
+    if (records == NULL || count != THREADS * (ROUNDS + 8) + 1) abort();
+
+    static size_t per_thread[65536];
+    memset(per_thread, 0, sizeof(per_thread));
+    size_t distinct = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (records[i].sequence != i) abort();
+    }
+    for (size_t i = 0; i < count - 1; i++) {
+        if (per_thread[records[i].thread]++ == 0) distinct++;
+        if (records[i].op == COLLECTION_TRACE_DICTIONARY_GET_MANY && records[i].index == 8) {
+            for (size_t j = 1; j < 8; j++) { // The rest of the batch follows from the same thread.
+                if (records[i + j].thread != records[i].thread || records[i + j].index != 8 - j) abort();
+            }
+        }
+    }
+    if (distinct != THREADS) abort();
+    for (size_t i = 0; i < 65536; i++) {
+        if (per_thread[i] != 0 && per_thread[i] != ROUNDS + 8) abort();
+    }
+    free(records);
+}
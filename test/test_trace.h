@@ -0,0 +1,16 @@
+/**
+ * @file test_trace.h
+ * @brief Trace Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_dictionary_recording(void);
+void test_dictionary_batches(void);
+void test_array_recording(void);
+void test_flush(void);
+void test_load_invalid(void);
+void test_dealloc(void);
+void test_concurrent_recording(void);
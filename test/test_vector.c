@@ -0,0 +1,116 @@
+/**
+ * @file test_vector.c
+ * @brief Vector-specific unit tests; the shared IArray behaviour is covered by test_array.c.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_vector.h"
+#include "collection/i_array.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "VectorTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_indexed_access", test_indexed_access);
+    test("test_reserve", test_reserve);
+    test("test_shrink_to_fit", test_shrink_to_fit);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+// Verifies indexed access across many buffer growths.
+void test_indexed_access(void) {
+    struct IArray *array = collection_array_new_vector();
+    if (array == NULL) abort();
+
+    for (uintptr_t i = 0; i < 100000; i++) {
+        if (array->push(array, (void *) (i + 1)) != true) abort();
+    }
+    if (array->count(array) != 100000) abort();
+
+    for (uintptr_t i = 0; i < 100000; i++) {
+        if (array->get(array, i) != (void *) (i + 1)) abort();
+    }
+    if (array->get(array, 100000) != NULL) abort();
+
+    if (array->put(array, (void *) 7, 500) != (void *) 501) abort();
+    if (array->get(array, 500) != (void *) 7) abort();
+    if (array->put(array, (void *) 7, 100000) != NULL) abort();
+
+    if (array->unshift(array, (void *) 9) != (void *) 9) abort();
+    if (array->get(array, 0) != (void *) 9) abort();
+    if (array->get(array, 1) != (void *) 1) abort();
+
+    collection_array_dealloc(&array, NULL);
+}
+
+// Verifies reserving capacity ahead of inserts, and that other arrays are refused.
+void test_reserve(void) {
+    struct IArray *array = collection_array_new_vector();
+    if (array == NULL) abort();
+
+    if (collection_array_vector_reserve(array, 1000) != true) abort();
+    if (array->count(array) != 0) abort();
+
+    for (uintptr_t i = 0; i < 1000; i++) {
+        if (array->push(array, (void *) (i + 1)) != true) abort();
+    }
+    if (collection_array_vector_reserve(array, 10) != true) abort(); // Never shrinks
+    if (array->get(array, 999) != (void *) 1000) abort();
+    collection_array_dealloc(&array, NULL);
+
+    array = collection_array_new(); // Not a vector
+    if (array == NULL) abort();
+    if (collection_array_vector_reserve(array, 1000) != false) abort();
+    if (collection_array_vector_shrink_to_fit(array) != false) abort();
+    collection_array_dealloc(&array, NULL);
+}
+
+// Verifies releasing unused capacity.
+void test_shrink_to_fit(void) {
+    struct IArray *array = collection_array_new_vector();
+    if (array == NULL) abort();
+
+    if (collection_array_vector_shrink_to_fit(array) != true) abort();
+
+    for (uintptr_t i = 0; i < 100; i++) array->push(array, (void *) (i + 1));
+    for (uintptr_t i = 0; i < 90; i++) array->pop(array);
+
+    if (collection_array_vector_shrink_to_fit(array) != true) abort();
+    if (array->count(array) != 10) abort();
+    if (array->get(array, 9) != (void *) 10) abort();
+    if (array->push(array, (void *) 11) != true) abort();
+
+    array->clear(array, NULL);
+    if (collection_array_vector_shrink_to_fit(array) != true) abort();
+    if (array->push(array, (void *) 1) != true) abort();
+    if (array->pop(array) != (void *) 1) abort();
+
+    collection_array_dealloc(&array, NULL);
+}
@@ -0,0 +1,12 @@
+/**
+ * @file test_vector.h
+ * @brief Vector Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_indexed_access(void);
+void test_reserve(void);
+void test_shrink_to_fit(void);
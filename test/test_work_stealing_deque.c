@@ -0,0 +1,261 @@
+/**
+ * @file test_work_stealing_deque.c
+ * @brief Work-stealing deque unit tests.
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#include "test_work_stealing_deque.h"
+#include "collection/i_array.h"
+#include "collection/i_platform.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+typedef HANDLE Thread;
+typedef DWORD WINAPI ThreadResult;
+#define THREAD_RETURN 0
+#else
+#include <sched.h>
+typedef pthread_t Thread;
+typedef void *ThreadResult;
+#define THREAD_RETURN NULL
+#endif
+
+#define THIEVES 3
+#define ITEMS 200000
+
+static void before_all(void) { }
+static void before_each(void) { }
+static void after_each(void) { }
+static void after_all(void) { }
+
+static void test(const char *name, void (*callback)(void)) {
+    printf("\033[0;34m[RUNNING]\033[0m %s...\n", name);
+    fflush(stdout);
+
+    before_each();
+    callback();
+    after_each();
+
+    printf("\033[0;32m[PASSED]\033[0m %s\n", name);
+    fflush(stdout);
+}
+
+int main(void) {
+    printf("\n\033[1;36m================================================\033[0m\n");
+    printf("\033[1;36m[SUITE] %s\033[0m\n", "WorkStealingDequeTest");
+    printf("\033[1;36m================================================\033[0m\n\n");
+
+    before_all();
+    test("test_push_pop", test_push_pop);
+    test("test_steal", test_steal);
+    test("test_grow", test_grow);
+    test("test_unsupported", test_unsupported);
+    test("test_dealloc", test_dealloc);
+    test("test_concurrent_steal", test_concurrent_steal);
+    after_all();
+
+    printf("\n\033[1;32m[DONE] All tests in suite finished.\033[0m\n");
+    return 0;
+}
+
+// Creates a platform thread.
+static void thread_create(Thread *thread, ThreadResult (*routine)(void *), void *arg) {
+#ifdef _WIN32
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+    if (*thread == NULL) abort();
+#else
+    if (pthread_create(thread, NULL, routine, arg) != 0) abort();
+#endif
+}
+
+// Waits for a platform thread to finish.
+static void thread_join(Thread thread) {
+#ifdef _WIN32
+    if (WaitForSingleObject(thread, INFINITE) != WAIT_OBJECT_0) abort();
+    CloseHandle(thread);
+#else
+    if (pthread_join(thread, NULL) != 0) abort();
+#endif
+}
+
+// Yields the processor while waiting on a full or empty queue.
+static void thread_yield(void) {
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// Verifies that the owner pops in LIFO order.
+void test_push_pop(void) {
+    struct IArray *deque = collection_array_new_work_stealing();
+    if (deque == NULL) abort();
+
+    if (deque->pop(deque) != NULL) abort();
+    if (deque->count(deque) != 0) abort();
+
+    for (uintptr_t i = 1; i <= 5; i++) {
+        if (deque->push(deque, (void *) i) != true) abort();
+    }
+    if (deque->count(deque) != 5) abort();
+    for (uintptr_t i = 5; i >= 1; i--) {
+        if (deque->pop(deque) != (void *) i) abort();
+    }
+    if (deque->pop(deque) != NULL) abort();
+    if (deque->count(deque) != 0) abort();
+
+    collection_array_dealloc(&deque, NULL);
+}
+
+// Verifies that shift steals in FIFO order and interleaves with pop.
+void test_steal(void) {
+    struct IArray *deque = collection_array_new_work_stealing();
+    if (deque == NULL) abort();
+
+    if (deque->shift(deque) != NULL) abort();
+
+    for (uintptr_t i = 1; i <= 4; i++) deque->push(deque, (void *) i);
+    if (deque->shift(deque) != (void *) 1) abort();
+    if (deque->pop(deque) != (void *) 4) abort();
+    if (deque->shift(deque) != (void *) 2) abort();
+    if (deque->pop(deque) != (void *) 3) abort();
+    if (deque->shift(deque) != NULL) abort();
+    if (deque->pop(deque) != NULL) abort();
+
+    collection_array_dealloc(&deque, NULL);
+}
+
+// Verifies that elements survive several doublings of the ring while the top has moved.
+void test_grow(void) {
+    struct IArray *deque = collection_array_new_work_stealing();
+    if (deque == NULL) abort();
+
+    for (uintptr_t i = 1; i <= 10; i++) deque->push(deque, (void *) i);
+    for (uintptr_t i = 1; i <= 10; i++) {
+        if (deque->shift(deque) != (void *) i) abort(); // Offset top so the copy wraps.
+    }
+
+    for (uintptr_t i = 1; i <= 1000; i++) {
+        if (deque->push(deque, (void *) i) != true) abort();
+    }
+    if (deque->count(deque) != 1000) abort();
+    for (uintptr_t i = 1; i <= 500; i++) {
+        if (deque->shift(deque) != (void *) i) abort();
+    }
+    for (uintptr_t i = 1000; i > 500; i--) {
+        if (deque->pop(deque) != (void *) i) abort();
+    }
+    if (deque->count(deque) != 0) abort();
+
+    collection_array_dealloc(&deque, NULL);
+}
+
+// Predicate that matches every element.
+static bool match_all(const void *element, const void *data) {
+    (void) element;
+    (void) data;
+    return true;
+}
+
+// Verifies that operations without deque semantics fail cleanly.
+void test_unsupported(void) {
+    struct IArray *deque = collection_array_new_work_stealing();
+    if (deque == NULL) abort();
+
+    if (deque->push(deque, (void *) 1) != true) abort();
+
+    if (deque->get(deque, 0) != NULL) abort();
+    if (deque->put(deque, (void *) 2, 0) != NULL) abort();
+    if (deque->find(deque, match_all, NULL) != NULL) abort();
+    if (deque->first_index(deque, match_all, NULL) != SIZE_MAX) abort();
+    if (deque->last_index(deque, match_all, NULL) != SIZE_MAX) abort();
+    if (deque->unshift(deque, (void *) 2) != NULL) abort();
+    if (deque->contains_value(deque, (void *) 1) != false) abort();
+    if (deque->remove_item(deque, (void *) 1) != NULL) abort();
+    if (deque->clone(deque) != NULL) abort();
+
+    if (deque->count(deque) != 1) abort();
+
+    collection_array_dealloc(&deque, NULL);
+}
+
+// Verifies destroying a deque and releasing remaining elements.
+void test_dealloc(void) {
+    struct IArray *deque = collection_array_new_work_stealing();
+    if (deque == NULL) abort();
+
+    for (int i = 0; i < 100; i++) { // Enough to retire a few rings.
+        int *value = malloc(sizeof(int));
+        if (value == NULL) abort();
+        *value = i;
+        if (deque->push(deque, value) != true) abort();
+    }
+
+    // Pass free if stored items are heap allocated
+    collection_array_dealloc(&deque, free);
+    if (deque != NULL) abort();
+}
+
+struct Shared {
+    struct IArray *deque;
+    atomic_uchar *seen;                 // Times each item was taken.
+    atomic_bool done;                   // Set by the owner once it has pushed everything and drained.
+};
+
+// Records that an item was taken.
+static void take(struct Shared *shared, const void *item) {
+    atomic_fetch_add_explicit(&shared->seen[(uintptr_t) item - 1], 1, memory_order_relaxed);
+}
+
+// Steals until the owner has finished and the deque is empty.
+static ThreadResult thief_thread(void *arg) {
+    struct Shared *shared = arg;
+    for (;;) {
+        const void *item = shared->deque->shift(shared->deque);
+        if (item) {
+            take(shared, item);
+        } else if (atomic_load(&shared->done)) {
+            break;
+        } else {
+            thread_yield();
+        }
+    }
+    return THREAD_RETURN;
+}
+
+// Verifies that every element is taken exactly once while thieves race the owner and the ring grows.
+void test_concurrent_steal(void) {
+    struct Shared shared = {collection_array_new_work_stealing(), calloc(ITEMS, sizeof(atomic_uchar)), false};
+    if (shared.deque == NULL || shared.seen == NULL) abort();
+
+    Thread thieves[THIEVES];
+    for (size_t i = 0; i < THIEVES; i++) thread_create(&thieves[i], thief_thread, &shared);
+
+    for (uintptr_t i = 1; i <= ITEMS; i++) {
+        if (shared.deque->push(shared.deque, (void *) i) != true) abort();
+        if (i % 3 == 0) { // Pop some of our own work, as a scheduler would.
+            const void *item = shared.deque->pop(shared.deque);
+            if (item) take(&shared, item);
+        }
+    }
+    const void *item;
+    while (shared.deque->count(shared.deque) > 0) {
+        if ((item = shared.deque->pop(shared.deque)) != NULL) take(&shared, item);
+    }
+    atomic_store(&shared.done, true);
+
+    for (size_t i = 0; i < THIEVES; i++) thread_join(thieves[i]);
+
+    for (size_t i = 0; i < ITEMS; i++) {
+        if (atomic_load(&shared.seen[i]) != 1) abort();
+    }
+
+    free(shared.seen);
+    collection_array_dealloc(&shared.deque, NULL);
+}
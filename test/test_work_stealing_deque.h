@@ -0,0 +1,15 @@
+/**
+ * @file test_work_stealing_deque.h
+ * @brief Work-Stealing Deque Unit Test
+ *
+ * @author Saad Shams https://linkedin.com/in/muizz
+ * @copyright BSD 3-Clause License
+ */
+#pragma once
+
+void test_push_pop(void);
+void test_steal(void);
+void test_grow(void);
+void test_unsupported(void);
+void test_dealloc(void);
+void test_concurrent_steal(void);